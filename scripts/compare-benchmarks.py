@@ -0,0 +1,107 @@
+#! /usr/bin/env python3
+"""Compares two vtbackend_bench runs and fails on a slowdown.
+
+Record each run with Catch2's XML reporter, e.g. a baseline before a change and a run after it:
+
+    vtbackend_bench --reporter xml::out=baseline.xml
+    vtbackend_bench --reporter xml::out=current.xml
+    scripts/compare-benchmarks.py baseline.xml current.xml --max-slowdown 10
+
+A baseline is only meaningful on the machine it was recorded on, so none is checked in: keep one per
+machine, next to the build tree.
+
+A benchmark counts as slower only when its mean rose by more than --max-slowdown percent AND the
+confidence intervals of the two means do not overlap. The second condition is what keeps a noisy
+benchmark on a busy laptop from failing the comparison on every other run.
+"""
+
+from __future__ import annotations
+
+import argparse
+import sys
+import xml.etree.ElementTree as ElementTree
+from dataclasses import dataclass
+from pathlib import Path
+
+
+@dataclass(frozen=True)
+class Estimate:
+    """A benchmark's mean, in nanoseconds, with the bounds of its confidence interval."""
+
+    mean: float
+    lower: float
+    upper: float
+
+
+def read_results(path: Path) -> dict[str, Estimate]:
+    """Reads every benchmark of a Catch2 XML report, keyed by "test case / benchmark"."""
+    results: dict[str, Estimate] = {}
+    for test_case in ElementTree.parse(path).getroot().iter("TestCase"):
+        for benchmark in test_case.iter("BenchmarkResults"):
+            mean = benchmark.find("mean")
+            if mean is None:
+                continue
+            key = f"{test_case.get('name')} / {benchmark.get('name')}"
+            results[key] = Estimate(
+                mean=float(mean.get("value", "nan")),
+                lower=float(mean.get("lowerBound", "nan")),
+                upper=float(mean.get("upperBound", "nan")),
+            )
+    return results
+
+
+def format_ns(value: float) -> str:
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if value >= scale:
+            return f"{value / scale:.2f} {unit}"
+    return f"{value:.1f} ns"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", type=Path, help="XML report of the run to compare against")
+    parser.add_argument("current", type=Path, help="XML report of the run to check")
+    parser.add_argument(
+        "--max-slowdown",
+        type=float,
+        default=10.0,
+        metavar="PERCENT",
+        help="largest tolerated rise of a mean, in percent (default: 10)",
+    )
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    current = read_results(args.current)
+    if not current:
+        print(f"{args.current}: no benchmark results; was it run with --reporter xml?", file=sys.stderr)
+        return 2
+
+    width = max(len(name) for name in current)
+    print(f"{'benchmark':<{width}}  {'baseline':>10}  {'current':>10}  {'change':>8}")
+
+    slower: list[str] = []
+    for name, now in sorted(current.items()):
+        before = baseline.get(name)
+        if before is None:
+            print(f"{name:<{width}}  {'-':>10}  {format_ns(now.mean):>10}  {'new':>8}")
+            continue
+        change = (now.mean / before.mean - 1.0) * 100.0
+        regressed = change > args.max_slowdown and now.lower > before.upper
+        marker = "  SLOWER" if regressed else ""
+        print(
+            f"{name:<{width}}  {format_ns(before.mean):>10}  {format_ns(now.mean):>10}  {change:>+7.1f}%{marker}"
+        )
+        if regressed:
+            slower.append(name)
+
+    for name in sorted(baseline.keys() - current.keys()):
+        print(f"{name:<{width}}  (not in the current run)")
+
+    if slower:
+        print(f"\n{len(slower)} benchmark(s) slower by more than {args.max_slowdown:g}%.", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
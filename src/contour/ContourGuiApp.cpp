@@ -29,6 +29,7 @@
 #include <crispy/LogSink.hpp>
 #include <crispy/LogStore.hpp>
 #include <crispy/ScopedTimer.hpp>
+#include <crispy/TraceEvents.hpp>
 #include <crispy/Utils.hpp>
 
 #include <QtCore/QEventLoop>
@@ -160,6 +161,9 @@ int ContourGuiApp::clientAction()
     auto const tmuxSocket = parameters().get<string>("contour.client.tmux-socket");
     auto const connectTcp = parameters().get<string>("contour.client.connect-tcp");
     auto const tlsCaPath = parameters().get<string>("contour.client.tls-ca");
+    auto const predictiveEcho = parameters().get<bool>("contour.client.predictive-echo")
+                                    ? vthost::client::PredictiveEchoMode::Enabled
+                                    : vthost::client::PredictiveEchoMode::Disabled;
 
     auto const resolvedToken = vthost::resolveToken(parameters().get<string>("contour.client.token"),
                                                     parameters().get<string>("contour.client.token-file"));
@@ -297,8 +301,8 @@ int ContourGuiApp::clientAction()
                                 "sessions.\n",
                                 resolved.error());
 
-        _nativeController =
-            std::make_unique<remote::NativeController>(std::move(endpoint), std::move(sessionSettings));
+        _nativeController = std::make_unique<remote::NativeController>(
+            std::move(endpoint), std::move(sessionSettings), predictiveEcho);
         if (auto connected = _nativeController->connectAndWait(std::chrono::seconds(5)); !connected)
         {
             cerr << std::format("contour client: {} ({})\n", connected.error(), endpointLabel);
@@ -315,8 +319,9 @@ int ContourGuiApp::clientAction()
         // split authored on the daemon, here or by another client), map each daemon
         // window onto an OS window and realize any tab not yet shown, each pane bound
         // to its remote session. Incremental — what is already shown is left untouched.
-        // A dying connection ends every mirror session (stop() closes the ptys),
-        // closing the tabs through the shell-exit teardown.
+        // A dropped connection is redialed and resumed by the controller; only one it
+        // gives up on ends every mirror session (stop() closes the ptys), closing the
+        // tabs through the shell-exit teardown.
         adopt = [this] {
             reconcileAttachWindows();
         };
@@ -437,6 +442,11 @@ crispy::cli::Command ContourGuiApp::parameterDefinition() const
                               "for --connect-tcp. Omitted = TOFU (encrypt, don't verify; "
                               "the token authenticates).",
                               "FILE" },
+                CLI::Option { "predictive-echo",
+                              CLI::Value { false },
+                              "Shows typed text before the daemon echoes it back, once the link "
+                              "is slow enough to notice (mosh-style). Never for full-screen "
+                              "applications." },
                 CLI::Option { "log",
                               CLI::Value { ""s },
                               "Enables logging for a comma (,) separated list of tags, or `all` "
@@ -536,6 +546,13 @@ crispy::cli::Command ContourGuiApp::parameterDefinition() const
                     CLI::Value { ""s },
                     "Dumps internal state at exit into the given directory. This is for debugging contour.",
                     "PATH" },
+                CLI::Option { "trace-file",
+                              CLI::Value { ""s },
+                              "Records each session's frame pipeline from its start and writes it when the "
+                              "session ends, to FILE with the session's number appended to its name "
+                              "(trace.json becomes trace-session-1.json), in the Chrome trace-event format "
+                              "(chrome://tracing, ui.perfetto.dev).",
+                              "FILE" },
                 CLI::Option { "early-exit-threshold",
                               CLI::Value { -1 },
                               "If the spawned process exits earlier than the given threshold seconds, an "
@@ -621,6 +638,14 @@ std::optional<fs::path> ContourGuiApp::dumpStateAtExit() const
     return fs::path(path);
 }
 
+std::optional<fs::path> ContourGuiApp::traceFile() const
+{
+    auto const path = parameters().get<std::string>("contour.terminal.trace-file");
+    if (path.empty())
+        return std::nullopt;
+    return fs::path(path);
+}
+
 void ContourGuiApp::onExit(session::TerminalSession& session)
 {
     if (auto const* localProcess = dynamic_cast<vtpty::Process const*>(&session.terminal().device()))
@@ -887,6 +912,8 @@ int ContourGuiApp::terminalGuiAction()
             return EXIT_FAILURE;
     }
 
+    crispy::trace::setThreadName("gui");
+
 #ifdef __APPLE__
     QGuiApplication::setAttribute(Qt::AA_MacDontSwapCtrlAndMeta, true);
 #endif
@@ -12,6 +12,8 @@
 #include <contour/session/TerminalSessionManager.hpp>
 #include <contour/window/UiStyleProvider.hpp>
 
+#include <vtrasterizer/SharedTextCache.hpp>
+
 #include <vtpty/Process.hpp>
 #include <vtpty/SshSession.hpp>
 
@@ -176,6 +178,10 @@ class ContourGuiApp: public QObject, public cli::ContourApp
 
     [[nodiscard]] std::optional<std::filesystem::path> dumpStateAtExit() const;
 
+    /// Where to write the frame traces recorded from startup, if requested (--trace-file): each session
+    /// writes its own, named after this path by crispy::trace::sessionTracePath().
+    [[nodiscard]] std::optional<std::filesystem::path> traceFile() const;
+
     void onExit(session::TerminalSession& session);
 
     config::Config& config() noexcept { return _config; }
@@ -214,6 +220,9 @@ class ContourGuiApp: public QObject, public cli::ContourApp
     /// in one tab could not stop what another tab had started.
     [[nodiscard]] platform::SpeechSynthesizer& speechSynthesizer() noexcept { return *_speechSynthesizer; }
 
+    /// The text shapers and rasterized glyphs this app's renderers share, one per like configuration.
+    [[nodiscard]] vtrasterizer::SharedTextCacheRegistry& textCaches() noexcept { return _textCaches; }
+
     [[nodiscard]] vtbackend::ColorPreference colorPreference() const noexcept { return _colorPreference; }
 
     /// Applies the configured GUI chrome theme (dark/light/system) to the application's color
@@ -302,6 +311,8 @@ class ContourGuiApp: public QObject, public cli::ContourApp
     std::unique_ptr<command::CommandHistoryStore> _commandHistoryStore;
     // Shared by every session, reached via _app; @see speechSynthesizer().
     std::unique_ptr<platform::SpeechSynthesizer> _speechSynthesizer;
+    // Shared by every display's renderer, reached via the session; @see textCaches().
+    vtrasterizer::SharedTextCacheRegistry _textCaches;
     session::TerminalSessionManager _sessionManager;
     std::unique_ptr<display::ForcedFontDpiProvider> _forcedFontDpiProvider;
     // Shared by every display, reached via the session; @see keyboardLayout(). Unlike the DPI
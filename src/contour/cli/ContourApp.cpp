@@ -706,6 +706,7 @@ int ContourApp::daemonAction()
     config.shell.program = shellCommand.front();
     config.shell.arguments.assign(std::next(shellCommand.begin()), shellCommand.end());
     config.shell.workingDirectory = vtpty::Process::homeDirectory();
+    config.prespawnedShells = parameters().get<unsigned>("contour.daemon.prespawned-shells");
 
     if (auto label = parameters().get<string>("contour.daemon.tmux-compat-socket"); !label.empty())
         config.tmuxCompatLabel = std::move(label);
@@ -766,6 +767,29 @@ int ContourApp::daemonAction()
         };
     }
 
+    // Opt-in metrics endpoint. It has no authentication at all, so a non-loopback address is
+    // refused here, where the user can still fix the command line, as well as by the daemon.
+    if (auto const listen = parameters().get<string>("contour.daemon.metrics-listen"); !listen.empty())
+    {
+        auto const hostPort = vthost::parseHostPort(listen);
+        if (!hostPort)
+        {
+            cerr << std::format("contour daemon: invalid --metrics-listen '{}' (expected HOST:PORT)\n",
+                                listen);
+            return EXIT_FAILURE;
+        }
+        if (!vthost::isLoopbackHost(hostPort->first))
+        {
+            cerr << std::format("contour daemon: --metrics-listen must be a loopback address, not '{}'\n",
+                                hostPort->first);
+            return EXIT_FAILURE;
+        }
+        config.metrics = vthost::MetricsListenerConfig { .host = hostPort->first, .port = hostPort->second };
+    }
+
+    if (auto const traceFile = parameters().get<string>("contour.daemon.trace-file"); !traceFile.empty())
+        config.traceFile = std::filesystem::path { traceFile };
+
     // Everything above has validated the configuration, so a typo is reported by THIS process
     // rather than killing a child whose stderr nobody is reading. Only now is it safe to hand
     // the work to a detached copy of ourselves.
@@ -1177,6 +1201,12 @@ crispy::cli::Command ContourApp::parameterDefinition() const
                                   "largest grid every client can fully display) or `largest` (the "
                                   "union, which smaller clients pan). Mirrors tmux's `window-size`.",
                                   "POLICY" },
+                    CLI::Option { "prespawned-shells",
+                                  CLI::Value { 0u },
+                                  "Number of shells to keep started in the background, so that a "
+                                  "new tab or split opens without waiting for the shell's startup "
+                                  "scripts. 0 (the default) starts each shell on demand.",
+                                  "COUNT" },
                     CLI::Option { "tmux-compat-socket",
                                   CLI::Value { ""s },
                                   "Additionally binds tmux's own discovery path "
@@ -1211,6 +1241,22 @@ crispy::cli::Command ContourApp::parameterDefinition() const
                                   "FILE" },
                     CLI::Option {
                         "tls-key", CLI::Value { ""s }, "PEM private key matching --tls-cert.", "FILE" },
+                    CLI::Option { "metrics-listen",
+                                  CLI::Value { ""s },
+                                  "Serves Prometheus-style metrics (PTY throughput, parse times, "
+                                  "per-connection push volume and latency) at "
+                                  "http://HOST:PORT/metrics. Opt-in, unauthenticated, and "
+                                  "therefore loopback only, e.g. 127.0.0.1:9464. "
+                                  "GET /trace there returns the frame trace recorded so far.",
+                                  "HOST:PORT" },
+                    CLI::Option { "trace-file",
+                                  CLI::Value { ""s },
+                                  "Records each session's PTY reads, parsing and delta pushes from "
+                                  "its start and writes them when it ends, to FILE with the "
+                                  "session's number appended to its name (trace.json becomes "
+                                  "trace-session-1.json), in the Chrome trace-event format "
+                                  "(chrome://tracing, ui.perfetto.dev).",
+                                  "FILE" },
                     CLI::Option { "log",
                                   CLI::Value { ""s },
                                   "Enables logging for a comma (,) separated list of tags, or "
@@ -75,6 +75,7 @@ struct OpenSelection{};
 struct PasteClipboard{ bool strip = false; };
 struct PasteSelection{ bool evaluateInShell = false;};
 struct Quit{};
+struct RecordFrameTrace{};
 struct ReloadConfig{ std::optional<std::string> profileName; };
 struct ResetConfig{};
 struct ResetFontSize{};
@@ -97,6 +98,7 @@ struct ToggleAllKeyMaps{};
 struct ToggleFullscreen{};
 struct ToggleInputMethodHandling {};
 struct ToggleInputProtection{};
+struct ToggleLatencyProbe{};
 struct ToggleStatusLine{};
 struct ToggleTitleBar{};
 struct TraceBreakAtEmptyQueue{};
@@ -148,6 +150,7 @@ struct ResetTabColor{}; // drop the user's tab color, revealing any color the ap
 struct CloseAllTabs{};  // close every tab in THIS window, which with one window means quitting
 struct SpeakSelection{}; // read the selected text aloud through the OS speech synthesizer
 struct StopSpeaking{};   // stop reading aloud
+struct CancelPaste{};    // abandon the paste still being streamed to the application
 struct SetTabBarVisibility{ config::TabBarVisibility mode = config::TabBarVisibility::Always; };
 struct SetTabBarPosition{ config::TabBarPosition position = config::TabBarPosition::Top; };
 // clang-format on
@@ -176,6 +179,7 @@ using Action = std::variant<CancelSelection,
                             PasteClipboard,
                             PasteSelection,
                             Quit,
+                            RecordFrameTrace,
                             ReloadConfig,
                             ResetConfig,
                             ResetFontSize,
@@ -198,6 +202,7 @@ using Action = std::variant<CancelSelection,
                             ToggleFullscreen,
                             ToggleInputMethodHandling,
                             ToggleInputProtection,
+                            ToggleLatencyProbe,
                             ToggleStatusLine,
                             ToggleTitleBar,
                             TraceBreakAtEmptyQueue,
@@ -249,7 +254,8 @@ using Action = std::variant<CancelSelection,
                             SetTabBarVisibility,
                             SetTabBarPosition,
                             SpeakSelection,
-                            StopSpeaking>;
+                            StopSpeaking,
+                            CancelPaste>;
 
 /// Actions that must fire exactly once per physical keypress and be dropped on key auto-repeat.
 ///
@@ -425,6 +431,10 @@ namespace documentation
                                                        "must be appended with linefeed and used as an input "
                                                        "for the running shell" };
     constexpr inline std::string_view Quit { "Quits the application." };
+    constexpr inline std::string_view RecordFrameTrace {
+        "Starts recording the current session's frame pipeline; invoked again, stops and writes the "
+        "recording as a Chrome trace (chrome://tracing, ui.perfetto.dev) into the local state directory."
+    };
     constexpr inline std::string_view ReloadConfig { "Forces a configuration reload." };
     constexpr inline std::string_view ResetConfig {
         "Overwrites current configuration with builtin default configuration and loads it. Attention, all "
@@ -464,6 +474,10 @@ namespace documentation
         "Enables/disables IME (input method editor) handling."
     };
     constexpr inline std::string_view ToggleInputProtection { "Enables/disables terminal input protection." };
+    constexpr inline std::string_view ToggleLatencyProbe {
+        "Starts/stops measuring keypress-to-present latency, shown per stage (p50/p95/p99) in an overlay "
+        "and logged when stopped."
+    };
     constexpr inline std::string_view ToggleStatusLine {
         "Shows/hides the VT320 compatible Indicator status line."
     };
@@ -527,6 +541,11 @@ namespace documentation
         "only where a speech engine and a voice are installed."
     };
     constexpr inline std::string_view StopSpeaking { "Stops reading aloud." };
+    constexpr inline std::string_view CancelPaste {
+        "Abandons a large paste that is still being sent to the application. What was already sent "
+        "stays; a bracketed paste is still closed properly. Typing a key with Control held, such as "
+        "Ctrl+C, does the same before the key is sent."
+    };
     constexpr inline std::string_view SplitVertical {
         "Splits the active pane into two side-by-side panes (a vertical divider)."
     };
@@ -661,6 +680,8 @@ struct ActionCatalogEntry
         ActionCatalogEntry { "PasteClipboard", Action { PasteClipboard {} }, documentation::PasteClipboard },
         ActionCatalogEntry { "PasteSelection", Action { PasteSelection {} }, documentation::PasteSelection },
         ActionCatalogEntry { "Quit", Action { Quit {} }, documentation::Quit },
+        ActionCatalogEntry {
+            "RecordFrameTrace", Action { RecordFrameTrace {} }, documentation::RecordFrameTrace },
         ActionCatalogEntry { "ReloadConfig", Action { ReloadConfig {} }, documentation::ReloadConfig },
         ActionCatalogEntry { "ResetConfig", Action { ResetConfig {} }, documentation::ResetConfig },
         ActionCatalogEntry { "ResetFontSize", Action { ResetFontSize {} }, documentation::ResetFontSize },
@@ -689,6 +710,8 @@ struct ActionCatalogEntry
         ActionCatalogEntry { "ToggleInputProtection",
                              Action { ToggleInputProtection {} },
                              documentation::ToggleInputProtection },
+        ActionCatalogEntry {
+            "ToggleLatencyProbe", Action { ToggleLatencyProbe {} }, documentation::ToggleLatencyProbe },
         ActionCatalogEntry {
             "ToggleStatusLine", Action { ToggleStatusLine {} }, documentation::ToggleStatusLine },
         ActionCatalogEntry { "ToggleTitleBar", Action { ToggleTitleBar {} }, documentation::ToggleTitleBar },
@@ -759,6 +782,7 @@ struct ActionCatalogEntry
             "SetTabBarPosition", Action { SetTabBarPosition {} }, documentation::SetTabBarPosition },
         ActionCatalogEntry { "SpeakSelection", Action { SpeakSelection {} }, documentation::SpeakSelection },
         ActionCatalogEntry { "StopSpeaking", Action { StopSpeaking {} }, documentation::StopSpeaking },
+        ActionCatalogEntry { "CancelPaste", Action { CancelPaste {} }, documentation::CancelPaste },
     };
     return catalog;
 }
@@ -907,6 +907,7 @@ void YAMLConfigReader::loadProfileBody(YAML::Node const& child, TerminalProfile&
         defaultSettings(where.shell.value());
 
         loadFromEntry(child, "escape_sandbox", where.escapeSandbox);
+        loadFromEntry(child, "prespawned_shells", where.prespawnedShells);
         loadFromEntry(child, "copy_last_mark_range_offset", where.copyLastMarkRangeOffset);
         loadFromEntry(child, "show_title_bar", where.showTitleBar);
         loadFromEntry(child, "dim_unfocused", where.dimUnfocused);
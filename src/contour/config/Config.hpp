@@ -590,6 +590,7 @@ struct TerminalProfile
     } }; // namespace contour::config
     ConfigEntry<vtpty::SshHostConfig, documentation::SshHostConfig> ssh {};
     ConfigEntry<bool, documentation::EscapeSandbox> escapeSandbox { true };
+    ConfigEntry<unsigned, documentation::PrespawnedShells> prespawnedShells { 0 };
     ConfigEntry<vtbackend::LineOffset, documentation::CopyLastMarkRangeOffset> copyLastMarkRangeOffset { 0 };
     // show_title_bar now selects the WINDOW DECORATION: true = native server-side frame (+ the OS's
     // own min/max/close controls; our tab strip then omits its custom ones), false = frameless with
@@ -47,6 +47,15 @@ constexpr StringLiteral EscapeSandboxConfig {
     "\n"
 };
 
+constexpr StringLiteral PrespawnedShellsConfig {
+    "{comment} Number of shells to keep started in the background, so that a new tab or split\n"
+    "{comment} of this profile opens without waiting for the shell's startup scripts.\n"
+    "{comment} These shells start in the profile's working directory; a tab that inherits\n"
+    "{comment} another directory starts its shell as usual. 0 (the default) disables this.\n"
+    "prespawned_shells: {}\n"
+    "\n"
+};
+
 constexpr StringLiteral SshHostConfigConfig {
     "{comment} Builtin SSH-client configuration.\n"
     "{comment} Use this to directly connect to an SSH server.\n"
@@ -1017,6 +1026,8 @@ constexpr StringLiteral InputMappingsConfig {
     "whitespaces.\n"
     "{comment} - PasteSelection    Pastes current selection to standard input.\n"
     "{comment} - Quit              Quits the application.\n"
+    "{comment} - RecordFrameTrace  Starts recording the current session's frame pipeline; invoked again, "
+    "stops and writes the recording as a Chrome trace (chrome://tracing, ui.perfetto.dev).\n"
     "{comment} - ReloadConfig      Forces a configuration reload.\n"
     "{comment} - ResetConfig       Overwrites current configuration with builtin default configuration "
     "and "
@@ -1053,6 +1064,8 @@ constexpr StringLiteral InputMappingsConfig {
     "{comment} - ToggleFullScreen  Enables/disables full screen mode.\n"
     "{comment} - ToggleInputMethodHandling Enables/disables IME (input method editor) handling.\n"
     "{comment} - ToggleInputProtection Enables/disables terminal input protection.\n"
+    "{comment} - ToggleLatencyProbe Starts/stops measuring keypress-to-present latency, shown per stage "
+    "(p50/p95/p99) in an overlay and logged when stopped.\n"
     "{comment} - ToggleStatusLine  Shows/hides the VT320 compatible Indicator status line.\n"
     "{comment} - ToggleTitleBar    Shows/Hides titlebar\n"
     "{comment} - TraceBreakAtEmptyQueue Executes any pending VT sequence from the VT sequence buffer in "
@@ -1549,6 +1562,21 @@ constexpr StringLiteral EscapeSandboxWeb {
 
 };
 
+constexpr StringLiteral PrespawnedShellsWeb {
+    "option keeps the given number of shells started in the background, so that a new tab or split of "
+    "this profile opens at once instead of after the shell's startup scripts ran. These shells start "
+    "in the profile's `initial_working_directory`, so only a tab or split opened there gets one. A tab "
+    "that inherits the working directory of the one it was opened beside, or a layout pane with its "
+    "own directory or command, starts its shell as usual and leaves the background shells alone. The "
+    "default value `0` disables this. It has no effect on a profile connecting via `ssh`.\n"
+    "``` yaml\n"
+    "profiles:\n"
+    "  profile_name:\n"
+    "    prespawned_shells: 2\n"
+    "```\n"
+    "\n"
+};
+
 constexpr StringLiteral SshHostConfigWeb {
     "With this key, you can bypass local PTY and process execution and directly connect via TCP/IP to a "
     "remote SSH server.\n"
@@ -2306,6 +2334,7 @@ constexpr StringLiteral MomentumScrollingWeb {
 
 using Shell = DocumentationEntry<ShellConfig, ShellWeb>;
 using EscapeSandbox = DocumentationEntry<EscapeSandboxConfig, EscapeSandboxWeb>;
+using PrespawnedShells = DocumentationEntry<PrespawnedShellsConfig, PrespawnedShellsWeb>;
 using SshHostConfig = DocumentationEntry<SshHostConfigConfig, SshHostConfigWeb>;
 using Maximized = DocumentationEntry<MaximizedConfig, MaximizedWeb>;
 using Fullscreen = DocumentationEntry<FullscreenConfig, FullscreenWeb>;
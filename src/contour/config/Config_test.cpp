@@ -251,6 +251,7 @@ profiles:
         arguments: ['-c', 'true']
         show_title_bar: true
         dim_unfocused: 0.25
+        prespawned_shells: 2
         size_indicator_on_resize: false
         fullscreen: true
         maximized: true
@@ -274,6 +275,7 @@ profiles:
     CHECK(profile->shell.value().arguments[0] == "-c");
     CHECK(profile->showTitleBar.value() == true);
     CHECK(profile->dimUnfocused.value() == 0.25);
+    CHECK(profile->prespawnedShells.value() == 2);
     CHECK(profile->sizeIndicatorOnResize.value() == false);
     CHECK(profile->fullscreen.value() == true);
     CHECK(profile->maximized.value() == true);
@@ -379,7 +379,8 @@ TEST_CASE("display: a scaled block is selected over its whole height", "[display
     // highlight must cover both of its rows -- and therefore reach below the glyph's own ink.
     h.session->terminal().markScreenDirty();
     {
-        auto const _ = std::scoped_lock { h.session->terminal() };
+        auto const _ =
+            vtbackend::Terminal::SiteLock { h.session->terminal(), vtbackend::LockSite::Selection };
         h.session->terminal().setSelector(std::make_unique<vtbackend::LinearSelection>(
             h.session->terminal().selectionHelper(),
             vtbackend::CellLocation { .line = vtbackend::LineOffset(0),
@@ -1144,7 +1145,8 @@ TEST_CASE("display: the accessibility text interface reads the viewport column-a
     // size, so the flat layout's stride is whatever that reflow settled on. A row is its cells, then
     // the newline that ends it.
     auto const columns = [&] {
-        auto const lock = std::lock_guard { h.session->terminal() };
+        auto const lock =
+            vtbackend::Terminal::SiteLock { h.session->terminal(), vtbackend::LockSite::Accessibility };
         return unbox<int>(h.session->terminal().pageSize().columns);
     }();
     auto const stride = columns + 1;
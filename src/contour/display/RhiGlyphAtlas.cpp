@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <contour/display/Logging.hpp>
+#include <contour/display/RhiGlyphAtlas.hpp>
+
+#include <crispy/Assert.hpp>
+
+#include <QtCore/QByteArray>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+using vtbackend::Height;
+using vtbackend::ImageSize;
+using vtbackend::Width;
+
+namespace atlas = vtrasterizer::atlas;
+
+namespace contour::display
+{
+
+ImageSize RhiGlyphAtlas::atlasSize() const noexcept
+{
+    auto const l = std::scoped_lock { _mutex };
+    return _atlasSize;
+}
+
+void RhiGlyphAtlas::configureAtlas(ConfigureAtlas atlas)
+{
+    auto const l = std::scoped_lock { _mutex };
+
+    // Tiles queued so far belong to the atlas being replaced, and their TileLocations were computed from
+    // the OLD tiles-per-row: replayed after the new configuration, each would land on top of an unrelated
+    // tile. Whoever owns the new atlas re-uploads what it needs.
+    _pendingUploads.clear();
+
+    _atlasSize = atlas.size;
+    _properties = atlas.properties;
+    _pendingConfiguration.emplace(std::move(atlas));
+
+    displayLog()("configureAtlas: {} {}", _atlasSize, _properties.format);
+}
+
+void RhiGlyphAtlas::uploadTile(UploadTile tile)
+{
+    auto const l = std::scoped_lock { _mutex };
+
+    // clang-format off
+    if (!(tile.bitmapSize.width <= _properties.tileSize.width))
+        errorLog()("uploadTile assertion alert: width {} <= {} failed.", tile.bitmapSize.width, _properties.tileSize.width);
+    if (!(tile.bitmapSize.height <= _properties.tileSize.height))
+        errorLog()("uploadTile assertion alert: height {} <= {} failed.", tile.bitmapSize.height, _properties.tileSize.height);
+    // clang-format on
+
+    _pendingUploads.emplace_back(std::move(tile));
+}
+
+void RhiGlyphAtlas::renderTile(RenderTile tile)
+{
+    (void) tile;
+    errorLog()("RhiGlyphAtlas::renderTile called; tiles are rendered through the renderer's own scheduler.");
+}
+
+bool RhiGlyphAtlas::attach()
+{
+    auto const l = std::scoped_lock { _mutex };
+    return _users++ == 0;
+}
+
+void RhiGlyphAtlas::detach() noexcept
+{
+    auto const l = std::scoped_lock { _mutex };
+    if (_users == 0 || --_users != 0)
+        return;
+
+    // A frame still in flight may sample it; deleteLater() holds it until that frame is submitted.
+    if (_texture)
+        _texture.release()->deleteLater();
+    _textureSize = {};
+    _pendingConfiguration.reset();
+    _pendingUploads.clear();
+}
+
+void RhiGlyphAtlas::ensureTexture(QRhi* rhi)
+{
+    Require(rhi != nullptr);
+
+    auto const l = std::scoped_lock { _mutex };
+    if (_texture)
+        return;
+
+    // Prefer the size of the configuration about to be applied: building the placeholder at any other
+    // size only to throw it away one execute() later costs a second multi-megabyte allocation.
+    auto const requested = _pendingConfiguration ? _pendingConfiguration->size : _atlasSize;
+    createTexture(rhi, requested.area() != 0 ? requested : ImageSize { Width(1), Height(1) });
+}
+
+size_t RhiGlyphAtlas::execute(QRhi* rhi, QRhiResourceUpdateBatch& updates)
+{
+    Require(rhi != nullptr);
+
+    auto const l = std::scoped_lock { _mutex };
+
+    if (auto const configuration = std::exchange(_pendingConfiguration, std::nullopt))
+    {
+        // std::has_single_bit also rejects 0, which a zero-sized atlas would be.
+        Require(std::has_single_bit(unbox(configuration->size.width)));
+        Require(std::has_single_bit(unbox(configuration->size.height)));
+        Require(configuration->properties.format == atlas::Format::RGBA);
+
+        // Alone, a configuration of the size the texture already has can keep it: the rasterizer only
+        // samples tiles it has uploaded since. Shared, another renderer may already have staged this
+        // frame's draws against the tiles the texture holds now.
+        if (!_texture || _textureSize != configuration->size || _users > 1)
+        {
+            if (_texture)
+                _texture.release()->deleteLater();
+            createTexture(rhi, configuration->size);
+        }
+    }
+
+    // No full-texture clear: the rasterizer only ever samples atlas tiles it has uploaded, so untouched
+    // regions are never read, and a multi-MB full-level clear upload (besides being pure overhead) is what
+    // the OpenGL RHI backend rejected as an "invalid texture upload" on a freshly created large texture.
+    auto const uploaded = _pendingUploads.size();
+    if (_texture)
+        for (auto const& tile: _pendingUploads)
+            queueUpload(updates, tile);
+    _pendingUploads.clear();
+    return uploaded;
+}
+
+QRhiTexture* RhiGlyphAtlas::texture() const
+{
+    auto const l = std::scoped_lock { _mutex };
+    return _texture.get();
+}
+
+ImageSize RhiGlyphAtlas::textureSize() const
+{
+    auto const l = std::scoped_lock { _mutex };
+    return _textureSize;
+}
+
+void RhiGlyphAtlas::createTexture(QRhi* rhi, ImageSize size)
+{
+    // A plain sampled RGBA8 texture (no extra usage flags): it is a CPU upload destination
+    // (uploadTexture) and a fragment-shader sample source, both of which a default sampled texture
+    // supports. The debug-only readback uses readBackTexture(), which the RHI backs with a transient copy
+    // where supported.
+    auto const pixelSize = QSize(unbox<int>(size.width), unbox<int>(size.height));
+    _texture.reset(rhi->newTexture(QRhiTexture::RGBA8, pixelSize, 1, {}));
+    if (!_texture->create())
+        errorLog()("Failed to create RHI atlas texture of size {}.", size);
+
+    // Only the GPU extent is recorded here. _atlasSize belongs to configureAtlas(): it is the size of the
+    // atlas the RASTERIZER is filling, and a texture created at a stale size is self-healing, since the
+    // pending configuration is applied by the next execute().
+    _textureSize = size;
+}
+
+void RhiGlyphAtlas::queueUpload(QRhiResourceUpdateBatch& updates, UploadTile const& tile) const
+{
+    // {{{ Force RGBA: the atlas texture is RGBA8, but tiles may arrive as Red (alpha-mask glyphs) or RGB.
+    auto const tileWidth = unbox<int>(tile.bitmapSize.width);
+    auto const tileHeight = unbox<int>(tile.bitmapSize.height);
+
+    // A zero-area tile (e.g. the blank glyph of a space) carries no pixels; uploading it would be rejected by
+    // the RHI as an invalid (empty) texture upload, and there is nothing to sample anyway. Skip it.
+    if (tileWidth <= 0 || tileHeight <= 0 || tile.bitmap.empty())
+        return;
+
+    QByteArray rgba;
+    switch (tile.bitmapFormat)
+    {
+        case atlas::Format::Red: {
+            rgba.resize(static_cast<qsizetype>(tile.bitmapSize.area()) * 4);
+            auto* t = reinterpret_cast<uint8_t*>(rgba.data());
+            for (auto const c: tile.bitmap)
+            {
+                *t++ = c;    // red
+                *t++ = 0x00; // green
+                *t++ = 0x00; // blue
+                *t++ = 0xFF; // alpha
+            }
+            break;
+        }
+        case atlas::Format::RGB: {
+            rgba.resize(static_cast<qsizetype>(tile.bitmapSize.area()) * 4);
+            auto* t = reinterpret_cast<uint8_t*>(rgba.data());
+            auto const* s = tile.bitmap.data();
+            auto const* const e = tile.bitmap.data() + tile.bitmap.size();
+            while (s != e)
+            {
+                *t++ = *s++; // red
+                *t++ = *s++; // green
+                *t++ = *s++; // blue
+                *t++ = 0xFF; // alpha
+            }
+            break;
+        }
+        case atlas::Format::RGBA:
+            rgba = QByteArray(reinterpret_cast<char const*>(tile.bitmap.data()),
+                              static_cast<qsizetype>(tile.bitmap.size()));
+            break;
+    }
+    // }}}
+
+    // Sub-image upload at the tile's atlas location. Row alignment is 1 byte (RGBA, tightly packed), which
+    // QRhi's tightly-packed byte-data path assumes; this mirrors the former
+    // glPixelStorei(UNPACK_ALIGNMENT,1).
+    QRhiTextureSubresourceUploadDescription desc(rgba.constData(), static_cast<quint32>(rgba.size()));
+    desc.setSourceSize(QSize(tileWidth, tileHeight));
+    desc.setDestinationTopLeft(QPoint(tile.location.x.value, tile.location.y.value));
+    updates.uploadTexture(_texture.get(), QRhiTextureUploadDescription(QRhiTextureUploadEntry(0, 0, desc)));
+}
+
+void RhiGlyphAtlas::scheduleReadback(QRhiResourceUpdateBatch& updates)
+{
+    auto const l = std::scoped_lock { _mutex };
+    if (!_readbackRequested || !_texture)
+        return;
+
+    updates.readBackTexture(QRhiReadbackDescription(_texture.get()), &_readbackResult);
+    _readbackRequested = false;
+}
+
+vtrasterizer::AtlasTextureScreenshot RhiGlyphAtlas::readAtlas()
+{
+    auto const l = std::scoped_lock { _mutex };
+
+    // A readBackTexture() scheduled into a frame's resource batch only completes after the command buffer
+    // for that frame is submitted (past the end of the render pass). We therefore request a capture on the
+    // next frame and hand back whatever the most recently completed capture produced. The first call
+    // (before any frame has captured) returns a correctly-sized zero buffer.
+    _readbackRequested = true;
+
+    // Aggregate-initialized rather than default-constructed + assigned: atlas::Format has no zero
+    // enumerator, so value-initializing the struct would leave `format` holding an invalid value.
+    auto output = vtrasterizer::AtlasTextureScreenshot {
+        .atlasInstanceId = 0, .size = _atlasSize, .format = _properties.format, .buffer = {}
+    };
+
+    auto const expectedBytes = static_cast<size_t>(_atlasSize.area()) * elementCount(_properties.format);
+
+    if (!_readbackResult.data.isEmpty()
+        && _readbackResult.pixelSize == QSize(unbox<int>(_atlasSize.width), unbox<int>(_atlasSize.height)))
+    {
+        auto const* bytes = reinterpret_cast<uint8_t const*>(_readbackResult.data.constData());
+        output.buffer.assign(bytes, bytes + std::min<size_t>(expectedBytes, _readbackResult.data.size()));
+    }
+    output.buffer.resize(expectedBytes);
+
+    return output;
+}
+
+} // namespace contour::display
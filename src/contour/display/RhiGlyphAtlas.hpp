@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <contour/display/RhiResource.hpp>
+
+#include <vtbackend/Primitives.hpp>
+
+#include <vtrasterizer/RenderTarget.hpp>
+#include <vtrasterizer/TextureAtlas.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <rhi/qrhi.h>
+
+namespace contour::display
+{
+
+/// The glyph atlas texture of one window, filled by every pane of that window drawing the same text.
+///
+/// Panes of one window render through the window's single QRhi, so they can all sample one texture.
+/// The rasterizer's SharedGlyphAtlas hands this backend to each of them (RhiRenderer::
+/// createSharedAtlasBackend()); configureAtlas() and uploadTile() arrive here from whichever pane's
+/// frame needed the tile, and every pane's text pipeline binds the resulting texture. Tiles are still
+/// drawn through each pane's own RhiRenderer, which owns the vertices and the scissor.
+///
+/// Each pane uploads the tiles queued so far onto its own frame's resource batch in execute(). The panes
+/// of one window stage all their frames before any of them draws, so a tile queued by one pane is on
+/// the GPU before another pane samples it.
+class RhiGlyphAtlas final: public vtrasterizer::atlas::AtlasBackend
+{
+  public:
+    using ImageSize = vtbackend::ImageSize;
+    using ConfigureAtlas = vtrasterizer::atlas::ConfigureAtlas;
+    using UploadTile = vtrasterizer::atlas::UploadTile;
+    using RenderTile = vtrasterizer::atlas::RenderTile;
+
+    RhiGlyphAtlas() = default;
+    RhiGlyphAtlas(RhiGlyphAtlas const&) = delete;
+    RhiGlyphAtlas& operator=(RhiGlyphAtlas const&) = delete;
+    RhiGlyphAtlas(RhiGlyphAtlas&&) = delete;
+    RhiGlyphAtlas& operator=(RhiGlyphAtlas&&) = delete;
+    ~RhiGlyphAtlas() override = default;
+
+    // AtlasBackend implementation
+    [[nodiscard]] ImageSize atlasSize() const noexcept override;
+    void configureAtlas(ConfigureAtlas atlas) override;
+    void uploadTile(UploadTile tile) override;
+
+    /// Never called: renderers draw their tiles through their own RenderTarget::textureScheduler().
+    void renderTile(RenderTile tile) override;
+
+    /// Counts one more RhiRenderer drawing from this atlas.
+    /// @return true if there was none before, so the texture holds none of the atlas' tiles.
+    [[nodiscard]] bool attach();
+
+    /// Counts one RhiRenderer less. The last one to leave takes the texture with it: it belongs to that
+    /// renderer's QRhi, which may not outlive it.
+    void detach() noexcept;
+
+    /// Creates the texture, at the configured size or as a 1x1 placeholder before any configuration,
+    /// so a text pipeline can be bound to it. No-op if it exists already.
+    void ensureTexture(QRhi* rhi);
+
+    /// Applies the pending configuration, if any, and queues every pending tile upload onto @p updates.
+    ///
+    /// A new configuration gets a new texture whenever another renderer shares this one: that renderer
+    /// may already have staged a frame sampling the old tiles at their old locations, so the old texture
+    /// is only released (QRhiResource::deleteLater()) once the frame has been submitted.
+    /// @return the number of tiles uploaded.
+    size_t execute(QRhi* rhi, QRhiResourceUpdateBatch& updates);
+
+    /// The texture every text pipeline drawing from this atlas binds, or nullptr before ensureTexture().
+    [[nodiscard]] QRhiTexture* texture() const;
+
+    /// The pixel size texture() was created at.
+    [[nodiscard]] ImageSize textureSize() const;
+
+    /// Queues a readback of the texture onto @p updates if readAtlas() asked for one.
+    void scheduleReadback(QRhiResourceUpdateBatch& updates);
+
+    /// Asks for a readback on the next frame and returns the pixels of the last one that completed, or a
+    /// zeroed buffer of the atlas' size if none has.
+    [[nodiscard]] vtrasterizer::AtlasTextureScreenshot readAtlas();
+
+  private:
+    void createTexture(QRhi* rhi, ImageSize size);
+    void queueUpload(QRhiResourceUpdateBatch& updates, UploadTile const& tile) const;
+
+    mutable std::mutex _mutex;
+    size_t _users = 0;
+
+    /// The atlas the rasterizer is filling; ahead of the texture until the next execute().
+    ImageSize _atlasSize {};
+    vtrasterizer::atlas::AtlasProperties _properties {};
+    std::optional<ConfigureAtlas> _pendingConfiguration;
+    std::vector<UploadTile> _pendingUploads;
+
+    QRhiResourcePtr<QRhiTexture> _texture;
+    ImageSize _textureSize {};
+
+    // Deferred, like every readback: the result lands once the frame it was scheduled into is submitted.
+    bool _readbackRequested = false;
+    QRhiReadbackResult _readbackResult;
+};
+
+} // namespace contour::display
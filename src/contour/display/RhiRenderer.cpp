@@ -142,9 +142,16 @@ namespace
  */
 
 RhiRenderer::RhiRenderer(vtbackend::ImageSize targetSurfaceSize,
-                         [[maybe_unused]] vtbackend::ImageSize textureTileSize):
-    _startTime { chrono::steady_clock::now().time_since_epoch() }
+                         [[maybe_unused]] vtbackend::ImageSize textureTileSize,
+                         QQuickWindow const* window,
+                         crispy::trace::Recorder* traceRecorder):
+    _startTime { chrono::steady_clock::now().time_since_epoch() },
+    _traceRecorder { traceRecorder },
+    _glyphAtlas { std::make_shared<RhiGlyphAtlas>() },
+    _window { window }
 {
+    (void) _glyphAtlas->attach();
+
     // Log the requested argument, not _renderTargetSize: setRenderSize() below is what assigns the member,
     // so reading it here would always report the default-constructed 0x0.
     display::displayLog()("RhiRenderer: Constructing with render size {}.", targetSurfaceSize);
@@ -189,11 +196,41 @@ atlas::AtlasBackend& RhiRenderer::textureScheduler()
     return *this;
 }
 
+void const* RhiRenderer::graphicsContext() const noexcept
+{
+    // One QRhi per window: every pane of it can sample every other pane's textures.
+    if (_window)
+        return _window;
+    return this;
+}
+
+std::shared_ptr<atlas::AtlasBackend> RhiRenderer::createSharedAtlasBackend()
+{
+    return std::make_shared<RhiGlyphAtlas>();
+}
+
+bool RhiRenderer::useSharedAtlasBackend(std::shared_ptr<atlas::AtlasBackend> const& backend)
+{
+    if (backend == _glyphAtlas)
+        return false;
+
+    auto glyphAtlas = std::dynamic_pointer_cast<RhiGlyphAtlas>(backend);
+    Require(glyphAtlas != nullptr);
+
+    // Detached right away: frames already staged against the old texture keep it alive until they are
+    // submitted (RhiGlyphAtlas::detach()), and execute() rebinds the text pass before it stages again.
+    auto const lostTiles = glyphAtlas->attach();
+    std::exchange(_glyphAtlas, std::move(glyphAtlas))->detach();
+    return lostTiles;
+}
+
 RhiRenderer::~RhiRenderer()
 {
     display::displayLog()("~RhiRenderer");
     // RHI resources are released through their std::unique_ptr<QRhiResource*, QRhiResourceDeleter>
-    // members in reverse declaration order; nothing raw to clean up here.
+    // members in reverse declaration order. The atlas texture may be shared with other renderers of the
+    // window, and is released with the last of them.
+    _glyphAtlas->detach();
 }
 
 void RhiRenderer::initialize()
@@ -227,41 +264,6 @@ QShader RhiRenderer::loadShader(QString const& resourcePath)
     return shader;
 }
 
-void RhiRenderer::createAtlasTexture(QRhi* rhi, ImageSize size)
-{
-    auto const pixelSize = QSize(unbox<int>(size.width), unbox<int>(size.height));
-
-    // (Re)create the atlas texture as a plain sampled RGBA8 texture (no extra usage flags): it is a CPU
-    // upload destination (uploadTexture) and a fragment-shader sample source, both of which a default
-    // sampled texture supports. The debug-only atlas readback uses readBackTexture(), which the RHI backs
-    // with a transient copy where supported.
-    _atlasTexture.reset(rhi->newTexture(QRhiTexture::RGBA8, pixelSize, 1, {}));
-    if (!_atlasTexture->create())
-        errorLog()("Failed to create RHI atlas texture of size {}.", size);
-
-    // Only the GPU extent is recorded here. _atlasTextureSize belongs to configureAtlas(): it is the size
-    // of the atlas the RASTERIZER is filling, and writing it from this GPU-side function let a caller's
-    // stale `size` argument travel backwards in time. createPipelines() reads the member, allocates a
-    // multi-megabyte texture (milliseconds), and lands here long after a concurrent configureAtlas() has
-    // moved on -- which is exactly how #2040 rewound a 4096x8192 atlas to 2048x4096 and left every glyph
-    // sampling a quarter of its tile. A texture created at the wrong size is self-healing: the pending
-    // ConfigureAtlas is applied by the next execute(), and _atlasCreatedSize below is what tells it to.
-    _atlasCreatedSize = size;
-
-    // Nearest filtering + clamp-to-edge mirrors the former QOpenGLTexture configuration; created once and
-    // reused across atlas resizes.
-    if (!_atlasSampler)
-    {
-        _atlasSampler.reset(rhi->newSampler(QRhiSampler::Nearest,
-                                            QRhiSampler::Nearest,
-                                            QRhiSampler::None,
-                                            QRhiSampler::ClampToEdge,
-                                            QRhiSampler::ClampToEdge));
-        if (!_atlasSampler->create())
-            errorLog()("Failed to create RHI atlas sampler.");
-    }
-}
-
 QVarLengthArray<QRhiShaderResourceBinding, 2> RhiRenderer::atlasSrbBindings(QRhiBuffer* uniformBuffer,
                                                                             bool hasSampler) const
 {
@@ -272,7 +274,7 @@ QVarLengthArray<QRhiShaderResourceBinding, 2> RhiRenderer::atlasSrbBindings(QRhi
         0, QRhiShaderResourceBinding::VertexStage | QRhiShaderResourceBinding::FragmentStage, uniformBuffer));
     if (hasSampler)
         bindings.append(QRhiShaderResourceBinding::sampledTexture(
-            1, QRhiShaderResourceBinding::FragmentStage, _atlasTexture.get(), _atlasSampler.get()));
+            1, QRhiShaderResourceBinding::FragmentStage, _boundAtlasTexture, _atlasSampler.get()));
     return bindings;
 }
 
@@ -282,7 +284,7 @@ void RhiRenderer::rebindAtlasTexture(RhiPipeline& pipeline, QRhiBuffer* uniformB
         return;
     // The binding layout is unchanged; only the atlas texture object differs after a recreate. Rebuild the
     // QRhiShaderResourceBindings in place (same layout as createPipeline via atlasSrbBindings) so the
-    // pipeline keeps its srb object while binding 1 points at the new _atlasTexture. Every atlas rebind is a
+    // pipeline keeps its srb object while binding 1 points at the new texture. Every atlas rebind is a
     // sampling pass, so hasSampler is always true here.
     auto const bindings = atlasSrbBindings(uniformBuffer, /*hasSampler*/ true);
     pipeline.srb->setBindings(bindings.cbegin(), bindings.cend());
@@ -323,7 +325,7 @@ void RhiRenderer::createPipeline(QRhi* rhi,
     // referenced by binding 1); createPipelines() guarantees this ordering before invoking us.
     if (desc.hasSampler)
     {
-        Require(_atlasTexture != nullptr);
+        Require(_boundAtlasTexture != nullptr);
         Require(_atlasSampler != nullptr);
     }
 
@@ -405,21 +407,25 @@ void RhiRenderer::createPipelines(QRhi* rhi, QRhiRenderPassDescriptor* rpDesc)
     _renderPassDescriptor = rpDesc;
 
     // Ensure the atlas texture + sampler exist before the text pipeline references them (its descriptor sets
-    // hasSampler). If configureAtlas has not been observed yet, fall back to the currently known atlas size
-    // (or a 1x1 placeholder) so the shader-resource-bindings are valid; the real atlas is (re)created on the
-    // next configureAtlas.
-    //
-    // Prefer the size of the ConfigureAtlas already queued for this frame over the member: execute() is
-    // about to apply it, and building the placeholder at the member's size only to throw it away one call
-    // later costs a second multi-megabyte allocation on every pane's first frame.
-    if (!_atlasTexture)
+    // hasSampler). Nearest filtering + clamp-to-edge mirrors the former QOpenGLTexture configuration; the
+    // sampler is created once and reused across atlas rebuilds.
+    if (!_atlasSampler)
     {
-        auto const requested = _scheduledExecutions.configureAtlas ? _scheduledExecutions.configureAtlas->size
-                                                                   : _atlasTextureSize;
-        auto const size = requested.area() != 0 ? requested : ImageSize { Width(1), Height(1) };
-        createAtlasTexture(rhi, size);
+        _atlasSampler.reset(rhi->newSampler(QRhiSampler::Nearest,
+                                            QRhiSampler::Nearest,
+                                            QRhiSampler::None,
+                                            QRhiSampler::ClampToEdge,
+                                            QRhiSampler::ClampToEdge));
+        if (!_atlasSampler->create())
+            errorLog()("Failed to create RHI atlas sampler.");
     }
 
+    // Before the atlas is configured its texture is a 1x1 placeholder, so the shader-resource-bindings are
+    // valid; execute() rebinds them once the real one exists. A texture another renderer of the window
+    // already filled is simply bound.
+    _glyphAtlas->ensureTexture(rhi);
+    bindGlyphAtlas();
+
     // The render passes, described as data (passDescriptor()), each paired with the pipeline slot it
     // populates. Adding a pass is one more row here plus its FramePass tag and record step — no new
     // near-duplicate builder function.
@@ -444,38 +450,17 @@ void RhiRenderer::createPipelines(QRhi* rhi, QRhiRenderPassDescriptor* rpDesc)
 // {{{ AtlasBackend impl
 ImageSize RhiRenderer::atlasSize() const noexcept
 {
-    return _atlasTextureSize;
+    return _glyphAtlas->atlasSize();
 }
 
 void RhiRenderer::configureAtlas(atlas::ConfigureAtlas atlas)
 {
-    // Tiles queued so far belong to the atlas being replaced, and their TileLocations were computed from
-    // the OLD tiles-per-row -- execute() applies the single (last) ConfigureAtlas and then replays EVERY
-    // queued upload, so keeping them writes the previous atlas' bitmaps at the previous atlas'
-    // coordinates into the new texture, landing each one on top of an unrelated tile. Two configures in
-    // one drain window is not hypothetical: applyPendingReconfig() rebuilds the atlas from its geometry
-    // branch (growAtlasForPage) and again from its font branch (updateFontMetrics) in the same pass.
-    // Whoever owns the new atlas re-uploads what it needs; nothing here can be salvaged.
-    _scheduledExecutions.uploadTiles.clear();
-
-    // schedule atlas creation
-    _scheduledExecutions.configureAtlas.emplace(atlas);
-    _atlasTextureSize = atlas.size;
-    _atlasProperties = atlas.properties;
-
-    display::displayLog()("configureAtlas: {} {}", atlas.size, atlas.properties.format);
+    _glyphAtlas->configureAtlas(std::move(atlas));
 }
 
 void RhiRenderer::uploadTile(atlas::UploadTile tile)
 {
-    // clang-format off
-    if (!(tile.bitmapSize.width <= _atlasProperties.tileSize.width))
-        errorLog()("uploadTile assertion alert: width {} <= {} failed.", tile.bitmapSize.width, _atlasProperties.tileSize.width);
-    if (!(tile.bitmapSize.height <= _atlasProperties.tileSize.height))
-        errorLog()("uploadTile assertion alert: height {} <= {} failed.", tile.bitmapSize.height, _atlasProperties.tileSize.height);
-    // clang-format on
-
-    _scheduledExecutions.uploadTiles.emplace_back(std::move(tile));
+    _glyphAtlas->uploadTile(std::move(tile));
 }
 
 void RhiRenderer::renderTile(atlas::RenderTile tile)
@@ -549,8 +534,9 @@ void RhiRenderer::renderTile(atlas::RenderTile tile)
     // probe upstream cannot see this, because the item->clip transform is entirely correct.
     if (samplingProbeLog)
     {
-        auto const atlasWidth = unbox<float>(_atlasTextureSize.width);
-        auto const atlasHeight = unbox<float>(_atlasTextureSize.height);
+        auto const atlasSize = _glyphAtlas->atlasSize();
+        auto const atlasWidth = unbox<float>(atlasSize.width);
+        auto const atlasHeight = unbox<float>(atlasSize.height);
         if (atlasWidth > 0.0f && atlasHeight > 0.0f && r > 0.0f && s > 0.0f)
         {
             // Back out the texel extent the normalized region covers.
@@ -576,8 +562,8 @@ void RhiRenderer::renderTile(atlas::RenderTile tile)
                     tile.bitmapSize.height.value,
                     tile.targetSize.width.value,
                     tile.targetSize.height.value,
-                    _atlasTextureSize.width.value,
-                    _atlasTextureSize.height.value,
+                    atlasSize.width.value,
+                    atlasSize.height.value,
                     tile.fragmentShaderSelector);
         }
     }
@@ -683,12 +669,14 @@ void RhiRenderer::execute(std::chrono::steady_clock::time_point now)
     if (_frameUpdates == nullptr)
         _frameUpdates = _rhi->nextResourceUpdateBatch();
 
-    // (Re)configure / upload the glyph atlas before any text pass references it.
-    if (_scheduledExecutions.configureAtlas)
-        executeConfigureAtlas(*_scheduledExecutions.configureAtlas);
-
-    for (auto const& tile: _scheduledExecutions.uploadTiles)
-        executeUploadTile(*_frameUpdates, tile);
+    // (Re)configure / upload the glyph atlas before any text pass references it. The uploads include
+    // those other renderers of this window queued into a shared atlas since their own last frame.
+    {
+        auto scope = crispy::trace::Scope { _traceRecorder, "gpu", "atlasUpload" };
+        auto const tiles = _glyphAtlas->execute(_rhi, *_frameUpdates);
+        scope.setArgument("tiles", static_cast<int64_t>(tiles));
+    }
+    bindGlyphAtlas();
 
     for (auto& create: _scheduledExecutions.imageCreates)
         executeCreateImageTexture(*_frameUpdates, create);
@@ -736,7 +724,7 @@ void RhiRenderer::uploadTextUniforms(QRhiResourceUpdateBatch& updates,
     updates.updateDynamicBuffer(&uniformBuffer, rhilayout::TextUniformTimeOffset, sizeof(float), &timeValue);
 
     auto const pixelX =
-        _atlasTextureSize.width.value != 0 ? 1.0f / unbox<float>(_atlasTextureSize.width) : 0.0f;
+        _boundAtlasSize.width.value != 0 ? 1.0f / unbox<float>(_boundAtlasSize.width) : 0.0f;
     updates.updateDynamicBuffer(&uniformBuffer, rhilayout::TextUniformPixelXOffset, sizeof(float), &pixelX);
 
     auto const [outR, outG, outB, outA] = atlas::normalize(_textOutlineColor);
@@ -906,6 +894,8 @@ void RhiRenderer::flushFrame()
     if (_rhi == nullptr || _commandBuffer == nullptr || !pipelinesReady())
         return;
 
+    auto const scope = crispy::trace::Scope { _traceRecorder, "gpu", "submit" };
+
     if (_frameUpdates == nullptr)
         _frameUpdates = _rhi->nextResourceUpdateBatch();
 
@@ -945,11 +935,7 @@ void RhiRenderer::flushFrame()
     }
 
     // Deferred atlas readback (debug inspector): schedule the capture so it completes after this frame.
-    if (_atlasReadbackRequested && _atlasTexture)
-    {
-        _frameUpdates->readBackTexture(QRhiReadbackDescription(_atlasTexture.get()), &_atlasReadbackResult);
-        _atlasReadbackRequested = false;
-    }
+    _glyphAtlas->scheduleReadback(*_frameUpdates);
 
     _commandBuffer->resourceUpdate(_frameUpdates);
     _frameUpdates = nullptr;
@@ -1121,95 +1107,21 @@ void RhiRenderer::applyScissor(QRhiGraphicsPipeline* pipeline,
         QRhiScissor(clip.x, clip.y, std::max(0, clip.width), std::max(0, clip.height)));
 }
 
-void RhiRenderer::executeConfigureAtlas(atlas::ConfigureAtlas const& param)
-{
-    // std::has_single_bit is the standard power-of-two predicate (unbox() yields the unsigned extent it
-    // requires); it also rejects 0, which a zero-sized atlas would be, unlike the old hand-rolled check.
-    Require(std::has_single_bit(unbox(param.size.width)));
-    Require(std::has_single_bit(unbox(param.size.height)));
-    Require(param.properties.format == atlas::Format::RGBA);
-
-    // (Re)create the atlas texture only when its GPU extent actually changes — a ConfigureAtlas may be
-    // scheduled repeatedly at the same size (e.g. on the initial resize burst), and recreating a multi-MB
-    // texture every time is wasteful. createPipelines() may also have stood up a 1x1 placeholder texture
-    // before the real size was known, which this first real configure replaces. When recreated, refresh
-    // EVERY atlas-sampling pipeline's shader-resource bindings so they reference the new texture object; the
-    // sampler and uniform buffers are reused and the binding layout is unchanged, so each pipeline keeps its
-    // QRhiShaderResourceBindings object. The offscreen screenshot text pipeline (built once by
-    // ensureScreenshotTarget, which has a same-size early-out) samples the same atlas and shares the
-    // swapchain text pipeline's uniform buffer, so it must be rebound here too — otherwise a later
-    // screenshot samples the freed old atlas texture (use-after-free).
-    if (!_atlasTexture || _atlasCreatedSize != param.size)
-    {
-        createAtlasTexture(_rhi, param.size);
-        // Rebind EVERY atlas-sampling pipeline so none is left holding a reference to the freed texture.
-        // Each rebinds against its OWN uniform buffer (the screenshot pipeline owns one so its offscreen
-        // pass can use an item-local transform). Listed here as the single place that enumerates the
-        // atlas-sampling set — add a future one here and both build and rebind stay correct.
-        for (RhiPipeline* pipeline: { &_textPipeline, &_screenshotTextPipeline })
-            rebindAtlasTexture(*pipeline, pipeline->uniformBuffer.get());
-    }
-
-    // No full-texture clear: the rasterizer only ever samples atlas tiles it has uploaded, so untouched
-    // regions are never read, and a multi-MB full-level clear upload (besides being pure overhead) is what
-    // the OpenGL RHI backend rejected as an "invalid texture upload" on a freshly created large texture.
-}
-
-void RhiRenderer::executeUploadTile(QRhiResourceUpdateBatch& updates, atlas::UploadTile const& param)
+void RhiRenderer::bindGlyphAtlas()
 {
-    // {{{ Force RGBA: the atlas texture is RGBA8, but tiles may arrive as Red (alpha-mask glyphs) or RGB.
-    auto const tileWidth = unbox<int>(param.bitmapSize.width);
-    auto const tileHeight = unbox<int>(param.bitmapSize.height);
-
-    // A zero-area tile (e.g. the blank glyph of a space) carries no pixels; uploading it would be rejected by
-    // the RHI as an invalid (empty) texture upload, and there is nothing to sample anyway. Skip it.
-    if (tileWidth <= 0 || tileHeight <= 0 || param.bitmap.empty())
+    auto* const texture = _glyphAtlas->texture();
+    if (texture == nullptr || texture == _boundAtlasTexture)
         return;
 
-    QByteArray rgba;
-    switch (param.bitmapFormat)
-    {
-        case atlas::Format::Red: {
-            rgba.resize(static_cast<qsizetype>(param.bitmapSize.area()) * 4);
-            auto* t = reinterpret_cast<uint8_t*>(rgba.data());
-            for (auto const c: param.bitmap)
-            {
-                *t++ = c;    // red
-                *t++ = 0x00; // green
-                *t++ = 0x00; // blue
-                *t++ = 0xFF; // alpha
-            }
-            break;
-        }
-        case atlas::Format::RGB: {
-            rgba.resize(static_cast<qsizetype>(param.bitmapSize.area()) * 4);
-            auto* t = reinterpret_cast<uint8_t*>(rgba.data());
-            auto const* s = param.bitmap.data();
-            auto const* const e = param.bitmap.data() + param.bitmap.size();
-            while (s != e)
-            {
-                *t++ = *s++; // red
-                *t++ = *s++; // green
-                *t++ = *s++; // blue
-                *t++ = 0xFF; // alpha
-            }
-            break;
-        }
-        case atlas::Format::RGBA:
-            rgba = QByteArray(reinterpret_cast<char const*>(param.bitmap.data()),
-                              static_cast<qsizetype>(param.bitmap.size()));
-            break;
-    }
-    // }}}
+    _boundAtlasTexture = texture;
+    _boundAtlasSize = _glyphAtlas->textureSize();
 
-    // Sub-image upload at the tile's atlas location. Row alignment is 1 byte (RGBA, tightly packed), which
-    // QRhi's tightly-packed byte-data path assumes; this mirrors the former
-    // glPixelStorei(UNPACK_ALIGNMENT,1).
-    QRhiTextureSubresourceUploadDescription desc(rgba.constData(), static_cast<quint32>(rgba.size()));
-    desc.setSourceSize(QSize(tileWidth, tileHeight));
-    desc.setDestinationTopLeft(QPoint(param.location.x.value, param.location.y.value));
-    updates.uploadTexture(_atlasTexture.get(),
-                          QRhiTextureUploadDescription(QRhiTextureUploadEntry(0, 0, desc)));
+    // Rebind EVERY atlas-sampling pipeline so none is left holding a reference to the released texture.
+    // Each rebinds against its OWN uniform buffer (the screenshot pipeline owns one so its offscreen
+    // pass can use an item-local transform). Listed here as the single place that enumerates the
+    // atlas-sampling set — add a future one here and both build and rebind stay correct.
+    for (RhiPipeline* pipeline: { &_textPipeline, &_screenshotTextPipeline })
+        rebindAtlasTexture(*pipeline, pipeline->uniformBuffer.get());
 }
 
 namespace
@@ -1299,34 +1211,7 @@ void RhiRenderer::clearNodeScissorRect() noexcept
 
 optional<vtrasterizer::AtlasTextureScreenshot> RhiRenderer::readAtlas()
 {
-    // Atlas readback is deferred: a readBackTexture() scheduled into a frame's resource batch only completes
-    // after the command buffer for that frame is submitted (past the end of the render pass). We therefore
-    // request a capture on the next execute() and hand back whatever the most recently completed capture
-    // produced. The first call (before any frame has captured) returns a correctly-sized zero buffer.
-    _atlasReadbackRequested = true;
-
-    // Aggregate-initialized rather than default-constructed + assigned: atlas::Format has no zero
-    // enumerator, so value-initializing the struct would leave `format` holding an invalid value.
-    auto output = vtrasterizer::AtlasTextureScreenshot {
-        .atlasInstanceId = 0, .size = _atlasTextureSize, .format = _atlasProperties.format, .buffer = {}
-    };
-
-    auto const expectedBytes =
-        static_cast<size_t>(_atlasTextureSize.area()) * elementCount(_atlasProperties.format);
-
-    if (!_atlasReadbackResult.data.isEmpty()
-        && _atlasReadbackResult.pixelSize
-               == QSize(unbox<int>(_atlasTextureSize.width), unbox<int>(_atlasTextureSize.height)))
-    {
-        auto const* bytes = reinterpret_cast<uint8_t const*>(_atlasReadbackResult.data.constData());
-        output.buffer.assign(bytes,
-                             bytes + std::min<size_t>(expectedBytes, _atlasReadbackResult.data.size()));
-        output.buffer.resize(expectedBytes);
-    }
-    else
-        output.buffer.resize(expectedBytes);
-
-    return { std::move(output) };
+    return _glyphAtlas->readAtlas();
 }
 
 void RhiRenderer::scheduleScreenshot(ScreenshotCallback callback)
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <contour/display/RhiGlyphAtlas.hpp>
+#include <contour/display/RhiResource.hpp>
 #include <contour/display/ScissorRect.hpp>
 #include <contour/display/ShaderConfig.hpp>
 
@@ -11,6 +13,7 @@
 #include <vtrasterizer/TextureAtlas.hpp>
 
 #include <crispy/StrongHash.hpp>
+#include <crispy/TraceEvents.hpp>
 
 #include <QtCore/QVarLengthArray>
 #include <QtGui/QMatrix4x4>
@@ -25,23 +28,6 @@
 namespace contour::display
 {
 
-/// Deleter that destroys a QRhi resource through its virtual destructor.
-///
-/// QRhi factory methods (QRhi::newBuffer, newTexture, ...) hand back ownership as a raw pointer; the
-/// resource is released with @c delete (which routes through QRhiResource's virtual destructor and frees
-/// the backing GPU object). Wrapping the pointers in std::unique_ptr with this deleter keeps the renderer's
-/// resource ownership explicit and exception-safe without a manual teardown list.
-struct QRhiResourceDeleter
-{
-    /// Deletes the owned QRhi resource.
-    /// @param resource The QRhi resource to delete (may be nullptr).
-    void operator()(QRhiResource* resource) const noexcept { delete resource; }
-};
-
-/// Owning smart pointer for a QRhi resource of type @p T.
-template <typename T>
-using QRhiResourcePtr = std::unique_ptr<T, QRhiResourceDeleter>;
-
 /// Holds the GPU pipeline state for one draw pass (background-rect or text-glyph).
 ///
 /// Each pass owns its graphics pipeline, the shader-resource-binding set it was built against, the
@@ -78,8 +64,15 @@ class RhiRenderer final:
     /**
      * @param targetSurfaceSize Initial render target size in pixels (the size that can be rendered to).
      * @param textureTileSize   Size in pixels for each tile. This should be the grid cell size.
+     * @param window            The window whose scene graph draws this renderer, or nullptr if there is
+     *                          none. Renderers of one window share their glyph atlas texture.
+     * @param traceRecorder     Where the GPU stages are traced, or nullptr when nothing is; must outlive
+     *                          the renderer, or be replaced through setTraceRecorder() first.
      */
-    RhiRenderer(vtbackend::ImageSize targetSurfaceSize, vtbackend::ImageSize textureTileSize);
+    RhiRenderer(vtbackend::ImageSize targetSurfaceSize,
+                vtbackend::ImageSize textureTileSize,
+                QQuickWindow const* window,
+                crispy::trace::Recorder* traceRecorder);
 
     ~RhiRenderer() override;
 
@@ -88,9 +81,10 @@ class RhiRenderer final:
     ///
     /// Invoked from the render node's prepare() once the QRhi and the frame's render-pass descriptor are
     /// known. The pipelines bake in the render-pass descriptor and the vertex-input/blend state, so they
-    /// must be rebuilt whenever the render target's pass layout changes. The atlas texture and sampler are
-    /// created here too (so the text pass's bindings can reference them) but the atlas pixel data is
-    /// (re)uploaded lazily via the scheduled-execution path.
+    /// must be rebuilt whenever the render target's pass layout changes. The atlas texture (unless another
+    /// renderer of the window created it already) and sampler are created here too (so the text pass's
+    /// bindings can reference them) but the atlas pixel data is (re)uploaded lazily via the
+    /// scheduled-execution path.
     /// @param rhi    The scene graph's RHI instance (non-owning; valid for the lifetime of the frame).
     /// @param rpDesc The render-pass descriptor of the current render target (non-owning).
     void createPipelines(QRhi* rhi, QRhiRenderPassDescriptor* rpDesc);
@@ -164,9 +158,18 @@ class RhiRenderer final:
     void setRenderSize(vtbackend::ImageSize targetSurfaceSize) override;
     [[nodiscard]] vtbackend::ImageSize renderSize() const noexcept override { return _renderTargetSize; }
     void setModelMatrix(QMatrix4x4 const& matrix) noexcept;
+
+    /// Traces the GPU stages that follow into @p traceRecorder, or into nothing if it is nullptr.
+    /// Called with the render thread idle.
+    void setTraceRecorder(crispy::trace::Recorder* traceRecorder) noexcept { _traceRecorder = traceRecorder; }
+
     void setMargin(vtrasterizer::PageMargin margin) noexcept override;
     std::optional<AtlasTextureScreenshot> readAtlas() override;
     AtlasBackend& textureScheduler() override;
+    [[nodiscard]] void const* graphicsContext() const noexcept override;
+    [[nodiscard]] std::shared_ptr<vtrasterizer::atlas::AtlasBackend> createSharedAtlasBackend() override;
+    [[nodiscard]] bool useSharedAtlasBackend(
+        std::shared_ptr<vtrasterizer::atlas::AtlasBackend> const& backend) override;
     void scheduleScreenshot(ScreenshotCallback callback) override;
     void renderRectangle(int x, int y, Width, Height, RGBAColor color) override;
     void setScissorRect(int x, int y, int width, int height) override;
@@ -313,17 +316,11 @@ class RhiRenderer final:
     [[nodiscard]] QVarLengthArray<QRhiShaderResourceBinding, 2> atlasSrbBindings(QRhiBuffer* uniformBuffer,
                                                                                  bool hasSampler) const;
 
-    /// Creates (or re-creates) the glyph atlas texture and its sampler for the given size.
-    /// @param rhi  The scene graph's RHI instance.
-    /// @param size The atlas texture size in pixels (power of two).
-    void createAtlasTexture(QRhi* rhi, ImageSize size);
-
-    /// Re-points a text pipeline's shader-resource bindings (binding 1) at the current _atlasTexture.
+    /// Re-points a text pipeline's shader-resource bindings (binding 1) at _boundAtlasTexture.
     ///
     /// Every SRB that samples the glyph atlas holds a reference to a specific QRhiTexture object; when
-    /// createAtlasTexture() replaces _atlasTexture (destroying the old one), every such SRB must be rebound
-    /// or it samples a freed texture. executeConfigureAtlas() calls this for each atlas-sampling pipeline
-    /// after a recreate.
+    /// the glyph atlas replaces its texture (releasing the old one), every such SRB must be rebound or it
+    /// samples a freed texture. bindGlyphAtlas() calls this for each atlas-sampling pipeline.
     /// @param pipeline      The pipeline whose srb references the atlas (no-op if it has no srb).
     /// @param uniformBuffer The uniform buffer bound at slot 0. The screenshot pipelines share the
     ///                      swapchain pipeline's buffer (their own uniformBuffer field is null), so it is
@@ -406,8 +403,9 @@ class RhiRenderer final:
                             QMatrix4x4 const& mvp,
                             float timeValue);
 
-    void executeConfigureAtlas(ConfigureAtlas const& param);
-    void executeUploadTile(QRhiResourceUpdateBatch& updates, UploadTile const& param);
+    /// Rebinds every atlas-sampling pipeline if the glyph atlas' texture is no longer the one they sample:
+    /// another renderer sharing the atlas, or this one, has rebuilt it since.
+    void bindGlyphAtlas();
 
     /// One run of quads sampling a single image texture.
     ///
@@ -469,8 +467,6 @@ class RhiRenderer final:
 
     struct Scheduler
     {
-        std::optional<vtrasterizer::atlas::ConfigureAtlas> configureAtlas = std::nullopt;
-        std::vector<vtrasterizer::atlas::UploadTile> uploadTiles {};
         RenderBatch renderBatch {};
         std::vector<vtrasterizer::atlas::CreateImageTexture> imageCreates {};
         std::vector<vtrasterizer::atlas::DestroyImageTexture> imageDestroys {};
@@ -482,8 +478,6 @@ class RhiRenderer final:
 
         void clear()
         {
-            configureAtlas.reset();
-            uploadTiles.clear();
             renderBatch.clear();
             imageCreates.clear();
             imageDestroys.clear();
@@ -497,6 +491,7 @@ class RhiRenderer final:
 
     bool _initialized = false;
     std::chrono::steady_clock::time_point _startTime;
+    crispy::trace::Recorder* _traceRecorder;
     vtbackend::ImageSize _renderTargetSize;
     /// The scene graph's item-local→clip transform (projection * node matrix), set per frame from
     /// QSGRenderNode::RenderState; subsumes the former separate view (item translation) matrix.
@@ -611,28 +606,21 @@ class RhiRenderer final:
     RhiPipeline _rectPipeline; ///< Background/filled-rect pass.
     RhiPipeline _textPipeline; ///< Text/glyph pass (samples the atlas).
 
-    // The glyph atlas texture (RGBA8) and the sampler used by the text pass. Both are referenced by the
-    // text pipeline's shader-resource-bindings. The texture is re-created on configureAtlas when the atlas
-    // size changes.
-    QRhiResourcePtr<QRhiTexture> _atlasTexture;
-    QRhiResourcePtr<QRhiSampler> _atlasSampler;
-    ImageSize _atlasTextureSize {};
+    // The glyph atlas this renderer's text pass samples: the one shared by the renderers of its window, or
+    // a private one until the rasterizer hands it that (useSharedAtlasBackend()).
+    std::shared_ptr<RhiGlyphAtlas> _glyphAtlas;
 
-    // The pixel size the live atlas QRhiTexture was actually created at. Distinct from _atlasTextureSize,
-    // which configureAtlas() overwrites with the requested size *before* execute() runs, so it cannot tell
-    // executeConfigureAtlas() whether the GPU texture must be recreated. This tracks the real GPU extent so
-    // a repeated ConfigureAtlas of the same size reuses the existing texture instead of recreating it.
-    ImageSize _atlasCreatedSize {};
+    // The atlas texture the text pipelines' shader-resource bindings name, and its size. Trails the glyph
+    // atlas' own texture until bindGlyphAtlas() catches up, which execute() does before staging any text.
+    QRhiTexture* _boundAtlasTexture = nullptr;
+    ImageSize _boundAtlasSize {};
 
-    vtrasterizer::atlas::AtlasProperties _atlasProperties {};
+    // The sampler used by the text pass and by every image. Created once and reused across atlas rebuilds.
+    QRhiResourcePtr<QRhiSampler> _atlasSampler;
     // }}}
 
-    // Deferred atlas readback (debug "dump state" / inspector). A readback scheduled into a frame's resource
-    // batch only completes once the command buffer is submitted (after the render pass ends), so the result
-    // lands one frame later. readAtlas() requests a capture on the next frame and returns the most recently
-    // captured pixels; the first call returns zeros until a frame has completed. Non-blocking by design.
-    bool _atlasReadbackRequested = false;
-    QRhiReadbackResult _atlasReadbackResult;
+    /// The window this renderer draws into, identifying the graphics context. Never dereferenced.
+    QQuickWindow const* _window;
 
     // CPU-side interleaved vertex buffer for the filled-rect (background) pass, populated by
     // renderRectangle() and uploaded/drawn in execute().
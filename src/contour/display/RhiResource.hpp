@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <memory>
+
+#include <rhi/qrhi.h>
+
+namespace contour::display
+{
+
+/// Deleter that destroys a QRhi resource through its virtual destructor.
+///
+/// QRhi factory methods (QRhi::newBuffer, newTexture, ...) hand back ownership as a raw pointer; the
+/// resource is released with @c delete (which routes through QRhiResource's virtual destructor and frees
+/// the backing GPU object). Wrapping the pointers in std::unique_ptr with this deleter keeps the renderer's
+/// resource ownership explicit and exception-safe without a manual teardown list.
+struct QRhiResourceDeleter
+{
+    /// Deletes the owned QRhi resource.
+    /// @param resource The QRhi resource to delete (may be nullptr).
+    void operator()(QRhiResource* resource) const noexcept { delete resource; }
+};
+
+/// Owning smart pointer for a QRhi resource of type @p T.
+template <typename T>
+using QRhiResourcePtr = std::unique_ptr<T, QRhiResourceDeleter>;
+
+} // namespace contour::display
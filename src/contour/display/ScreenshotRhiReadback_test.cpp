@@ -241,7 +241,8 @@ TEST_CASE("RHI readback: a captured screenshot is delivered top-left origin, not
         SKIP("could not create a texture render target");
 
     auto const captureSize = ImageSize { Width(W), Height(H) };
-    auto renderer = contour::display::RhiRenderer(captureSize, ImageSize { Width(4), Height(4) });
+    auto renderer = contour::display::RhiRenderer(
+        captureSize, ImageSize { Width(4), Height(4) }, /*window=*/nullptr, /*traceRecorder=*/nullptr);
     renderer.initialize();
     renderer.createPipelines(rhi, frameTarget.rpDesc.get());
     if (!renderer.pipelinesReady())
@@ -332,7 +333,9 @@ std::vector<uint8_t> renderTileScaled(QRhi* rhi,
     constexpr int AtlasExtent = 16; // power of two: executeConfigureAtlas requires it
 
     auto renderer = RhiRenderer(ImageSize { Width(targetWidth), Height(targetHeight) },
-                                ImageSize { Width(TileExtent), Height(TileExtent) });
+                                ImageSize { Width(TileExtent), Height(TileExtent) },
+                                /*window=*/nullptr,
+                                /*traceRecorder=*/nullptr);
     renderer.initialize();
     renderer.createPipelines(rhi, target.rpDesc.get());
     if (!renderer.pipelinesReady())
@@ -190,7 +190,8 @@ QString TerminalAccessible::text(QAccessible::Text which) const
     {
         case QAccessible::Name: return item->session().title();
         case QAccessible::Value: {
-            auto const lock = std::lock_guard { item->terminal() };
+            auto const lock =
+                vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
             auto const& screen = item->terminal().currentScreen();
             return QString::fromStdString(screen.lineTextAt(screen.cursor().position.line));
         }
@@ -260,7 +261,7 @@ int TerminalAccessible::characterCount() const
     if (item == nullptr || !item->hasSession())
         return 0;
 
-    auto const lock = std::lock_guard { item->terminal() };
+    auto const lock = vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
     return flatTextLength(item->terminal().pageSize());
 }
 
@@ -270,7 +271,7 @@ int TerminalAccessible::cursorPosition() const
     if (item == nullptr || !item->hasSession())
         return 0;
 
-    auto const lock = std::lock_guard { item->terminal() };
+    auto const lock = vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
     auto const& terminal = item->terminal();
     if (!terminal.isCursorInViewport())
         return 0;
@@ -292,7 +293,8 @@ QRect TerminalAccessible::characterRect(int offset) const
 
     auto const metrics = item->gridMetrics();
     auto const columns = [&] {
-        auto const lock = std::lock_guard { item->terminal() };
+        auto const lock =
+            vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
         return item->terminal().pageSize().columns;
     }();
 
@@ -309,7 +311,7 @@ QString TerminalAccessible::text(int startOffset, int endOffset) const
     if (item == nullptr || !item->hasSession()) // terminal() asserts a session; check before touching it
         return {};
 
-    auto const lock = std::lock_guard { item->terminal() };
+    auto const lock = vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
     auto const& terminal = item->terminal();
     auto const pageSize = terminal.pageSize();
     auto const columns = pageSize.columns;
@@ -370,7 +372,7 @@ int TerminalAccessible::offsetAtPoint(QPoint const& point) const
     if (column < 0 || line < 0)
         return -1;
 
-    auto const lock = std::lock_guard { item->terminal() };
+    auto const lock = vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
     auto const pageSize = item->terminal().pageSize();
     if (column >= unbox<int>(pageSize.columns) || line >= unbox<int>(pageSize.lines))
         return -1;
@@ -441,7 +443,8 @@ void TerminalAccessible::reportCaret()
     // ONE pass under the lock, yielding the state the gate judges and the caret's flat offset. Asking
     // cursorPosition() for the latter afterwards would take the lock a second time for a value in hand.
     auto const [current, caretOffset] = [&] {
-        auto const lock = std::lock_guard { item->terminal() };
+        auto const lock =
+            vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
         auto const& terminal = item->terminal();
 
         // BLINK-FREE deliberately: cursorCurrentlyVisible() folds in the blink phase, and following that
@@ -532,7 +535,8 @@ QRect PromptAccessible::rect() const
     // One lock for both reads: taking it twice gave the grid a window to be resized between the span
     // and the width it is measured against.
     auto const [span, columns] = [&] {
-        auto const lock = std::lock_guard { item->terminal() };
+        auto const lock =
+            vtbackend::Terminal::SiteLock { item->terminal(), vtbackend::LockSite::Accessibility };
         return std::pair { item->terminal().livePromptSpan(), item->terminal().pageSize().columns };
     }();
     if (!span.has_value())
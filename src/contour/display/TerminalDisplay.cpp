@@ -24,6 +24,7 @@
 #include <crispy/App.hpp>
 #include <crispy/LogStore.hpp>
 #include <crispy/ScopedTimer.hpp>
+#include <crispy/TraceEvents.hpp>
 #include <crispy/Utils.hpp>
 
 #include <QtCore/QDebug>
@@ -228,6 +229,14 @@ void TerminalDisplay::assignSession(session::TerminalSession* newSession)
 {
     fenceRenderThread();
     _session = newSession;
+
+    // Each session traces into its own recorder, so whatever this display draws next is traced for
+    // the session it now shows.
+    auto* const traceRecorder = newSession ? &newSession->traceRecorder() : nullptr;
+    if (_renderer)
+        _renderer->setTraceRecorder(traceRecorder);
+    if (_renderTarget)
+        _renderTarget->setTraceRecorder(traceRecorder);
 }
 
 void TerminalDisplay::setSession(session::TerminalSession* newSession)
@@ -338,6 +347,8 @@ void TerminalDisplay::setSession(session::TerminalSession* newSession)
             _session->config().renderer.value().textureAtlasDirectMapping,
             // The composition root picks the locator engine; the renderer just uses what it is given.
             vtrasterizer::createFontLocator(profile().fonts.value().fontLocator),
+            _session->app().textCaches(),
+            &_session->traceRecorder(),
             _session->profile().hyperlinkDecoration.value().normal,
             _session->profile().hyperlinkDecoration.value().hover,
             _session->config().textScalingMethod.value());
@@ -492,6 +503,12 @@ void TerminalDisplay::handleWindowChanged(QQuickWindow* newWindow)
                 &TerminalDisplay::onBeforeSynchronize,
                 Qt::DirectConnection);
 
+        connect(newWindow,
+                &QQuickWindow::afterFrameEnd,
+                this,
+                &TerminalDisplay::onAfterFrameEnd,
+                Qt::DirectConnection);
+
         connect(newWindow,
                 &QQuickWindow::sceneGraphInvalidated,
                 this,
@@ -786,6 +803,19 @@ void TerminalDisplay::logRhiBackendInfoOnce()
     }
 }
 
+void TerminalDisplay::onAfterFrameEnd()
+{
+    // Render thread, once the window's frame has been submitted for presentation: the closest this
+    // process gets to the photons. Only the latency probe cares.
+    if (!_session || !terminal().latencyProbe().framePresented(_frameRenderStartedAt))
+        return;
+
+    post([this]() {
+        if (_session)
+            _session->latencySampled();
+    });
+}
+
 void TerminalDisplay::onBeforeSynchronize()
 {
     // Reached on the render thread during the sync phase. Closing a split pane unparents this item from the
@@ -923,7 +953,11 @@ void TerminalDisplay::createRenderer()
         _renderer->reserveAtlasForPage(fit.pageSize);
     }
 
-    _renderTarget = std::make_unique<RhiRenderer>(precalculatedTargetSize, textureTileSize);
+    // createRenderer() runs on the render thread (sync phase), so this names the thread every frame
+    // of this window is traced on; renaming it for a later pane of the same window is harmless.
+    crispy::trace::setThreadName("render");
+    _renderTarget = std::make_unique<RhiRenderer>(
+        precalculatedTargetSize, textureTileSize, window(), &_session->traceRecorder());
     _renderer->setRenderTarget(*_renderTarget);
 
     // The terminal no longer paints from the window's beforeRendering/afterRendering signals (which fired
@@ -1124,6 +1158,7 @@ void TerminalDisplay::paint()
 
         terminal().tick(steady_clock::now());
 
+        _frameRenderStartedAt = steady_clock::now();
         auto const fontReconfigApplied = _renderer->render(terminal(), _renderingPressure);
 
         // The lazily-applied font/DPI change made the cell size current only now; re-derive page size
@@ -1456,7 +1491,7 @@ QVariant TerminalDisplay::inputMethodQuery(Qt::InputMethodQuery query) const
             // One locked GridMetrics copy, for this case only: it yields the cell size AND the page
             // margin tear-free, where two separate reads could straddle a concurrent font apply.
             auto const metrics = _renderer->gridMetrics();
-            auto const lock = std::lock_guard { term };
+            auto const lock = vtbackend::Terminal::SiteLock { term, vtbackend::LockSite::Query };
             auto const& screen = term.currentScreen();
             auto const cursor = screen.cursor().position;
             if (term.isCursorInViewport() && imeCursorAddressable(cursor, term.pageSize()))
@@ -1470,14 +1505,14 @@ QVariant TerminalDisplay::inputMethodQuery(Qt::InputMethodQuery query) const
         case Qt::ImCursorPosition: {
             // Qt contract: the cursor's CHARACTER index within ImSurroundingText (the current
             // line), i.e. the grid column — not a pixel offset.
-            auto const lock = std::lock_guard { term };
+            auto const lock = vtbackend::Terminal::SiteLock { term, vtbackend::LockSite::Query };
             if (term.isCursorInViewport())
                 return unbox<int>(term.currentScreen().cursor().position.column);
             return 0;
         }
         case Qt::ImSurroundingText: {
             // return the text from the current line
-            auto const lock = std::lock_guard { term };
+            auto const lock = vtbackend::Terminal::SiteLock { term, vtbackend::LockSite::Query };
             auto const& screen = term.currentScreen();
             auto const cursor = screen.cursor().position;
             if (term.isCursorInViewport() && imeCursorAddressable(cursor, term.pageSize()))
@@ -1836,6 +1871,16 @@ void TerminalDisplay::doDumpStateInternal()
         fs.close();
     }
 
+#if defined(CONTOUR_PERF_STATS)
+    {
+        // Who has been holding the terminal lock, and who waited for it, since the session started.
+        auto const lockStats = terminal().lockStats().summary();
+        std::cout << lockStats;
+        auto fs = ofstream { (targetDir / "lock-stats.txt").string(), ios::trunc };
+        fs << lockStats;
+    }
+#endif
+
     enum class ImageBufferFormat : uint8_t
     {
         RGBA,
@@ -352,6 +352,7 @@ class TerminalDisplay: public QQuickItem, public session::DisplaySurface
     void onAutoScrollTick();
     void onSceneGrapheInitialized();
     void onBeforeSynchronize();
+    void onAfterFrameEnd();
 
     void handleWindowChanged(QQuickWindow* newWindow);
     void cleanup();
@@ -543,6 +544,9 @@ class TerminalDisplay: public QQuickItem, public session::DisplaySurface
     /// split pane is destroyed session-less), which a _session-routed call could not reach.
     session::TerminalSessionManager* _manager = nullptr;
     std::chrono::steady_clock::time_point _startTime;
+    /// When paint() last started rendering (render thread only): a frame only shows a keystroke's
+    /// echo if it began after the render buffer holding it was swapped in. @see onAfterFrameEnd().
+    std::chrono::steady_clock::time_point _frameRenderStartedAt {};
     text::DPI _lastFontDPI {};
     /// The app-wide forced-font-DPI provider (see ContentScale.h), injected in setSession(). Null until
     /// then (and in tests): contentScale() falls back to the window DPR.
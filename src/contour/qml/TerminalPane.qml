@@ -208,6 +208,27 @@ ContourTerminal {
         z: 10
     }
 
+    // Keypress-to-present latency per stage, while the ToggleLatencyProbe action has the probe on.
+    Rectangle {
+        objectName: "latencyOverlay"
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.margins: 8
+        width: latencyText.contentWidth + 12
+        height: latencyText.contentHeight + 8
+        color: "#cc000000"
+        radius: 3
+        z: 15
+        visible: pane.session ? pane.session.latencyReport !== "" : false
+        Text {
+            id: latencyText
+            anchors.centerIn: parent
+            color: "white"
+            font.family: "monospace"
+            text: pane.session ? pane.session.latencyReport : ""
+        }
+    }
+
     TapHandler {
         onTapped: pane.activated()
     }
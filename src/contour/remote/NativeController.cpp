@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <ranges>
 #include <utility>
+#include <variant>
 
 #include <net/Sockets.hpp>
+#include <net/WithTimeout.hpp>
 
 namespace contour::remote
 {
@@ -22,8 +24,11 @@ namespace
 } // namespace
 
 NativeController::NativeController(vthost::AttachEndpoint endpoint,
-                                   std::optional<vtbackend::Settings> sessionSettings):
-    _endpoint(std::move(endpoint)), _sessionSettings(std::move(sessionSettings))
+                                   std::optional<vtbackend::Settings> sessionSettings,
+                                   vthost::client::PredictiveEchoMode predictiveEcho):
+    _endpoint(std::move(endpoint)),
+    _sessionSettings(std::move(sessionSettings)),
+    _predictiveEcho(predictiveEcho)
 {
 }
 
@@ -37,7 +42,6 @@ NativeController::~NativeController()
 
 coro::Task<void> NativeController::runClient(net::EventLoop* loop)
 {
-    auto const token = vthost::endpointToken(_endpoint);
     auto socket = co_await vthost::connectAttach(loop, _endpoint);
     if (!socket)
     {
@@ -51,16 +55,46 @@ coro::Task<void> NativeController::runClient(net::EventLoop* loop)
         co_return;
     }
 
+    // A lost connection keeps every binding and mirror; only this loop ending closes them, through
+    // connectionClosed (the GUI then stops the controller, which closes the ptys).
+    auto end = co_await serve(loop, std::move(*socket));
+    auto giveUpAt = net::SteadyTimePoint {};
+    while (end != ConnectionEnd::Ended)
+    {
+        // A redial that never got an answer is still the same outage, and keeps its deadline.
+        if (end == ConnectionEnd::Lost)
+            giveUpAt = loop->clock().now() + ReconnectWindow;
+        auto next = co_await redial(loop, giveUpAt);
+        if (!next)
+            break;
+        end = co_await serve(loop, std::move(next));
+    }
+    _carried = {};
+
+    {
+        auto const lock = std::lock_guard { _mutex };
+        if (_state == State::Connecting || _state == State::Ready)
+            _state = State::Closed;
+    }
+    _connected.notify_all();
+    emit connectionClosed();
+}
+
+coro::Task<NativeController::ConnectionEnd> NativeController::serve(net::EventLoop* loop,
+                                                                    std::unique_ptr<net::ISocket> socket)
+{
     auto client = NativeClient {
         *loop,
-        std::move(*socket),
+        std::move(socket),
         NativeClient::HandshakeOptions {
-            .token = token,
+            .token = vthost::endpointToken(_endpoint),
             // Stated once, at the handshake: the daemon applies it to the sessions THIS connection
             // goes on to create, and to nothing that already exists.
             .sessionSettings = _sessionSettings
                                    ? std::optional { vthost::toWireSessionSettings(*_sessionSettings) }
                                    : std::nullopt,
+            // The segment is passed over the socket, which only the daemon's own host can do.
+            .sharedMemory = std::holds_alternative<vthost::UnixEndpoint>(_endpoint),
         },
         NativeClient::UpdateHandler { [this](RemoteScreen const& screen, vthost::proto::Delta const& delta) {
             onUpdate(screen, delta);
@@ -73,6 +107,8 @@ coro::Task<void> NativeController::runClient(net::EventLoop* loop)
             } },
         NativeClient::LayoutHandler { [this](vthost::proto::LayoutState const& layout) { onLayout(layout); } }
     };
+    auto const resuming = _carried.instance != 0;
+    client.resumeFrom(std::exchange(_carried, {}));
     {
         auto const lock = std::lock_guard { _mutex };
         _client = &client;
@@ -85,6 +121,19 @@ coro::Task<void> NativeController::runClient(net::EventLoop* loop)
         _client = nullptr;
     } };
 
+    if (resuming)
+    {
+        // Whatever was reported went to the previous connection, and a report made during the gap
+        // went nowhere: re-assert the client area and every pane grid on this one.
+        {
+            auto const lock = std::lock_guard { _geometryMutex };
+            _lastReportedArea.reset();
+            _lastReportedPaneSizes.clear();
+        }
+        QMetaObject::invokeMethod(this, [this] { flushGeometry(); }, Qt::QueuedConnection);
+    }
+
+    auto cancelled = false;
     try
     {
         co_await client.run();
@@ -94,24 +143,59 @@ coro::Task<void> NativeController::runClient(net::EventLoop* loop)
         // stop() cancelled the loop mid-serve; fall through to the normal
         // bookkeeping so state and observers still see the closure.
         attachLog()("Attach serve loop cancelled by stop().");
+        cancelled = true;
     }
 
+    // _client is cleared by `forgetClient` above, on this path and on every other.
+    auto const lock = std::lock_guard { _mutex };
+    if (client.versionMismatch())
     {
-        // _client is cleared by `forgetClient` above, on this path and on every other.
-        auto const lock = std::lock_guard { _mutex };
         if (_state == State::Connecting || _state == State::Ready)
         {
-            if (client.versionMismatch())
-            {
-                _state = State::Failed;
-                _failure = "daemon speaks an incompatible protocol version";
-            }
-            else
-                _state = State::Closed;
+            _state = State::Failed;
+            _failure = "daemon speaks an incompatible protocol version";
         }
+        co_return ConnectionEnd::Ended;
     }
-    _connected.notify_all();
-    emit connectionClosed();
+    // Only an attach that completed has panes worth keeping; one that never got that far fails the
+    // connect as it always did. A restarted daemon's sessions are not the ones these panes show.
+    if (cancelled || _stopped || _state != State::Ready || client.daemonRestarted())
+        co_return ConnectionEnd::Ended;
+    if (!client.connected())
+    {
+        _carried = client.takeResumeState();
+        co_return ConnectionEnd::Unanswered;
+    }
+    attachLog()("Lost the connection to the daemon; reconnecting to resume {} sessions.",
+                client.screens().size());
+    _carried = client.takeResumeState();
+    co_return ConnectionEnd::Lost;
+}
+
+coro::Task<std::unique_ptr<net::ISocket>> NativeController::redial(net::EventLoop* loop,
+                                                                   net::SteadyTimePoint giveUpAt)
+{
+    auto backoff = FirstRedialDelay;
+    try
+    {
+        while (loop->clock().now() < giveUpAt)
+        {
+            co_await loop->delay(backoff);
+            backoff = std::min(backoff * 2, MaxRedialDelay);
+            auto socket =
+                co_await net::withTimeout(loop, vthost::connectAttach(loop, _endpoint), RedialTimeout);
+            if (socket && *socket)
+                co_return std::move(**socket);
+            attachLog()("Reconnecting to the daemon failed: {}", socket ? socket->error() : "timed out");
+        }
+    }
+    catch (coro::OperationCancelled const&)
+    {
+        attachLog()("Reconnecting cancelled by stop().");
+        co_return nullptr;
+    }
+    attachLog()("Gave up reconnecting to the daemon after {}s.", ReconnectWindow.count());
+    co_return nullptr;
 }
 
 void NativeController::onUpdate(RemoteScreen const& screen, vthost::proto::Delta const& delta)
@@ -125,8 +209,21 @@ void NativeController::onUpdate(RemoteScreen const& screen, vthost::proto::Delta
     {
         // The mirror is absent only in the window between createPty() and bindTerminal(); the
         // priming replay in bindTerminal() picks the session up from whatever arrived meanwhile.
+        // Until then the client's copy of the history is the only one, so it is kept.
         if (binding->second.mirror)
+        {
             binding->second.mirror->apply(screen, delta);
+            binding->second.mirror->terminal().latencyProbe().mark(vtbackend::LatencyStage::DeltaReceived);
+            if (auto& echo = binding->second.echo)
+            {
+                // Before the history is released: restoring a row a withdrawn prediction drew on
+                // may need one this update scrolled off the page.
+                echo->reconcile(screen, std::chrono::steady_clock::now());
+                binding->second.mirror->applyOverlay(screen, echo->overlay());
+            }
+            // The mirror terminal's own scrollback now holds these rows.
+            _client->releaseHistory(screen.session);
+        }
         return;
     }
     if (_closedSessions.contains(screen.session))
@@ -408,10 +505,11 @@ std::optional<vtpty::PageSize> NativeController::composedClientArea() const
 
 void NativeController::primeBinding(uint64_t session)
 {
-    if (_client == nullptr)
-        return;
-    auto const screen = _client->screens().find(session);
-    if (screen == _client->screens().end())
+    // A pane realized while the connection is down primes from the mirrors waiting for the next one;
+    // resumed, that session is sent only what changed, so the rest has to be on the grid already.
+    auto const& screens = _client != nullptr ? _client->screens() : _carried.screens;
+    auto const screen = screens.find(session);
+    if (screen == screens.end())
         return;
 
     auto const lock = std::lock_guard { _mutex };
@@ -421,6 +519,10 @@ void NativeController::primeBinding(uint64_t session)
     // Discard: this pane's mirror terminal is brand new, so there is no local
     // scrollback of its own to preserve.
     binding->second.mirror->fullReplay(screen->second, vthost::client::LocalHistory::Discard);
+    // Between connections the rows stay with the carried mirror; the first update after the resume
+    // releases them (onUpdate).
+    if (_client != nullptr)
+        _client->releaseHistory(session);
 }
 
 void NativeController::bindTerminal(vtpty::Pty const* pty, vtbackend::Terminal& terminal)
@@ -435,6 +537,8 @@ void NativeController::bindTerminal(vtpty::Pty const* pty, vtbackend::Terminal&
         if (binding == _bindings.end())
             return;
         binding->second.mirror = std::make_unique<vthost::client::ScreenMirror>(terminal);
+        if (_predictiveEcho == vthost::client::PredictiveEchoMode::Enabled)
+            binding->second.echo.emplace();
     }
     // The daemon may already have described this session before its pane existed, so the priming
     // replay runs on the reactor (where _client lives) rather than reading it from here.
@@ -578,8 +682,22 @@ std::unique_ptr<vtpty::Pty> NativeController::createPty(std::optional<std::strin
         vtpty::PageSize { vtpty::LineCount(lines), vtpty::ColumnCount(columns) },
         [this, session](std::string_view bytes) {
             _reactor.post([this, session, copy = std::string { bytes }] {
-                if (_client != nullptr)
-                    _client->sendInput(session, copy);
+                if (_client == nullptr)
+                    return;
+                _client->sendInput(session, copy);
+                auto const lock = std::lock_guard { _mutex };
+                if (auto const binding = _bindings.find(session);
+                    binding != _bindings.end() && binding->second.mirror)
+                {
+                    auto& probe = binding->second.mirror->terminal().latencyProbe();
+                    probe.mark(vtbackend::LatencyStage::InputSent);
+                    auto const screen = _client->screens().find(session);
+                    if (auto& echo = binding->second.echo; echo && screen != _client->screens().end())
+                    {
+                        echo->predict(screen->second, copy, std::chrono::steady_clock::now());
+                        binding->second.mirror->applyOverlay(screen->second, echo->overlay());
+                    }
+                }
             });
         },
         // A pane's grid is NOT the client area: reporting it as one made the daemon project the
@@ -17,6 +17,12 @@
 /// nothing is lost to an escape-sequence round trip on the way. That needs the
 /// terminal, which does not exist when `createPty` hands out the pty, so
 /// `bindTerminal` closes the cycle and primes the mirror.
+///
+/// A connection lost after the attach completed (a VPN flap, a laptop waking on another network)
+/// does not end the panes. The controller keeps its bindings and their mirrors, redials the same
+/// endpoint, and hands the mirrors to the next `NativeClient` so the daemon resumes each session
+/// from where it stopped rather than snapshotting it again. Only a stop, a restarted daemon, or a
+/// daemon that stays unreachable for `ReconnectWindow` ends them.
 
 #include <contour/remote/ReactorThread.hpp>
 #include <contour/remote/RemoteController.hpp>
@@ -43,9 +49,12 @@
 #include <unordered_set>
 #include <vector>
 
+#include <net/ISocket.hpp>
+#include <net/platform/Clock.hpp>
 #include <vthost/Daemon.hpp>
 #include <vthost/client/LayoutReconstruction.hpp>
 #include <vthost/client/NativeClient.hpp>
+#include <vthost/client/PredictiveEcho.hpp>
 #include <vthost/client/ScreenMirror.hpp>
 #include <vtworkspace/Primitives.hpp>
 
@@ -63,12 +72,24 @@ class NativeController final: public QObject, public contour::session::SessionFa
     Q_OBJECT
 
   public:
+    /// How long a lost connection is redialed before its panes are given up.
+    static constexpr auto ReconnectWindow = std::chrono::seconds { 60 };
+    /// The pause before the first redial, doubled after each failed one up to MaxRedialDelay.
+    static constexpr auto FirstRedialDelay = std::chrono::milliseconds { 250 };
+    static constexpr auto MaxRedialDelay = std::chrono::milliseconds { 5000 };
+    /// How long one redial may take: a TCP connect into a dead route otherwise hangs for minutes.
+    static constexpr auto RedialTimeout = std::chrono::milliseconds { 10000 };
+
     /// @param endpoint How to reach the daemon: the local unix control socket, or
     ///        a TLS-encrypted, token-authenticated TCP endpoint.
     /// @param sessionSettings The emulation settings to ask the daemon for on the sessions this
     ///        client creates — this client's own resolved profile — or nullopt to take whatever the
     ///        daemon hosts with. Not defaulted, so a caller with no preference says so.
-    NativeController(vthost::AttachEndpoint endpoint, std::optional<vtbackend::Settings> sessionSettings);
+    /// @param predictiveEcho Whether panes show typing before the daemon echoes it
+    ///        (@see vthost::client::PredictiveEcho) — worth it over a slow link, and off otherwise.
+    NativeController(vthost::AttachEndpoint endpoint,
+                     std::optional<vtbackend::Settings> sessionSettings,
+                     vthost::client::PredictiveEchoMode predictiveEcho);
 
     /// Stops the reactor (detaching if still connected) and joins.
     ~NativeController() override;
@@ -243,11 +264,21 @@ class NativeController final: public QObject, public contour::session::SessionFa
     {
         vtpty::ChannelPty* pty = nullptr;
         std::unique_ptr<vthost::client::ScreenMirror> mirror;
+        /// Present with the mirror when predictive echo is on; drawn by it over every update.
+        std::optional<vthost::client::PredictiveEcho> echo;
+    };
+
+    /// How one connection of the attach ended.
+    enum class ConnectionEnd : uint8_t
+    {
+        Ended,      ///< For good: stopped, refused, or lost before the attach completed.
+        Lost,       ///< Dropped after the daemon answered; its mirrors wait in `_carried`.
+        Unanswered, ///< A redial dropped before the daemon answered; the mirrors are back in `_carried`.
     };
 
   protected:
-    /// The reactor's whole lifetime: connect, serve, notify. Takes the loop
-    /// by pointer (coroutine reference parameters can dangle).
+    /// The reactor's whole lifetime: connect, serve, redial whatever was lost, notify. Takes the
+    /// loop by pointer (coroutine reference parameters can dangle).
     [[nodiscard]] coro::Task<void> runClient(net::EventLoop* loop) override;
 
     // RemoteController hooks: the attach-specific half of the shared connect lifecycle.
@@ -267,6 +298,16 @@ class NativeController final: public QObject, public contour::session::SessionFa
     }
 
   private:
+    /// Reactor-side: runs one connection over @p socket, resuming the mirrors in `_carried`.
+    /// @return How it ended; unless `Ended`, the mirrors are back in `_carried` for the next one.
+    [[nodiscard]] coro::Task<ConnectionEnd> serve(net::EventLoop* loop, std::unique_ptr<net::ISocket> socket);
+
+    /// Reactor-side: dials the endpoint again, backing off between attempts, until one connects,
+    /// @p giveUpAt passes, or the controller stops.
+    /// @return The connected transport, or nullptr when the attach is over.
+    [[nodiscard]] coro::Task<std::unique_ptr<net::ISocket>> redial(net::EventLoop* loop,
+                                                                  net::SteadyTimePoint giveUpAt);
+
     /// Reactor-side: applies @p delta through the session's mirror (if bound).
     void onUpdate(vthost::client::RemoteScreen const& screen, vthost::proto::Delta const& delta);
 
@@ -283,7 +324,7 @@ class NativeController final: public QObject, public contour::session::SessionFa
     void onLayout(vthost::proto::LayoutState const& layout);
 
     /// Reactor-side: feeds a fresh binding its full replay if the session's
-    /// screen is already known.
+    /// screen is already known, from the live client or, between connections, from `_carried`.
     void primeBinding(uint64_t session);
 
     /// GUI-side (from a pane's pty resize sink, on whichever thread resized it): records the grid
@@ -328,6 +369,8 @@ class NativeController final: public QObject, public contour::session::SessionFa
     /// This client's profile, stated in the ClientHello and applied by the daemon to the sessions
     /// this connection creates. Fixed at construction: it is what the user launched with.
     std::optional<vtbackend::Settings> _sessionSettings;
+    /// Whether bound panes predict their echo. Fixed at construction.
+    vthost::client::PredictiveEchoMode _predictiveEcho;
     std::deque<PendingSession> _pending; ///< Discovered remote sessions without a local tab.
     std::unordered_map<uint64_t, Binding> _bindings;
     /// The daemon's latest tab/pane tree per window id (B2/B4). Ordered so windowIds()
@@ -345,9 +388,10 @@ class NativeController final: public QObject, public contour::session::SessionFa
     ///
     /// Never pruned, and that is sound rather than a leak: session ids are monotonic (never reused),
     /// so a lingering tombstone can never suppress a genuinely new session, the set is bounded by
-    /// this connection's lifetime at 8 bytes an entry, and a reattach is a fresh controller with an
-    /// empty set. The daemon's own removal notice arrives as a re-pushed `LayoutState`, which the
-    /// reconciler acts on structurally rather than per id (@see applyRemoteLayout).
+    /// this controller's lifetime at 8 bytes an entry, and a reattach is a fresh controller with an
+    /// empty set. A reconnect keeps it: the daemon, and so its ids, are the same. The daemon's own
+    /// removal notice arrives as a re-pushed `LayoutState`, which the reconciler acts on
+    /// structurally rather than per id (@see applyRemoteLayout).
     std::unordered_set<uint64_t> _closedSessions;
     /// Guards the geometry bookkeeping below, and ONLY that.
     ///
@@ -376,6 +420,9 @@ class NativeController final: public QObject, public contour::session::SessionFa
     std::optional<uint64_t> _geometryAnchor;
     bool _geometryFlushScheduled = false;            ///< A coalesced flush is already queued.
     vthost::client::NativeClient* _client = nullptr; ///< Reactor-owned; valid while serving.
+    /// Reactor-confined: the mirrors of a lost connection, until the next one adopts them. Input
+    /// typed in that gap has no connection to go out on and is dropped.
+    vthost::client::NativeClient::ResumeState _carried;
 };
 
 } // namespace contour::remote
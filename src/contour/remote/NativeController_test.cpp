@@ -22,6 +22,7 @@
 #include <thread>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #ifndef _WIN32
     #include <unistd.h>
@@ -65,6 +66,9 @@ struct DaemonFixture
     std::uint16_t port = 0; ///< The OS-assigned loopback port the daemon listens on.
     std::thread thread;
     bool cancelled = false; ///< Whether teardown unwound the accept loop.
+    /// Every connection accepted so far, for dropConnections(). Daemon-thread only; an entry is only
+    /// valid while its connection is served.
+    std::vector<net::ISocket*> connections;
 
     DaemonFixture()
     {
@@ -73,6 +77,8 @@ struct DaemonFixture
             [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
             vtbackend::Settings {},
             crispy::defaultEnvironment(),
+            /*metrics=*/nullptr,
+            /*traceFile=*/std::nullopt,
             /*startPumps=*/false);
         auto listener = net::listen(loop, "127.0.0.1", 0);
         REQUIRE(listener.has_value());
@@ -85,8 +91,11 @@ struct DaemonFixture
         REQUIRE(tls.has_value());
         auto native = vthost::makeNativeHandler(loop, *host);
         auto const& context = *tls;
-        auto handler = [context, native](vthost::ConnectionId id, std::unique_ptr<net::ISocket> socket) {
-            return native(std::move(id), context->wrap(std::move(socket)));
+        auto handler = [this, context, native](vthost::ConnectionId id,
+                                               std::unique_ptr<net::ISocket> socket) {
+            auto encrypted = context->wrap(std::move(socket));
+            connections.push_back(encrypted.get());
+            return native(std::move(id), std::move(encrypted));
         };
         server = std::make_unique<vthost::ConnectionAcceptor>(loop, "test", std::move(*listener), handler);
         thread = std::thread { [this] {
@@ -132,6 +141,16 @@ struct DaemonFixture
         return future.get();
     }
 
+    /// Closes every connection served so far, as a network outage would, and keeps listening.
+    void dropConnections()
+    {
+        onDaemon([this] {
+            for (auto* connection: std::exchange(connections, {}))
+                connection->close();
+            return 0;
+        });
+    }
+
     /// Seeds one session and writes @p text on its terminal.
     [[nodiscard]] vtworkspace::SessionId seedSession(std::string text)
     {
@@ -230,6 +249,7 @@ struct MirrorPane
         auto* device = pty.get();
         terminal = std::make_unique<vtbackend::Terminal>(events,
                                                          crispy::defaultEnvironment(),
+                                                         /*traceRecorder=*/nullptr,
                                                          std::move(pty),
                                                          std::move(settings),
                                                          std::chrono::steady_clock::now());
@@ -243,7 +263,7 @@ struct MirrorPane
     [[nodiscard]] bool shows(std::string_view needle) const
     {
         return waitUntil([&] {
-            auto const guard = std::lock_guard { *terminal };
+            auto const guard = vtbackend::Terminal::SiteLock { *terminal, vtbackend::LockSite::Query };
             return terminal->primaryScreen().grid().renderMainPageText().contains(needle);
         });
     }
@@ -306,7 +326,9 @@ TEST_CASE("attach controller mirrors a remote session over a real socket", "[att
     auto daemon = DaemonFixture {};
     auto const session = daemon.seedSession("hello attach");
 
-    auto controller = contour::remote::NativeController { daemon.endpoint(), std::nullopt };
+    auto controller = contour::remote::NativeController { daemon.endpoint(),
+                                                          std::nullopt,
+                                                          vthost::client::PredictiveEchoMode::Disabled };
     auto const connected = controller.connectAndWait(10s);
     REQUIRE(connected.has_value());
     REQUIRE(controller.pendingCount() == 1);
@@ -360,7 +382,9 @@ TEST_CASE("attach controller captures the daemon's tab and pane layout", "[attac
         return 0;
     });
 
-    auto controller = contour::remote::NativeController { daemon.endpoint(), std::nullopt };
+    auto controller = contour::remote::NativeController { daemon.endpoint(),
+                                                          std::nullopt,
+                                                          vthost::client::PredictiveEchoMode::Disabled };
     auto const connected = controller.connectAndWait(10s);
     REQUIRE(connected.has_value());
 
@@ -585,7 +609,9 @@ TEST_CASE("releasing a mirrored pty leaves its remote session running", "[attach
     auto daemon = DaemonFixture {};
     std::ignore = daemon.seedSession("keep me running");
 
-    auto controller = contour::remote::NativeController { daemon.endpoint(), std::nullopt };
+    auto controller = contour::remote::NativeController { daemon.endpoint(),
+                                                          std::nullopt,
+                                                          vthost::client::PredictiveEchoMode::Disabled };
     requireConnected(controller);
     REQUIRE(controller.pendingCount() == 1);
     auto const liveSessions = [&daemon] {
@@ -1070,7 +1096,9 @@ TEST_CASE("a closed mirrored tab does not resurrect on later remote output", "[a
     auto daemon = DaemonFixture {};
     auto const session = daemon.seedSession("first line");
 
-    auto controller = contour::remote::NativeController { daemon.endpoint(), std::nullopt };
+    auto controller = contour::remote::NativeController { daemon.endpoint(),
+                                                          std::nullopt,
+                                                          vthost::client::PredictiveEchoMode::Disabled };
     requireConnected(controller);
     REQUIRE(controller.pendingCount() == 1);
 
@@ -1108,11 +1136,61 @@ TEST_CASE("a closed mirrored tab does not resurrect on later remote output", "[a
     controller.stop();
 }
 
+// A VPN flap or a laptop waking on another network drops the connection, not the daemon. The panes
+// must survive it: the controller redials and resumes each mirror rather than ending every one.
+TEST_CASE("a dropped attach reconnects and resumes its panes", "[attach][controller]")
+{
+    auto daemon = DaemonFixture {};
+    auto const session = daemon.seedSession("before the drop");
+
+    auto controller = contour::remote::NativeController { daemon.endpoint(),
+                                                          std::nullopt,
+                                                          vthost::client::PredictiveEchoMode::Disabled };
+    auto closed = std::atomic<int> { 0 };
+    QObject::connect(&controller, &contour::remote::NativeController::connectionClosed, [&] { ++closed; });
+    requireConnected(controller);
+
+    auto route = AttachRoute { controller };
+    auto pty = route.router.createPty(std::nullopt);
+    REQUIRE(pty != nullptr);
+    auto pane = MirrorPane { route.router, std::move(pty) };
+    REQUIRE(pane.shows("before the drop"));
+
+    daemon.dropConnections();
+    daemon.onDaemon([&] {
+        daemon.host->terminal(session)->writeToScreen("\r\nafter the drop");
+        return 0;
+    });
+
+    // The same pane, fed over a second connection.
+    CHECK(pane.shows("after the drop"));
+    CHECK(pane.shows("before the drop"));
+    CHECK(daemon.onDaemon([&] { return daemon.server->acceptedCount(); }) == 2);
+    CHECK(!pane.pty().isClosed());
+    CHECK(closed == 0);
+    CHECK(controller.isBound(unbox(session)));
+
+    // Input reaches the remote PTY over the new connection.
+    std::ignore = pane.pty().write("ls\r");
+    CHECK(waitUntil([&] {
+        return daemon.onDaemon([&] {
+            auto& tapped = dynamic_cast<vthost::TappingPty&>(daemon.host->terminal(session)->device());
+            return dynamic_cast<vtpty::MockPty&>(tapped.inner()).stdinBuffer();
+        }) == "ls\r";
+    }));
+
+    controller.stop();
+    CHECK(pane.pty().isClosed());
+    pane.terminal.reset();
+}
+
 TEST_CASE("attach controller reports an unreachable daemon", "[attach][controller]")
 {
     // Port 1 on loopback has nothing listening: connect is refused before any TLS.
     auto controller = contour::remote::NativeController {
-        vthost::TcpEndpoint { .host = "127.0.0.1", .port = 1, .token = {}, .caPem = {} }, std::nullopt
+        vthost::TcpEndpoint { .host = "127.0.0.1", .port = 1, .token = {}, .caPem = {} },
+        std::nullopt,
+        vthost::client::PredictiveEchoMode::Disabled
     };
     auto const connected = controller.connectAndWait(2s);
     REQUIRE(!connected.has_value());
@@ -1231,6 +1309,7 @@ TEST_CASE("the routing session factory forwards every verb to its delegate", "[a
     auto* device = pty.get();
     auto terminal = vtbackend::Terminal { events,
                                           crispy::defaultEnvironment(),
+                                          /*traceRecorder=*/nullptr,
                                           std::move(pty),
                                           std::move(settings),
                                           std::chrono::steady_clock::now() };
@@ -12,7 +12,6 @@
 #include <algorithm>
 #include <mutex>
 
-using std::scoped_lock;
 using std::string;
 
 using vtbackend::ImageSize;
@@ -126,7 +125,7 @@ void applyResize(ImageSize newPixelSize, TerminalSession& session, vtrasterizer:
                           terminal.pageSize(),
                           fit.pageSize);
 
-    auto const l = scoped_lock { terminal };
+    auto const l = vtbackend::Terminal::SiteLock { terminal, vtbackend::LockSite::Configure };
 
     // fit.pageSize is already clamped (see above), so a direct comparison decides the early-out.
     if (fit.pageSize == terminal.totalPageSize())
@@ -16,6 +16,16 @@ using std::nullopt;
 namespace contour::session
 {
 
+namespace
+{
+    /// Whether a shell started for @p a is exactly the one @p b asks for.
+    [[nodiscard]] bool sameLaunch(vtpty::Process::ExecInfo const& a, vtpty::Process::ExecInfo const& b)
+    {
+        return a.program == b.program && a.arguments == b.arguments
+               && a.workingDirectory == b.workingDirectory && a.env == b.env;
+    }
+} // namespace
+
 vtbackend::PageSize childPtyPageSize(vtbackend::PageSize total,
                                      vtbackend::StatusDisplayType statusLine) noexcept
 {
@@ -76,8 +86,59 @@ std::unique_ptr<vtpty::Pty> AppSessionFactory::createPty(
     // this).
     auto const initialSize = childPtyPageSize(pageSize.value_or(profile->terminalSize.value()),
                                               profile->statusLine.value().initialType);
+    auto const sandbox = profile->escapeSandbox.value() ? ShellSandbox::Escaped : ShellSandbox::Confined;
+    // A pooled shell is started before anyone asks where the next one should run, so it runs in the
+    // profile's own working directory. A session that wants another one (a tab inheriting the
+    // directory of the one it was opened beside, a layout pane naming its own) or its own command
+    // starts its shell on the spot, and leaves the pool to the sessions it fits.
+    if (overridesShellProgram(commandOverride)
+        || shell.workingDirectory != profile->shell.value().workingDirectory)
+        return spawnShell(shell, sandbox, initialSize);
+    return spawnLocalShell(profileName.value_or(_app.profileName()),
+                           shell,
+                           sandbox,
+                           profile->prespawnedShells.value(),
+                           initialSize);
+}
+
+std::unique_ptr<vtpty::Pty> AppSessionFactory::spawnShell(vtpty::Process::ExecInfo const& shell,
+                                                          ShellSandbox sandbox,
+                                                          vtbackend::PageSize pageSize)
+{
     return make_unique<vtpty::Process>(
-        shell, vtpty::createPty(initialSize, nullopt), profile->escapeSandbox.value());
+        shell, vtpty::createPty(pageSize, nullopt), sandbox == ShellSandbox::Escaped);
+}
+
+std::unique_ptr<vtpty::Pty> AppSessionFactory::spawnLocalShell(std::string const& profileKey,
+                                                               vtpty::Process::ExecInfo const& shell,
+                                                               ShellSandbox sandbox,
+                                                               unsigned prespawnedShells,
+                                                               vtbackend::PageSize pageSize)
+{
+    if (prespawnedShells == 0)
+    {
+        // Also what a config reload that turned the option off ends up in: the pool goes with it.
+        _prespawned.erase(profileKey);
+        return spawnShell(shell, sandbox, pageSize);
+    }
+
+    auto& warm = _prespawned[profileKey];
+    if (!warm.pool || warm.sandbox != sandbox || !sameLaunch(warm.shell, shell)
+        || warm.pool->capacity() != prespawnedShells)
+    {
+        // A config reload changed the profile's shell or the option. The shells started under the
+        // old ones are hung up on before new ones start.
+        warm.pool.reset();
+        warm = PrespawnedShells {
+            .shell = shell,
+            .sandbox = sandbox,
+            .pool = make_unique<vtpty::PtyPool>(
+                [shell, sandbox](vtbackend::PageSize size) { return spawnShell(shell, sandbox, size); },
+                prespawnedShells,
+                pageSize),
+        };
+    }
+    return warm.pool->acquire(pageSize);
 }
 
 #ifdef VTPTY_LIBSSH2
@@ -6,10 +6,13 @@
 
 #include <vtpty/Process.hpp>
 #include <vtpty/Pty.hpp>
+#include <vtpty/PtyPool.hpp>
 #ifdef VTPTY_LIBSSH2
     #include <vtpty/SshSession.hpp>
 #endif
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -163,6 +166,12 @@ class SessionFactory
 
 /// The production SessionFactory: consults the app's active profile and produces either a local
 /// process PTY or an SSH session PTY.
+///
+/// A profile with `prespawned_shells` set gets its local shells from a vtpty::PtyPool. A started
+/// shell cannot change what it runs or where, so the pool keeps shells of the profile's own launch
+/// (program, arguments, environment and working directory) only. A session asking for anything
+/// else, most often a tab inheriting the working directory of the one it was opened beside, spawns
+/// its shell as it always did and leaves the pool alone.
 class AppSessionFactory final: public SessionFactory
 {
   public:
@@ -181,7 +190,37 @@ class AppSessionFactory final: public SessionFactory
                                        vtpty::SshHostkeyVerificationResponseCallback const& response);
 #endif
 
+    /// Whether a local shell runs inside the Flatpak sandbox (@see the profile's `escape_sandbox`).
+    enum class ShellSandbox : uint8_t
+    {
+        Confined,
+        Escaped,
+    };
+
+    /// Starts a local shell running @p shell right away.
+    [[nodiscard]] static std::unique_ptr<vtpty::Pty> spawnShell(vtpty::Process::ExecInfo const& shell,
+                                                                ShellSandbox sandbox,
+                                                                vtbackend::PageSize pageSize);
+
+    /// A local shell for @p profileKey running the profile's own @p shell, from the profile's pool
+    /// when it has one.
+    [[nodiscard]] std::unique_ptr<vtpty::Pty> spawnLocalShell(std::string const& profileKey,
+                                                              vtpty::Process::ExecInfo const& shell,
+                                                              ShellSandbox sandbox,
+                                                              unsigned prespawnedShells,
+                                                              vtbackend::PageSize pageSize);
+
+    /// The shells started ahead of time for a profile.
+    struct PrespawnedShells
+    {
+        vtpty::Process::ExecInfo shell;
+        ShellSandbox sandbox = ShellSandbox::Confined;
+        std::unique_ptr<vtpty::PtyPool> pool;
+    };
+
     ContourGuiApp& _app;
+    /// The pool of each profile with `prespawned_shells` set.
+    std::map<std::string, PrespawnedShells> _prespawned;
 };
 
 } // namespace contour::session
@@ -241,6 +241,8 @@ bool sendKeyEvent(QKeyEvent* event,
     using vtbackend::Key;
     using vtbackend::Modifier;
 
+    if (eventType != vtbackend::KeyboardEventType::Release)
+        session.terminal().latencyProbe().keyPressed();
     auto const now = steady_clock::now();
 
     static auto constexpr KeyMappings = array {
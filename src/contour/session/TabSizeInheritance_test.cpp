@@ -46,7 +46,7 @@ struct ManagerFixture
     /// so the NEXT tab created in that window inherits this size.
     static void resizeSessionGrid(contour::session::TerminalSession& session, vtbackend::PageSize to)
     {
-        auto const _ = std::scoped_lock { session.terminal() };
+        auto const _ = vtbackend::Terminal::SiteLock { session.terminal(), vtbackend::LockSite::Configure };
         session.terminal().resizeScreen(to, std::nullopt);
     }
 
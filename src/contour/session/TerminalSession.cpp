@@ -25,6 +25,7 @@
 
 #include <crispy/Assert.hpp>
 #include <crispy/StackTrace.hpp>
+#include <crispy/TraceEvents.hpp>
 #include <crispy/Utils.hpp>
 
 #include <QtCore/QDeadlineTimer>
@@ -82,6 +83,16 @@ namespace contour::session
 
 namespace
 {
+    /// Largest clipboard text pasteFromClipboard() accepts. Pastes are streamed to the PTY in chunks
+    /// (@see InputGenerator::generatePaste()), so this only bounds the clipboard copy held in memory.
+    constexpr auto PasteHardLimit = qsizetype { 64 } * 1024 * 1024;
+
+    /// Clipboard text above this size needs the user's permission to be pasted.
+    constexpr auto PasteSoftLimit = qsizetype { 512 } * 1024;
+
+    /// How long flushInput() waits before retrying when the PTY accepted nothing.
+    constexpr auto InputBackpressureRetry = std::chrono::milliseconds(10);
+
     string unhandledExceptionMessage(string_view const& where, exception const& e)
     {
         return std::format("{}: Unhandled exception caught ({}). {}", where, typeid(e).name(), e.what());
@@ -228,6 +239,9 @@ namespace
             settings.colorPalette = *p;
         settings.highlightDoubleClickedWord = profile.highlightDoubleClickedWord.value();
         settings.highlightTimeout = profile.highlightTimeout.value();
+        // flushInput() runs on the GUI thread, which a full PTY must not stall; TerminalSession::flushInput()
+        // retries whatever the PTY did not take.
+        settings.ptyInputWrite = vtbackend::PtyInputWrite::NonBlocking;
 
         return settings;
     }
@@ -289,8 +303,10 @@ TerminalSession::TerminalSession(TerminalSessionManager* manager,
     _currentColorPreference { app.colorPreference() },
     _accumulatedPixelScroll {},
     _accumulatedAngleScroll {},
+    _traceRecorder { std::format("session {}", _id) },
     _terminal { *this,
                 app.processEnvironment(),
+                &_traceRecorder,
                 std::move(pty),
                 createSettingsFromConfig(_config, _profile, _currentColorPreference, initialPageSize),
                 std::chrono::steady_clock::now() },
@@ -309,6 +325,9 @@ TerminalSession::TerminalSession(TerminalSessionManager* manager,
     _musicalNotesBuffer.reserve(16);
     _profile = *_config.profile(_profileName); // XXX do it again. but we've to be more efficient here
     configureTerminal();
+
+    if (app.traceFile())
+        _traceRecorder.start();
 }
 
 TerminalSession::~TerminalSession()
@@ -350,6 +369,16 @@ TerminalSession::~TerminalSession()
 
     if (_screenUpdateThread)
         _screenUpdateThread->join();
+
+    // Every thread that recorded for this session has stopped doing so by now: the PTY thread was
+    // joined above, and the display was released (or never attached).
+    if (auto const path = _app.traceFile())
+    {
+        _traceRecorder.stop();
+        auto const tracePath = crispy::trace::sessionTracePath(*path, static_cast<std::uint64_t>(_id));
+        if (auto const written = _traceRecorder.writeJson(tracePath); !written)
+            errorLog()("Failed to write the frame trace: {}", written.error());
+    }
 }
 
 void TerminalSession::detachDisplay(DisplaySurface& display)
@@ -402,7 +431,7 @@ void TerminalSession::attachDisplay(DisplaySurface& newDisplay)
     if (!isClosed())
     {
         // NB: Inform connected TTY and local Screen instance about initial cell pixel size.
-        auto const l = scoped_lock { _terminal };
+        auto const l = Terminal::SiteLock { _terminal, LockSite::Configure };
         _terminal.resizeScreen(_terminal.totalPageSize(),
                                _display->reportedPixelSize(_terminal.totalPageSize()));
         // refreshRate() dereferences window()->screen(); pre-window (see below) the posted
@@ -533,6 +562,7 @@ void TerminalSession::reportDeviceStartFailure(vtpty::StartFailure const& failur
 void TerminalSession::mainLoop()
 {
     setThreadName("Terminal.Loop");
+    crispy::trace::setThreadName(std::format("pty session {}", _id));
 
     _mainLoopThreadID = this_thread::get_id();
 
@@ -652,9 +682,23 @@ void TerminalSession::screenUpdated()
 
 void TerminalSession::flushInput()
 {
+    auto const pendingBefore = terminal().pendingInputSize();
     terminal().flushInput();
-    if (terminal().hasInput() && _display)
-        _display->post(bind(&TerminalSession::flushInput, this));
+    if (!terminal().hasInput() || !_display || _inputRetry == InputRetry::Scheduled)
+        return;
+
+    // Progress means the application is reading: keep feeding it from the event loop, between other
+    // events, so a streaming paste never holds up the GUI. No progress means the PTY buffer is full;
+    // reposting right away would spin until the application drains it, so back off briefly instead.
+    _inputRetry = InputRetry::Scheduled;
+    auto const retry = [this]() {
+        _inputRetry = InputRetry::Idle;
+        flushInput();
+    };
+    if (terminal().pendingInputSize() < pendingBefore)
+        _display->post(retry);
+    else
+        QTimer::singleShot(InputBackpressureRetry, this, retry);
 }
 
 void TerminalSession::renderBufferUpdated()
@@ -1177,8 +1221,7 @@ void TerminalSession::pasteFromClipboard(unsigned count, bool strip)
 
         auto const text = clipboard->text(QClipboard::Clipboard);
 
-        // 1 MB hard limit
-        if (text.size() > static_cast<qsizetype>(1024 * 1024))
+        if (text.size() > PasteHardLimit)
         {
             sessionLog()("Clipboard contains huge text. Ignoring.");
             // A display-less session (background pane, headless test) has nowhere to toast the
@@ -1189,8 +1232,7 @@ void TerminalSession::pasteFromClipboard(unsigned count, bool strip)
                 });
             return;
         }
-        // 512 KB soft limit to ask user for permission
-        if (text.size() > static_cast<qsizetype>(1024 * 512))
+        if (text.size() > PasteSoftLimit)
         {
             _pendingBigPaste = clipboard;
             emit requestPermissionForPasteLargeFile();
@@ -1198,18 +1240,18 @@ void TerminalSession::pasteFromClipboard(unsigned count, bool strip)
             return;
         }
 
-        string const strippedText = stripIf(normalizeCrlf(clipboard->text(QClipboard::Clipboard)), strip);
+        auto strippedText = stripIf(normalizeCrlf(clipboard->text(QClipboard::Clipboard)), strip);
         sessionLog()("Size of text: {}", strippedText.size());
         if (strippedText.empty())
             sessionLog()("Clipboard does not contain text.");
         else if (count == 1)
-            terminal().sendPaste(string_view { strippedText });
+            terminal().sendPaste(std::move(strippedText));
         else
         {
             string fullPaste;
             for (unsigned i = 0; i < count; ++i)
                 fullPaste += strippedText;
-            terminal().sendPaste(string_view { fullPaste });
+            terminal().sendPaste(std::move(fullPaste));
         }
     }
     else
@@ -1233,7 +1275,7 @@ void TerminalSession::applyPendingPaste(bool allow, bool remember)
 
     auto* clipboard = _pendingBigPaste.value();
     auto text = clipboard->text(QClipboard::Clipboard);
-    terminal().sendPaste(string_view { text.toStdString() });
+    terminal().sendPaste(text.toStdString());
 }
 
 void TerminalSession::onSelectionCompleted()
@@ -1355,6 +1397,16 @@ std::tuple<LineOffset, ColumnOffset> TerminalSession::consumeScroll() noexcept
     };
 }
 
+QString TerminalSession::latencyReport() const
+{
+    auto const& probe = _terminal.latencyProbe();
+    if (!probe.enabled())
+        return {};
+    if (probe.samples() == 0)
+        return QStringLiteral("Latency probe: type at an idle prompt.");
+    return QString::fromStdString(probe.summary()).trimmed();
+}
+
 QString TerminalSession::title() const
 {
     // Bound to Main.qml's window `title:`, so Qt re-evaluates this on the GUI thread whenever the title
@@ -1629,7 +1681,7 @@ void TerminalSession::sendMousePressEvent(Modifiers modifiers,
 
     terminal().tick(steady_clock::now());
 
-    if (crispy::locked(_terminal, [&]() {
+    if (_terminal.locked(LockSite::Input, [&]() {
             return _terminal.sendMousePressEvent(modifiers, button, pixelPosition, uiHandledHint);
         }))
         return;
@@ -1704,7 +1756,7 @@ void TerminalSession::sendMouseMoveEvent(vtbackend::Modifiers modifiers,
     // afterwards. tryGetHoveringHyperlink() re-queries the screen and needs the same non-recursive
     // mutex, so a second acquisition here would be one more chance to deadlock, and a callback fired
     // from vtbackend's own hover-state update would run WITH the lock held and self-deadlock outright.
-    auto const hoveredUri = crispy::locked(_terminal, [&]() -> std::string {
+    auto const hoveredUri = _terminal.locked(LockSite::Input, [&]() -> std::string {
         _terminal.sendMouseMoveEvent(modifiers, pos, pixelPosition, UiHandledHint);
         auto const link = _terminal.tryGetHoveringHyperlink();
         return link ? link->uri : std::string {};
@@ -1768,7 +1820,7 @@ void TerminalSession::sendMouseReleaseEvent(Modifiers modifiers,
 {
     terminal().tick(steady_clock::now());
 
-    crispy::locked(_terminal, [&]() {
+    _terminal.locked(LockSite::Input, [&]() {
         auto const uiHandledHint = false;
         _terminal.sendMouseReleaseEvent(modifiers, button, pixelPosition, uiHandledHint);
     });
@@ -1778,7 +1830,7 @@ void TerminalSession::sendMouseReleaseEvent(Modifiers modifiers,
 void TerminalSession::performAutoScroll(int direction, vtbackend::LineCount lineCount)
 {
     terminal().tick(steady_clock::now());
-    crispy::locked(_terminal, [&]() { _terminal.performAutoScroll(direction, lineCount); });
+    _terminal.locked(LockSite::Viewport, [&]() { _terminal.performAutoScroll(direction, lineCount); });
 }
 
 void TerminalSession::sendFocusInEvent()
@@ -1862,7 +1914,7 @@ bool TerminalSession::operator()(actions::CancelSelection)
 {
     // Locked: the selection is torn down by the parser thread too (a buffer scroll re-extends or drops
     // it). See ViNormalMode for the rationale.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Selection };
 
     if (!_terminal.selectionAvailable())
         return false;
@@ -1886,19 +1938,19 @@ bool TerminalSession::operator()(actions::ClearHistoryAndReset)
     sessionLog()("Clearing history and perform terminal hard reset");
 
     // Locked, for the reason spelled out at operator()(SoftReset) below.
-    crispy::locked(_terminal, [&]() { terminal().hardReset(); });
+    _terminal.locked(LockSite::Input, [&]() { terminal().hardReset(); });
     return true;
 }
 
 bool TerminalSession::operator()(actions::CopyPreviousMarkRange)
 {
-    crispy::locked(_terminal, [&]() { copyToClipboard(terminal().extractLastMarkRange()); });
+    _terminal.locked(LockSite::Selection, [&]() { copyToClipboard(terminal().extractLastMarkRange()); });
     return true;
 }
 
 bool TerminalSession::operator()(actions::SelectAll)
 {
-    crispy::locked(_terminal, [&]() { terminal().selectAll(); });
+    _terminal.locked(LockSite::Selection, [&]() { terminal().selectAll(); });
     return true;
 }
 
@@ -1907,7 +1959,7 @@ bool TerminalSession::operator()(actions::OpenContextMenu)
     // Not while a left-drag selection is in flight. The popup takes the mouse grab, so the button-release
     // that would end that drag never reaches the display: the selection would go on extending with every
     // later hover, and the auto-scroll timer would go on firing, with no button held down at all.
-    if (crispy::locked(_terminal, [&]() { return terminal().leftMouseButtonPressed(); }))
+    if (_terminal.locked(LockSite::Input, [&]() { return terminal().leftMouseButtonPressed(); }))
         return false;
 
     _manager->openContextMenu(this);
@@ -1925,7 +1977,7 @@ command::ContextMenuState TerminalSession::contextMenuState()
     // mimeData()->hasText(), not text(): the latter is a synchronous round-trip to whichever process owns
     // the clipboard, and it drags the ENTIRE payload across — a 5 MB log, a huge listing — only for
     // .isEmpty() to throw it away. On the GUI thread, inside a mouse-press handler. This is the very cost
-    // pasteFromClipboard() is written to avoid (it refuses above 1 MB and asks above 512 KB); asking for
+    // pasteFromClipboard() is written to avoid (it refuses above 64 MB and asks above 512 KB); asking for
     // the available formats instead answers the same question without transferring a byte of content.
     auto const* clipboard = QGuiApplication::clipboard();
     auto const* mimeData = clipboard != nullptr ? clipboard->mimeData(QClipboard::Clipboard) : nullptr;
@@ -1938,7 +1990,7 @@ command::ContextMenuState TerminalSession::contextMenuState()
     // One lock for the whole snapshot. The parser thread mutates the grid concurrently, so a menu that
     // asked the terminal a fresh question per row would be reading a moving target — and a QML binding
     // that reached into the terminal on its own schedule would be a plain data race.
-    return crispy::locked(_terminal, [&]() {
+    return _terminal.locked(LockSite::Query, [&]() {
         auto const block = terminal().lastCommandBlock();
         auto const hyperlink = terminal().tryGetHoveringHyperlink();
 
@@ -1980,7 +2032,7 @@ bool TerminalSession::operator()(actions::SoftReset)
     // Taking the lock cannot deadlock: DECSTR (CSI ! p) already reaches Terminal::softReset() from the
     // parser thread, from inside writeToScreen()'s own _stateMutex hold, so every callback the reset makes
     // is exercised under this very lock every time an application asks for one. This path simply joins it.
-    crispy::locked(_terminal, [&]() { terminal().softReset(); });
+    _terminal.locked(LockSite::Input, [&]() { terminal().softReset(); });
     return true;
 }
 
@@ -2001,7 +2053,7 @@ bool TerminalSession::operator()(actions::CopyLastCommandBlock)
 
 bool TerminalSession::copyLastCommandBlock(vtbackend::CommandBlockPart part)
 {
-    auto const block = crispy::locked(_terminal, [&]() { return terminal().lastCommandBlock(); });
+    auto const block = _terminal.locked(LockSite::Selection, [&]() { return terminal().lastCommandBlock(); });
     if (!block)
         return false;
 
@@ -2029,7 +2081,7 @@ bool TerminalSession::operator()(actions::CopyHyperlink const& action)
         return true;
     }
 
-    auto const l = scoped_lock { terminal() };
+    auto const l = Terminal::SiteLock { terminal(), LockSite::Query };
     auto const hyperlink = terminal().tryGetHoveringHyperlink();
     if (!hyperlink)
         return false;
@@ -2045,7 +2097,8 @@ bool TerminalSession::operator()(actions::CopySelection copySelection)
     {
         case actions::CopyFormat::Text:
             // Copy the selection in pure text, plus whitespaces and newline.
-            crispy::locked(_terminal, [&]() { copyToClipboard(terminal().extractSelectionText()); });
+            _terminal.locked(LockSite::Selection,
+                             [&]() { copyToClipboard(terminal().extractSelectionText()); });
             break;
         case actions::CopyFormat::HTML:
             // TODO: This requires walking through each selected cell and construct HTML+CSS for it.
@@ -2070,7 +2123,7 @@ bool TerminalSession::operator()(actions::CreateDebugDump)
 bool TerminalSession::operator()(actions::CreateSelection const& customSelector)
 {
     // Locked: word-wise selection scans grid cells and installs a selector. See ViNormalMode.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Selection };
 
     _terminal.triggerWordWiseSelectionWithCustomDelimiters(customSelector.delimiters);
     return true;
@@ -2107,7 +2160,7 @@ bool TerminalSession::operator()(actions::DecreaseOpacity)
 bool TerminalSession::operator()(actions::FocusNextSearchMatch)
 {
     // Locked: searchNextMatch() walks the grid and the Vi cursor moves with it. See ViNormalMode.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Search };
 
     auto const nextPosition = _terminal.searchNextMatch(_terminal.normalModeCursorPosition());
     if (!nextPosition)
@@ -2121,7 +2174,7 @@ bool TerminalSession::operator()(actions::FocusNextSearchMatch)
 bool TerminalSession::operator()(actions::FocusPreviousSearchMatch)
 {
     // Locked for the same reason as FocusNextSearchMatch above.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Search };
 
     auto const nextPosition = _terminal.searchPrevMatch(_terminal.normalModeCursorPosition());
     if (!nextPosition)
@@ -2142,7 +2195,7 @@ bool TerminalSession::operator()(actions::FollowHyperlink const& action)
         return true;
     }
 
-    auto const l = scoped_lock { terminal() };
+    auto const l = Terminal::SiteLock { terminal(), LockSite::Query };
     if (auto const hyperlink = terminal().tryGetHoveringHyperlink())
     {
         followHyperlink(*hyperlink);
@@ -2219,7 +2272,7 @@ bool TerminalSession::operator()(actions::HintMode const& action)
         .scope = action.scope,
         .scrollbackLimit = profile().hintScrollbackLines.value(),
     };
-    crispy::locked(terminal(), [&]() { terminal().activateHintMode(std::move(request)); });
+    terminal().locked(LockSite::Input, [&]() { terminal().activateHintMode(std::move(request)); });
     return true;
 }
 
@@ -2259,7 +2312,7 @@ bool TerminalSession::operator()(actions::NewTerminal const& action)
 bool TerminalSession::operator()(actions::NoSearchHighlight)
 {
     // Locked: clears the search term and the match set the parser thread re-derives on new output.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Search };
 
     _terminal.clearSearch();
     return true;
@@ -2292,7 +2345,7 @@ bool TerminalSession::operator()(actions::OpenFileManager)
     auto localPath = std::optional<std::string> {};
     auto cwd = std::string {};
     {
-        auto const l = scoped_lock { terminal() };
+        auto const l = Terminal::SiteLock { terminal(), LockSite::Query };
         cwd = terminal().currentWorkingDirectory();
         localPath = vtbackend::localWorkingDirectory(cwd, localHost);
     }
@@ -2314,7 +2367,7 @@ bool TerminalSession::operator()(actions::OpenFileManager)
 
 bool TerminalSession::operator()(actions::OpenSelection)
 {
-    crispy::locked(_terminal, [&]() {
+    _terminal.locked(LockSite::Selection, [&]() {
         (void) _app.externalLauncher().openUrl(
             QUrl(QString::fromUtf8(terminal().extractSelectionText().c_str())));
     });
@@ -2331,16 +2384,16 @@ bool TerminalSession::operator()(actions::PasteSelection paste)
 {
     if (QClipboard const* clipboard = QGuiApplication::clipboard(); clipboard != nullptr)
     {
-        string const text = normalizeCrlf(clipboard->text(QClipboard::Selection));
+        auto text = normalizeCrlf(clipboard->text(QClipboard::Selection));
 
         // Locked around the terminal calls only -- the clipboard read above is Qt's and must not run
         // with the terminal lock held. See ViNormalMode for the rationale.
-        auto const l = scoped_lock { _terminal };
+        auto const l = Terminal::SiteLock { _terminal, LockSite::Selection };
 
         if (paste.evaluateInShell)
             terminal().sendRawInput(string_view { text + "\n" });
         else
-            terminal().sendPaste(string_view { text });
+            terminal().sendPaste(std::move(text));
     }
 
     return true;
@@ -2359,6 +2412,36 @@ bool TerminalSession::operator()(actions::Quit)
     return true;
 }
 
+bool TerminalSession::operator()(actions::RecordFrameTrace)
+{
+    // The recorder is this session's: its PTY thread, and the render and GUI threads while they work
+    // for it, record into it, each under its own track. The other panes stay untraced.
+    if (!_traceRecorder.isRecording())
+    {
+        _traceRecorder.start();
+        sessionLog()("Recording frame trace.");
+        return true;
+    }
+
+    _traceRecorder.stop();
+    auto const tracePath = crispy::App::instance()->localStateDir() / "traces"
+                           / fs::path(std::format("contour-trace-session-{}-{:%Y-%m-%d-%H-%M-%S}.json",
+                                                  _id,
+                                                  chrono::system_clock::now()));
+    if (auto const written = _traceRecorder.writeJson(tracePath); !written)
+    {
+        errorLog()("Failed to write the frame trace: {}", written.error());
+        return true;
+    }
+
+    auto message = std::format("Frame trace written to {}", tracePath.string());
+    sessionLog()(message);
+    if (_display)
+        _display->post(
+            [this, message]() { emit showNotification("Frame trace", QString::fromStdString(message)); });
+    return true;
+}
+
 bool TerminalSession::operator()(actions::ReloadConfig const& action)
 {
     if (action.profileName.has_value())
@@ -2384,7 +2467,7 @@ bool TerminalSession::operator()(actions::ResetFontSize)
 
 bool TerminalSession::operator()(actions::ScreenshotVT)
 {
-    auto l = lock_guard { terminal() };
+    auto const l = Terminal::SiteLock { terminal(), LockSite::Query };
     auto const screenshot = terminal().isPrimaryScreen() ? terminal().primaryScreen().screenshot()
                                                          : terminal().alternateScreen().screenshot();
     ofstream ofs { "screenshot.vt", ios::trunc | ios::binary };
@@ -2425,7 +2508,7 @@ void TerminalSession::smoothScrollUp(vtbackend::LineCount lineCount)
     // viewport offset and the smooth-scroll state are read and advanced by the parser thread too (a
     // buffer scroll shifts the viewport), so a GUI-thread scroll must not interleave with it. See
     // ViNormalMode for the full GUI-vs-parser-thread rationale.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     if (terminal().settings().smoothScrolling)
     {
@@ -2440,7 +2523,7 @@ void TerminalSession::smoothScrollUp(vtbackend::LineCount lineCount)
 void TerminalSession::smoothScrollDown(vtbackend::LineCount lineCount)
 {
     // Locked for the same reason as smoothScrollUp() above.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     if (terminal().settings().smoothScrolling)
     {
@@ -2461,7 +2544,7 @@ bool TerminalSession::operator()(actions::ScrollDown)
 bool TerminalSession::operator()(actions::ScrollMarkDown)
 {
     // Locked: scans the grid for marks and moves the viewport. See ViNormalMode.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     terminal().viewport().scrollMarkDown();
     return true;
@@ -2470,7 +2553,7 @@ bool TerminalSession::operator()(actions::ScrollMarkDown)
 bool TerminalSession::operator()(actions::ScrollMarkUp)
 {
     // Locked for the same reason as ScrollMarkDown above.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     terminal().viewport().scrollMarkUp();
     return true;
@@ -2505,7 +2588,7 @@ bool TerminalSession::operator()(actions::ScrollPageUp)
 bool TerminalSession::operator()(actions::ScrollToBottom)
 {
     // Locked: mutates the smooth-scroll state and the viewport. See ViNormalMode.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     // Snap immediately for ScrollToTop/Bottom (animating large distances is impractical).
     terminal().resetSmoothScroll();
@@ -2516,7 +2599,7 @@ bool TerminalSession::operator()(actions::ScrollToBottom)
 bool TerminalSession::operator()(actions::ScrollToTop)
 {
     // Locked for the same reason as ScrollToBottom above.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Viewport };
 
     // Snap immediately for ScrollToTop/Bottom (animating large distances is impractical).
     terminal().resetSmoothScroll();
@@ -2534,7 +2617,7 @@ bool TerminalSession::operator()(actions::SearchReverse)
 {
     // Locked: starting a search switches Vi mode, which pushes the indicator status line and so
     // resizes the page -- the same hazard ViNormalMode documents.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Search };
 
     terminal().inputHandler().startSearchExternally();
 
@@ -2545,7 +2628,7 @@ bool TerminalSession::operator()(actions::SendChars const& event)
 {
     // Locked: sendRawInput() appends to the input generator and flushes it, and the parser thread
     // appends to that same generator whenever a sequence replies. See ViNormalMode.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Input };
 
     // auto const now = steady_clock::now();
     // for (auto const ch: event.chars)
@@ -2560,7 +2643,7 @@ bool TerminalSession::operator()(actions::ToggleAllKeyMaps)
     input::inputLog()("{} key mappings.", _allowKeyMappings ? "Enabling" : "Disabling");
 
     // Locked: setStatusDisplay() resizes the page and reflows the grid, exactly as ViNormalMode does.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Input };
 
     if (!_allowKeyMappings)
     {
@@ -2592,7 +2675,7 @@ bool TerminalSession::operator()(actions::ToggleInputProtection)
     // Locked around the terminal calls only; announce() below is Qt accessibility and must not run
     // with the terminal lock held. See ViNormalMode for the rationale.
     auto const allowInput = [&]() {
-        auto const l = scoped_lock { _terminal };
+        auto const l = Terminal::SiteLock { _terminal, LockSite::Input };
         terminal().setAllowInput(!terminal().allowInput());
         return terminal().allowInput();
     }();
@@ -2604,9 +2687,26 @@ bool TerminalSession::operator()(actions::ToggleInputProtection)
     return true;
 }
 
+bool TerminalSession::operator()(actions::ToggleLatencyProbe)
+{
+    auto& probe = _terminal.latencyProbe();
+    if (!probe.enabled())
+    {
+        probe.reset();
+        probe.setMode(LatencyProbeMode::Enabled);
+    }
+    else
+    {
+        probe.setMode(LatencyProbeMode::Disabled);
+        sessionLog()("Keypress-to-present latency over {} keystrokes:\n{}", probe.samples(), probe.summary());
+    }
+    emit latencyReportChanged();
+    return true;
+}
+
 bool TerminalSession::operator()(actions::ToggleStatusLine)
 {
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::StatusLine };
     if (terminal().statusDisplayType() != StatusDisplayType::Indicator)
         terminal().setStatusDisplay(StatusDisplayType::Indicator);
     else
@@ -2668,7 +2768,7 @@ bool TerminalSession::operator()(actions::ViNormalMode)
     // verifyState() abort -- and Require() is not compiled out in release builds. That is #1495,
     // which needed a remote tmux only because it keeps the parser thread busy enough to hit the
     // window nearly every time.
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Input };
 
     if (terminal().inputHandler().mode() == ViMode::Insert)
         terminal().inputHandler().setMode(ViMode::Normal);
@@ -2703,7 +2803,7 @@ bool TerminalSession::operator()(actions::SpeakSelection)
     // Locked around the extraction only: it reads the selection and the grid cells behind it, both of
     // which the parser thread mutates. The say() below is Qt and must not hold the lock.
     auto const text = [&]() {
-        auto const l = scoped_lock { _terminal };
+        auto const l = Terminal::SiteLock { _terminal, LockSite::Selection };
         return platform::speakableText(terminal().extractSelectionText(), MaxSpokenChars);
     }();
     if (text.empty())
@@ -2719,6 +2819,17 @@ bool TerminalSession::operator()(actions::StopSpeaking)
     return true;
 }
 
+bool TerminalSession::operator()(actions::CancelPaste)
+{
+    // Not consumed when there is nothing to cancel, so a key bound to it keeps reaching the
+    // application the rest of the time.
+    if (!terminal().pasteInProgress())
+        return false;
+
+    terminal().cancelPaste();
+    return true;
+}
+
 bool TerminalSession::operator()(actions::CloseAllTabs)
 {
     // Deliberately NOT actions::Quit: that one calls exit() straight from a Qt slot, with no teardown
@@ -3065,7 +3176,7 @@ std::string TerminalSession::workingDirectory() const
     // crashes the app, so extract the filesystem path first (fix from master's OSC-7 crash fix).
     std::string cwdUrl;
     {
-        auto const _l = scoped_lock { _terminal };
+        auto const _l = Terminal::SiteLock { _terminal, LockSite::Query };
         cwdUrl = _terminal.currentWorkingDirectory();
     }
     if (!cwdUrl.empty())
@@ -3091,7 +3202,7 @@ std::string TerminalSession::displayWorkingDirectory() const
     // and it is the only source that can be right for a remote session. Reported as a file:// URL.
     auto cwdUrl = std::string {};
     {
-        auto const lock = scoped_lock { _terminal };
+        auto const lock = Terminal::SiteLock { _terminal, LockSite::Query };
         cwdUrl = _terminal.currentWorkingDirectory();
     }
     if (!cwdUrl.empty())
@@ -3211,7 +3322,7 @@ void TerminalSession::activateProfile(string const& newProfileName, ProfileWindo
 
 void TerminalSession::configureTerminal()
 {
-    auto const l = scoped_lock { _terminal };
+    auto const l = Terminal::SiteLock { _terminal, LockSite::Configure };
     sessionLog()("Configuring terminal.");
 
     _terminal.setWordDelimiters(_config.wordDelimiters.value());
@@ -3285,7 +3396,7 @@ void TerminalSession::updateImageCanvasCeiling()
     // no room for -- one that then overflows the page and scrolls the screen instead of fitting it.
     auto const ceiling = geometry::reportedPixels(devicePixels, _display->reportedPixelScale());
 
-    auto const _ = std::scoped_lock { _terminal };
+    auto const _ = Terminal::SiteLock { _terminal, LockSite::Configure };
     _terminal.setImageCanvasCeiling(ceiling);
 }
 
@@ -23,6 +23,7 @@
 #include <vtrasterizer/Renderer.hpp>
 
 #include <crispy/Point.hpp>
+#include <crispy/TraceEvents.hpp>
 
 #include <QtCore/QAbstractItemModel>
 #include <QtCore/QFileSystemWatcher>
@@ -110,6 +111,9 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     // signal serves them: the anchor without its text describes nothing.
     Q_PROPERTY(QString hyperlinkTooltipText READ hyperlinkTooltipText NOTIFY hyperlinkHoverChanged)
     Q_PROPERTY(QRectF hyperlinkTooltipAnchor READ hyperlinkTooltipAnchor NOTIFY hyperlinkHoverChanged)
+    // The latency probe's figures while it is on (ToggleLatencyProbe), for the debug overlay; empty
+    // while it is off.
+    Q_PROPERTY(QString latencyReport READ latencyReport NOTIFY latencyReportChanged)
 
     // Q_PROPERTY(QString profileName READ profileName NOTIFY profileNameChanged)
 
@@ -132,6 +136,12 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     /// along with it.
     [[nodiscard]] QRectF hyperlinkTooltipAnchor() const noexcept { return _hyperlinkTooltipAnchor; }
 
+    /// The latency probe's summary table, or empty while the probe is off.
+    [[nodiscard]] QString latencyReport() const;
+
+    /// The latency probe completed a sample (posted by the display, GUI thread): refreshes the overlay.
+    void latencySampled() { emit latencyReportChanged(); }
+
     /// Withdraws the hyperlink tooltip, whatever the pointer is over.
     ///
     /// Called when the pointer leaves the terminal, and when the viewport scrolls: the hovered-link
@@ -576,6 +586,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     bool operator()(actions::PasteClipboard);
     bool operator()(actions::PasteSelection);
     bool operator()(actions::Quit);
+    bool operator()(actions::RecordFrameTrace);
     bool operator()(actions::ReloadConfig const&);
     bool operator()(actions::ResetConfig);
     bool operator()(actions::ResetFontSize);
@@ -598,6 +609,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     bool operator()(actions::ToggleFullscreen);
     bool operator()(actions::ToggleInputMethodHandling);
     bool operator()(actions::ToggleInputProtection);
+    bool operator()(actions::ToggleLatencyProbe);
     bool operator()(actions::ToggleStatusLine);
     bool operator()(actions::ToggleTitleBar);
     bool operator()(actions::TraceBreakAtEmptyQueue);
@@ -611,6 +623,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     bool operator()(actions::CloseAllTabs);
     bool operator()(actions::SpeakSelection);
     bool operator()(actions::StopSpeaking);
+    bool operator()(actions::CancelPaste);
     bool operator()(actions::SetTabBarVisibility);
     bool operator()(actions::SetTabBarPosition);
     bool operator()(actions::MoveTabTo);
@@ -677,6 +690,10 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
 
     ContourGuiApp& app() noexcept { return _app; }
 
+    /// This session's frame trace: its PTY thread, and the render and GUI work done for it. Recording
+    /// while `--trace-file` is given, or once the RecordFrameTrace action starts it.
+    [[nodiscard]] crispy::trace::Recorder& traceRecorder() noexcept { return _traceRecorder; }
+
     std::chrono::steady_clock::time_point startTime() const noexcept { return _startTime; }
 
     float uptime() const noexcept
@@ -700,6 +717,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
 
   signals:
     void hyperlinkHoverChanged();
+    void latencyReportChanged();
     void sessionClosed(TerminalSession&);
     void profileNameChanged(QString newValue);
     void lineCountChanged(int newValue);
@@ -806,9 +824,19 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     /// Scrolls down by @p lineCount lines, using smooth pixel scrolling if enabled, otherwise line-based.
     void smoothScrollDown(vtbackend::LineCount lineCount);
     uint8_t matchModeFlags() const;
+
+    /// Writes pending input to the PTY, and schedules a retry for whatever the PTY did not take.
     void flushInput();
     void mainLoop();
 
+    /// Whether flushInput() has a retry queued (a repost, or a backpressure timer). One is enough:
+    /// every flush that leaves input behind would otherwise start a retry chain of its own.
+    enum class InputRetry : uint8_t
+    {
+        Idle,
+        Scheduled,
+    };
+
     // private data
     //
     TerminalSessionManager* _manager;
@@ -835,6 +863,8 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     QString _hyperlinkTooltipText;
     QRectF _hyperlinkTooltipAnchor;
 
+    // Before the terminal, which records into it from the PTY thread.
+    crispy::trace::Recorder _traceRecorder;
     vtbackend::Terminal _terminal;
     bool _terminatedAndWaitingForKeyPress = false;
     DisplaySurface* _display = nullptr;
@@ -880,6 +910,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     std::optional<CaptureBufferRequest> _pendingBufferCapture;
     std::optional<vtbackend::FontDef> _pendingFontChange;
     std::optional<QClipboard*> _pendingBigPaste;
+    InputRetry _inputRetry = InputRetry::Idle;
     PermissionCache _rememberedPermissions;
     std::unique_ptr<QThread> _exitWatcherThread;
 
@@ -737,6 +737,18 @@ TEST_CASE("TerminalSession: opener, paste and reload actions run without a displ
     CHECK((*session)(actions::ScreenshotVT {}));
     CHECK((*session)(actions::CreateDebugDump {}));
 
+    // RecordFrameTrace starts the session's recording; stopped directly so no trace file is written.
+    CHECK((*session)(actions::RecordFrameTrace {}));
+    CHECK(session->traceRecorder().isRecording());
+    session->traceRecorder().stop();
+
+    // ToggleLatencyProbe turns the probe and its overlay on, and off again.
+    CHECK((*session)(actions::ToggleLatencyProbe {}));
+    CHECK(session->terminal().latencyProbe().enabled());
+    CHECK_FALSE(session->latencyReport().isEmpty());
+    CHECK((*session)(actions::ToggleLatencyProbe {}));
+    CHECK(session->latencyReport().isEmpty());
+
     // Search-highlight navigation actions with no active search are safe.
     CHECK_NOTHROW((*session)(actions::FocusNextSearchMatch {}));
     CHECK_NOTHROW((*session)(actions::FocusPreviousSearchMatch {}));
@@ -1029,7 +1041,7 @@ TEST_CASE("TerminalSession: ViNormalMode holds the terminal lock while switching
     auto session = makeDisplaylessSession(testApp.app());
     namespace actions = contour::actions;
 
-    auto parserHold = std::unique_lock { session->terminal() };
+    session->terminal().lock(vtbackend::LockSite::Parse);
 
     auto started = std::atomic<bool> { false };
     auto completed = std::atomic<bool> { false };
@@ -1047,7 +1059,7 @@ TEST_CASE("TerminalSession: ViNormalMode holds the terminal lock while switching
 
     CHECK_FALSE(completed.load(std::memory_order_acquire));
 
-    parserHold.unlock();
+    session->terminal().unlock();
     worker.join();
 
     CHECK(completed.load(std::memory_order_acquire));
@@ -1615,7 +1627,7 @@ TEST_CASE("TerminalSession: search-match focus actions move the vi cursor onto a
 
     // Set a search pattern through the terminal, then the match-focus actions have somewhere to go.
     {
-        auto const l = std::scoped_lock { session->terminal() };
+        auto const l = vtbackend::Terminal::SiteLock { session->terminal(), vtbackend::LockSite::Search };
         session->terminal().setNewSearchTerm(U"needle", /*initiatedByDoubleClick*/ false);
     }
     // At least one of next/prev must find a match now (position-dependent), and neither throws.
@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/Base64.hpp>
+
+#include <cstring>
+#include <ranges>
+
+// The kernels are compiled for their instruction set function by function and picked at run time, so
+// the library itself keeps targeting the baseline CPU. Elsewhere the scalar code does all the work.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define CRISPY_BASE64_X86_KERNELS 1
+    #include <immintrin.h>
+#endif
+
+namespace crispy::base64::detail
+{
+
+#if defined(CRISPY_BASE64_X86_KERNELS)
+
+namespace
+{
+    // Both directions follow W. Muła and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+    // Instructions" (2018): bytes are regrouped into 6-bit indices with shuffles and multiplies,
+    // and indices are mapped to and from ASCII by adding a per-range offset.
+
+    // {{{ SSSE3
+    __attribute__((target("ssse3"))) __m128i encodeIndices(__m128i bytes) noexcept
+    {
+        // Lane i of each 32-bit group holds bytes [b1, b0, b2, b1] of its 3-byte source group, from
+        // which the two multiplies shift each of the four 6-bit fields into a byte of its own.
+        auto const in =
+            _mm_shuffle_epi8(bytes, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        auto const ac =
+            _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        auto const bd =
+            _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        return _mm_or_si128(ac, bd);
+    }
+
+    __attribute__((target("ssse3"))) __m128i encodeAscii(__m128i indices) noexcept
+    {
+        // Reduce each index to the number of its range (A-Z 13, a-z 0, 0-9 1..10, + 11, / 12), then
+        // look up the offset that range adds.
+        auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        auto const upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+        auto const offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+    }
+
+    /// The 6-bit values of 16 characters, and which of them are in the alphabet at all.
+    struct DecodedValues
+    {
+        __m128i values;
+        int validLanes; ///< One bit per character, as _mm_movemask_epi8 has it; 0xFFFF when all are.
+    };
+
+    __attribute__((target("ssse3"))) DecodedValues decodeValues(__m128i chars) noexcept
+    {
+        // Signed compares: bytes from 0x80 up are negative and so fall outside every range.
+        auto const within = [chars](char lo, char hi) {
+            return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                                 _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), chars));
+        };
+        auto const upper = within('A', 'Z');
+        auto const lower = within('a', 'z');
+        auto const digit = within('0', '9');
+        auto const plus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+        auto const slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+
+        auto const valid =
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+
+        auto offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+        offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        offset = _mm_or_si128(offset, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+        offset = _mm_or_si128(offset, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+        return DecodedValues { .values = _mm_add_epi8(chars, offset),
+                               .validLanes = _mm_movemask_epi8(valid) };
+    }
+
+    /// Packs the 6-bit values of each group of four into its three bytes, in the low 12 bytes.
+    __attribute__((target("ssse3"))) __m128i decodePack(__m128i values) noexcept
+    {
+        auto const pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        auto const groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        return _mm_shuffle_epi8(groups,
+                                _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    }
+
+    __attribute__((target("ssse3"))) size_t encodeSSSE3(uint8_t const* input,
+                                                        size_t size,
+                                                        char* output) noexcept
+    {
+        // 12 bytes are encoded per block, but 16 are loaded.
+        auto const blocks = size < 16 ? size_t { 0 } : (size - 16) / 12 + 1;
+        for (auto const block: std::views::iota(size_t { 0 }, blocks))
+        {
+            auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + block * 12));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + block * 16),
+                             encodeAscii(encodeIndices(bytes)));
+        }
+        return blocks * 12;
+    }
+
+    __attribute__((target("ssse3"))) size_t decodeSSSE3(char const* input,
+                                                        size_t size,
+                                                        uint8_t* output) noexcept
+    {
+        auto const blocks = size / 16;
+        for (auto const block: std::views::iota(size_t { 0 }, blocks))
+        {
+            auto const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + block * 16));
+            auto const decoded = decodeValues(chars);
+            if (decoded.validLanes != 0xFFFF)
+                return block * 16;
+            // The caller's buffer may end right after these 12 bytes.
+            auto* const out = output + block * 12;
+            auto const packed = decodePack(decoded.values);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+            auto const tail = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+            std::memcpy(out + 8, &tail, sizeof(tail));
+        }
+        return blocks * 16;
+    }
+    // }}}
+
+    // {{{ AVX2
+    // For each low nibble, the high nibbles (as bits 2 to 7) that complete it to a character of the
+    // alphabet: '0'..'9' are 0x3?, 'A'..'O' 0x4?, 'P'..'Z' 0x5?, 'a'..'o' 0x6?, 'p'..'z' 0x7?, and
+    // '+' and '/' are 0x2B and 0x2F.
+    constexpr char A8 = static_cast<char>(0b1010'1000);
+    constexpr char F8 = static_cast<char>(0b1111'1000);
+    constexpr char F0 = static_cast<char>(0b1111'0000);
+    constexpr char S4 = static_cast<char>(0b0101'0100);
+    constexpr char S0 = static_cast<char>(0b0101'0000);
+
+    __attribute__((target("avx2"))) size_t encodeAVX2(uint8_t const* input,
+                                                      size_t size,
+                                                      char* output) noexcept
+    {
+        // 24 bytes are encoded per block, but 28 are loaded.
+        auto const blocks = size < 28 ? size_t { 0 } : (size - 28) / 24 + 1;
+        for (auto const block: std::views::iota(size_t { 0 }, blocks))
+        {
+            // One 3-byte-group aligned half per 128-bit lane, the same per-lane shuffle as SSSE3.
+            auto const* const bytes = input + block * 24;
+            auto const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+            auto const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + 12));
+            auto const in = _mm256_shuffle_epi8(
+                _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1),
+                _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+            auto const ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                               _mm256_set1_epi32(0x04000040));
+            auto const bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                               _mm256_set1_epi32(0x01000010));
+            auto const indices = _mm256_or_si256(ac, bd);
+
+            auto range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            auto const upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+            range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+            auto const offsets = _mm256_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            auto const ascii = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + block * 32), ascii);
+        }
+        auto const consumed = blocks * 24;
+        return consumed + encodeSSSE3(input + consumed, size - consumed, output + blocks * 32);
+    }
+
+    __attribute__((target("avx2"))) size_t decodeAVX2(char const* input,
+                                                      size_t size,
+                                                      uint8_t* output) noexcept
+    {
+        // The SSSE3 kernel takes over from the first block holding a character outside the alphabet,
+        // and stops at that character itself.
+        auto const rest = [&](size_t block) {
+            return block * 32 + decodeSSSE3(input + block * 32, size - block * 32, output + block * 24);
+        };
+
+        auto const blocks = size / 32;
+        for (auto const block: std::views::iota(size_t { 0 }, blocks))
+        {
+            // Each character's high nibble picks its range's offset and a bit, its low nibble the set
+            // of high nibbles that make it part of the alphabet. '/' is the one range of one.
+            auto const chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + block * 32));
+            auto const hi = _mm256_and_si256(_mm256_srli_epi32(chars, 4), _mm256_set1_epi8(0x0F));
+            auto const lo = _mm256_and_si256(chars, _mm256_set1_epi8(0x0F));
+            auto const allowed = _mm256_shuffle_epi8(
+                _mm256_setr_epi8(A8, F8, F8, F8, F8, F8, F8, F8, F8, F8, F0, S4, S0, S0, S0, S4,
+                                 A8, F8, F8, F8, F8, F8, F8, F8, F8, F8, F0, S4, S0, S0, S0, S4),
+                lo);
+            auto const bit = _mm256_shuffle_epi8(
+                _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                 1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0),
+                hi);
+            auto const invalid = _mm256_cmpeq_epi8(_mm256_and_si256(allowed, bit), _mm256_setzero_si256());
+            if (_mm256_movemask_epi8(invalid) != 0)
+                return rest(block);
+
+            auto const offset = _mm256_blendv_epi8(
+                _mm256_shuffle_epi8(_mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                     0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                                    hi),
+                _mm256_set1_epi8(63 - '/'),
+                _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')));
+            auto const values = _mm256_add_epi8(chars, offset);
+
+            auto const pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            auto const groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+            auto const lanes = _mm256_shuffle_epi8(
+                groups,
+                _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            // Close the gap between the lanes' 12 bytes each, then store exactly 24.
+            auto const packed = _mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+            auto* const out = output + block * 24;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(packed, 1));
+        }
+        return rest(blocks);
+    }
+    // }}}
+
+    size_t encodeScalar(uint8_t const*, size_t, char*) noexcept
+    {
+        return 0;
+    }
+
+    size_t decodeScalar(char const*, size_t, uint8_t*) noexcept
+    {
+        return 0;
+    }
+
+    struct Kernels
+    {
+        size_t (*encode)(uint8_t const*, size_t, char*) noexcept;
+        size_t (*decode)(char const*, size_t, uint8_t*) noexcept;
+    };
+
+    Kernels const& kernels() noexcept
+    {
+        static auto const selected = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return Kernels { .encode = encodeAVX2, .decode = decodeAVX2 };
+            if (__builtin_cpu_supports("ssse3"))
+                return Kernels { .encode = encodeSSSE3, .decode = decodeSSSE3 };
+            return Kernels { .encode = encodeScalar, .decode = decodeScalar };
+        }();
+        return selected;
+    }
+} // namespace
+
+size_t encodeBlocks(uint8_t const* input, size_t size, char* output) noexcept
+{
+    return kernels().encode(input, size, output);
+}
+
+size_t decodeBlocks(char const* input, size_t size, uint8_t* output) noexcept
+{
+    return kernels().decode(input, size, output);
+}
+
+#else
+
+size_t encodeBlocks(uint8_t const*, size_t, char*) noexcept
+{
+    return 0;
+}
+
+size_t decodeBlocks(char const*, size_t, uint8_t*) noexcept
+{
+    return 0;
+}
+
+#endif
+
+} // namespace crispy::base64::detail
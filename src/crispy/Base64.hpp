@@ -2,9 +2,14 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace crispy::base64
 {
@@ -45,6 +50,21 @@ namespace detail
             s += c;
         return s;
     }
+
+    /// Vectorized encoding of the longest prefix of @p input that fills whole blocks, picked for the
+    /// CPU at run time (@see Base64.cpp). Consumes a multiple of 3 bytes, writing 4 characters per 3,
+    /// and returns the number of bytes consumed; the rest is left to the scalar code.
+    size_t encodeBlocks(uint8_t const* input, size_t size, char* output) noexcept;
+
+    /// Vectorized decoding of the longest prefix of @p input that fills whole blocks with characters
+    /// of the alphabet, stopping short of the first block holding anything else -- padding included,
+    /// so every edge case stays with the scalar code. Consumes a multiple of 4 characters, writing
+    /// exactly 3 bytes per 4, and returns the number of characters consumed.
+    size_t decodeBlocks(char const* input, size_t size, uint8_t* output) noexcept;
+
+    template <typename Iterator>
+    constexpr bool IsByteSpan =
+        std::contiguous_iterator<Iterator> && sizeof(std::iter_value_t<Iterator>) == 1;
 } // namespace detail
 
 struct EncoderState
@@ -135,7 +155,28 @@ std::string encode(Iterator begin, Iterator end, Alphabet alphabet)
 template <typename Iterator>
 std::string encode(Iterator begin, Iterator end)
 {
-    return encode(begin, end, detail::Base64Alphabet);
+    if constexpr (detail::IsByteSpan<Iterator>)
+    {
+        auto const size = static_cast<size_t>(std::distance(begin, end));
+        auto const* input = reinterpret_cast<uint8_t const*>(std::to_address(begin));
+        auto output = std::string((size + 2) / 3 * 4, '\0');
+
+        auto const consumed = detail::encodeBlocks(input, size, output.data());
+        auto* out = output.data() + (consumed / 3 * 4);
+        auto const flusher = [&out](char a, char b, char c, char d) {
+            *out++ = a;
+            *out++ = b;
+            *out++ = c;
+            *out++ = d;
+        };
+        auto state = EncoderState {};
+        for (auto const i: std::views::iota(consumed, size))
+            encode(input[i], state, flusher);
+        finish(state, flusher);
+        return output;
+    }
+    else
+        return encode(begin, end, detail::Base64Alphabet);
 }
 
 inline std::string encode(std::string_view value)
@@ -224,7 +265,20 @@ size_t decode(Iterator begin, Iterator end, IndexTable const& indexmap, Output o
 template <typename Iterator, typename Output>
 size_t decode(Iterator begin, Iterator end, Output output)
 {
-    return decode(begin, end, detail::IndexMap, output);
+    if constexpr (detail::IsByteSpan<Iterator> && detail::IsByteSpan<Output>)
+    {
+        auto const consumed = detail::decodeBlocks(reinterpret_cast<char const*>(std::to_address(begin)),
+                                                   static_cast<size_t>(std::distance(begin, end)),
+                                                   reinterpret_cast<uint8_t*>(std::to_address(output)));
+        auto const produced = consumed / 4 * 3;
+        return produced
+               + decode(begin + static_cast<std::iter_difference_t<Iterator>>(consumed),
+                        end,
+                        detail::IndexMap,
+                        output + static_cast<std::iter_difference_t<Output>>(produced));
+    }
+    else
+        return decode(begin, end, detail::IndexMap, output);
 }
 
 template <typename Output>
@@ -235,10 +289,104 @@ size_t decode(std::string_view input, Output output)
 
 inline std::string decode(std::string_view input)
 {
+    // Sized for the whole input rather than by decodeLength(), whose scalar scan for the end of the
+    // text would cost more than the vectorized decode itself.
     std::string output;
-    output.resize(decodeLength(input));
+    output.resize((input.size() + 3) / 4 * 3);
     output.resize(decode(input, output.data()));
     return output;
 }
 
+/// The part of a 4-character group a streaming decode() has seen but not yet emitted.
+struct DecoderState
+{
+    uint8_t modulo = 0;
+    uint8_t pending[3] {};
+};
+
+namespace detail
+{
+    /// Emits the bytes a partial group of @p state holds and starts a new group.
+    template <typename T>
+    constexpr T* flush(DecoderState& state, T* out) noexcept
+    {
+        auto const* input = state.pending;
+        if (state.modulo >= 2)
+            *out++ = static_cast<T>(input[0] << 2 | input[1] >> 4);
+        if (state.modulo == 3)
+            *out++ = static_cast<T>(input[1] << 4 | input[2] >> 2);
+        state.modulo = 0;
+        return out;
+    }
+} // namespace detail
+
+/// Decodes @p input as the continuation of everything decoded through @p state so far, appending the
+/// bytes to @p output.
+///
+/// A group split across two calls is carried over in @p state, so a stream arriving in chunks decodes
+/// into its destination as it arrives, without the whole text ever being held. Padding ends a group, so
+/// chunks padded each on their own decode as they would one by one. Any other character outside the
+/// alphabet is skipped. Call finish() once the stream has ended.
+/// @param input The next part of the text.
+/// @param state The decoder's state between calls.
+/// @param output A contiguous container of bytes (std::string, std::vector<uint8_t>) to append to.
+template <typename Container>
+void decode(std::string_view input, DecoderState& state, Container& output)
+{
+    using T = typename Container::value_type;
+
+    auto const start = output.size();
+    output.resize(start + ((state.modulo + input.size()) / 4 * 3) + 3);
+    auto* const begin = output.data() + start;
+    auto* out = begin;
+
+    while (!input.empty())
+    {
+        // Whole groups of the alphabet go through the vectorized kernel whenever a group starts here.
+        if (state.modulo == 0 && input.size() >= 16)
+        {
+            auto const consumed =
+                detail::decodeBlocks(input.data(), input.size(), reinterpret_cast<uint8_t*>(out));
+            out += consumed / 4 * 3;
+            input.remove_prefix(consumed);
+            if (input.empty())
+                break;
+        }
+
+        auto const ch = input.front();
+        input.remove_prefix(1);
+        auto const value = detail::IndexMap[static_cast<uint8_t>(ch)];
+        if (value > 63)
+        {
+            if (ch == '=')
+                out = detail::flush(state, out);
+            continue;
+        }
+        if (state.modulo < 3)
+        {
+            state.pending[state.modulo++] = value;
+            continue;
+        }
+
+        auto const* group = state.pending;
+        *out++ = static_cast<T>(group[0] << 2 | group[1] >> 4);
+        *out++ = static_cast<T>(group[1] << 4 | group[2] >> 2);
+        *out++ = static_cast<T>(group[2] << 6 | value);
+        state.modulo = 0;
+    }
+
+    output.resize(start + static_cast<size_t>(out - begin));
+}
+
+/// Emits whatever a stream decoded through @p state ended in the middle of a group with, for a
+/// stream that was not padded.
+template <typename Container>
+void finish(DecoderState& state, Container& output)
+{
+    auto const start = output.size();
+    output.resize(start + 2);
+    auto* const end = detail::flush(state, output.data() + start);
+    output.resize(static_cast<size_t>(end - output.data()));
+}
+
 } // namespace crispy::base64
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/Base64.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <ranges>
+#include <string>
+#include <string_view>
+
+using namespace crispy;
+
+// Throughput of the base64 codec on image-sized payloads, with the scalar code as the yardstick the
+// vectorized kernels are measured against. Compare two runs with scripts/compare-benchmarks.py.
+
+namespace
+{
+
+/// A 1 MiB pixmap's worth of bytes that do not repeat with any period a kernel could exploit.
+std::string makePayload()
+{
+    auto bytes = std::string(1024 * 1024, '\0');
+    auto state = uint32_t { 0x12345678 };
+    for (auto& ch: bytes)
+    {
+        state = state * 1664525 + 1013904223;
+        ch = static_cast<char>(state >> 24);
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST_CASE("base64.encode", "[!benchmark][base64]")
+{
+    auto const bytes = makePayload();
+
+    BENCHMARK("1 MiB")
+    {
+        return base64::encode(bytes);
+    };
+
+    BENCHMARK("1 MiB, scalar")
+    {
+        return base64::encode(bytes.begin(), bytes.end(), base64::detail::Base64Alphabet);
+    };
+}
+
+TEST_CASE("base64.decode", "[!benchmark][base64]")
+{
+    auto const encoded = base64::encode(makePayload());
+
+    BENCHMARK("1 MiB")
+    {
+        return base64::decode(encoded);
+    };
+
+    BENCHMARK_ADVANCED("1 MiB, scalar")(Catch::Benchmark::Chronometer meter)
+    {
+        auto output = std::string(encoded.size(), '\0');
+        meter.measure([&] {
+            return base64::decode(encoded.begin(), encoded.end(), base64::detail::IndexMap, output.data());
+        });
+    };
+
+    // As a chunked kitty graphics transmission delivers it.
+    BENCHMARK_ADVANCED("1 MiB, streamed in 4 KiB chunks")(Catch::Benchmark::Chronometer meter)
+    {
+        auto output = std::string {};
+        output.reserve(encoded.size());
+        meter.measure([&] {
+            output.clear();
+            auto state = base64::DecoderState {};
+            for (auto const chunk: std::views::iota(size_t { 0 }, (encoded.size() + 4095) / 4096))
+                base64::decode(std::string_view(encoded).substr(chunk * 4096, 4096), state, output);
+            base64::finish(state, output);
+            return output.size();
+        });
+    };
+}
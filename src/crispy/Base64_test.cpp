@@ -1,14 +1,35 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <crispy/Base64.hpp>
+#include <crispy/Escape.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <random>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <vector>
 
 using namespace crispy;
 
+namespace
+{
+
+// The scalar codec, bypassing the vectorized kernels: the reference the fast paths must agree with.
+std::string scalarEncode(std::string_view input)
+{
+    return base64::encode(input.begin(), input.end(), base64::detail::Base64Alphabet);
+}
+
+std::string scalarDecode(std::string_view input)
+{
+    auto output = std::string(input.size(), '\0');
+    output.resize(base64::decode(input.begin(), input.end(), base64::detail::IndexMap, output.data()));
+    return output;
+}
+
+} // namespace
+
 // Helper: encode a string using the streaming (byte-at-a-time) API.
 static std::string streamingEncode(std::string_view input)
 {
@@ -88,3 +109,109 @@ TEST_CASE("base64.streaming_encode_binary_roundtrip", "[base64]")
     auto const decoded = base64::decode(encoded);
     CHECK(decoded == binary);
 }
+
+TEST_CASE("base64.streaming_decode_matches_batch_at_every_split", "[base64]")
+{
+    auto binary = std::string {};
+    for (auto const i: std::views::iota(0, 256))
+        binary += static_cast<char>(i);
+
+    for (auto const* input: { "a", "ab", "abc", "abcd", "foo:bar", "Hello, World!" })
+    {
+        auto const encoded = base64::encode(std::string_view(input));
+        for (auto const split: std::views::iota(size_t { 0 }, encoded.size() + 1))
+        {
+            auto output = std::string {};
+            auto state = base64::DecoderState {};
+            base64::decode(std::string_view(encoded).substr(0, split), state, output);
+            base64::decode(std::string_view(encoded).substr(split), state, output);
+            base64::finish(state, output);
+            CHECK(output == input);
+        }
+    }
+
+    // Unpadded, into a byte vector, one character at a time.
+    auto const encoded = base64::encode(binary);
+    auto output = std::vector<uint8_t> {};
+    auto state = base64::DecoderState {};
+    for (auto const ch: std::string_view(encoded).substr(0, encoded.find('=')))
+        base64::decode(std::string_view(&ch, 1), state, output);
+    base64::finish(state, output);
+    CHECK(std::string(output.begin(), output.end()) == binary);
+}
+
+TEST_CASE("base64.streaming_decode_takes_chunks_padded_on_their_own", "[base64]")
+{
+    auto output = std::string {};
+    auto state = base64::DecoderState {};
+    for (auto const* chunk: { "YQ==", "Yg==", "YWI=", "\nYWJj" })
+        base64::decode(chunk, state, output);
+    base64::finish(state, output);
+    CHECK(output == "abababc");
+}
+
+TEST_CASE("base64.vectorized_codec_matches_scalar", "[base64]")
+{
+    // Lengths around every block size and its multiples, each with a fresh random payload, and the
+    // encoded text then damaged at a random place, so that the kernels must stop exactly where the
+    // scalar decoder would.
+    auto rng = std::mt19937 { 0xB64 }; // NOLINT(cert-msc32-c,cert-msc51-cpp): reproducible on purpose
+    auto byte = std::uniform_int_distribution<int> { 0, 255 };
+    auto const damage = std::string_view { "=\n \x80\xFF-_.\0", 9 };
+
+    for (auto const size: std::views::iota(size_t { 0 }, size_t { 201 }))
+    {
+        for ([[maybe_unused]] auto const round: std::views::iota(0, 4))
+        {
+            auto bytes = std::string(size, '\0');
+            for (auto& ch: bytes)
+                ch = static_cast<char>(byte(rng));
+
+            auto const encoded = base64::encode(bytes);
+            REQUIRE(encoded == scalarEncode(bytes));
+            REQUIRE(base64::decode(encoded) == bytes);
+            REQUIRE(base64::decode(encoded) == scalarDecode(encoded));
+
+            if (encoded.empty())
+                continue;
+            auto damaged = encoded;
+            damaged[static_cast<size_t>(byte(rng)) % damaged.size()] =
+                damage[static_cast<size_t>(byte(rng)) % damage.size()];
+            INFO(crispy::escape(damaged));
+            auto batch = std::string(damaged.size(), '\0');
+            batch.resize(base64::decode(std::string_view(damaged), batch.data()));
+            CHECK(batch == scalarDecode(damaged));
+
+            // One call, and one character per call, where the kernels never get a whole block.
+            auto streamed = std::string {};
+            auto state = base64::DecoderState {};
+            base64::decode(damaged, state, streamed);
+            base64::finish(state, streamed);
+            auto trickled = std::string {};
+            state = {};
+            for (auto const ch: damaged)
+                base64::decode(std::string_view(&ch, 1), state, trickled);
+            base64::finish(state, trickled);
+            CHECK(streamed == trickled);
+        }
+    }
+}
+
+TEST_CASE("base64.vectorized_decode_tells_every_byte_apart", "[base64]")
+{
+    // Each byte value at each position of two AVX2 blocks: the kernels must accept exactly the
+    // alphabet, wherever in a block the odd one out sits.
+    auto const valid = base64::encode(std::string(48, '\x5A'));
+    REQUIRE(valid.size() == 64);
+    for (auto const value: std::views::iota(0, 256))
+    {
+        for (auto const position: std::views::iota(size_t { 0 }, valid.size()))
+        {
+            auto text = valid;
+            text[position] = static_cast<char>(value);
+            auto output = std::string(text.size(), '\0');
+            output.resize(base64::decode(std::string_view(text), output.data()));
+            CHECK(output == scalarDecode(text));
+        }
+    }
+}
@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/TraceEvents.hpp>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using std::chrono::steady_clock;
+
+namespace crispy::trace
+{
+
+namespace
+{
+    struct Event
+    {
+        char const* category;
+        char const* name;
+        steady_clock::time_point start;
+        steady_clock::duration duration;
+        char const* argumentName;
+        std::int64_t argumentValue;
+    };
+
+    /// Hands out Recorder::_id.
+    std::atomic<std::uint64_t> nextRecorderId = 1;
+} // namespace
+
+struct Recorder::ThreadBuffer
+{
+    /// Only ever contended by toJson() and start(): the thread itself is the only writer.
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::string name;
+    std::uint64_t id = 0;
+    std::size_t dropped = 0;
+};
+
+namespace
+{
+    /// Appends @p text as the body of a JSON string.
+    void appendEscaped(std::string& out, std::string_view text)
+    {
+        for (auto const ch: text)
+        {
+            if (ch == '"' || ch == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(ch) < 0x20)
+                std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(ch));
+            else
+                out += ch;
+        }
+    }
+
+    double microsecondsBetween(steady_clock::time_point from, steady_clock::time_point to)
+    {
+        return std::chrono::duration<double, std::micro>(to - from).count();
+    }
+} // namespace
+
+Recorder::Recorder(std::string label):
+    _id { nextRecorderId.fetch_add(1, std::memory_order_relaxed) }, _label { std::move(label) }
+{
+}
+
+Recorder::~Recorder() = default;
+
+namespace
+{
+    /// What setThreadName() last named the calling thread; buffers it creates later start out so.
+    thread_local auto currentThreadName = std::string {};
+} // namespace
+
+struct Recorder::CachedBuffer
+{
+    std::uint64_t recorder;
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+std::vector<Recorder::CachedBuffer>& Recorder::threadCache()
+{
+    // Usually one entry per session the thread works for. A buffer only its thread still holds
+    // belongs to a recorder that is gone.
+    thread_local auto cache = std::vector<CachedBuffer> {};
+    return cache;
+}
+
+Recorder::ThreadBuffer& Recorder::threadBuffer()
+{
+    auto& cache = threadCache();
+    for (auto const& cached: cache)
+        if (cached.recorder == _id)
+            return *cached.buffer;
+
+    std::erase_if(cache, [](auto const& cached) { return cached.buffer.use_count() == 1; });
+
+    auto created = std::make_shared<ThreadBuffer>();
+    {
+        auto const l = std::scoped_lock { _mutex };
+        created->id = _nextThreadId++;
+        created->name = currentThreadName.empty() ? std::format("thread {}", created->id) : currentThreadName;
+        _threads.emplace_back(created);
+    }
+    return *cache.emplace_back(CachedBuffer { .recorder = _id, .buffer = std::move(created) }).buffer;
+}
+
+void Recorder::complete(char const* category,
+                        char const* name,
+                        steady_clock::time_point start,
+                        char const* argumentName,
+                        std::int64_t argumentValue)
+{
+    auto const duration = steady_clock::now() - start;
+    auto& buffer = threadBuffer();
+    auto const l = std::scoped_lock { buffer.mutex };
+    if (buffer.events.size() >= MaxEventsPerThread)
+    {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.events.emplace_back(Event { .category = category,
+                                       .name = name,
+                                       .start = start,
+                                       .duration = duration,
+                                       .argumentName = argumentName,
+                                       .argumentValue = argumentValue });
+}
+
+void Recorder::start()
+{
+    auto const l = std::scoped_lock { _mutex };
+    // A buffer nobody else holds belongs to a thread that has exited; a new recording has no use for it.
+    std::erase_if(_threads, [](auto const& buffer) { return buffer.use_count() == 1; });
+    for (auto const& buffer: _threads)
+    {
+        auto const bl = std::scoped_lock { buffer->mutex };
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+    _epoch = steady_clock::now();
+    _recording = true;
+}
+
+void Recorder::stop()
+{
+    _recording = false;
+}
+
+void setThreadName(std::string name)
+{
+    for (auto const& cached: Recorder::threadCache())
+    {
+        auto const l = std::scoped_lock { cached.buffer->mutex };
+        cached.buffer->name = name;
+    }
+    currentThreadName = std::move(name);
+}
+
+void Recorder::appendEvents(std::string& out, int pid, steady_clock::time_point origin) const
+{
+    auto const l = std::scoped_lock { _mutex };
+
+    if (!out.ends_with('['))
+        out += ',';
+    std::format_to(std::back_inserter(out), R"({{"name":"process_name","ph":"M","pid":{},"tid":0,)", pid);
+    out += R"("args":{"name":")";
+    appendEscaped(out, _label);
+    out += R"("}})";
+
+    for (auto const& buffer: _threads)
+    {
+        auto const bl = std::scoped_lock { buffer->mutex };
+
+        std::format_to(std::back_inserter(out),
+                       R"(,{{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":")",
+                       pid,
+                       buffer->id);
+        appendEscaped(out, buffer->name);
+        out += R"("}})";
+
+        for (auto const& event: buffer->events)
+        {
+            // A scope opened during an earlier recording may have closed during this one.
+            if (event.start < _epoch)
+                continue;
+            std::format_to(std::back_inserter(out),
+                           R"(,{{"name":"{}","cat":"{}","ph":"X","pid":{},"tid":{},"ts":{:.3f},"dur":{:.3f})",
+                           event.name,
+                           event.category,
+                           pid,
+                           buffer->id,
+                           microsecondsBetween(origin, event.start),
+                           std::chrono::duration<double, std::micro>(event.duration).count());
+            if (event.argumentName)
+                std::format_to(std::back_inserter(out),
+                               R"(,"args":{{"{}":{}}})",
+                               event.argumentName,
+                               event.argumentValue);
+            out += '}';
+        }
+
+        if (buffer->dropped != 0)
+            std::format_to(std::back_inserter(out),
+                           R"(,{{"name":"events dropped","ph":"i","s":"t","pid":{},"tid":{},"ts":{:.3f},)"
+                           R"("args":{{"count":{}}}}})",
+                           pid,
+                           buffer->id,
+                           microsecondsBetween(origin, _epoch),
+                           buffer->dropped);
+    }
+}
+
+std::string Recorder::toJson() const
+{
+    auto const self = this;
+    return trace::toJson(std::span { &self, 1 });
+}
+
+std::expected<void, std::string> Recorder::writeJson(std::filesystem::path const& path) const
+{
+    auto ec = std::error_code {};
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+    auto file = std::ofstream { path, std::ios::out | std::ios::binary | std::ios::trunc };
+    if (!file)
+        return std::unexpected { std::format("Cannot open {} for writing.", path.string()) };
+    file << toJson();
+    if (!file)
+        return std::unexpected { std::format("Failed writing {}.", path.string()) };
+    return {};
+}
+
+std::string toJson(std::span<Recorder const* const> recorders)
+{
+    // Each recorder's events are timed from its own start(); shifting them onto the earliest puts
+    // the sessions of one dump on one time line.
+    auto origin = steady_clock::time_point::max();
+    for (auto const* recorder: recorders)
+    {
+        auto const l = std::scoped_lock { recorder->_mutex };
+        origin = std::min(origin, recorder->_epoch);
+    }
+
+    auto out = std::string { R"({"displayTimeUnit":"ms","traceEvents":[)" };
+    auto pid = 0;
+    for (auto const* recorder: recorders)
+        recorder->appendEvents(out, ++pid, origin);
+    out += "]}";
+    return out;
+}
+
+std::filesystem::path sessionTracePath(std::filesystem::path const& base, std::uint64_t session)
+{
+    auto path = base;
+    path.replace_filename(
+        std::format("{}-session-{}{}", base.stem().string(), session, base.extension().string()));
+    return path;
+}
+
+} // namespace crispy::trace
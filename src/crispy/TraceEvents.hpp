@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// Records the frame pipeline as Chrome trace events, for chrome://tracing and ui.perfetto.dev.
+///
+/// "The terminal felt slow" used to mean rebuilding with a profiler attached and hoping to reproduce it.
+/// Each session owns a Recorder, and the stages of its pipeline open a trace::Scope on it, which costs
+/// a null test and one relaxed load while nothing is being recorded; while something is, each scope
+/// appends one complete ("X") event to a buffer owned by its thread, so the PTY, render and GUI threads
+/// never contend with each other to record.
+///
+/// Event names and categories are stored by pointer and must be string literals.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace crispy::trace
+{
+
+/// At most this many events are kept per thread and recording; later ones are counted, not kept.
+inline constexpr auto MaxEventsPerThread = std::size_t { 1 } << 20;
+
+/// Collects the trace events of one session's pipeline while recording.
+///
+/// Owned by the session -- the GUI's, or the daemon's hosted one -- and handed to every component of
+/// its pipeline that opens a Scope, so that recording one session leaves the others untraced and out
+/// of its dump. A component handed nullptr records nothing, which is what tests and tools that never
+/// trace do.
+class Recorder
+{
+  public:
+    /// @param label Names the recording in the dump, e.g. after its session.
+    explicit Recorder(std::string label = "contour");
+    ~Recorder();
+
+    Recorder(Recorder const&) = delete;
+    Recorder& operator=(Recorder const&) = delete;
+    Recorder(Recorder&&) = delete;
+    Recorder& operator=(Recorder&&) = delete;
+
+    /// @return Whether events are being recorded.
+    [[nodiscard]] bool isRecording() const noexcept { return _recording.load(std::memory_order_relaxed); }
+
+    /// Discards whatever an earlier recording collected and starts recording.
+    void start();
+
+    /// Stops recording; the events collected so far are kept for toJson().
+    void stop();
+
+    /// @return Every event recorded, in the Chrome trace-event JSON object format.
+    [[nodiscard]] std::string toJson() const;
+
+    /// Writes toJson() to @p path, creating its directory if need be.
+    /// @return Nothing once written; why not otherwise.
+    [[nodiscard]] std::expected<void, std::string> writeJson(std::filesystem::path const& path) const;
+
+    /// Appends one complete event on the calling thread's buffer. Scope's destructor calls this.
+    void complete(char const* category,
+                  char const* name,
+                  std::chrono::steady_clock::time_point start,
+                  char const* argumentName,
+                  std::int64_t argumentValue);
+
+  private:
+    struct ThreadBuffer;
+    struct CachedBuffer;
+
+    friend void setThreadName(std::string name);
+    friend std::string toJson(std::span<Recorder const* const> recorders);
+
+    /// The buffers of every recorder the calling thread has recorded into.
+    static std::vector<CachedBuffer>& threadCache();
+
+    /// The calling thread's buffer for this recorder, registered on its first use.
+    ThreadBuffer& threadBuffer();
+
+    /// Appends this recorder's events as process @p pid, timed from @p origin.
+    void appendEvents(std::string& out, int pid, std::chrono::steady_clock::time_point origin) const;
+
+    /// Tells this recorder's buffers apart from another's in each thread's cache; never reused, so a
+    /// recorder built where an earlier one lived does not inherit its buffers.
+    std::uint64_t const _id;
+    std::string const _label;
+
+    std::atomic<bool> _recording = false;
+
+    mutable std::mutex _mutex;
+    /// Shared with the owning thread, so a thread that has exited still shows up in the dump.
+    std::vector<std::shared_ptr<ThreadBuffer>> _threads;
+    std::uint64_t _nextThreadId = 1;
+    std::chrono::steady_clock::time_point _epoch = std::chrono::steady_clock::now();
+};
+
+/// Names the calling thread in every recording it takes part in, e.g. after the session whose PTY
+/// it reads.
+void setThreadName(std::string name);
+
+/// @return The events of all of @p recorders in one Chrome trace-event JSON object, each recorder as
+///         a process of its own, on one time line.
+[[nodiscard]] std::string toJson(std::span<Recorder const* const> recorders);
+
+/// @return Where session @p session writes its trace when one file, @p base, was named for all of
+///         them: `trace.json` becomes `trace-session-3.json`.
+[[nodiscard]] std::filesystem::path sessionTracePath(std::filesystem::path const& base,
+                                                     std::uint64_t session);
+
+/// Records the lifetime of a scope as one trace event.
+class [[nodiscard]] Scope
+{
+  public:
+    /// @param recorder Where the event goes, or nullptr to record nothing. Must outlive the scope.
+    Scope(Recorder* recorder, char const* category, char const* name) noexcept:
+        _category { category }, _name { name }
+    {
+        if (recorder && recorder->isRecording())
+        {
+            _recorder = recorder;
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~Scope()
+    {
+        if (_recorder)
+            _recorder->complete(_category, _name, _start, _argumentName, _argumentValue);
+    }
+
+    /// Attaches one numeric argument to the event, such as the number of bytes a stage processed.
+    void setArgument(char const* name, std::int64_t value) noexcept
+    {
+        _argumentName = name;
+        _argumentValue = value;
+    }
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+  private:
+    Recorder* _recorder = nullptr; ///< Set only if it was recording when the scope opened.
+    char const* _category;
+    char const* _name;
+    char const* _argumentName = nullptr;
+    std::int64_t _argumentValue = 0;
+    std::chrono::steady_clock::time_point _start {};
+};
+
+} // namespace crispy::trace
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/TraceEvents.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <string>
+
+using namespace std::string_literals;
+
+TEST_CASE("TraceEvents.records_scopes_while_recording")
+{
+    auto recorder = crispy::trace::Recorder { "session 1" };
+    recorder.start();
+    crispy::trace::setThreadName("test \"main\"");
+    {
+        auto scope = crispy::trace::Scope { &recorder, "vt", "parseFragment" };
+        scope.setArgument("bytes", 4096);
+    }
+    recorder.stop();
+    {
+        // Not recorded: recording has stopped.
+        auto scope = crispy::trace::Scope { &recorder, "vt", "afterStop" };
+    }
+
+    auto const json = recorder.toJson();
+    CHECK(json.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+    CHECK(json.ends_with("]}"));
+    CHECK(json.find(R"("name":"parseFragment","cat":"vt","ph":"X")") != std::string::npos);
+    CHECK(json.find(R"("args":{"bytes":4096})") != std::string::npos);
+    CHECK(json.find(R"("args":{"name":"test \"main\""})") != std::string::npos);
+    CHECK(json.find(R"("args":{"name":"session 1"})") != std::string::npos);
+    CHECK(json.find("afterStop") == std::string::npos);
+}
+
+TEST_CASE("TraceEvents.start_discards_earlier_recording")
+{
+    auto recorder = crispy::trace::Recorder {};
+    recorder.start();
+    {
+        auto const scope = crispy::trace::Scope { &recorder, "render", "first" };
+    }
+    recorder.stop();
+    recorder.start();
+    {
+        auto const scope = crispy::trace::Scope { &recorder, "render", "second" };
+    }
+    recorder.stop();
+
+    auto const json = recorder.toJson();
+    CHECK(json.find(R"("name":"first")") == std::string::npos);
+    CHECK(json.find(R"("name":"second")") != std::string::npos);
+}
+
+TEST_CASE("TraceEvents.recorders_are_isolated")
+{
+    auto recording = crispy::trace::Recorder {};
+    auto idle = crispy::trace::Recorder {};
+    recording.start();
+    {
+        auto const scope = crispy::trace::Scope { &recording, "render", "kept" };
+        auto const ignored = crispy::trace::Scope { &idle, "render", "ignored" };
+        auto const untraced = crispy::trace::Scope { nullptr, "render", "untraced" };
+    }
+    recording.stop();
+
+    auto const json = recording.toJson();
+    CHECK(json.find(R"("name":"kept")") != std::string::npos);
+    CHECK(json.find("ignored") == std::string::npos);
+    CHECK(json.find("untraced") == std::string::npos);
+    CHECK(idle.toJson().find("kept") == std::string::npos);
+}
+
+TEST_CASE("TraceEvents.merges_recorders_as_processes")
+{
+    auto first = crispy::trace::Recorder { "session 1" };
+    auto second = crispy::trace::Recorder { "session 2" };
+    first.start();
+    second.start();
+    {
+        auto const scope = crispy::trace::Scope { &first, "pty", "one" };
+        auto const other = crispy::trace::Scope { &second, "pty", "two" };
+    }
+    first.stop();
+    second.stop();
+
+    auto const recorders = std::array<crispy::trace::Recorder const*, 2> { &first, &second };
+    auto const json = crispy::trace::toJson(recorders);
+    CHECK(json.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[{"name":"process_name")"));
+    CHECK(json.find(R"("pid":1,"tid":0,"args":{"name":"session 1"})") != std::string::npos);
+    CHECK(json.find(R"("pid":2,"tid":0,"args":{"name":"session 2"})") != std::string::npos);
+    CHECK(json.find(R"("name":"one","cat":"pty","ph":"X","pid":1)") != std::string::npos);
+    CHECK(json.find(R"("name":"two","cat":"pty","ph":"X","pid":2)") != std::string::npos);
+}
+
+TEST_CASE("TraceEvents.sessionTracePath")
+{
+    CHECK(crispy::trace::sessionTracePath("/tmp/trace.json", 3) == "/tmp/trace-session-3.json");
+    CHECK(crispy::trace::sessionTracePath("trace", 12) == "trace-session-12");
+}
@@ -139,7 +139,7 @@ coro::Task<std::expected<void, NetError>> AsyncBufferedReader::fill()
     co_return {};
 }
 
-coro::Task<IoResult> appendReadChunk(ISocket* socket, std::vector<std::byte>* buffer)
+coro::Task<IoResult> appendReadChunk(ISocket* socket, std::vector<std::byte>* buffer, int* fd)
 {
     // Straight into the buffer's tail. A local scratch array would be a COROUTINE-FRAME member, so
     // every read on this path — per client per input burst on the daemon, per delta on a client —
@@ -149,7 +149,16 @@ coro::Task<IoResult> appendReadChunk(ISocket* socket, std::vector<std::byte>* bu
     constexpr auto ChunkSize = std::size_t { 16384 };
     auto const offset = buffer->size();
     buffer->resize(offset + ChunkSize);
-    auto const n = co_await socket->read(std::span { buffer->data() + offset, ChunkSize });
+    auto const chunk = std::span { buffer->data() + offset, ChunkSize };
+    auto n = IoResult {};
+    if (fd != nullptr)
+    {
+        auto const received = co_await socket->readWithFd(chunk);
+        *fd = received.has_value() ? received->fd : -1;
+        n = received.has_value() ? IoResult { received->bytesRead } : std::unexpected(received.error());
+    }
+    else
+        n = co_await socket->read(chunk);
     // The tail is truncated on EVERY exit, error included: it holds nothing the caller may see.
     buffer->resize(offset + (n.has_value() ? *n : std::size_t { 0 }));
     if (!n.has_value())
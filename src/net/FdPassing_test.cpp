@@ -12,6 +12,7 @@
     #include <span>
     #include <string>
     #include <string_view>
+    #include <utility>
 
     #include <fcntl.h>
     #include <unistd.h>
@@ -21,6 +22,7 @@
     #include <net/PollEventSource.hpp>
     #include <net/Sockets.hpp>
     #include <net/SplitSocket.hpp>
+    #include <net/WriteQueue.hpp>
     #include <net/testing/InMemoryTransport.hpp>
 
 using coro::Task;
@@ -197,6 +199,95 @@ TEST_CASE("the default readWithFd never yields a descriptor", "[net][fdpass]")
     loop.blockOn(scenario(&loop, pair->first.get(), pair->second.get()));
 }
 
+TEST_CASE("writeWithFd sends bytes and a descriptor readWithFd receives", "[net][fdpass]")
+{
+    auto pair = Pair {};
+    auto peer = net::adoptFd(pair.loop, std::exchange(pair.theirs, -1));
+    REQUIRE(peer.has_value());
+    CHECK(pair.ours->passesDescriptors());
+
+    auto pipeFds = std::array<int, 2> { -1, -1 };
+    REQUIRE(::pipe(pipeFds.data()) == 0);
+    REQUIRE(::write(pipeFds[1], "thru", 4) == 4);
+
+    auto const payload = std::string_view { "hello" };
+    auto const wrote =
+        pair.loop.blockOn(pair.ours->writeWithFd(std::as_bytes(std::span { payload }), pipeFds[0]));
+    REQUIRE(wrote.has_value());
+    CHECK(*wrote == 5);
+    ::close(pipeFds[0]); // not consumed: the caller still owned it
+
+    auto buffer = std::array<std::byte, 64> {};
+    auto const result = pair.loop.blockOn((*peer)->readWithFd(buffer));
+    REQUIRE(result.has_value());
+    CHECK(result->bytesRead == 5);
+    REQUIRE(result->fd >= 0);
+    auto proof = std::array<char, 8> {};
+    CHECK(::read(result->fd, proof.data(), proof.size()) == 4);
+    CHECK(std::string_view(proof.data(), 4) == "thru");
+    ::close(result->fd);
+    ::close(pipeFds[1]);
+}
+
+TEST_CASE("a transport that cannot pass descriptors says so", "[net][fdpass]")
+{
+    auto source = net::PollEventSource {};
+    auto loop = net::EventLoop { source };
+
+    // Pipe halves, as a stdio transport has: bytes go through, descriptors cannot.
+    auto inbound = std::array<int, 2> { -1, -1 };
+    auto outbound = std::array<int, 2> { -1, -1 };
+    REQUIRE(::pipe(inbound.data()) == 0);
+    REQUIRE(::pipe(outbound.data()) == 0);
+    auto readHalf = net::adoptFd(loop, inbound[0]);
+    auto writeHalf = net::adoptFd(loop, outbound[1]);
+    REQUIRE(readHalf.has_value());
+    REQUIRE(writeHalf.has_value());
+    auto split = net::combineHalves(std::move(*readHalf), std::move(*writeHalf));
+    CHECK_FALSE(split->passesDescriptors());
+
+    auto const payload = std::string_view { "x" };
+    auto const wrote = loop.blockOn(split->writeWithFd(std::as_bytes(std::span { payload }), inbound[1]));
+    CHECK_FALSE(wrote.has_value());
+
+    split->close();
+    ::close(inbound[1]);
+    ::close(outbound[0]);
+}
+
+TEST_CASE("a queued descriptor travels with its frame", "[net][fdpass]")
+{
+    auto pair = Pair {};
+    auto peer = net::adoptFd(pair.loop, std::exchange(pair.theirs, -1));
+    REQUIRE(peer.has_value());
+    auto queue = net::WriteQueue { pair.loop, pair.ours.get(), 1024 };
+
+    auto pipeFds = std::array<int, 2> { -1, -1 };
+    REQUIRE(::pipe(pipeFds.data()) == 0);
+    REQUIRE(::write(pipeFds[1], "thru", 4) == 4);
+    REQUIRE(queue.enqueue("one", 0));
+    REQUIRE(queue.enqueueWithFd("two", pipeFds[0])); // the queue owns it from here
+
+    auto received = std::string {};
+    auto passed = -1;
+    while (received.size() < 6)
+    {
+        auto buffer = std::array<std::byte, 64> {};
+        auto const result = pair.loop.blockOn((*peer)->readWithFd(buffer));
+        REQUIRE(result.has_value());
+        REQUIRE(result->bytesRead > 0);
+        received.append(reinterpret_cast<char const*>(buffer.data()), result->bytesRead);
+        if (result->fd >= 0)
+            passed = result->fd;
+    }
+    CHECK(received == "onetwo");
+    REQUIRE(passed >= 0);
+    auto proof = std::array<char, 8> {};
+    CHECK(::read(passed, proof.data(), proof.size()) == 4);
+    ::close(passed);
+    ::close(pipeFds[1]);
+}
+
 TEST_CASE("a split socket reads one half and writes the other", "[net][fdpass]")
 {
     auto pair = Pair {};
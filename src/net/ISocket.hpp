@@ -72,6 +72,24 @@ class ISocket
     ///         success), or a @c NetError on failure.
     [[nodiscard]] virtual coro::Task<IoResult> write(std::span<std::byte const> buffer) = 0;
 
+    /// Writes like @c write but passes @p fd to the peer along with the FIRST
+    /// byte (SCM_RIGHTS), so a reader using @c readWithFd receives it no later
+    /// than that byte. Only where @c passesDescriptors() holds; the default
+    /// implementation fails with @c NetErrorCode::Unsupported.
+    /// @param buffer Source span, at least one byte; must outlive the returned task.
+    /// @param fd The descriptor to pass. Not consumed: the caller still owns it.
+    /// @return The byte count written, or a @c NetError on failure.
+    [[nodiscard]] virtual coro::Task<IoResult> writeWithFd(std::span<std::byte const> /*buffer*/,
+                                                           int /*fd*/)
+    {
+        co_return std::unexpected(
+            makeNetError(NetErrorCode::Unsupported, 0, "descriptor passing on this transport"));
+    }
+
+    /// @return Whether @c writeWithFd / @c readWithFd can carry a descriptor on
+    ///         this transport: a connected AF_UNIX socket on POSIX, and nothing else.
+    [[nodiscard]] virtual bool passesDescriptors() const noexcept { return false; }
+
     /// @return The remote peer's printable address ("127.0.0.1", "::1"), or "" if
     ///         unknown (e.g. the in-memory transport).
     [[nodiscard]] virtual std::string peerAddress() const { return {}; }
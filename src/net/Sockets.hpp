@@ -82,7 +82,11 @@ namespace net
 /// @param socket The transport to read from (not owned; a pointer, since
 ///        coroutine reference parameters can dangle).
 /// @param buffer Receives the read bytes.
+/// @param fd When not null, the chunk is read with @c ISocket::readWithFd and the descriptor
+///        that arrived with it (ownership passes to the caller), or -1, is stored here.
 /// @return The number of bytes appended, 0 on a clean EOF, or the transport error.
-[[nodiscard]] coro::Task<IoResult> appendReadChunk(ISocket* socket, std::vector<std::byte>* buffer);
+[[nodiscard]] coro::Task<IoResult> appendReadChunk(ISocket* socket,
+                                                   std::vector<std::byte>* buffer,
+                                                   int* fd = nullptr);
 
 } // namespace net
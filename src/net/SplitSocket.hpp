@@ -45,6 +45,18 @@ class SplitSocket final: public ISocket
         return _writeHalf->write(buffer);
     }
 
+    /// Forwards to the write half, for the same reason readWithFd forwards to the read half.
+    [[nodiscard]] coro::Task<IoResult> writeWithFd(std::span<std::byte const> buffer, int fd) override
+    {
+        return _writeHalf->writeWithFd(buffer, fd);
+    }
+
+    /// Only when both halves can: a descriptor is sent on one and received on the other.
+    [[nodiscard]] bool passesDescriptors() const noexcept override
+    {
+        return _readHalf->passesDescriptors() && _writeHalf->passesDescriptors();
+    }
+
     void close() noexcept override
     {
         _readHalf->close();
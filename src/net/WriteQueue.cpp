@@ -2,14 +2,55 @@
 #include <net/WriteQueue.hpp>
 
 #include <span>
+#include <tuple>
 #include <utility>
 
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
 #include <coro/Cancellation.hpp>
 
 namespace net
 {
 
+namespace
+{
+    /// Closes a descriptor the queue owns. None ever reaches it on Windows, where no transport
+    /// passes descriptors.
+    void closeDescriptor(int fd) noexcept
+    {
+#ifndef _WIN32
+        if (fd >= 0)
+            ::close(fd);
+#else
+        std::ignore = fd;
+#endif
+    }
+} // namespace
+
+void WriteQueue::State::discardQueued() noexcept
+{
+    for (auto const& pending: queue)
+        closeDescriptor(pending.fd);
+    queue.clear();
+    backlogBytes = 0;
+}
+
 bool WriteQueue::enqueue(std::string frame, uint64_t tag)
+{
+    return push(std::move(frame), tag, -1);
+}
+
+bool WriteQueue::enqueueWithFd(std::string frame, int fd)
+{
+    if (push(std::move(frame), 0, fd))
+        return true;
+    closeDescriptor(fd);
+    return false;
+}
+
+bool WriteQueue::push(std::string frame, uint64_t tag, int fd)
 {
     auto& state = *_state;
     if (state.closed || state.failure.has_value())
@@ -20,7 +61,7 @@ bool WriteQueue::enqueue(std::string frame, uint64_t tag)
         return false; // over bound: the caller applies its disconnect policy
 
     state.backlogBytes += frame.size();
-    state.queue.push_back(State::Pending { .frame = std::move(frame), .tag = tag });
+    state.queue.push_back(State::Pending { .frame = std::move(frame), .tag = tag, .fd = fd });
 
     if (!state.draining)
     {
@@ -46,8 +87,7 @@ std::size_t WriteQueue::dropTagged(uint64_t tag) noexcept
 void WriteQueue::close() noexcept
 {
     _state->closed = true;
-    _state->queue.clear();
-    _state->backlogBytes = 0;
+    _state->discardQueued();
     // Also zeroed here, not only in the drain: the drain may never resume to do it (loop
     // shutdown), and a stale count would misreport a dead queue.
     _state->inFlightBytes = 0;
@@ -79,19 +119,24 @@ coro::Task<void> WriteQueue::drain(std::shared_ptr<State> state)
             auto const bytes =
                 std::span<std::byte const> { reinterpret_cast<std::byte const*>(pending.frame.data()),
                                              pending.frame.size() };
-            auto const written = co_await state->socket->write(bytes);
+            auto written = IoResult {};
+            if (pending.fd >= 0)
+                written = co_await state->socket->writeWithFd(bytes, pending.fd);
+            else
+                written = co_await state->socket->write(bytes);
+            closeDescriptor(pending.fd); // the peer holds its own copy now, or never will
             state->inFlightBytes = 0;
             if (!written.has_value())
             {
                 state->failure = written.error();
-                state->queue.clear();
-                state->backlogBytes = 0;
+                state->discardQueued();
             }
         }
         catch (coro::OperationCancelled const&)
         {
             // Loop shutdown while parked on backpressure: stop draining; the
             // queue's owner is being torn down with the loop.
+            closeDescriptor(pending.fd);
             state->inFlightBytes = 0;
             break;
         }
@@ -72,6 +72,15 @@ class WriteQueue
     ///         A frame enqueued onto an empty backlog is always accepted.
     [[nodiscard]] bool enqueue(std::string frame, uint64_t tag = 0);
 
+    /// Queues @p frame like @ref enqueue, passing @p fd to the peer along with it
+    /// (@see ISocket::writeWithFd). Untagged: a descriptor is never superseded.
+    /// @param frame The bytes to send as one atomic unit (moved in; not empty).
+    /// @param fd The descriptor to pass. Ownership transfers to the queue, which
+    ///        closes it once written, or when the frame is discarded unwritten —
+    ///        refused ones included.
+    /// @return As for @ref enqueue.
+    [[nodiscard]] bool enqueueWithFd(std::string frame, int fd);
+
     /// Discards every unwritten frame carrying @p tag.
     ///
     /// For a producer whose next frame fully re-describes what the tagged ones said — a
@@ -143,12 +152,22 @@ class WriteQueue
             socket(socketArg), maxQueuedBytes(maxQueuedBytesArg)
         {
         }
+        ~State() { discardQueued(); }
+
+        State(State const&) = delete;
+        State& operator=(State const&) = delete;
+        State(State&&) = delete;
+        State& operator=(State&&) = delete;
+
+        /// Empties the backlog, closing the descriptors its frames still own.
+        void discardQueued() noexcept;
 
         /// One queued frame and the label that lets a later frame supersede it.
         struct Pending
         {
             std::string frame; ///< The bytes to write, as one atomic unit.
             uint64_t tag;      ///< @see WriteQueue::dropTagged. Zero can never be dropped.
+            int fd = -1;       ///< Passed along with the frame, then closed; -1 for none.
         };
 
         ISocket* socket;                 ///< The transport written to (not owned).
@@ -161,6 +180,9 @@ class WriteQueue
         std::optional<NetError> failure; ///< First write error; poisons the queue.
     };
 
+    /// The body of both enqueues. @see enqueue, enqueueWithFd.
+    [[nodiscard]] bool push(std::string frame, uint64_t tag, int fd);
+
     /// The single writer: pops and writes frames until the queue is empty, then
     /// finishes. enqueue() spawns a fresh drain for the next burst — the
     /// `draining` flag guarantees at most one drain exists at any moment.
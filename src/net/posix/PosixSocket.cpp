@@ -243,6 +243,65 @@ coro::Task<IoResult> PosixSocket::write(std::span<std::byte const> buffer)
     co_return total;
 }
 
+coro::Task<IoResult> PosixSocket::writeWithFd(std::span<std::byte const> buffer, int fd)
+{
+    while (true)
+    {
+        if (_closed || _fd < 0)
+            co_return std::unexpected(makeNetError(NetErrorCode::BadHandle, 0, "write on closed socket"));
+        if (_plainFd || buffer.empty())
+            co_return std::unexpected(
+                makeNetError(NetErrorCode::Unsupported, 0, "descriptor passing without a socket or payload"));
+
+        // The descriptor rides on the first sendmsg that moves any bytes; whatever that call left
+        // unwritten follows as an ordinary write.
+        auto iov = ::iovec { .iov_base = const_cast<std::byte*>(buffer.data()), .iov_len = buffer.size() };
+        alignas(::cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        auto msg = ::msghdr {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        auto* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+        auto const n = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            auto const sent = static_cast<std::size_t>(n);
+            if (sent == buffer.size())
+                co_return sent;
+            auto const rest = co_await write(buffer.subspan(sent));
+            if (!rest)
+                co_return std::unexpected(rest.error());
+            co_return sent + *rest;
+        }
+
+        auto const err = errno;
+        if (isWouldBlock(err))
+        {
+            co_await _loop.waitWritable(_fd);
+            continue;
+        }
+        if (err == EINTR)
+            continue;
+        co_return std::unexpected(fromErrno(err, "sendmsg"));
+    }
+}
+
+bool PosixSocket::passesDescriptors() const noexcept
+{
+    if (_closed || _fd < 0 || _plainFd)
+        return false;
+    auto address = ::sockaddr_storage {};
+    auto length = static_cast<::socklen_t>(sizeof(address));
+    return ::getsockname(_fd, reinterpret_cast<::sockaddr*>(&address), &length) == 0
+           && address.ss_family == AF_UNIX;
+}
+
 } // namespace net
 
 #endif // !_WIN32
@@ -37,6 +37,8 @@ class PosixSocket final: public ISocket
     [[nodiscard]] coro::Task<std::expected<ReadWithFd, NetError>> readWithFd(
         std::span<std::byte> buffer) override;
     [[nodiscard]] coro::Task<IoResult> write(std::span<std::byte const> buffer) override;
+    [[nodiscard]] coro::Task<IoResult> writeWithFd(std::span<std::byte const> buffer, int fd) override;
+    [[nodiscard]] bool passesDescriptors() const noexcept override;
 
     [[nodiscard]] std::string peerAddress() const override { return _peerAddress; }
 
@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/BenchWorkloads.hpp>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <iterator>
+#include <ranges>
+
+#include <libunicode/convert.h>
+
+namespace vtbackend
+{
+
+namespace
+{
+    unsigned uniform(std::mt19937& rng, unsigned low, unsigned high)
+    {
+        return std::uniform_int_distribution<unsigned> { low, high }(rng);
+    }
+
+    void appendCodepoints(std::string& out, std::u32string_view codepoints)
+    {
+        for (auto const codepoint: codepoints)
+            out += unicode::convert_to<char>(codepoint);
+    }
+
+    /// Appends @p count cells of lower-case words, as source code or a log would have them.
+    void appendText(std::string& out, std::mt19937& rng, unsigned count)
+    {
+        std::ranges::generate_n(std::back_inserter(out), count, [&] {
+            return uniform(rng, 0, 5) == 0 ? ' ' : static_cast<char>('a' + uniform(rng, 0, 25));
+        });
+    }
+
+    unsigned columnsOf(PageSize pageSize)
+    {
+        return unbox<unsigned>(pageSize.columns);
+    }
+
+    unsigned linesOf(PageSize pageSize)
+    {
+        return unbox<unsigned>(pageSize.lines);
+    }
+
+    /// Lines of CJK ideographs and kana: every character is two cells wide.
+    BenchChunk cjk(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        while (chunk.bytes.size() < approximateSize)
+        {
+            for ([[maybe_unused]] auto const cell: std::views::iota(0u, columns / 2))
+            {
+                auto const codepoint = uniform(rng, 0, 7) == 0 ? uniform(rng, 0x3041, 0x3096)  // Hiragana
+                                                               : uniform(rng, 0x4E00, 0x9FFF); // Ideographs
+                chunk.bytes += unicode::convert_to<char>(static_cast<char32_t>(codepoint));
+            }
+            if (columns % 2 != 0)
+                chunk.bytes += '.';
+            chunk.bytes += "\r\n";
+            chunk.cells += columns;
+        }
+        return chunk;
+    }
+
+    /// Lines of emoji grapheme clusters: modifiers, ZWJ sequences, flags, presentation selectors and
+    /// combining marks, each one cluster of several codepoints.
+    BenchChunk emoji(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        struct Cluster
+        {
+            std::u32string_view codepoints;
+            unsigned width;
+        };
+        static constexpr auto Clusters = std::array {
+            Cluster { U"\U0001F600", 2 },                                 // Grinning face.
+            Cluster { U"\U0001F44D\U0001F3FD", 2 },                       // Thumbs up, skin tone.
+            Cluster { U"\U0001F468\u200D\U0001F469\u200D\U0001F467", 2 }, // Family (ZWJ).
+            Cluster { U"\U0001F1E9\U0001F1EA", 2 },                       // Flag (regional indicators).
+            Cluster { U"\u2764\uFE0F", 2 },                               // Heart, emoji presentation.
+            Cluster { U"e\u0301", 1 },                                    // e, combining acute.
+            Cluster { U" ", 1 },
+        };
+
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        while (chunk.bytes.size() < approximateSize)
+        {
+            auto used = 0u;
+            while (used + 2 <= columns)
+            {
+                auto const& cluster = Clusters[uniform(rng, 0, static_cast<unsigned>(Clusters.size()) - 1)];
+                appendCodepoints(chunk.bytes, cluster.codepoints);
+                used += cluster.width;
+            }
+            chunk.bytes += "\r\n";
+            chunk.cells += used;
+        }
+        return chunk;
+    }
+
+    /// An editor scrolling a split: DECSTBM and DECSLRM margins, lines added at the bottom margin
+    /// and, now and then, at the top by reverse index.
+    BenchChunk margins(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        auto const lines = linesOf(pageSize);
+        auto const top = 2u;
+        auto const bottom = lines - 1;
+        auto const left = 5u;
+        auto const right = columns - 4;
+        auto const width = right - left + 1;
+
+        std::format_to(
+            std::back_inserter(chunk.bytes), "\033[?69h\033[{};{}r\033[{};{}s", top, bottom, left, right);
+        while (chunk.bytes.size() < approximateSize)
+        {
+            if (uniform(rng, 0, 7) == 0)
+                std::format_to(std::back_inserter(chunk.bytes), "\033[{};{}H\033M", top, left);
+            else
+                std::format_to(std::back_inserter(chunk.bytes), "\033[{};{}H\n", bottom, left);
+            appendText(chunk.bytes, rng, width);
+            chunk.cells += width;
+        }
+        chunk.bytes += "\033[r\033[s\033[?69l\033[H";
+        return chunk;
+    }
+
+    /// A multiplexer inside a multiplexer: lines inserted and deleted at random rows of a region
+    /// that spares the status line, each followed by a full line of text.
+    BenchChunk insertDelete(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        auto const lines = linesOf(pageSize);
+
+        std::format_to(std::back_inserter(chunk.bytes), "\033[1;{}r", lines - 1);
+        while (chunk.bytes.size() < approximateSize)
+        {
+            std::format_to(std::back_inserter(chunk.bytes),
+                           "\033[{};1H\033[{}{}",
+                           uniform(rng, 1, lines - 1),
+                           uniform(rng, 1, 3),
+                           uniform(rng, 0, 1) == 0 ? 'L' : 'M');
+            appendText(chunk.bytes, rng, columns);
+            chunk.cells += columns;
+        }
+        chunk.bytes += "\033[r\033[H";
+        return chunk;
+    }
+
+    /// A process monitor: every frame addresses each row and rewrites it in full, with colored
+    /// meters at the top and a highlighted row in the process table.
+    BenchChunk repaint(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        auto const lines = linesOf(pageSize);
+        auto const meterRows = std::min(4u, lines);
+        auto const selected = uniform(rng, meterRows + 1, std::max(meterRows + 1, lines));
+
+        while (chunk.bytes.size() < approximateSize)
+        {
+            for (auto const row: std::views::iota(1u, lines + 1))
+            {
+                std::format_to(std::back_inserter(chunk.bytes), "\033[{};1H", row);
+                if (row <= meterRows)
+                {
+                    auto const label = std::format("{:>3}[", row - 1);
+                    auto const labelWidth = static_cast<unsigned>(label.size()) + 1;
+                    auto const room = columns > labelWidth ? columns - labelWidth : 0;
+                    auto const used = uniform(rng, 0, room);
+                    std::format_to(std::back_inserter(chunk.bytes),
+                                   "{}\033[32m{}\033[31m{}\033[m{}]",
+                                   label,
+                                   std::string(used / 2, '|'),
+                                   std::string(used - (used / 2), '|'),
+                                   std::string(room - used, ' '));
+                }
+                else
+                {
+                    auto line = std::format("{:>7} user      20   0 {:>7}M {:>6}K S {:>5.1f} ",
+                                            uniform(rng, 1, 99999),
+                                            uniform(rng, 1, 9999),
+                                            uniform(rng, 1, 99999),
+                                            uniform(rng, 0, 1000) / 10.0);
+                    if (line.size() < columns)
+                        appendText(line, rng, columns - static_cast<unsigned>(line.size()));
+                    line.resize(columns, ' ');
+                    if (row == selected)
+                        std::format_to(std::back_inserter(chunk.bytes), "\033[7m{}\033[m", line);
+                    else
+                        chunk.bytes += line;
+                }
+                chunk.bytes += "\033[K";
+            }
+            chunk.cells += std::uint64_t { columns } * lines;
+        }
+        return chunk;
+    }
+
+    /// Output in which every word is an OSC 8 hyperlink, as from `ls --hyperlink` or a compiler
+    /// linking its diagnostics to the source.
+    BenchChunk hyperlinks(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng)
+    {
+        auto chunk = BenchChunk {};
+        auto const columns = columnsOf(pageSize);
+        auto used = 0u;
+        while (chunk.bytes.size() < approximateSize)
+        {
+            auto const length = uniform(rng, 3, 12);
+            if (used + length + 1 > columns)
+            {
+                chunk.bytes += "\r\n";
+                chunk.cells += used;
+                used = 0;
+            }
+            auto const id = uniform(rng, 0, 4095);
+            std::format_to(
+                std::back_inserter(chunk.bytes), "\033]8;id={0};file:///home/user/src/{0}.cpp\033\\", id);
+            std::ranges::generate_n(std::back_inserter(chunk.bytes), length, [&] {
+                return static_cast<char>('a' + uniform(rng, 0, 25));
+            });
+            chunk.bytes += "\033]8;;\033\\ ";
+            used += length + 1;
+        }
+        chunk.bytes += "\r\n";
+        chunk.cells += used;
+        return chunk;
+    }
+
+    constexpr auto Workloads = std::array {
+        BenchWorkload { "cjk", "CJK text, every character two cells wide", &cjk },
+        BenchWorkload { "emoji", "Emoji grapheme clusters of several codepoints", &emoji },
+        BenchWorkload { "margins", "DECSTBM/DECSLRM margin scrolling, as an editor split", &margins },
+        BenchWorkload { "insdel", "Insert/delete line storms, as a nested multiplexer", &insertDelete },
+        BenchWorkload { "repaint", "Cursor-addressed full-screen repaints, as htop", &repaint },
+        BenchWorkload { "hyperlinks", "An OSC 8 hyperlink on every word", &hyperlinks },
+    };
+} // namespace
+
+std::span<BenchWorkload const> benchWorkloads() noexcept
+{
+    return Workloads;
+}
+
+} // namespace vtbackend
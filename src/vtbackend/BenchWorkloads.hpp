@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// Synthetic VT streams for bench-headless that stress the paths real applications take through
+/// Screen, beyond termbench's ASCII-centric tests: wide and clustered Unicode, margin scrolling,
+/// line insertion storms, cursor-addressed full-screen repaints and hyperlinks.
+
+#include <vtbackend/Primitives.hpp>
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace vtbackend
+{
+
+/// One piece of a workload's stream.
+///
+/// A chunk leaves the terminal as it found it (margins, modes and SGR reset), so chunks may be fed
+/// back to back in any number.
+struct BenchChunk
+{
+    std::string bytes;
+    /// The number of grid cells the chunk writes text into; a wide character counts twice.
+    std::uint64_t cells = 0;
+};
+
+struct BenchWorkload
+{
+    std::string_view name;
+    std::string_view description;
+    /// Builds a chunk of roughly @p approximateSize bytes for a page of @p pageSize.
+    BenchChunk (*generate)(PageSize pageSize, std::size_t approximateSize, std::mt19937& rng);
+};
+
+/// @return Every workload, in the order bench-headless runs them.
+[[nodiscard]] std::span<BenchWorkload const> benchWorkloads() noexcept;
+
+} // namespace vtbackend
@@ -139,7 +139,7 @@ class BasicCellProxy
 
     // -- Write interface (only available on mutable proxy) ------------------------
 
-    void write(GraphicsAttributes const& attrs, char32_t ch, uint8_t cellWidth) noexcept
+    void write(GraphicsAttributes const& attrs, char32_t ch, uint8_t cellWidth)
         requires(!IsConst)
     {
         markDirty();
@@ -149,7 +149,7 @@ class BasicCellProxy
     void write(GraphicsAttributes const& attrs,
                char32_t ch,
                uint8_t cellWidth,
-               HyperlinkId hyperlinkId) noexcept
+               HyperlinkId hyperlinkId)
         requires(!IsConst)
     {
         markDirty();
@@ -168,7 +168,7 @@ class BasicCellProxy
             clearClusterExtras(*_line, _col);
     }
 
-    void reset() noexcept
+    void reset()
         requires(!IsConst)
     {
         markDirty();
@@ -177,7 +177,7 @@ class BasicCellProxy
         _line->widths[_col] = 1;
         _line->scales[_col] = 1;
         _line->textScaleExtras[_col] = 0;
-        _line->sgr[_col] = GraphicsAttributes {};
+        _line->sgr.set(_col, GraphicsAttributes {});
         _line->hyperlinks[_col] = {};
         _line->clusterSize[_col] = 0;
         if (oldClusterSize > 1)
@@ -186,7 +186,7 @@ class BasicCellProxy
             _line->imageFragments->erase(static_cast<uint16_t>(_col));
     }
 
-    void reset(GraphicsAttributes const& attrs) noexcept
+    void reset(GraphicsAttributes const& attrs)
         requires(!IsConst)
     {
         markDirty();
@@ -195,7 +195,7 @@ class BasicCellProxy
         _line->widths[_col] = 1;
         _line->scales[_col] = 1;
         _line->textScaleExtras[_col] = 0;
-        _line->sgr[_col] = attrs;
+        _line->sgr.set(_col, attrs);
         _line->hyperlinks[_col] = {};
         _line->clusterSize[_col] = 0;
         if (oldClusterSize > 1)
@@ -205,7 +205,7 @@ class BasicCellProxy
         invalidateTrivialIfNeeded();
     }
 
-    void reset(GraphicsAttributes const& attrs, HyperlinkId hyperlinkId) noexcept
+    void reset(GraphicsAttributes const& attrs, HyperlinkId hyperlinkId)
         requires(!IsConst)
     {
         reset(attrs);
@@ -273,43 +273,43 @@ class BasicCellProxy
         _line->widths[_col] = w;
     }
 
-    void resetFlags() noexcept
+    void resetFlags()
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].flags = CellFlag::None;
+        updateAttributes([](GraphicsAttributes& attrs) { attrs.flags = CellFlag::None; });
         invalidateTrivialIfNeeded();
     }
 
-    void resetFlags(CellFlags f) noexcept
+    void resetFlags(CellFlags f)
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].flags = f;
+        updateAttributes([f](GraphicsAttributes& attrs) { attrs.flags = f; });
         invalidateTrivialIfNeeded();
     }
 
-    void setForegroundColor(Color c) noexcept
+    void setForegroundColor(Color c)
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].foregroundColor = c;
+        updateAttributes([c](GraphicsAttributes& attrs) { attrs.foregroundColor = c; });
         invalidateTrivialIfNeeded();
     }
 
-    void setBackgroundColor(Color c) noexcept
+    void setBackgroundColor(Color c)
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].backgroundColor = c;
+        updateAttributes([c](GraphicsAttributes& attrs) { attrs.backgroundColor = c; });
         invalidateTrivialIfNeeded();
     }
 
-    void setUnderlineColor(Color c) noexcept
+    void setUnderlineColor(Color c)
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].underlineColor = c;
+        updateAttributes([c](GraphicsAttributes& attrs) { attrs.underlineColor = c; });
         invalidateTrivialIfNeeded();
     }
 
@@ -344,11 +344,12 @@ class BasicCellProxy
             _line->imageFragments->erase(static_cast<uint16_t>(_col));
     }
 
-    void setGraphicsRendition(GraphicsRendition sgr) noexcept
+    void setGraphicsRendition(GraphicsRendition sgr)
         requires(!IsConst)
     {
         markDirty();
-        _line->sgr[_col].flags = CellUtil::makeCellFlags(sgr, _line->sgr[_col].flags);
+        updateAttributes(
+            [sgr](GraphicsAttributes& attrs) { attrs.flags = CellUtil::makeCellFlags(sgr, attrs.flags); });
         invalidateTrivialIfNeeded();
     }
 
@@ -360,6 +361,17 @@ class BasicCellProxy
             *_dirty = true;
     }
 
+    /// Rewrites this cell's graphics attributes through @p update; they are interned, so they cannot
+    /// be changed in place. @see InternedAttributes
+    template <typename Update>
+    void updateAttributes(Update update)
+        requires(!IsConst)
+    {
+        auto attrs = _line->sgr[_col];
+        update(attrs);
+        _line->sgr.set(_col, attrs);
+    }
+
     /// Invalidate the trivial flag if this cell's SGR or hyperlink differs from another cell.
     /// When at col 0, compare against col 1 (an unwritten cell).
     /// When at col > 0, compare against col 0.
@@ -370,7 +382,7 @@ class BasicCellProxy
         {
             auto const checkCol = (_col > 0) ? size_t(0) : size_t(1);
             if (checkCol < _line->codepoints.size()
-                && (_line->sgr[_col] != _line->sgr[checkCol]
+                && (_line->sgr.indexAt(_col) != _line->sgr.indexAt(checkCol)
                     || _line->hyperlinks[_col] != _line->hyperlinks[checkCol]))
             {
                 _line->trivial = false;
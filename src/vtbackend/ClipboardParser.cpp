@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/ClipboardParser.hpp>
+#include <vtbackend/Logging.hpp>
+
+namespace vtbackend
+{
+
+void ClipboardParser::pass(char ch)
+{
+    switch (_state)
+    {
+        case State::Selection:
+            // Contour models the clipboard ('c') and the default, empty selection.
+            if (ch == ';')
+                _state = State::Data;
+            else if (ch == 'c' && _selection.empty())
+                _selection.push_back(ch);
+            else
+                _state = State::Dropped;
+            break;
+        case State::Data:
+            ++_received;
+            _staged.push_back(ch);
+            if (_staged.size() >= StagingSize)
+                decodeStaged();
+            break;
+        case State::Dropped: break;
+    }
+}
+
+void ClipboardParser::decodeStaged()
+{
+    crispy::base64::decode(_staged, _decoder, _data);
+    _staged.clear();
+    dropIfOversized();
+}
+
+void ClipboardParser::finishDecoding()
+{
+    decodeStaged();
+    if (_state != State::Data)
+        return;
+    crispy::base64::finish(_decoder, _data);
+    dropIfOversized();
+}
+
+void ClipboardParser::dropIfOversized()
+{
+    if (_data.size() > MaxDataSize)
+    {
+        // Dropped rather than truncated: a partial clipboard is not what the application copied.
+        vtParserLog()("OSC 52 clipboard write exceeded {} bytes and was dropped.", MaxDataSize);
+        _state = State::Dropped;
+        std::string {}.swap(_data);
+        std::string {}.swap(_staged);
+    }
+}
+
+void ClipboardParser::finalize()
+{
+    if (_state == State::Data)
+    {
+        if (_received == 1 && _staged == "?")
+        {
+            if (_onRead)
+                _onRead(_selection);
+        }
+        else
+        {
+            finishDecoding();
+            if (_state == State::Data && _onWrite)
+                _onWrite(_selection, _data);
+        }
+    }
+
+    _state = State::Selection;
+    _selection.clear();
+    _staged.clear();
+    _received = 0;
+    _decoder = {};
+    _data.clear();
+}
+
+} // namespace vtbackend
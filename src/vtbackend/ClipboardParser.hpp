@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/KittyClipboard.hpp>
+
+#include <vtparser/ParserExtension.hpp>
+
+#include <crispy/Base64.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace vtbackend
+{
+
+/// Streams an OSC 52 clipboard write (`OSC 52 ; Pc ; Pd ST`), decoding Pd as it arrives.
+///
+/// Collected as an ordinary OSC, Pd would be cut off at Sequence::MaxOscLength, which an editor
+/// yanking a whole file easily exceeds. Here only the decoded data is held, and it is bounded on
+/// the decoded size, like the other clipboard protocol (@see kitty_clipboard::MaxClipboardWriteSize).
+///
+/// Pd of `?` is a read request rather than data.
+class ClipboardParser: public ParserExtension
+{
+  public:
+    /// Largest clipboard write accepted, in decoded bytes. A larger one is dropped as a whole.
+    static constexpr size_t MaxDataSize = kitty_clipboard::MaxClipboardWriteSize;
+
+    /// Base64 is staged up to this size and then decoded in one go, not character by character.
+    static constexpr size_t StagingSize = 4096;
+
+    using OnWrite = std::function<void(std::string_view selection, std::string_view data)>;
+    using OnRead = std::function<void(std::string_view selection)>;
+
+    ClipboardParser(OnWrite onWrite, OnRead onRead):
+        _onWrite { std::move(onWrite) }, _onRead { std::move(onRead) }
+    {
+    }
+
+    // ParserExtension overrides
+    //
+    void pass(char ch) override;
+    void finalize() override;
+
+  private:
+    /// Decodes the staged base64, dropping the write if it grew past MaxDataSize.
+    void decodeStaged();
+
+    /// Decodes what is still staged once the payload has ended, including a final unpadded group.
+    void finishDecoding();
+
+    /// Drops the write if its decoded data grew past MaxDataSize.
+    void dropIfOversized();
+
+    enum class State : uint8_t
+    {
+        Selection,
+        Data,
+        Dropped, ///< Not a write Contour honors; the rest is ignored.
+    };
+
+    State _state = State::Selection;
+    std::string _selection;
+    std::string _staged;
+    size_t _received = 0;
+    crispy::base64::DecoderState _decoder;
+    std::string _data;
+
+    OnWrite _onWrite;
+    OnRead _onRead;
+};
+
+} // namespace vtbackend
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/ClipboardParser.hpp>
+
+#include <crispy/Base64.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+using vtbackend::ClipboardParser;
+
+namespace
+{
+
+struct Outcome
+{
+    std::optional<std::string> written;
+    std::optional<std::string> read;
+};
+
+/// Runs @p body -- an OSC 52 string without its leading "52;" -- through a ClipboardParser.
+Outcome parse(std::string_view body)
+{
+    auto outcome = Outcome {};
+    auto parser = ClipboardParser {
+        [&](std::string_view, std::string_view data) { outcome.written = std::string(data); },
+        [&](std::string_view selection) { outcome.read = std::string(selection); },
+    };
+    for (auto const ch: body)
+        parser.pass(ch);
+    parser.finalize();
+    return outcome;
+}
+
+} // namespace
+
+TEST_CASE("ClipboardParser.write", "[ClipboardParser]")
+{
+    CHECK(parse("c;dGVzdGluZyAxMjM=").written == "testing 123");
+    CHECK(parse(";dGVzdGluZyAxMjM=").written == "testing 123");
+    CHECK(parse("c;").written == "");
+    CHECK(!parse("c;dGVzdGluZyAxMjM=").read);
+}
+
+TEST_CASE("ClipboardParser.write_across_staging_blocks", "[ClipboardParser]")
+{
+    // Neither the text nor its base64 a multiple of the staging size or of a base64 group.
+    auto text = std::string {};
+    while (text.size() < 3 * ClipboardParser::StagingSize + 7)
+        text += "The quick brown fox jumps over the lazy dog. ";
+    CHECK(parse("c;" + crispy::base64::encode(text)).written == text);
+}
+
+TEST_CASE("ClipboardParser.read", "[ClipboardParser]")
+{
+    CHECK(parse("c;?").read == "c");
+    CHECK(parse(";?").read == "");
+    CHECK(!parse(";?").written);
+    CHECK(parse(";??").written == "");
+}
+
+TEST_CASE("ClipboardParser.rejects_unmodelled_selections", "[ClipboardParser]")
+{
+    for (auto const* body: { "p;dGVzdA==", "cc;dGVzdA==", "s0;?", "c" })
+    {
+        INFO(body);
+        auto const outcome = parse(body);
+        CHECK(!outcome.written);
+        CHECK(!outcome.read);
+    }
+}
+
+TEST_CASE("ClipboardParser.drops_a_write_past_the_limit", "[ClipboardParser]")
+{
+    auto const fits = std::string(ClipboardParser::MaxDataSize, 'x');
+    CHECK(parse("c;" + crispy::base64::encode(fits)).written == fits);
+
+    auto const tooLarge = std::string(ClipboardParser::MaxDataSize + 1, 'x');
+    CHECK(!parse("c;" + crispy::base64::encode(tooLarge)).written);
+}
@@ -103,7 +103,10 @@ namespace detail
 
 } // namespace detail
 // {{{ Grid impl
-Grid::Grid(PageSize pageSize, bool reflowOnResize, MaxHistoryLineCount maxHistoryLineCount):
+Grid::Grid(PageSize pageSize,
+           bool reflowOnResize,
+           MaxHistoryLineCount maxHistoryLineCount,
+           LineCount eagerReflowLineCount):
     _pageSize { pageSize },
     _reflowOnResize { reflowOnResize },
     _historyLimit { maxHistoryLineCount },
@@ -117,7 +120,8 @@ Grid::Grid(PageSize pageSize, bool reflowOnResize, MaxHistoryLineCount maxHistor
         }(),
         reflowOnResize,
         GraphicsAttributes {}) },
-    _linesUsed { pageSize.lines }
+    _linesUsed { pageSize.lines },
+    _eagerReflowLineCount { eagerReflowLineCount }
 {
     verifyState();
 }
@@ -158,7 +162,8 @@ void Grid::finalizeRevisions() noexcept
         if (offset < LineOffset(0))
             stampedHistoryFloor = std::min(stampedHistoryFloor, stableLineIdOf(offset));
     }
-    if (stamped)
+    // A batch that only shifted rows stamps none, yet consumers must still see it as news.
+    if (stamped || (!_rowShifts.empty() && _rowShifts.back().seqno == next))
         _seqno = next;
     // Remember how deep a history change reached and when, so a consumer that has not caught up to
     // this batch still scans down to it (@see forEachLineChangedSince).
@@ -178,9 +183,99 @@ void Grid::finalizeRevisions() noexcept
     _stableBaseAtLastFinalize = _stableBase;
 }
 
+void Grid::syncSemanticLines()
+{
+    auto const record = [this](LineOffset offset, Line const& line) {
+        auto const flags = line.flags() & HeadOnlyLineFlags;
+        if (flags.any())
+            _semanticLines.insert_or_assign(stableLineIdOf(offset), flags);
+        else
+            _semanticLines.erase(stableLineIdOf(offset));
+    };
+    if (forEachLineChangedSince(_semanticLinesCursor, record) == GridDeltaResult::ResyncRequired)
+    {
+        _semanticLines.clear();
+        forEachValidLine(record);
+    }
+
+    // Rows that left the addressable range report no change: eviction and a reverse scroll off the
+    // page's bottom destroy them without writing them.
+    auto const validIds = std::pair { stableLineIdOf(addressableTop()),
+                                      stableLineIdOf(boxed_cast<LineOffset>(_pageSize.lines)) };
+    _semanticLines.erase(_semanticLines.begin(), _semanticLines.lower_bound(validIds.first));
+    _semanticLines.erase(_semanticLines.lower_bound(validIds.second), _semanticLines.end());
+}
+
+std::optional<LineOffset> Grid::findFlaggedLineAbove(LineOffset line, LineFlags flags)
+{
+    assert(HeadOnlyLineFlags.contains(flags));
+    syncSemanticLines();
+
+    auto const nearestFirst =
+        std::ranges::subrange(_semanticLines.begin(), _semanticLines.lower_bound(stableLineIdOf(line)))
+        | std::views::reverse;
+    auto const found =
+        std::ranges::find_if(nearestFirst, [flags](auto const& entry) { return entry.second.any(flags); });
+    if (found == nearestFirst.end())
+        return std::nullopt;
+    return LineOffset::cast_from(found->first - _stableBase);
+}
+
+std::optional<LineOffset> Grid::findFlaggedLineBelow(LineOffset line, LineFlags flags)
+{
+    assert(HeadOnlyLineFlags.contains(flags));
+    syncSemanticLines();
+
+    auto const below =
+        std::ranges::subrange(_semanticLines.upper_bound(stableLineIdOf(line)), _semanticLines.end());
+    auto const found =
+        std::ranges::find_if(below, [flags](auto const& entry) { return entry.second.any(flags); });
+    if (found == below.end())
+        return std::nullopt;
+    return LineOffset::cast_from(found->first - _stableBase);
+}
+
+bool Grid::shiftedSince(uint64_t seqno, LineOffset offset) const noexcept
+{
+    auto const id = stableLineIdOf(offset);
+    return std::ranges::any_of(_rowShifts, [&](GridRowShift const& shift) {
+        return shift.seqno > seqno && shift.top <= id && id <= shift.bottom;
+    });
+}
+
+void Grid::recordRowShift(LineOffset top, LineOffset bottom, int count) noexcept
+{
+    auto const seqno = _seqno + 1;
+    auto const topId = stableLineIdOf(top);
+    auto const bottomId = stableLineIdOf(bottom);
+
+    // An application scrolling its region line by line within one batch (a pager, a log tail) logs
+    // one shift, not one per line.
+    if (!_rowShifts.empty())
+    {
+        auto& last = _rowShifts.back();
+        if (last.seqno == seqno && last.top == topId && last.bottom == bottomId
+            && (last.count < 0) == (count < 0))
+        {
+            auto const height = static_cast<int32_t>(bottomId - topId + 1);
+            last.count = std::clamp(last.count + count, -height, height);
+            return;
+        }
+    }
+
+    if (_rowShifts.size() == MaxRowShifts)
+    {
+        _rowShiftsLostThrough = std::max(_rowShiftsLostThrough, _rowShifts.front().seqno);
+        _rowShifts.pop_front();
+    }
+    _rowShifts.push_back(
+        GridRowShift { .top = topId, .bottom = bottomId, .count = count, .seqno = seqno });
+}
+
 void Grid::clearHistory()
 {
     _linesUsed = _pageSize.lines;
+    discardPendingReflow();
     // The floor jumps to the base: every history id is evicted, no resend needed —
     // deliberately NOT a generation bump (page row identity is untouched).
     syncStableFloor();
@@ -285,7 +380,7 @@ CellProxy Grid::at(LineOffset line, ColumnOffset column) const noexcept
 void Grid::resetPageLines(LineCount count, GraphicsAttributes defaultAttributes) noexcept
 {
     for (auto const line: std::views::iota(0, *count))
-        lineAt(LineOffset(line)).reset(defaultLineFlags(), defaultAttributes);
+        lineAt(LineOffset(line)).reset(defaultLineFlags(), defaultAttributes, _pageSize.columns);
 }
 
 // }}}
@@ -384,7 +479,7 @@ LineCount Grid::scrollUp(LineCount linesCountToScrollUp, GraphicsAttributes defa
         for (auto y = boxed_cast<LineOffset>(_pageSize.lines - linesCountToScrollUp);
              y < boxed_cast<LineOffset>(_pageSize.lines);
              ++y)
-            lineAt(y).reset(defaultLineFlags(), defaultAttributes);
+            lineAt(y).reset(defaultLineFlags(), defaultAttributes, _pageSize.columns);
 
         return linesCountToScrollUp;
     }
@@ -412,7 +507,7 @@ LineCount Grid::scrollUp(LineCount linesCountToScrollUp, GraphicsAttributes defa
             for (auto y = boxed_cast<LineOffset>(_pageSize.lines - linesCountToScrollUp);
                  y < boxed_cast<LineOffset>(_pageSize.lines);
                  ++y)
-                lineAt(y).reset(defaultLineFlags(), defaultAttributes);
+                lineAt(y).reset(defaultLineFlags(), defaultAttributes, _pageSize.columns);
         }
         return LineCount::cast_from(linesAppendCount);
     }
@@ -447,11 +542,14 @@ LineCount Grid::scrollUp(LineCount n, GraphicsAttributes defaultAttributes, Marg
             auto const firstProtectedLine = margin.vertical.to + 1;
             auto const pageBottomLine = boxed_cast<LineOffset>(_pageSize.lines) - LineOffset(1);
 
+            // The rows below the margin stay put on screen, i.e. they move down by n2 relative to the
+            // page that just scrolled up under them.
             for (auto targetLine = pageBottomLine; targetLine >= firstProtectedLine; --targetLine)
             {
                 auto const sourceLine = targetLine - *n2;
-                lineAt(targetLine) = std::move(lineAt(sourceLine));
+                lineAt(targetLine).shiftFrom(std::move(lineAt(sourceLine)));
             }
+            recordRowShift(firstProtectedLine - *n2, pageBottomLine, -unbox<int>(n2));
 
             // Blank the new region rows at the region bottom.
             for (auto const lineNumber:
@@ -467,7 +565,8 @@ LineCount Grid::scrollUp(LineCount n, GraphicsAttributes defaultAttributes, Marg
         {
             for (auto topLineOffset = *margin.vertical.from; topLineOffset <= *margin.vertical.to - *n2;
                  ++topLineOffset)
-                _lines[topLineOffset] = std::move(_lines[topLineOffset + *n2]);
+                _lines[topLineOffset].shiftFrom(std::move(_lines[topLineOffset + *n2]));
+            recordRowShift(margin.vertical.from, margin.vertical.to, unbox<int>(n2));
         }
 
         auto const topEmptyLineNr = *margin.vertical.to - *n2 + 1;
@@ -479,6 +578,8 @@ LineCount Grid::scrollUp(LineCount n, GraphicsAttributes defaultAttributes, Marg
     }
     else
     {
+        // A scroll bounded by left/right margins moves only part of each row, which a GridRowShift
+        // cannot express: its rows are rewritten in place and reported as changed, row by row.
         auto const marginHeight = margin.vertical.length();
         auto const n2 = std::min(n, marginHeight);
         auto const topTargetLineOffset = margin.vertical.from;
@@ -551,15 +652,20 @@ void Grid::scrollDown(LineCount vN, GraphicsAttributes const& defaultAttributes,
 
     if (fullHorizontal)
     {
-        auto a = std::next(begin(_lines), *margin.vertical.from);
-        auto b = std::next(begin(_lines), *margin.vertical.to + 1 - *n);
-        auto c = std::next(begin(_lines), *margin.vertical.to + 1);
-        std::rotate(a, b, c);
+        // Moved rather than rotated, so that the grid can log the region shift as what it is
+        // (@see recordRowShift) instead of every row in it counting as changed.
+        // Bottom up, so that each row is moved out before it is overwritten.
+        auto const targets = std::views::iota(*margin.vertical.from + *n, *margin.vertical.to + 1);
+        for (auto const line: targets | std::views::reverse)
+            lineAt(LineOffset(line)).shiftFrom(std::move(lineAt(LineOffset(line - *n))));
         for (auto const i: std::views::iota(*margin.vertical.from, *margin.vertical.from + *n))
             _lines[i].reset(defaultLineFlags(), defaultAttributes);
+        if (*n > 0 && n < margin.vertical.length())
+            recordRowShift(margin.vertical.from, margin.vertical.to, -unbox<int>(n));
     }
     else
     {
+        // As in scrollUp: a column-bounded scroll is not a GridRowShift, so its rows count as changed.
         if (n <= margin.vertical.length())
         {
             // Shift every line that has somewhere to go: targets [from+n, to], each pulling from n rows
@@ -647,9 +753,10 @@ void Grid::scrollLeft(GraphicsAttributes defaultAttributes, Margin margin) noexc
 void Grid::reset()
 {
     _linesUsed = _pageSize.lines;
+    discardPendingReflow();
     _lines.rotateRight(_lines.zeroIndex());
     for (int i = 0; i < unbox(_pageSize.lines); ++i)
-        _lines[i].reset(defaultLineFlags(), GraphicsAttributes {});
+        _lines[i].reset(defaultLineFlags(), GraphicsAttributes {}, _pageSize.columns);
     bumpGeneration();
     verifyState();
 }
@@ -685,6 +792,12 @@ CellLocation Grid::growLines(LineCount newHeight, CellLocation cursor)
     _linesUsed = min(_linesUsed + totalLinesToExtend, LineCount::cast_from(_lines.size()));
     syncStableFloor(); // the min() clamp can shrink the history at ring capacity
 
+    // At ring capacity the rows the page grew into were the oldest history, which may be history a
+    // reflowing resize set aside at an older width.
+    for (auto const y: std::views::iota(*_pageSize.lines - *totalLinesToExtend, *_pageSize.lines))
+        if (auto& line = _lines[y]; line.size() != _pageSize.columns)
+            line.reset(defaultLineFlags(), GraphicsAttributes {}, _pageSize.columns);
+
     Ensures(_pageSize.lines == newHeight);
     Ensures(_lines.size() >= unbox<size_t>(maxHistoryLineCount() + _pageSize.lines));
     verifyState();
@@ -804,7 +917,8 @@ CellLocation Grid::resize(PageSize newSize, CellLocation currentCursorPos, bool
                 }
             };
 
-            for (int i = -*historyLineCount(); i < *_pageSize.lines; ++i)
+            auto const band = eagerReflowBand();
+            for (auto const i: std::views::iota(-*band, *_pageSize.lines))
             {
                 auto& line = _lines[i];
                 Require(line.size() >= _pageSize.columns);
@@ -843,17 +957,15 @@ CellLocation Grid::resize(PageSize newSize, CellLocation currentCursorPos, bool
                 Ensures(LineCount::cast_from(grownLines.size()) == _pageSize.lines);
             }
 
-            _linesUsed = LineCount::cast_from(grownLines.size());
-
-            auto const totalLineCount = unbox<size_t>(_pageSize.lines + maxHistoryLineCount());
-            while (grownLines.size() < totalLineCount)
-                grownLines.emplace_back(newColumnCount, defaultLineFlags(), GraphicsAttributes {});
+            // The rows above the band stay in the history, at the width they had, until they are
+            // rewrapped. Padding them to the new width is all it takes for anything reading them not
+            // to run past their end; it touches no cell.
+            for (auto const offset: std::views::iota(-unbox(historyLineCount()), -*band))
+                if (auto& line = _lines[offset]; line.size() < newColumnCount)
+                    line.resize(newColumnCount);
 
-            _lines = std::move(grownLines);
             _pageSize.columns = newColumnCount;
-
-            auto const newHistoryLineCount = _linesUsed - _pageSize.lines;
-            rotateBuffersLeft(newHistoryLineCount);
+            placeReflowedBand(std::move(grownLines), band);
 
             verifyState();
             return CellLocation { .line = -boxed_cast<LineOffset>(cy),
@@ -880,12 +992,11 @@ CellLocation Grid::resize(PageSize newSize, CellLocation currentCursorPos, bool
             size_t wrappedUsed = 0;
             LineFlags previousFlags = _lines.front().inheritableFlags();
 
-            auto const totalLineCount = unbox<size_t>(_pageSize.lines + maxHistoryLineCount());
-            shrunkLines.reserve(totalLineCount);
-            Require(totalLineCount == unbox<size_t>(this->totalLineCount()));
+            auto const band = eagerReflowBand();
+            shrunkLines.reserve(unbox<size_t>(band + _pageSize.lines));
 
             auto numLinesWritten = LineCount(0);
-            for (auto i = -*historyLineCount(); i < *_pageSize.lines; ++i)
+            for (auto const i: std::views::iota(-*band, *_pageSize.lines))
             {
                 auto& line = _lines[i];
 
@@ -959,22 +1070,8 @@ CellLocation Grid::resize(PageSize newSize, CellLocation currentCursorPos, bool
             Require(unbox<size_t>(numLinesWritten) == shrunkLines.size());
             Require(numLinesWritten >= _pageSize.lines);
 
-            while (shrunkLines.size() < totalLineCount)
-                shrunkLines.emplace_back(newColumnCount, LineFlag::None, GraphicsAttributes {});
-
-            _linesUsed = LineCount::cast_from(numLinesWritten);
-            _lines = std::move(shrunkLines);
             _pageSize.columns = newColumnCount;
-
-            // The rotation goes through the ring primitive rather than being applied to the local
-            // vector, because rotateBuffersLeft is where the stable-id accounting lives. Rotating
-            // `shrunkLines` instead left `_stableBase` exactly where it was while the history GREW
-            // underneath it — and syncStableFloor()'s max() can only RAISE the floor, never lower
-            // one — so every history row the reflow had just created sat below `_stableFloor` and
-            // forEachValidLine() began its walk above them: a client attaching after a narrowing
-            // resize got a grid with no scrollback at all, though the daemon still held the rows.
-            // growColumns has always gone through this primitive; the two paths now agree.
-            rotateBuffersLeft(historyLineCount());
+            placeReflowedBand(std::move(shrunkLines), band);
 
             verifyState();
             return cursor; // TODO
@@ -1012,6 +1109,190 @@ void Grid::clampHistory()
 {
     // TODO: needed?
 }
+
+LineCount Grid::eagerReflowBand() const noexcept
+{
+    auto const history = historyLineCount();
+    auto band = std::min(history, _eagerReflowLineCount);
+    // Never cut a logical line in two: the rows set aside are rewrapped on their own later.
+    while (band < history && _lines[-*band].wrapped())
+        ++band;
+    return band;
+}
+
+void Grid::insertRingSlotsAboveHistory(size_t count)
+{
+    // The oldest used row sits right after the free slots in ring order, so inserting in front of
+    // its storage index grows the free run. Shift the zero index along if the insert moved row 0.
+    auto& storage = _lines.storage();
+    auto const oldestIndex =
+        (_lines.zeroIndex() + _lines.size() - unbox<size_t>(_linesUsed - _pageSize.lines)) % _lines.size();
+    auto const zeroMoves = oldestIndex <= _lines.zeroIndex();
+    storage.insert(std::next(storage.begin(), static_cast<std::ptrdiff_t>(oldestIndex)),
+                   count,
+                   Line(_pageSize.columns, defaultLineFlags(), GraphicsAttributes {}));
+    if (zeroMoves)
+        _lines.rotateLeft(count);
+}
+
+void Grid::placeReflowedBand(Lines&& reflowed, LineCount bandHistory)
+{
+    auto const consumed = unbox<size_t>(bandHistory + _pageSize.lines);
+    auto const produced = reflowed.size();
+    auto const setAside = _linesUsed - bandHistory - _pageSize.lines;
+    Require(produced >= unbox<size_t>(_pageSize.lines));
+
+    auto const freeSlots = _lines.size() - unbox<size_t>(_linesUsed);
+    if (produced > consumed + freeSlots)
+        insertRingSlotsAboveHistory(produced - consumed - freeSlots);
+
+    // Rows past the consumed ones spill into the free slots, which wrap around to right above the
+    // rows set aside; rows the reflow did not need are blanked and handed back as free slots.
+    auto const top = -*bandHistory;
+    for (auto const i: std::views::iota(size_t { 0 }, produced))
+        _lines[top + static_cast<long>(i)] = std::move(reflowed[static_cast<long>(i)]);
+    for (auto const i: std::views::iota(produced, consumed))
+        _lines[top + static_cast<long>(i)] =
+            Line(_pageSize.columns, defaultLineFlags(), GraphicsAttributes {});
+
+    // Bring the last page-height of the result to the page. A raw rotation, because the stable ids
+    // are re-keyed below as a whole rather than shifted along with it.
+    auto const newHistory = LineCount::cast_from(produced) - _pageSize.lines;
+    auto const shift = *newHistory - *bandHistory;
+    if (shift > 0)
+        _lines.rotateLeft(static_cast<size_t>(shift));
+    else if (shift < 0)
+        _lines.rotateRight(static_cast<size_t>(-shift));
+    _linesUsed = setAside + LineCount::cast_from(produced);
+
+    // The history must stay addressable from its oldest row on, the rows set aside included, so the
+    // floor moves to exactly its top (the caller's generation bump is what allows the floor to move
+    // at all). The rows set aside take the ids right below the rebuilt band.
+    auto const floor = std::max(_stableFloor, _stableBase);
+    _stableFloor = floor;
+    _stableBase = floor + unbox<int64_t>(setAside + newHistory);
+    discardPendingReflow();
+    if (*setAside > 0)
+    {
+        _pendingReflowEnd = floor + unbox<int64_t>(setAside);
+        _pendingReflowCursor = _pendingReflowEnd;
+    }
+}
+
+void Grid::reflowLogicalLine(int64_t head, int64_t end, Lines& output) const
+{
+    auto const& headLine = _lines[static_cast<long>(head - _stableBase)];
+
+    LineSoA buffer;
+    initializeLineSoA(buffer, ColumnCount(0));
+    size_t used = 0;
+    for (auto const id: std::views::iota(head, end))
+    {
+        auto const& line = _lines[static_cast<long>(id - _stableBase)];
+        auto const columns = trimBlankRight(line.storage(), unbox<size_t>(line.size()));
+        if (columns == 0)
+            continue;
+        resizeLineSoA(buffer, ColumnCount::cast_from(used + columns));
+        copyColumns(line.storage(), 0, buffer, used, columns);
+        used += columns;
+    }
+
+    if (used == 0)
+    {
+        output.emplace_back(headLine);
+        output.back().resize(_pageSize.columns);
+        return;
+    }
+
+    detail::addNewWrappedLines(output,
+                               _pageSize.columns,
+                               buffer,
+                               used,
+                               headLine.flags().without(LineFlag::Wrapped),
+                               headLine.commandEndOffset(),
+                               headLine.promptEndOffset(),
+                               true);
+}
+
+bool Grid::reflowPendingHistory(LineCount budget)
+{
+    if (!historyReflowPending())
+    {
+        discardPendingReflow();
+        return false;
+    }
+
+    auto const oldest = oldestUsedLineId();
+    auto const end = std::min(_pendingReflowEnd, _stableBase);
+    if (_pendingReflowCursor > end)
+    {
+        // A reverse scroll pulled set-aside rows into the page, and the page reset them: whatever
+        // was rewrapped from them is stale. Start over from what is still set aside.
+        _pendingReflowEnd = end;
+        _pendingReflowCursor = end;
+        _reflowedHistory.clear();
+    }
+
+    Lines logicalLine;
+    while (*budget > 0 && _pendingReflowCursor > oldest)
+    {
+        auto head = _pendingReflowCursor - 1;
+        while (head > oldest && _lines[static_cast<long>(head - _stableBase)].wrapped())
+            --head;
+
+        logicalLine.clear();
+        reflowLogicalLine(head, _pendingReflowCursor, logicalLine);
+        for (auto const i: std::views::iota(size_t { 0 }, logicalLine.size()) | std::views::reverse)
+            _reflowedHistory.emplace_back(std::move(logicalLine[static_cast<long>(i)]));
+
+        budget -= LineCount::cast_from(_pendingReflowCursor - head);
+        _pendingReflowCursor = head;
+    }
+
+    if (_pendingReflowCursor > oldest)
+        return true;
+
+    spliceReflowedHistory();
+    return false;
+}
+
+void Grid::spliceReflowedHistory()
+{
+    auto const oldest = oldestUsedLineId();
+    auto const end = std::min(_pendingReflowEnd, _stableBase);
+    auto const setAside = static_cast<size_t>(end - oldest);
+
+    // Scrolling may have evicted set-aside rows that were already rewrapped. Their share of the
+    // result cannot be told apart any more, so keep only as many of the newest rows as survived.
+    auto const count = _pendingReflowCursor >= oldest ? _reflowedHistory.size()
+                                                      : std::min(_reflowedHistory.size(), setAside);
+
+    auto const freeSlots = _lines.size() - unbox<size_t>(_linesUsed);
+    if (count > setAside + freeSlots)
+        insertRingSlotsAboveHistory(count - setAside - freeSlots);
+
+    // Newest first, from right above the visible history upwards: past the set-aside rows this runs
+    // on into the free slots, and set-aside rows the result did not need become free slots.
+    auto const rowFor = [this, end](size_t k) -> Line& {
+        return _lines[static_cast<long>(end - 1 - static_cast<int64_t>(k) - _stableBase)];
+    };
+    for (auto const k: std::views::iota(size_t { 0 }, count))
+        rowFor(k) = std::move(_reflowedHistory[k]);
+    for (auto const k: std::views::iota(count, setAside))
+        rowFor(k) = Line(_pageSize.columns, defaultLineFlags(), GraphicsAttributes {});
+    _linesUsed = _linesUsed - LineCount::cast_from(setAside) + LineCount::cast_from(count);
+
+    discardPendingReflow();
+
+    // Every row above the spliced ones keeps its id, so consumers get the splice as changed lines
+    // rather than a resync. Fewer rows than were set aside raise the floor, as eviction would; more
+    // of them lower it, for the rows that only exist now.
+    auto const top = end - static_cast<int64_t>(count);
+    _stableFloor = count > setAside ? top : std::max(_stableFloor, top);
+    if (count > 0)
+        noteMutableRow(LineOffset::cast_from(top - _stableBase));
+    verifyState();
+}
 // }}}
 // {{{ dumpGrid impl
 std::ostream& dumpGrid(std::ostream& os, Grid const& grid)
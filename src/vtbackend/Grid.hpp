@@ -14,11 +14,15 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <limits>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace vtbackend
 {
@@ -548,6 +552,23 @@ enum class GridDeltaResult : uint8_t
     ResyncRequired, ///< Row identity was rebuilt: snapshot via forEachValidLine().
 };
 
+/// A block of page rows a margin scroll moved as a whole, in stable ids (@see Grid::forEachChangeSince).
+///
+/// With @c count n > 0 the rows [top + n, bottom] moved up to [top, bottom - n]; with n < 0 the rows
+/// [top, bottom + n] moved down to [top - n, bottom]. The |n| rows left behind were reset, so they
+/// are reported as changed in their own right.
+///
+/// Only scrolls of full-width regions (DECSTBM alone) are logged as shifts. A scroll that left/right
+/// margins (DECSLRM) bound moves part of each row, which a shift of whole rows cannot describe, so
+/// every row it touches is reported as changed instead.
+struct GridRowShift
+{
+    int64_t top = 0;    ///< Stable id of the block's first row.
+    int64_t bottom = 0; ///< Stable id of the block's last row, inclusive.
+    int32_t count = 0;  ///< Rows the content moved up by; negative moved it down.
+    uint64_t seqno = 0; ///< The batch the shift belongs to.
+};
+
 /// Whether a captured row carries the rendition its cells wear (tmux `capture-pane -e`).
 enum class CaptureRendition : uint8_t
 {
@@ -573,7 +594,12 @@ enum class CaptureTrailingSpaces : uint8_t
 class Grid
 {
   public:
-    Grid(PageSize pageSize, bool reflowOnResize, MaxHistoryLineCount maxHistoryLineCount);
+    /// @param eagerReflowLineCount How many history lines a reflowing resize rewraps on the spot
+    ///        (@see eagerReflowLineCount()).
+    Grid(PageSize pageSize,
+         bool reflowOnResize,
+         MaxHistoryLineCount maxHistoryLineCount,
+         LineCount eagerReflowLineCount = DefaultEagerReflowLineCount);
 
     Grid(): Grid(PageSize { LineCount(25), ColumnCount(80) }, false, LineCount(0)) {}
 
@@ -595,11 +621,35 @@ class Grid
         return maxHistoryLineCount() + _pageSize.lines;
     }
 
+    /// The scrollback lines above the page, history a reflowing resize has set aside included.
     [[nodiscard]] LineCount historyLineCount() const noexcept { return _linesUsed - _pageSize.lines; }
 
     [[nodiscard]] bool reflowOnResize() const noexcept { return _reflowOnResize; }
     void setReflowOnResize(bool enabled) { _reflowOnResize = enabled; }
 
+    /// The number of history lines right above the page that a reflowing resize rewraps on the spot.
+    static constexpr LineCount DefaultEagerReflowLineCount = LineCount(1000);
+
+    /// How many history lines above the page a reflowing resize rewraps on the spot.
+    ///
+    /// Older history is set aside at the width it had and rewrapped later, a slice at a time, by
+    /// reflowPendingHistory(). Until then it stays in the history as it was, so the scrollback neither
+    /// shrinks nor jumps. This is what keeps a resize as cheap with a deep (or unlimited) scrollback as
+    /// with an empty one.
+    [[nodiscard]] LineCount eagerReflowLineCount() const noexcept { return _eagerReflowLineCount; }
+
+    /// @return whether history set aside by a reflowing resize is still waiting to be rewrapped.
+    [[nodiscard]] bool historyReflowPending() const noexcept { return *pendingReflowLineCount() > 0; }
+
+    /// Rewraps up to about @p budget lines of the history set aside by a reflowing resize, newest first.
+    ///
+    /// Once all of it is rewrapped, it replaces the rows it came from in one go. The rows below keep
+    /// their stable ids, so the generation stays: the replaced rows are reported as changed lines.
+    ///
+    /// @param budget How many set-aside lines to rewrap at most, rounded up to a whole logical line.
+    /// @return whether any of it is still pending.
+    bool reflowPendingHistory(LineCount budget);
+
     [[nodiscard]] PageSize pageSize() const noexcept { return _pageSize; }
 
     /// Resizes the main page area of the grid and adapts the scrollback area's width accordingly.
@@ -794,10 +844,44 @@ class Grid
     /// current state and ResyncRequired is returned WITHOUT reporting lines — the caller
     /// snapshots via forEachValidLine() instead. (A resync must never be "changes since
     /// seqno 0": post-rebuild rows legitimately keep revision 0 forever.)
+    ///
+    /// A row a margin scroll moved counts as changed here, since this overload has no way to say
+    /// that it only moved. @see forEachChangeSince.
     /// @param cursor The consumer's stream position (updated).
     /// @param callback Invoked as callback(LineOffset, Line const&) per changed line.
     template <typename F>
     [[nodiscard]] GridDeltaResult forEachLineChangedSince(GridDeltaCursor& cursor, F&& callback)
+    {
+        return scanChangesSince(cursor, nullptr, std::forward<F>(callback));
+    }
+
+    /// Like forEachLineChangedSince(), but reports margin scrolls as row shifts rather than as every
+    /// row they moved.
+    ///
+    /// The shifts since @p cursor go to @p onRowShift first, oldest first; a row that only moved is
+    /// then not reported as a line. A consumer applies the shifts to the rows it holds before the
+    /// lines, which carry each row's final content — so scrolling a 50-row region costs it one shift
+    /// plus the rows the scroll exposed.
+    ///
+    /// A consumer so far behind that shifts it has not seen were already dropped from the log
+    /// (@see MaxRowShifts) gets no shifts, and every row in range as a line instead.
+    /// @param cursor The consumer's stream position (updated).
+    /// @param onRowShift Invoked as onRowShift(GridRowShift const&) per shift.
+    /// @param onLine Invoked as onLine(LineOffset, Line const&) per changed line.
+    template <typename S, typename F>
+    [[nodiscard]] GridDeltaResult forEachChangeSince(GridDeltaCursor& cursor, S&& onRowShift, F&& onLine)
+    {
+        return scanChangesSince(cursor, std::forward<S>(onRowShift), std::forward<F>(onLine));
+    }
+
+    /// How many row shifts the grid remembers for consumers that have not queried yet.
+    static constexpr size_t MaxRowShifts = 256;
+
+  private:
+    /// The one implementation of both delta queries; a null @p onRowShift asks for moved rows to be
+    /// reported as lines.
+    template <typename S, typename F>
+    [[nodiscard]] GridDeltaResult scanChangesSince(GridDeltaCursor& cursor, S&& onRowShift, F&& callback)
     {
         finalizeRevisions();
         if (cursor.generation != _generation)
@@ -817,6 +901,20 @@ class Grid
         // later scroll ever brings it back into the prefix above — so it would be stamped and then
         // never reported. A consumer already past that seqno has seen it and scans nothing extra.
         auto&& report = std::forward<F>(callback);
+
+        // A consumer that replays shifts gets them and nothing more for the rows they moved. One
+        // that cannot gets those rows as lines — and one that missed a shift the log no longer
+        // holds cannot know which rows moved, so it gets every row.
+        constexpr auto replaysShifts = !std::is_null_pointer_v<std::remove_cvref_t<S>>;
+        auto const shiftsLost = cursor.seqno < _rowShiftsLostThrough;
+        if constexpr (replaysShifts)
+        {
+            if (!shiftsLost)
+                for (auto const& shift: _rowShifts)
+                    if (shift.seqno > cursor.seqno)
+                        onRowShift(shift);
+        }
+
         auto const scrolledFloor = _stableBase - scrolledOutDepthSince(cursor.stableBase);
         auto const floorId = cursor.seqno < _changedHistorySeqno
                                  ? std::min(scrolledFloor, _changedHistoryFloor)
@@ -824,7 +922,10 @@ class Grid
         for (auto offset = scanTopFor(floorId); offset < boxed_cast<LineOffset>(_pageSize.lines); ++offset)
         {
             auto const& line = std::as_const(*this).lineAt(offset);
-            if (line.revision() > cursor.seqno)
+            auto changed = line.revision() > cursor.seqno || shiftsLost;
+            if constexpr (!replaysShifts)
+                changed = changed || shiftedSince(cursor.seqno, offset);
+            if (changed)
                 report(offset, line);
         }
 
@@ -833,6 +934,10 @@ class Grid
         return GridDeltaResult::Delta;
     }
 
+    /// Whether a shift after batch @p seqno moved the row at @p offset.
+    [[nodiscard]] bool shiftedSince(uint64_t seqno, LineOffset offset) const noexcept;
+
+  public:
     /// The topmost offset whose row still holds valid data — the shallower of the history depth and
     /// the stable floor.
     ///
@@ -874,6 +979,24 @@ class Grid
     }
     // }}}
 
+    // {{{ semantic line index
+    /// The nearest row strictly above @p line carrying any of @p flags, among the rows this grid holds.
+    ///
+    /// Answered from an index of the rows carrying semantic marks, so jumping to the previous prompt
+    /// costs a lookup rather than a walk over the scrollback, however deep it is.
+    /// @param line The row to search upwards from; it may lie below the page.
+    ///
+    /// Not const: the index is brought up to date first, which finalizes the pending line revisions
+    /// (@see syncSemanticLines).
+    /// @param flags Head-only flags to look for (@see HeadOnlyLineFlags); no other flag is indexed.
+    /// @return The row's offset, or nullopt if none does.
+    [[nodiscard]] std::optional<LineOffset> findFlaggedLineAbove(LineOffset line, LineFlags flags);
+
+    /// The nearest row strictly below @p line carrying any of @p flags, up to the page's last row.
+    /// @see findFlaggedLineAbove.
+    [[nodiscard]] std::optional<LineOffset> findFlaggedLineBelow(LineOffset line, LineFlags flags);
+    // }}}
+
     [[nodiscard]] constexpr LineFlags defaultLineFlags() const noexcept;
     [[nodiscard]] constexpr LineCount linesUsed() const noexcept;
 
@@ -920,6 +1043,56 @@ class Grid
     CellLocation growLines(LineCount newHeight, CellLocation cursor);
     void clampHistory();
 
+    // {{{ lazy reflow helpers
+    /// Id value of _pendingReflowEnd meaning no history has been set aside.
+    static constexpr int64_t NoPendingReflow = std::numeric_limits<int64_t>::min();
+
+    /// The stable id of the oldest used row, set aside or not.
+    [[nodiscard]] int64_t oldestUsedLineId() const noexcept
+    {
+        return _stableBase - unbox<int64_t>(_linesUsed - _pageSize.lines);
+    }
+
+    /// The number of used history rows that a reflowing resize set aside: the oldest ones, below the
+    /// stable id _pendingReflowEnd. Derived rather than counted, so that scrolling evicting them, a
+    /// history clear and a reset all shrink it with no bookkeeping of their own.
+    [[nodiscard]] LineCount pendingReflowLineCount() const noexcept
+    {
+        auto const end = std::min(_pendingReflowEnd, _stableBase);
+        auto const oldest = oldestUsedLineId();
+        return end > oldest ? LineCount::cast_from(end - oldest) : LineCount(0);
+    }
+
+    /// The number of visible history lines the reflowing resize in progress rewraps on the spot:
+    /// eagerReflowLineCount(), widened to start at the head of a logical line.
+    [[nodiscard]] LineCount eagerReflowBand() const noexcept;
+
+    /// Rewraps the logical line made up of the rows with the stable ids [@p head, @p end) to the
+    /// page width, appending the result to @p output. The rows themselves are left untouched.
+    void reflowLogicalLine(int64_t head, int64_t end, Lines& output) const;
+
+    /// Puts @p reflowed, a reflowing resize's result for the @p bandHistory history lines above the
+    /// page and the page itself, back into the ring in place of those rows. The rows above the band
+    /// stay where they are and are set aside for reflowPendingHistory(); the last page-height of
+    /// @p reflowed becomes the page.
+    void placeReflowedBand(Lines&& reflowed, LineCount bandHistory);
+
+    /// Replaces the set-aside history with its rewrapped rows.
+    void spliceReflowedHistory();
+
+    /// Inserts @p count blank slots into the ring between the free slots and the oldest used row,
+    /// for a reflow that produced more rows than the ring can hold. Nothing moves in ring order.
+    void insertRingSlotsAboveHistory(size_t count);
+
+    /// Drops any set-aside history and the rewrapped rows collected for it.
+    void discardPendingReflow() noexcept
+    {
+        _pendingReflowEnd = NoPendingReflow;
+        _pendingReflowCursor = NoPendingReflow;
+        _reflowedHistory.clear();
+    }
+    // }}}
+
     // {{{ buffer helpers
     void resizeBuffers(PageSize newSize)
     {
@@ -1030,6 +1203,9 @@ class Grid
         _dirtyHistoryFloor = NoHistoryFloor;
         _changedHistoryFloor = NoHistoryFloor;
         _changedHistorySeqno = 0;
+        // The ids the shifts name are gone, and consumers resync rather than replaying them.
+        _rowShifts.clear();
+        _rowShiftsLostThrough = 0;
         // Re-anchor the finalize scan: the pre-rebuild base delta is meaningless now.
         _stableBaseAtLastFinalize = _stableBase;
     }
@@ -1043,6 +1219,17 @@ class Grid
     /// @param count             How many lines from the top of the page to reset.
     /// @param defaultAttributes The attributes the blanked cells take on.
     void resetPageLines(LineCount count, GraphicsAttributes defaultAttributes) noexcept;
+
+    /// Brings the semantic line index up to date with every row changed since it was last read.
+    ///
+    /// Lazy, through the same change stream the daemon follows: the write paths pay nothing, and
+    /// whatever changed a row — a write, a reflow, a margin scroll, an in-place mark on a history
+    /// row — is reported here exactly as it is to a mirror, by one tracking mechanism.
+    void syncSemanticLines();
+
+    /// Logs that the page rows [@p top, @p bottom] moved up by @p count (down if negative) in the
+    /// current batch, merging it into the previous shift where that is the same scroll repeated.
+    void recordRowShift(LineOffset top, LineOffset bottom, int count) noexcept;
     // }}}
 
     // private fields
@@ -1053,6 +1240,12 @@ class Grid
     Lines _lines;
     LineCount _linesUsed;
 
+    // Lazy reflow (see reflowPendingHistory()).
+    LineCount _eagerReflowLineCount;
+    int64_t _pendingReflowEnd = NoPendingReflow;    ///< Used rows below this stable id are set aside.
+    int64_t _pendingReflowCursor = NoPendingReflow; ///< Set-aside rows from here up are rewrapped.
+    std::vector<Line> _reflowedHistory {};          ///< Their rewrapped rows, newest first.
+
     // Stable row identity (see the accessors above): maintained exclusively by the
     // ring-rotation primitives, syncStableFloor() and bumpGeneration().
     uint64_t _generation = 0;
@@ -1083,6 +1276,18 @@ class Grid
     int64_t _changedHistoryFloor = NoHistoryFloor;
     uint64_t _changedHistorySeqno = 0;
 
+    /// The margin scrolls of recent batches, oldest first, for forEachChangeSince(). Bounded by
+    /// MaxRowShifts: a consumer that has not queried for that long is not worth more memory.
+    std::deque<GridRowShift> _rowShifts;
+    /// The newest batch a shift was dropped from @c _rowShifts for. A consumer whose cursor predates
+    /// it missed a shift it can no longer be told about.
+    uint64_t _rowShiftsLostThrough = 0;
+
+    /// The head-only flags of every row carrying any, by stable id (@see findFlaggedLineAbove).
+    /// Read through syncSemanticLines(), which keeps it current as a consumer of the change stream.
+    std::map<int64_t, LineFlags> _semanticLines;
+    GridDeltaCursor _semanticLinesCursor; ///< Where the index stands in the change stream.
+
     uint64_t _seqno = 0;                   ///< The single monotonic source revisions draw from.
     int64_t _stableBaseAtLastFinalize = 0; ///< Bounds the finalize scan to scrolled-out rows.
                                            ///< Bootstrap: starts at 0 matching _stableBase,
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/Grid.hpp>
+#include <vtbackend/Line.hpp>
+#include <vtbackend/LineSoA.hpp>
+#include <vtbackend/SoAClusterWriter.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace vtbackend;
+
+// Microbenchmarks of the grid and line storage underneath Screen. @see Screen_bench.cpp
+
+namespace
+{
+
+/// A line of @p columns cells of words and spaces, marked wrappable as the shell's output is.
+Line makeTextLine(ColumnCount columns)
+{
+    auto line = Line(columns, LineFlag::Wrappable, GraphicsAttributes {});
+    auto text = std::string {};
+    while (text.size() < unbox<size_t>(columns))
+        text += "lorem ipsum dolor ";
+    text.resize(unbox<size_t>(columns));
+    writeTextToSoA(line.materializedStorage(), 0, text, GraphicsAttributes {});
+    return line;
+}
+
+} // namespace
+
+TEST_CASE("Grid.resize", "[!benchmark][Grid]")
+{
+    auto const wide = PageSize { .lines = LineCount(50), .columns = ColumnCount(200) };
+    auto const narrow = PageSize { .lines = LineCount(50), .columns = ColumnCount(120) };
+
+    auto grid = Grid(wide, true, LineCount(2000));
+    for (auto const i: std::views::iota(0, 2000 + unbox(wide.lines)))
+    {
+        grid.scrollUp(LineCount(1));
+        auto const text = std::string(150, static_cast<char>('a' + (i % 26)));
+        grid.setLineText(LineOffset::cast_from(unbox(wide.lines) - 1), text);
+    }
+
+    // Alternating keeps every run a real reflow, rewrapping the page and recent history.
+    BENCHMARK_ADVANCED("reflow 200 <-> 120 columns")(Catch::Benchmark::Chronometer meter)
+    {
+        auto cursor = CellLocation {};
+        meter.measure([&](int run) {
+            cursor = grid.resize(run % 2 ? wide : narrow, cursor, false);
+            return cursor;
+        });
+    };
+}
+
+TEST_CASE("Line.reflow", "[!benchmark][Line]")
+{
+    BENCHMARK_ADVANCED("200 to 80 columns")(Catch::Benchmark::Chronometer meter)
+    {
+        auto lines = std::vector<Line>(static_cast<size_t>(meter.runs()), makeTextLine(ColumnCount(200)));
+        meter.measure([&](int run) { return lines[static_cast<size_t>(run)].reflow(ColumnCount(80)); });
+    };
+}
+
+TEST_CASE("writeTextToSoA", "[!benchmark][SoAWriter]")
+{
+    auto line = LineSoA {};
+    initializeLineSoA(line, ColumnCount(200));
+    auto const attrs = GraphicsAttributes {};
+
+    auto const ascii = std::string(160, 'x');
+    BENCHMARK("160 ASCII cells")
+    {
+        return writeTextToSoA(line, 0, ascii, attrs, {}, true);
+    };
+
+    // U+4E2D, two cells wide, 80 times.
+    auto cjk = std::string {};
+    for ([[maybe_unused]] auto const i: std::views::iota(0, 80))
+        cjk += "\xE4\xB8\xAD";
+    BENCHMARK("80 wide CJK characters")
+    {
+        return writeTextToSoA(line, 0, cjk, attrs);
+    };
+}
+
+TEST_CASE("writeCellToSoA", "[!benchmark][SoAWriter]")
+{
+    auto line = LineSoA {};
+    initializeLineSoA(line, ColumnCount(200));
+
+    // A pen per cell that shifts on every run, as lolcat draws: nearly every write adds a new pen to
+    // the line's attribute table (@see InternedAttributes).
+    auto pass = 0;
+    BENCHMARK("200 cells, a truecolor pen each")
+    {
+        ++pass;
+        for (auto const col: std::views::iota(0, 200))
+        {
+            auto const pen = GraphicsAttributes { .foregroundColor = RGBColor((col * 0x010203) + pass) };
+            writeCellToSoA(line, static_cast<size_t>(col), U'x', 1, pen);
+        }
+        return line.sgr.tableSize();
+    };
+}
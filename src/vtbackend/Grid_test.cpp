@@ -6,6 +6,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <format>
 #include <ranges>
@@ -958,6 +959,107 @@ TEST_CASE("Grid resize with wrap and spaces", "[grid]")
     REQUIRE(grid.lineText(LineOffset(0)) == "a a a a");
 }
 
+namespace
+{
+Grid setupGridForLazyReflow(LineCount eagerReflowLineCount = Grid::DefaultEagerReflowLineCount)
+{
+    auto grid = Grid(PageSize { LineCount(2), ColumnCount(6) }, true, LineCount(40), eagerReflowLineCount);
+    for (auto const row: std::views::iota(0, 8))
+    {
+        grid.setLineText(LineOffset(1), std::format("{}ABCDE", row));
+        grid.lineAt(LineOffset(1)).setWrappable(true);
+        grid.scrollUp(LineCount(1));
+    }
+    return grid;
+}
+
+std::vector<std::string> textOf(Grid const& grid)
+{
+    auto text = std::vector<std::string> {};
+    auto const top = -unbox<int>(grid.historyLineCount());
+    for (auto const offset: std::views::iota(top, unbox<int>(grid.pageSize().lines)))
+        text.push_back(grid.lineText(LineOffset::cast_from(offset)));
+    return text;
+}
+} // namespace
+
+TEST_CASE("Grid.reflow.lazy", "[grid]")
+{
+    // A resize rewraps the page and a band of history above it, and sets the rest aside for later
+    // slices. Once those are done, the grid must read exactly as if all of it had been rewrapped at once.
+    auto eager = setupGridForLazyReflow();
+    auto lazy = setupGridForLazyReflow(LineCount(2));
+    auto const resize = [](Grid& grid, ColumnCount columns) {
+        std::ignore = grid.resize(PageSize { LineCount(2), columns }, CellLocation {}, false);
+    };
+
+    auto const before = textOf(lazy);
+    resize(eager, ColumnCount(3));
+    resize(lazy, ColumnCount(3));
+    REQUIRE(!eager.historyReflowPending());
+    REQUIRE(lazy.historyReflowPending());
+
+    // The page and the band are there at once. The six history rows above the band stay in the
+    // history as they were, so the scrollback does not shrink while it waits for the slices; the two
+    // band rows and the page rewrap to seven rows.
+    auto const partial = textOf(lazy);
+    auto const complete = textOf(eager);
+    REQUIRE(lazy.historyLineCount() == LineCount(11));
+    CHECK(std::ranges::equal(partial | std::views::take(6), before | std::views::take(6)));
+    CHECK(std::ranges::equal(partial | std::views::drop(6),
+                             complete | std::views::drop(std::ssize(complete) - 7)));
+    CHECK(lazy.stableRangeFloor()
+          == lazy.stableLineIdOf(LineOffset(0)) - unbox<int64_t>(lazy.historyLineCount()));
+
+    SECTION("slices restore the whole history")
+    {
+        auto const generation = lazy.generation();
+        auto cursor = GridDeltaCursor {};
+        lazy.anchorCursorToHead(cursor);
+        while (lazy.reflowPendingHistory(LineCount(1)))
+            ;
+        CHECK(!lazy.historyReflowPending());
+        CHECK(textOf(lazy) == complete);
+        CHECK(lazy.stableRangeFloor()
+              == lazy.stableLineIdOf(LineOffset(0)) - unbox<int64_t>(lazy.historyLineCount()));
+
+        // The splice is a delta: the rows it replaced come back as changed lines, not as a resync.
+        CHECK(lazy.generation() == generation);
+        auto reported = std::vector<int> {};
+        CHECK(lazy.forEachLineChangedSince(cursor, [&](LineOffset offset, Line const&) {
+            reported.push_back(unbox<int>(offset));
+        }) == GridDeltaResult::Delta);
+        CHECK(std::ranges::includes(reported, std::views::iota(-16, -5)));
+
+        SECTION("and widen again")
+        {
+            resize(eager, ColumnCount(6));
+            resize(lazy, ColumnCount(6));
+            REQUIRE(lazy.historyReflowPending());
+            while (lazy.reflowPendingHistory(LineCount(2)))
+                ;
+            CHECK(textOf(lazy) == textOf(eager));
+        }
+    }
+
+    SECTION("resizing again before the slices are done")
+    {
+        resize(eager, ColumnCount(4));
+        resize(lazy, ColumnCount(4));
+        while (lazy.reflowPendingHistory(LineCount(3)))
+            ;
+        CHECK(textOf(lazy) == textOf(eager));
+    }
+
+    SECTION("clearing the history drops what was set aside")
+    {
+        lazy.clearHistory();
+        CHECK(!lazy.historyReflowPending());
+        CHECK(!lazy.reflowPendingHistory(LineCount(100)));
+        CHECK(lazy.historyLineCount() == LineCount(0));
+    }
+}
+
 // }}}
 
 // {{{ Grid::render extraLines tests
@@ -1612,6 +1714,112 @@ TEST_CASE("Grid.delta.marginScrollMovedRowsAreReported", "[grid][delta]")
     CHECK(grid.lineText(LineOffset(1)) == "CCCCC");
 }
 
+namespace
+{
+struct ChangesWithShifts
+{
+    std::vector<GridRowShift> shifts;
+    std::vector<int> lines;
+};
+
+ChangesWithShifts changesWithShifts(Grid& grid, GridDeltaCursor& cursor)
+{
+    auto out = ChangesWithShifts {};
+    std::ignore = grid.forEachChangeSince(
+        cursor,
+        [&](GridRowShift const& shift) { out.shifts.push_back(shift); },
+        [&](LineOffset offset, Line const&) { out.lines.push_back(unbox<int>(offset)); });
+    return out;
+}
+
+Margin rowsMargin(int from, int to, int columns)
+{
+    return Margin { .vertical = Margin::Vertical { .from = LineOffset(from), .to = LineOffset(to) },
+                    .horizontal =
+                        Margin::Horizontal { .from = ColumnOffset(0), .to = ColumnOffset(columns - 1) } };
+}
+} // namespace
+
+TEST_CASE("Grid.delta.marginScrollIsReportedAsOneShift", "[grid][delta]")
+{
+    auto grid = Grid(PageSize { LineCount(5), ColumnCount(5) }, false, LineCount(0));
+    for (auto const line: std::views::iota(0, 5))
+        grid.setLineText(LineOffset(line), std::string(5, static_cast<char>('A' + line)));
+    auto cursor = drainedCursor(grid);
+    auto const top = grid.stableLineIdOf(LineOffset(1));
+    auto const bottom = grid.stableLineIdOf(LineOffset(3));
+
+    // Two lines' worth within one batch log one shift; only the two exposed rows are lines.
+    std::ignore = grid.scrollUp(LineCount(1), GraphicsAttributes {}, rowsMargin(1, 3, 5));
+    std::ignore = grid.scrollUp(LineCount(1), GraphicsAttributes {}, rowsMargin(1, 3, 5));
+    auto changes = changesWithShifts(grid, cursor);
+    REQUIRE(changes.shifts.size() == 1);
+    CHECK(changes.shifts[0].top == top);
+    CHECK(changes.shifts[0].bottom == bottom);
+    CHECK(changes.shifts[0].count == 2);
+    CHECK(changes.lines == std::vector { 2, 3 });
+    CHECK(grid.lineText(LineOffset(1)) == "DDDDD");
+
+    grid.scrollDown(LineCount(1), GraphicsAttributes {}, rowsMargin(1, 3, 5));
+    changes = changesWithShifts(grid, cursor);
+    REQUIRE(changes.shifts.size() == 1);
+    CHECK(changes.shifts[0].count == -1);
+    CHECK(changes.lines == std::vector { 1 });
+    CHECK(grid.lineText(LineOffset(2)) == "DDDDD");
+
+    // Nothing new: the shifts are not reported twice.
+    changes = changesWithShifts(grid, cursor);
+    CHECK(changes.shifts.empty());
+    CHECK(changes.lines.empty());
+}
+
+TEST_CASE("Grid.delta.aConsumerThatMissedShiftsGetsEveryRow", "[grid][delta]")
+{
+    auto grid = Grid(PageSize { LineCount(4), ColumnCount(5) }, false, LineCount(0));
+    auto stale = drainedCursor(grid);
+    auto current = stale;
+
+    // One shift per batch, each batch closed by the consumer that keeps up, until the log has
+    // dropped the first one.
+    for ([[maybe_unused]] auto const batch: std::views::iota(size_t { 0 }, Grid::MaxRowShifts + 1))
+    {
+        std::ignore = grid.scrollUp(LineCount(1), GraphicsAttributes {}, rowsMargin(0, 2, 5));
+        std::ignore = changesWithShifts(grid, current);
+    }
+
+    auto const changes = changesWithShifts(grid, stale);
+    CHECK(changes.shifts.empty());
+    CHECK(changes.lines == std::vector { 0, 1, 2, 3 });
+}
+
+TEST_CASE("Grid.semanticLines.followMarksThroughScrollsAndEviction", "[grid]")
+{
+    auto grid = Grid(PageSize { LineCount(3), ColumnCount(5) }, false, LineCount(4));
+    auto const page = LineOffset(3);
+    CHECK_FALSE(grid.findFlaggedLineAbove(page, LineFlag::Marked).has_value());
+
+    grid.lineAt(LineOffset(1)).setMarked(true);
+    grid.lineAt(LineOffset(2)).setFlag(LineFlag::OutputStart, true);
+    CHECK(grid.findFlaggedLineAbove(page, LineFlag::Marked) == LineOffset(1));
+    CHECK(grid.findFlaggedLineAbove(page, LineFlag::OutputStart) == LineOffset(2));
+    CHECK(grid.findFlaggedLineAbove(LineOffset(2), LineFlag::OutputStart) == std::nullopt);
+    CHECK(grid.findFlaggedLineBelow(LineOffset(0), LineFlag::Marked) == LineOffset(1));
+
+    // Into the history, where the mark keeps its row.
+    grid.scrollUp(LineCount(2));
+    CHECK(grid.findFlaggedLineAbove(page, LineFlag::Marked) == LineOffset(-1));
+    CHECK(grid.findFlaggedLineBelow(LineOffset(-2), LineFlag::Marked) == LineOffset(-1));
+
+    // Cleared in place, deep in the history: nothing scrolled, and the index still hears of it.
+    grid.lineAt(LineOffset(-1)).setMarked(false);
+    CHECK_FALSE(grid.findFlaggedLineAbove(page, LineFlag::Marked).has_value());
+
+    // Evicted: scrolled past the history limit, the row is gone and so is its mark.
+    CHECK(grid.findFlaggedLineAbove(page, LineFlag::OutputStart) == LineOffset(0));
+    grid.scrollUp(LineCount(5));
+    CHECK_FALSE(grid.findFlaggedLineAbove(page, LineFlag::OutputStart).has_value());
+}
+
 TEST_CASE("Grid.delta.resizeForcesOneResyncThenDeltas", "[grid][delta]")
 {
     auto grid = Grid(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(5));
@@ -8,6 +8,7 @@
 #include <memory>
 #include <ranges>
 #include <utility>
+#include <vector>
 
 // clang-format off
 #if (__cpp_lib_simd >= 202411L)
@@ -411,16 +412,48 @@ Image::Data RasterizedImage::fragment(CellLocation pos, ImageSize targetCellSize
     return fragmentData;
 }
 
+crispy::StrongHash ImagePool::contentHash(ImageFormat format,
+                                          ImageSize pixelSize,
+                                          Image::Data const& data) noexcept
+{
+    return crispy::StrongHash::compute(data.data(), data.size())
+           * crispy::StrongHash(static_cast<uint32_t>(format),
+                                unbox<uint32_t>(pixelSize.width),
+                                unbox<uint32_t>(pixelSize.height),
+                                static_cast<uint32_t>(data.size()));
+}
+
+shared_ptr<Image const> ImagePool::findImageByContent(crispy::StrongHash const& hash,
+                                                      ImageFormat format,
+                                                      ImageSize pixelSize,
+                                                      Image::Data const& data) const
+{
+    auto const _ = std::lock_guard { _idIndex->mutex };
+    auto const it = _idIndex->contents.find(hash);
+    if (it == _idIndex->contents.end())
+        return {};
+    auto image = it->second.lock();
+    if (!image || image->format() != format || image->size() != pixelSize || image->data() != data)
+        return {};
+    return image;
+}
+
 shared_ptr<Image const> ImagePool::create(ImageFormat format, ImageSize size, Image::Data&& data)
 {
-    // TODO: This operation should be idempotent, i.e. if that image has been created already, return a
-    // reference to that.
+    auto const hash = contentHash(format, size, data);
+    if (auto existing = findImageByContent(hash, format, size, data))
+        return existing;
+
     auto const id = _nextImageId++;
     // The remover prunes the id index before the user's callback runs. It captures the
     // index by shared_ptr, never the pool: an image's last reference may outlive the
     // pool member order-wise, and it may drop on any thread.
     auto image = make_shared<Image>(
-        id, format, std::move(data), size, [index = _idIndex, remover = _onImageRemove](Image const* image) {
+        id,
+        format,
+        std::move(data),
+        size,
+        [index = _idIndex, hash, remover = _onImageRemove](Image const* image) {
             {
                 auto const _ = std::lock_guard { index->mutex };
                 // Prune only if this dying image still owns its slot. After the uint32
@@ -432,6 +465,11 @@ shared_ptr<Image const> ImagePool::create(ImageFormat format, ImageSize size, Im
                 if (auto const it = index->images.find(image->id().value);
                     it != index->images.end() && it->second.expired())
                     index->images.erase(it);
+                // Same reasoning for the content slot: a colliding hash may have been taken
+                // over by a different, still-live image.
+                if (auto const it = index->contents.find(hash);
+                    it != index->contents.end() && it->second.expired())
+                    index->contents.erase(it);
             }
             if (remover)
                 remover(image);
@@ -444,6 +482,7 @@ shared_ptr<Image const> ImagePool::create(ImageFormat format, ImageSize size, Im
         // leaving the new live image unindexed — findImageById would then miss it
         // and callers would wrongly treat a present image as gone.
         _idIndex->images.insert_or_assign(id.value, image);
+        _idIndex->contents.insert_or_assign(hash, image);
     }
     return image;
 }
@@ -456,6 +495,24 @@ shared_ptr<Image const> ImagePool::findImageById(ImageId id) const
     return {};
 }
 
+size_t ImagePool::liveBytes() const
+{
+    // The images are collected and only summed and released after the index is unlocked: dropping
+    // what turns out to be the last reference runs the image's remover, which takes the same lock.
+    auto live = std::vector<shared_ptr<Image const>> {};
+    {
+        auto const _ = std::lock_guard { _idIndex->mutex };
+        live.reserve(_idIndex->images.size());
+        for (auto const& weak: _idIndex->images | std::views::values)
+            if (auto image = weak.lock())
+                live.emplace_back(std::move(image));
+    }
+    auto bytes = size_t { 0 };
+    for (auto const& image: live)
+        bytes += image->data().size();
+    return bytes;
+}
+
 shared_ptr<RasterizedImage> rasterize(shared_ptr<Image const> image,
                                       ImageAlignment alignmentPolicy,
                                       ImageResize resizePolicy,
@@ -492,6 +549,7 @@ void ImagePool::clear()
     {
         auto const _ = std::lock_guard { _idIndex->mutex };
         _idIndex->images.clear();
+        _idIndex->contents.clear();
     }
 }
 
@@ -366,6 +366,16 @@ class ImagePool
     ImagePool(OnImageRemove onImageRemove = [](auto) {}, ImageId nextImageId = ImageId(1));
 
     /// Creates an RGBA image of given size in pixels.
+    ///
+    /// Content-addressed: if a live image with identical format, size and pixel data exists in this
+    /// pool, that image is returned instead of a new one. Applications that re-send the same frame
+    /// (sixel/Kitty animations, dashboards redrawing a logo) therefore share one Image, one image id,
+    /// one GPU texture and one daemon-side ImageData transfer, however often they repeat it.
+    ///
+    /// @param format    Pixel format of @p data.
+    /// @param pixelSize Image dimensions in pixels.
+    /// @param data      Decoded pixmap; left untouched-but-unused when an existing image is reused.
+    /// @return The new or the reused image.
     std::shared_ptr<Image const> create(ImageFormat format, ImageSize pixelSize, Image::Data&& data);
 
     // named image access
@@ -382,6 +392,10 @@ class ImagePool
     ///      is not internally guarded — a dangling pool pointer is use-after-free.
     [[nodiscard]] std::shared_ptr<Image const> findImageById(ImageId id) const;
 
+    /// @return The pixel bytes of every live image, for the daemon's metrics. Walks the id
+    ///         index, so it costs one step per live image; not meant for a hot path.
+    [[nodiscard]] size_t liveBytes() const;
+
     void inspect(std::ostream& os) const;
 
     void clear();
@@ -395,16 +409,43 @@ class ImagePool
 
     using NameToImageIdCache = crispy::StrongLRUCache<std::string, std::shared_ptr<Image const>>;
 
+    /// Hashes a StrongHash into a bucket index for the content index.
+    struct ContentHasher
+    {
+        size_t operator()(crispy::StrongHash const& hash) const noexcept
+        {
+            return static_cast<size_t>(static_cast<uint32_t>(crispy::toInteger(hash)));
+        }
+    };
+
     /// The id index behind findImageById(): weak_ptrs so the index never extends image
     /// lifetime (eviction stays refcount-driven), shared with each image's remover so
     /// pruning is safe regardless of destruction order, and mutex-guarded because the
     /// last reference can drop on any thread (e.g. the GUI's render thread).
+    ///
+    /// The content index behind create()'s deduplication follows the same rules: it maps a
+    /// pixmap's content hash to the live image carrying that content, and never keeps it alive.
     struct IdIndex
     {
         std::mutex mutex;
         std::unordered_map<uint32_t, std::weak_ptr<Image const>> images;
+        std::unordered_map<crispy::StrongHash, std::weak_ptr<Image const>, ContentHasher> contents;
     };
 
+    /// Computes the content key of a pixmap: its format and size are folded in, so two images
+    /// whose bytes agree but whose geometry differs never share a key.
+    [[nodiscard]] static crispy::StrongHash contentHash(ImageFormat format,
+                                                        ImageSize pixelSize,
+                                                        Image::Data const& data) noexcept;
+
+    /// Looks up a live image with exactly the given content.
+    /// @return The image, or nullptr if none is live. Byte-compares on a hash hit, so a hash
+    ///         collision can never alias two different images.
+    [[nodiscard]] std::shared_ptr<Image const> findImageByContent(crispy::StrongHash const& hash,
+                                                                  ImageFormat format,
+                                                                  ImageSize pixelSize,
+                                                                  Image::Data const& data) const;
+
     // data members
     //
     ImageId _nextImageId;                      //!< ID for next image to be put into the pool
@@ -301,9 +301,10 @@ TEST_CASE("ImagePool.idIndexSurvivesIdWrapReuse", "[image]")
 
     // Rewind the counter so the next create() re-issues the SAME id while `first` is
     // still alive -- exactly the state a real uint32 id-counter wrap produces.
+    // The pixel differs from `first`'s so content deduplication does not hand `first` back.
     ImagePoolIdWrapTester::rewindNextId(pool, reusedId);
     auto second =
-        pool.create(ImageFormat::RGBA, ImageSize { Width(1), Height(1) }, Image::Data { 0, 0, 0, 0xFF });
+        pool.create(ImageFormat::RGBA, ImageSize { Width(1), Height(1) }, Image::Data { 0xFF, 0, 0, 0xFF });
     REQUIRE(second->id() == reusedId);
     CHECK(second.get() != first.get());
 
@@ -323,3 +324,52 @@ TEST_CASE("ImagePool.idIndexSurvivesIdWrapReuse", "[image]")
     second.reset();
     CHECK(pool.findImageById(reusedId) == nullptr);
 }
+
+TEST_CASE("ImagePool.createDeduplicatesIdenticalContent", "[image]")
+{
+    auto pool = ImagePool {};
+    auto const size = ImageSize { Width(2), Height(1) };
+    auto const pixels = Image::Data { 1, 2, 3, 0xFF, 4, 5, 6, 0xFF };
+
+    auto first = pool.create(ImageFormat::RGBA, size, Image::Data(pixels));
+    auto second = pool.create(ImageFormat::RGBA, size, Image::Data(pixels));
+
+    // Identical content while the first is alive: the very same image, and thus the same id.
+    CHECK(second.get() == first.get());
+    CHECK(second->id() == first->id());
+
+    // Same bytes, different geometry or format: never shared.
+    auto const transposed =
+        pool.create(ImageFormat::RGBA, ImageSize { Width(1), Height(2) }, Image::Data(pixels));
+    CHECK(transposed.get() != first.get());
+    auto const asRgb =
+        pool.create(ImageFormat::RGB, ImageSize { Width(1), Height(1) }, Image::Data { 1, 2, 3 });
+    CHECK(asRgb.get() != first.get());
+
+    // Different pixels: a new image.
+    auto changed = pixels;
+    changed[0] = 9;
+    auto const other = pool.create(ImageFormat::RGBA, size, std::move(changed));
+    CHECK(other.get() != first.get());
+    CHECK(other->id() != first->id());
+}
+
+TEST_CASE("ImagePool.contentIndexTracksImageLifetime", "[image]")
+{
+    auto removed = 0;
+    auto pool = ImagePool { [&](Image const*) { ++removed; } };
+    auto const size = ImageSize { Width(1), Height(1) };
+
+    auto image = pool.create(ImageFormat::RGBA, size, Image::Data { 7, 7, 7, 0xFF });
+    auto const firstId = image->id();
+
+    // The content index never keeps an image alive: dropping the last reference still removes it.
+    image.reset();
+    CHECK(removed == 1);
+
+    // Re-sending the content afterwards creates a fresh image rather than resurrecting a stale entry.
+    auto again = pool.create(ImageFormat::RGBA, size, Image::Data { 7, 7, 7, 0xFF });
+    REQUIRE(again != nullptr);
+    CHECK(again->id() != firstId);
+    CHECK(pool.findImageById(again->id()).get() == again.get());
+}
@@ -27,6 +27,12 @@ using namespace std;
 namespace vtbackend
 {
 
+namespace
+{
+    constexpr auto BracketedPasteStart = CSI "200~"sv;
+    constexpr auto BracketedPasteEnd = CSI "201~"sv;
+} // namespace
+
 string toString(Modifiers modifiers)
 {
     return std::format("{}", modifiers);
@@ -1018,6 +1024,8 @@ bool InputGenerator::generate(char32_t characterEvent,
                               KeyboardModifiers modifiers,
                               KeyboardEventType eventType)
 {
+    interruptPaste(modifiers, eventType);
+
     // Win32 Input Mode supersedes all other keyboard protocols when active.
     // It is the native ConPTY input format and carries richer key information
     // (VK codes, scan codes) than CSI u in the Windows environment.
@@ -1045,7 +1053,7 @@ bool InputGenerator::generate(char32_t characterEvent,
 
     if (success)
     {
-        _pendingSequence += _keyboardInputGenerator.take();
+        sink() += _keyboardInputGenerator.take();
         inputLog()("Sending {} \"{}\" {}.",
                    modifiers,
                    crispy::escape(unicode::convert_to<char>(characterEvent)),
@@ -1076,6 +1084,9 @@ static constexpr Modifiers stripSelfModifier(Key key, Modifiers modifiers) noexc
 
 bool InputGenerator::generate(Key key, KeyboardModifiers modifiers, KeyboardEventType eventType)
 {
+    if (!isModifierKey(key))
+        interruptPaste(modifiers, eventType);
+
     if (_win32InputMode)
     {
         auto effectiveModifiers = modifiers;
@@ -1094,44 +1105,145 @@ bool InputGenerator::generate(Key key, KeyboardModifiers modifiers, KeyboardEven
 
     if (success)
     {
-        _pendingSequence += _keyboardInputGenerator.take();
+        sink() += _keyboardInputGenerator.take();
         inputLog()("Sending {} \"{}\" {}.", modifiers, key, eventType);
     }
 
     return success;
 }
 
-void InputGenerator::generatePaste(std::string_view const& text)
+void InputGenerator::generatePaste(std::string text)
 {
     inputLog()("Sending paste of {} bytes.", text.size());
 
     if (text.empty())
         return;
 
-    if (_bracketedPaste)
-        append("\033[200~"sv);
+    // Input held back behind an earlier paste was generated before this one, so it goes before it.
+    if (!_pastes.empty() && !_heldSequence.empty())
+    {
+        _pastes.push_back(PasteStream { .text = std::exchange(_heldSequence, {}),
+                                        .kind = PasteStreamKind::HeldInput });
+    }
+
+    _pastes.push_back(PasteStream { .text = std::move(text),
+                                    .kind = _bracketedPaste ? PasteStreamKind::Bracketed
+                                                            : PasteStreamKind::Plain });
+
+    if (peek().empty())
+        refillFromPaste();
+}
+
+std::array<std::string_view, 3> InputGenerator::partsOf(PasteStream const& paste) noexcept
+{
+    if (paste.kind != PasteStreamKind::Bracketed)
+        return { std::string_view {}, paste.text, std::string_view {} };
+    return { BracketedPasteStart, paste.text, BracketedPasteEnd };
+}
+
+size_t InputGenerator::sizeOf(PasteStream const& paste) noexcept
+{
+    auto total = size_t { 0 };
+    for (auto const part: partsOf(paste))
+        total += part.size();
+    return total;
+}
+
+size_t InputGenerator::pendingPasteBytes() const noexcept
+{
+    auto total = size_t { 0 };
+    for (auto const& paste: _pastes)
+        if (paste.kind != PasteStreamKind::HeldInput)
+            total += sizeOf(paste) - paste.offset;
+    return total;
+}
+
+void InputGenerator::cancelPaste()
+{
+    if (!pasteInProgress())
+        return;
+
+    inputLog()("Cancelling paste with {} bytes left.", pendingPasteBytes());
+
+    // Only the front stream can have been partially handed out. If it is a bracketed paste that has,
+    // the application is inside the brackets now: whatever of the closing marker is still pending goes
+    // right behind what was handed out, and the text before it is dropped.
+    auto remaining = std::deque<PasteStream> {};
+    auto& front = _pastes.front();
+    if (front.kind == PasteStreamKind::Bracketed && front.offset != 0)
+    {
+        auto const closing = sizeOf(front) - BracketedPasteEnd.size();
+        _pendingSequence.append(BracketedPasteEnd.substr(std::max(front.offset, closing) - closing));
+    }
+    else if (front.kind == PasteStreamKind::HeldInput)
+        remaining.push_back(std::move(front));
+
+    for (auto& paste: _pastes | std::views::drop(1))
+        if (paste.kind == PasteStreamKind::HeldInput)
+            remaining.push_back(std::move(paste));
+
+    _pastes = std::move(remaining);
+    if (peek().empty())
+        refillFromPaste();
+    releaseHeldInput();
+}
+
+void InputGenerator::interruptPaste(KeyboardModifiers modifiers, KeyboardEventType eventType)
+{
+    if (pasteInProgress() && eventType != KeyboardEventType::Release
+        && modifiers.chord.contains(Modifier::Control))
+        cancelPaste();
+}
+
+void InputGenerator::refillFromPaste()
+{
+    if (_pastes.empty())
+        return;
+
+    // The chunk is cut from the paste's parts as they are, so the paste is never copied whole.
+    auto& paste = _pastes.front();
+    auto skip = paste.offset;
+    auto budget = PasteChunkSize;
+    for (auto const part: partsOf(paste))
+    {
+        auto const chunk = part.substr(std::min(skip, part.size()), budget);
+        skip -= std::min(skip, part.size());
+        _pendingSequence.append(chunk);
+        paste.offset += chunk.size();
+        budget -= chunk.size();
+    }
 
-    append(text);
+    if (paste.offset == sizeOf(paste))
+        _pastes.pop_front();
+
+    releaseHeldInput();
+}
+
+void InputGenerator::releaseHeldInput()
+{
+    if (!_pastes.empty() || _heldSequence.empty())
+        return;
 
-    if (_bracketedPaste)
-        append("\033[201~"sv);
+    _pendingSequence += _heldSequence;
+    _heldSequence.clear();
 }
 
 inline bool InputGenerator::append(std::string_view sequence)
 {
-    _pendingSequence.insert(end(_pendingSequence), begin(sequence), end(sequence));
+    auto& target = sink();
+    target.insert(end(target), begin(sequence), end(sequence));
     return true;
 }
 
 inline bool InputGenerator::append(char asciiChar)
 {
-    _pendingSequence.push_back(asciiChar);
+    sink().push_back(asciiChar);
     return true;
 }
 
 inline bool InputGenerator::append(uint8_t byte)
 {
-    _pendingSequence.push_back(static_cast<char>(byte));
+    sink().push_back(static_cast<char>(byte));
     return true;
 }
 
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <deque>
 #include <format>
 #include <optional>
 #include <set>
@@ -702,7 +703,32 @@ class InputGenerator
                         eventType);
     }
     bool generate(Key key, KeyboardModifiers modifiers, KeyboardEventType eventType);
-    void generatePaste(std::string_view const& text);
+
+    /// Upper bound of paste bytes handed out by a single peek().
+    static constexpr size_t PasteChunkSize = 64 * 1024;
+
+    /// Queues @p text as a paste, framed by the bracketed-paste markers if that mode is enabled.
+    ///
+    /// The paste is streamed rather than copied into the pending sequence in one piece: peek() hands it
+    /// out at most PasteChunkSize bytes at a time, straight from @p text and refilling as the caller
+    /// consumes, so the caller can feed the PTY only as fast as the application drains it. Any input
+    /// generated while a paste is in flight is held back and follows it, so a keystroke never lands
+    /// between the paste's brackets. A key pressed with Control is the exception: it cancels the paste
+    /// (@see cancelPaste()) and follows what was handed out already, so Ctrl+C never waits for
+    /// megabytes of paste to go out first.
+    void generatePaste(std::string text);
+
+    /// @return whether a paste still has bytes that peek() has not handed out yet.
+    [[nodiscard]] bool pasteInProgress() const noexcept { return !_pastes.empty(); }
+
+    /// @return the number of paste bytes, framing included, that peek() has not handed out yet.
+    [[nodiscard]] size_t pendingPasteBytes() const noexcept;
+
+    /// Abandons the paste in flight, and any queued behind it.
+    ///
+    /// Bytes already handed out by peek() are unaffected. A bracketed paste whose opening marker has
+    /// been handed out is still closed, so the application is never left in paste mode.
+    void cancelPaste();
     bool generateMousePress(Modifiers modifier,
                             MouseButton button,
                             CellLocation pos,
@@ -740,6 +766,7 @@ class InputGenerator
         {
             _consumedBytes = 0;
             _pendingSequence.clear();
+            refillFromPaste();
         }
     }
 
@@ -813,6 +840,40 @@ class InputGenerator
     inline bool append(uint8_t byte);
     inline bool append(unsigned int asciiChar);
 
+    enum class PasteStreamKind : uint8_t
+    {
+        Plain,     ///< A paste sent as-is.
+        Bracketed, ///< A paste framed by the bracketed-paste markers (already part of its text).
+        HeldInput, ///< Not a paste: input generated between two pastes, kept in order. Never cancelled.
+    };
+
+    struct PasteStream
+    {
+        std::string text;  ///< The paste as handed over, framing excluded, or the held-back input.
+        size_t offset = 0; ///< Number of bytes, framing included, already moved into the pending sequence.
+        PasteStreamKind kind = PasteStreamKind::Plain;
+    };
+
+    /// @return the parts @p paste is streamed from, in order: its text, between its framing if it has any.
+    [[nodiscard]] static std::array<std::string_view, 3> partsOf(PasteStream const& paste) noexcept;
+
+    /// @return the number of bytes @p paste streams, framing included.
+    [[nodiscard]] static size_t sizeOf(PasteStream const& paste) noexcept;
+
+    /// Cancels the paste in flight if a key pressed with @p modifiers is to go out ahead of it.
+    void interruptPaste(KeyboardModifiers modifiers, KeyboardEventType eventType);
+
+    /// Moves the next chunk of the paste in flight into the (fully consumed) pending sequence, and
+    /// releases the held-back input once the last paste has been handed out.
+    void refillFromPaste();
+
+    /// Releases the input held back behind the pastes, once none is left.
+    void releaseHeldInput();
+
+    /// @return where newly generated input goes: straight to the pending sequence, or, while a paste
+    ///         is in flight, to the held-back sequence that follows it.
+    [[nodiscard]] Sequence& sink() noexcept { return _pastes.empty() ? _pendingSequence : _heldSequence; }
+
     // private fields
     //
     bool _bracketedPaste = false;
@@ -826,6 +887,8 @@ class InputGenerator
     int _modifyOtherKeys = 0;
     Sequence _pendingSequence {};
     int _consumedBytes {};
+    std::deque<PasteStream> _pastes {};
+    Sequence _heldSequence {};
 
     std::set<MouseButton> _currentlyPressedMouseButtons {};
     CellLocation _currentMousePosition {}; // current mouse position
@@ -1946,3 +1946,127 @@ TEST_CASE("InputGenerator.reset.clears_keyboard_modes", "[terminal][input]")
     input.generate(Key::Backspace, Modifiers {}, KeyboardEventType::Press);
     CHECK(escape(input.peek()) == escape("\x7F"sv));
 }
+
+// {{{ paste streaming
+namespace
+{
+std::string drainInput(InputGenerator& input)
+{
+    auto output = std::string {};
+    while (!input.peek().empty())
+    {
+        output += input.peek();
+        input.consume(static_cast<int>(input.peek().size()));
+    }
+    return output;
+}
+} // namespace
+
+TEST_CASE("InputGenerator.paste.streams_in_chunks", "[terminal][input][paste]")
+{
+    auto input = InputGenerator {};
+    input.setBracketedPaste(true);
+    auto const text = std::string(3 * InputGenerator::PasteChunkSize + 17, 'x');
+    auto const framed = "\033[200~" + text + "\033[201~";
+
+    input.generatePaste(text);
+
+    // The paste is handed out a chunk at a time, never as one multi-megabyte sequence.
+    CHECK(input.peek().size() == InputGenerator::PasteChunkSize);
+    CHECK(input.pasteInProgress());
+    CHECK(input.pendingPasteBytes() == framed.size() - InputGenerator::PasteChunkSize);
+
+    // A partial consume (a short PTY write) does not refill: the rest is what gets retried.
+    auto output = std::string(input.peek().substr(0, 100));
+    input.consume(100);
+    CHECK(input.peek().size() == InputGenerator::PasteChunkSize - 100);
+
+    output += drainInput(input);
+    CHECK(output == framed);
+    CHECK_FALSE(input.pasteInProgress());
+}
+
+TEST_CASE("InputGenerator.paste.input_waits_for_paste_to_finish", "[terminal][input][paste]")
+{
+    auto input = InputGenerator {};
+    input.setBracketedPaste(true);
+    auto const text = std::string(2 * InputGenerator::PasteChunkSize, 'p');
+
+    input.generatePaste(text);
+    input.generateRaw("\033[0n"sv); // a reply generated while the paste is in flight
+    input.generatePaste("second");
+    input.generateRaw("k"sv);
+
+    CHECK(drainInput(input) == "\033[200~" + text + "\033[201~" + "\033[0n" + "\033[200~second\033[201~k");
+}
+
+TEST_CASE("InputGenerator.paste.cancel", "[terminal][input][paste]")
+{
+    auto const text = std::string(4 * InputGenerator::PasteChunkSize, 'c');
+
+    SECTION("cancelling a started bracketed paste still closes it")
+    {
+        auto input = InputGenerator {};
+        input.setBracketedPaste(true);
+        input.generatePaste(text);
+        auto const first = std::string(input.peek());
+        input.consume(static_cast<int>(first.size()));
+        input.generateRaw("k"sv);
+
+        input.cancelPaste();
+
+        CHECK_FALSE(input.pasteInProgress());
+        CHECK(input.pendingPasteBytes() == 0);
+        CHECK(escape(drainInput(input)) == escape(std::string(InputGenerator::PasteChunkSize, 'c')
+                                                  + "\033[201~k"));
+    }
+
+    SECTION("cancelling a paste that has not started drops it entirely")
+    {
+        auto input = InputGenerator {};
+        input.setBracketedPaste(true);
+        input.generateRaw("a"sv);
+        input.generatePaste(text);
+        input.generateRaw("b"sv);
+
+        input.cancelPaste();
+
+        CHECK(drainInput(input) == "ab");
+    }
+
+    SECTION("cancelling once the closing marker is split across chunks keeps its remainder")
+    {
+        auto input = InputGenerator {};
+        input.setBracketedPaste(true);
+        // The first chunk ends in "\033[2", the stream still holds "01~".
+        input.generatePaste(std::string(InputGenerator::PasteChunkSize - 9, 'c'));
+        REQUIRE(input.pendingPasteBytes() == 3);
+
+        input.cancelPaste();
+
+        CHECK(drainInput(input)
+              == "\033[200~" + std::string(InputGenerator::PasteChunkSize - 9, 'c') + "\033[201~");
+    }
+
+    SECTION("a key pressed with Control cancels the paste and goes out right behind it")
+    {
+        auto input = InputGenerator {};
+        input.setBracketedPaste(true);
+        input.generatePaste(text);
+        input.generate(U'a', Modifiers {}, KeyboardEventType::Press); // held back behind the paste
+        input.generate(U'c', Modifier::Control, KeyboardEventType::Press);
+
+        CHECK_FALSE(input.pasteInProgress());
+        auto const handedOut = "\033[200~" + std::string(InputGenerator::PasteChunkSize - 6, 'c');
+        CHECK(escape(drainInput(input)) == escape(handedOut + "\033[201~a\x03"));
+    }
+
+    SECTION("nothing to cancel")
+    {
+        auto input = InputGenerator {};
+        input.generateRaw("x"sv);
+        input.cancelPaste();
+        CHECK(input.peek() == "x");
+    }
+}
+// }}}
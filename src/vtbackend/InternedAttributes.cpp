@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/InternedAttributes.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <utility>
+
+namespace vtbackend
+{
+
+namespace
+{
+    /// Where the probe sequence for @p attrs starts in a hash index of @p slotCount slots.
+    size_t slotOf(GraphicsAttributes const& attrs, size_t slotCount) noexcept
+    {
+        auto const colors =
+            (uint64_t { attrs.foregroundColor.content } << 32) | attrs.backgroundColor.content;
+        auto const rest = (uint64_t { attrs.underlineColor.content } << 32) | attrs.flags.value();
+        // Fibonacci hashing: the top bits of the product depend on every bit of the key.
+        auto const hash = (colors ^ std::rotl(rest, 23)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash >> (64 - std::countr_zero(slotCount)));
+    }
+} // namespace
+
+void InternedAttributes::copyFrom(InternedAttributes const& src,
+                                  size_t srcCol,
+                                  size_t dstCol,
+                                  size_t count)
+{
+    assert(srcCol + count <= src._indices.size());
+    assert(dstCol + count <= _indices.size());
+
+    if (&src == this)
+    {
+        move(srcCol, dstCol, count);
+        return;
+    }
+
+    for (auto const i: std::views::iota(size_t { 0 }, count))
+    {
+        // Runs in the source stay runs here: re-read the cell just written rather than caching its
+        // index, which a compaction in between would have renumbered.
+        if (i > 0 && src._indices[srcCol + i] == src._indices[srcCol + i - 1])
+            _indices[dstCol + i] = _indices[dstCol + i - 1];
+        else
+            _indices[dstCol + i] = intern(src._table[src._indices[srcCol + i]]);
+    }
+}
+
+InternedAttributes::Index InternedAttributes::internSlow(GraphicsAttributes attrs)
+{
+    if (auto const hit = find(attrs); hit != NoIndex)
+    {
+        _last = hit;
+        return _last;
+    }
+
+    // A line holds at most size() distinct attributes, so letting the table reach twice that before
+    // compacting keeps the table bounded and the compaction cost amortized over the writes between.
+    if (_table.size() >= std::clamp(2 * _indices.size(), MinCompactionThreshold, MaxTableSize))
+        compact();
+    assert(_table.size() < MaxTableSize);
+
+    _table.push_back(attrs);
+    _last = static_cast<Index>(_table.size() - 1);
+    indexNewest();
+    return _last;
+}
+
+InternedAttributes::Index InternedAttributes::find(GraphicsAttributes attrs) const noexcept
+{
+    if (_slots.empty())
+    {
+        // Newest first: a pen that was just added is the likeliest to come back.
+        auto const newestFirst = std::views::reverse(_table);
+        auto const hit = std::ranges::find(newestFirst, attrs);
+        return hit != newestFirst.end() ? static_cast<Index>(std::distance(_table.begin(), hit.base()) - 1)
+                                        : NoIndex;
+    }
+
+    auto const mask = _slots.size() - 1;
+    auto slot = slotOf(attrs, _slots.size());
+    while (_slots[slot] != NoIndex)
+    {
+        if (_table[_slots[slot]] == attrs)
+            return _slots[slot];
+        slot = (slot + 1) & mask;
+    }
+    return NoIndex;
+}
+
+void InternedAttributes::indexNewest()
+{
+    if (_table.size() <= SearchedTableSize)
+        return;
+
+    if (2 * _table.size() > _slots.size())
+    {
+        rebuildSlots();
+        return;
+    }
+
+    auto const mask = _slots.size() - 1;
+    auto slot = slotOf(_table.back(), _slots.size());
+    while (_slots[slot] != NoIndex)
+        slot = (slot + 1) & mask;
+    _slots[slot] = _last;
+}
+
+void InternedAttributes::rebuildSlots()
+{
+    if (_table.size() <= SearchedTableSize)
+    {
+        _slots.clear();
+        return;
+    }
+
+    // Four slots per entry leaves room to double the table before the index has to grow again.
+    _slots.assign(std::bit_ceil(4 * _table.size()), NoIndex);
+    auto const mask = _slots.size() - 1;
+    for (auto const index: std::views::iota(size_t { 0 }, _table.size()))
+    {
+        auto slot = slotOf(_table[index], _slots.size());
+        while (_slots[slot] != NoIndex)
+            slot = (slot + 1) & mask;
+        _slots[slot] = static_cast<Index>(index);
+    }
+}
+
+void InternedAttributes::compact()
+{
+    // Only a table past SearchedTableSize is ever compacted, so the hash index exists and is larger
+    // than the table. It is rebuilt below anyway and serves as the remap from old to new index until
+    // then, which keeps compaction free of allocations.
+    static_assert(MinCompactionThreshold > SearchedTableSize);
+    assert(_slots.size() >= _table.size());
+    auto remap = std::span(_slots).first(_table.size());
+
+    std::ranges::fill(remap, NoIndex);
+    for (auto const index: _indices)
+        remap[index] = 0;
+
+    // Survivors keep their order, so each moves down or stays put and the table compacts in place.
+    auto kept = size_t { 0 };
+    for (auto const index: std::views::iota(size_t { 0 }, _table.size()))
+        if (remap[index] != NoIndex)
+        {
+            _table[kept] = _table[index];
+            remap[index] = static_cast<Index>(kept++);
+        }
+    _table.resize(kept);
+
+    for (auto& index: _indices)
+        index = remap[index];
+
+    _last = 0;
+    rebuildSlots();
+}
+
+} // namespace vtbackend
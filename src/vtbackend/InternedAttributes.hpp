@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/GraphicsAttributes.hpp>
+
+#include <crispy/AlignedAllocator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace vtbackend
+{
+
+/// The graphics attributes of one line's cells, interned.
+///
+/// A line rarely uses more than a handful of distinct pens, yet storing a GraphicsAttributes per cell
+/// spends 16 bytes on each. Here each cell holds a 2-byte index into a per-line table of the
+/// distinct attributes in use instead.
+///
+/// Invariants:
+/// - Table entries are pairwise distinct, so two cells have equal attributes if and only if they
+///   have equal indices (@see indexAt()). Run detection never has to compare the attributes.
+/// - Entries no cell refers to any more are left in place until the table outgrows its bound, at
+///   which point it is compacted in one pass (@see compact()).
+/// - Past SearchedTableSize entries, every entry is also in the open-addressed hash index `_slots`,
+///   so a pen not seen before costs one probe sequence rather than a search of the table. Output
+///   with a different colour per cell (truecolor gradients) adds a pen on nearly every write.
+///
+/// Reads return by value: writing may grow the table, and a reference into it would dangle.
+class InternedAttributes
+{
+  public:
+    using Index = uint16_t;
+
+    /// Largest table a 16-bit index can address, one short: the last index marks an empty slot.
+    static constexpr size_t MaxTableSize = std::numeric_limits<Index>::max();
+
+    /// Largest table that is searched directly; larger ones are looked up through the hash index.
+    static constexpr size_t SearchedTableSize = 8;
+
+    /// Smallest table size at which compaction is considered.
+    static constexpr size_t MinCompactionThreshold = 64;
+
+    [[nodiscard]] size_t size() const noexcept { return _indices.size(); }
+    [[nodiscard]] bool empty() const noexcept { return _indices.empty(); }
+
+    [[nodiscard]] GraphicsAttributes operator[](size_t col) const noexcept { return _table[_indices[col]]; }
+
+    /// The table index of the cell at @p col; equal indices mean equal attributes.
+    [[nodiscard]] Index indexAt(size_t col) const noexcept { return _indices[col]; }
+
+    /// The number of distinct attributes in the table, including those no cell refers to any more.
+    [[nodiscard]] size_t tableSize() const noexcept { return _table.size(); }
+
+    /// Makes the column @p n cells of @p attrs, dropping every other table entry.
+    void assign(size_t n, GraphicsAttributes attrs)
+    {
+        _table.assign(1, attrs);
+        _indices.assign(n, Index { 0 });
+        _slots.clear();
+        _last = 0;
+    }
+
+    /// Grows or shrinks the column to @p n cells; cells added are @p attrs.
+    void resize(size_t n, GraphicsAttributes attrs)
+    {
+        if (n <= _indices.size())
+            _indices.resize(n);
+        else if (_indices.empty())
+            assign(n, attrs);
+        else
+            _indices.resize(n, intern(attrs));
+    }
+
+    /// Empties the column and gives back its memory, for the blank-line state.
+    void release() noexcept
+    {
+        std::vector<GraphicsAttributes> {}.swap(_table);
+        crispy::AlignedVector<Index> {}.swap(_indices);
+        std::vector<Index> {}.swap(_slots);
+        _last = 0;
+    }
+
+    void set(size_t col, GraphicsAttributes attrs)
+    {
+        assert(col < _indices.size());
+        _indices[col] = intern(attrs);
+    }
+
+    void fill(size_t from, size_t count, GraphicsAttributes attrs)
+    {
+        assert(from + count <= _indices.size());
+        if (count != 0)
+            std::fill_n(_indices.data() + from, count, intern(attrs));
+    }
+
+    /// Copies @p count cells from @p src, starting at @p srcCol, to this column at @p dstCol.
+    void copyFrom(InternedAttributes const& src, size_t srcCol, size_t dstCol, size_t count);
+
+    /// Moves @p count cells from @p srcCol to @p dstCol within this column; the ranges may overlap.
+    void move(size_t srcCol, size_t dstCol, size_t count) noexcept
+    {
+        assert(srcCol + count <= _indices.size());
+        assert(dstCol + count <= _indices.size());
+        std::memmove(_indices.data() + dstCol, _indices.data() + srcCol, count * sizeof(Index));
+    }
+
+    /// Returns the table index of @p attrs, adding it to the table if it is not there yet.
+    ///
+    /// Consecutive writes nearly always carry the same pen, so the last hit is checked before the
+    /// table is looked up. Adding an entry may allocate.
+    [[nodiscard]] Index intern(GraphicsAttributes attrs)
+    {
+        if (_last < _table.size() && _table[_last] == attrs)
+            return _last;
+        return internSlow(attrs);
+    }
+
+  private:
+    /// Marks an empty slot in the hash index, and a pen not in the table.
+    static constexpr Index NoIndex = std::numeric_limits<Index>::max();
+
+    Index internSlow(GraphicsAttributes attrs);
+
+    /// The table index of @p attrs, or NoIndex if it is not in the table.
+    [[nodiscard]] Index find(GraphicsAttributes attrs) const noexcept;
+
+    /// Adds the newest table entry to the hash index, building or growing the index as needed.
+    void indexNewest();
+
+    /// Rebuilds the hash index from the table, or drops it if the table is small enough to search.
+    void rebuildSlots();
+
+    /// Drops the table entries no cell refers to, renumbering the cells.
+    void compact();
+
+    std::vector<GraphicsAttributes> _table;
+    crispy::AlignedVector<Index> _indices;
+    std::vector<Index> _slots; ///< Open-addressed, power-of-two sized, at most half full; or empty.
+    Index _last = 0;
+};
+
+} // namespace vtbackend
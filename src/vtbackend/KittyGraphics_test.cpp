@@ -279,6 +279,40 @@ TEST_CASE("KittyGraphics.chunked_transmission_is_reassembled", "[kitty]")
     CHECK(mock.terminal.primaryScreen().at(LineOffset(0), ColumnOffset(0)).imageFragment());
 }
 
+TEST_CASE("KittyGraphics.chunks_padded_each_on_their_own_are_reassembled", "[kitty]")
+{
+    auto mock = MockTerm<vtpty::MockPty> { PageSize { LineCount(4), ColumnCount(8) } };
+    mock.terminal.setCellPixelSize(ImageSize { Width(2), Height(2) });
+
+    auto pixels = std::string {};
+    for ([[maybe_unused]] auto const i: std::views::iota(0, 4))
+        pixels += "\x00\xFF\x00\xFF"sv;
+
+    // Split mid-group, each half encoded and padded separately: the decoded size must still match.
+    auto const first = crispy::base64::encode(std::string_view(pixels).substr(0, 5));
+    auto const rest = crispy::base64::encode(std::string_view(pixels).substr(5));
+    mock.writeToScreen(std::format("\033_Ga=T,f=32,s=2,v=2,i=5,m=1;{}\033\\", first));
+    mock.writeToScreen(std::format("\033_Gm=0;{}\033\\", rest));
+    CHECK(mock.terminal.primaryScreen().at(LineOffset(0), ColumnOffset(0)).imageFragment());
+    CHECK(!mock.terminal.peekInput().contains("EINVAL"));
+}
+
+TEST_CASE("KittyGraphics.unchunked_payload_ends_at_the_first_character_outside_the_alphabet", "[kitty]")
+{
+    auto mock = MockTerm<vtpty::MockPty> { PageSize { LineCount(4), ColumnCount(8) } };
+    mock.terminal.setCellPixelSize(ImageSize { Width(2), Height(2) });
+
+    auto pixels = std::string {};
+    for ([[maybe_unused]] auto const i: std::views::iota(0, 4))
+        pixels += "\x00\xFF\x00\xFF"sv;
+
+    // What follows the stray character is not part of the image, so the decoded size still matches.
+    mock.writeToScreen(
+        std::format("\033_Ga=T,f=32,s=2,v=2,i=6;{}!AAAA\033\\", crispy::base64::encode(pixels)));
+    CHECK(mock.terminal.primaryScreen().at(LineOffset(0), ColumnOffset(0)).imageFragment());
+    CHECK(!mock.terminal.peekInput().contains("EINVAL"));
+}
+
 TEST_CASE("KittyGraphics.transmit_then_put_displays_the_stored_image", "[kitty]")
 {
     auto mock = MockTerm<vtpty::MockPty> { PageSize { LineCount(4), ColumnCount(8) } };
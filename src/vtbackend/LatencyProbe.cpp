@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LatencyProbe.hpp>
+
+#include <format>
+#include <iterator>
+
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace vtbackend
+{
+
+namespace
+{
+    /// The stage a keystroke must have reached before @p stage can be marked for it.
+    std::optional<LatencyStage> predecessor(LatencyStage stage) noexcept
+    {
+        switch (stage)
+        {
+            case LatencyStage::PtyWrite: return std::nullopt;
+            // The daemon channel hands the bytes to the connection's thread, which may send them
+            // before the write returns and marks PtyWrite.
+            case LatencyStage::InputSent: return std::nullopt;
+            case LatencyStage::DeltaReceived: return LatencyStage::PtyWrite;
+            case LatencyStage::EchoParsed: return LatencyStage::PtyWrite;
+            case LatencyStage::RenderBufferSwap: return std::nullopt; // Either of two; see markArmed().
+            case LatencyStage::Presented: return LatencyStage::RenderBufferSwap;
+        }
+        return std::nullopt;
+    }
+} // namespace
+
+void LatencyProbe::setMode(LatencyProbeMode mode)
+{
+    auto const l = std::scoped_lock { _mutex };
+    _mode.store(mode, std::memory_order_relaxed);
+    if (mode == LatencyProbeMode::Disabled)
+        disarm();
+}
+
+void LatencyProbe::keyPressed()
+{
+    if (!enabled())
+        return;
+
+    auto const now = _clock();
+    auto const l = std::scoped_lock { _mutex };
+    if (_keyPressedAt && reached(LatencyStage::PtyWrite))
+    {
+        if (now - *_keyPressedAt < Timeout)
+            return;
+        _abandoned.fetch_add(1, std::memory_order_relaxed);
+    }
+    // A key that has not written anything yet (a modifier, a shortcut) is simply superseded.
+    _marks.fill(std::nullopt);
+    _keyPressedAt = now;
+    _armed.store(true, std::memory_order_relaxed);
+}
+
+void LatencyProbe::markArmed(LatencyStage stage, steady_clock::time_point now)
+{
+    auto const l = std::scoped_lock { _mutex };
+    if (!_keyPressedAt || reached(stage))
+        return;
+
+    if (now - *_keyPressedAt >= Timeout)
+    {
+        if (reached(LatencyStage::PtyWrite))
+            _abandoned.fetch_add(1, std::memory_order_relaxed);
+        disarm();
+        return;
+    }
+
+    if (stage == LatencyStage::RenderBufferSwap)
+    {
+        // Local output is parsed; a daemon's arrives as a Delta written straight into the grid.
+        if (!reached(LatencyStage::EchoParsed) && !reached(LatencyStage::DeltaReceived))
+            return;
+    }
+    else if (auto const before = predecessor(stage); before && !reached(*before))
+        return;
+
+    _marks[static_cast<std::size_t>(stage)] = now;
+}
+
+bool LatencyProbe::framePresented(steady_clock::time_point renderStartedAt)
+{
+    if (!_armed.load(std::memory_order_relaxed))
+        return false;
+
+    auto const now = _clock();
+    auto const l = std::scoped_lock { _mutex };
+    auto const& swappedAt = _marks[static_cast<std::size_t>(LatencyStage::RenderBufferSwap)];
+    if (!_keyPressedAt || !swappedAt || *swappedAt > renderStartedAt)
+        return false;
+
+    _marks[static_cast<std::size_t>(LatencyStage::Presented)] = now;
+    for (auto const stage: AllLatencyStages)
+        if (auto const& reachedAt = _marks[static_cast<std::size_t>(stage)])
+            _latencies[static_cast<std::size_t>(stage)].record(
+                std::chrono::duration_cast<nanoseconds>(*reachedAt - *_keyPressedAt));
+    disarm();
+    return true;
+}
+
+std::string LatencyProbe::summary() const
+{
+    auto out = std::format("{:<15} {:>8} {:>9} {:>9} {:>9}\n", "key to", "samples", "p50", "p95", "p99");
+    for (auto const stage: AllLatencyStages)
+    {
+        auto const& histogram = latencies(stage);
+        if (histogram.count() == 0)
+            continue;
+        std::format_to(std::back_inserter(out),
+                       "{:<15} {:>8} {:>9} {:>9} {:>9}\n",
+                       stage,
+                       histogram.count(),
+                       formatDuration(histogram.quantile(0.5)),
+                       formatDuration(histogram.quantile(0.95)),
+                       formatDuration(histogram.quantile(0.99)));
+    }
+    if (auto const given = abandoned(); given != 0)
+        std::format_to(std::back_inserter(out), "{} keystrokes timed out\n", given);
+    return out;
+}
+
+void LatencyProbe::reset()
+{
+    auto const l = std::scoped_lock { _mutex };
+    disarm();
+    for (auto& histogram: _latencies)
+        histogram.reset();
+    _abandoned.store(0, std::memory_order_relaxed);
+}
+
+void LatencyProbe::disarm() noexcept
+{
+    _armed.store(false, std::memory_order_relaxed);
+    _keyPressedAt.reset();
+    _marks.fill(std::nullopt);
+}
+
+} // namespace vtbackend
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/LockStats.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace vtbackend
+{
+
+/// A point a keystroke passes on its way to the screen, in the order it passes them.
+///
+/// Each is measured from the key event, so a stage's figures read as "how long until the keystroke
+/// got this far"; the last one is the end-to-end keypress-to-present latency.
+enum class LatencyStage : uint8_t
+{
+    PtyWrite,         ///< The key's bytes were written to the PTY (the daemon channel, when attached).
+    InputSent,        ///< Attached to a daemon: the Input PDU carrying them was sent.
+    DeltaReceived,    ///< Attached to a daemon: the next Delta was applied to the mirror terminal.
+    EchoParsed,       ///< The next output read from the PTY was parsed.
+    RenderBufferSwap, ///< A render buffer holding that output was published to the render thread.
+    Presented,        ///< A frame rendered from that buffer was handed to the window system.
+};
+
+/// Every LatencyStage, in declaration order.
+inline constexpr auto AllLatencyStages = std::array {
+    LatencyStage::PtyWrite,
+    LatencyStage::InputSent,
+    LatencyStage::DeltaReceived,
+    LatencyStage::EchoParsed,
+    LatencyStage::RenderBufferSwap,
+    LatencyStage::Presented,
+};
+
+/// Whether a LatencyProbe follows keystrokes.
+enum class LatencyProbeMode : uint8_t
+{
+    Disabled,
+    Enabled,
+};
+
+/// Measures keypress-to-present latency, one keystroke at a time.
+///
+/// The stages are marked from whichever thread reaches them -- the GUI thread for the key and the
+/// write, the PTY thread for the parse, the render thread for the frame. A keystroke is followed
+/// until its frame is presented; keys pressed meanwhile are not measured, so a burst of typing
+/// reports the latency of its first key rather than a queue of them. The "echo" is simply the next
+/// output after the write: measure at an idle prompt, not while something is printing.
+///
+/// Off by default. While off, and while on but no keystroke is in flight, a mark costs one relaxed
+/// load.
+///
+/// The mode is switched at runtime rather than fixed at construction: the ToggleLatencyProbe action
+/// turns it on and off in a running session, while the PTY and render threads keep marking the one
+/// probe their terminal owns. Replacing the probe instead would need those threads to synchronize on
+/// every mark, which is exactly the cost the relaxed load avoids.
+class LatencyProbe
+{
+  public:
+    /// Reads the current time. Called from every thread that marks a stage.
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    /// A keystroke whose frame has not been presented by then (a password prompt, a key the
+    /// application ignores) is given up on.
+    static constexpr auto Timeout = std::chrono::seconds(1);
+
+    /// @param clock Timestamps the key event and every stage. Only read while a keystroke is in
+    ///              flight, so a mark stays one relaxed load otherwise.
+    explicit LatencyProbe(Clock clock): _clock { std::move(clock) } {}
+
+    /// Turns the probe on or off; turning it off gives up on the keystroke in flight.
+    void setMode(LatencyProbeMode mode);
+    [[nodiscard]] bool enabled() const noexcept
+    {
+        return _mode.load(std::memory_order_relaxed) == LatencyProbeMode::Enabled;
+    }
+
+    /// Starts following a key event happening now, unless the previous one is still in flight.
+    void keyPressed();
+
+    /// Marks @p stage for the keystroke in flight, if it has reached the stage before it.
+    /// LatencyStage::Presented is marked through framePresented() instead.
+    void mark(LatencyStage stage)
+    {
+        if (_armed.load(std::memory_order_relaxed))
+            markArmed(stage, _clock());
+    }
+
+    /// Marks LatencyStage::Presented, now, for a frame whose rendering started at
+    /// @p renderStartedAt, provided it started after the render buffer swap: an earlier frame shows
+    /// the old contents.
+    ///
+    /// @return Whether this completed a sample.
+    bool framePresented(std::chrono::steady_clock::time_point renderStartedAt);
+
+    /// Latencies from the key event to @p stage, over every completed sample.
+    [[nodiscard]] DurationHistogram const& latencies(LatencyStage stage) const noexcept
+    {
+        return _latencies[static_cast<std::size_t>(stage)];
+    }
+
+    /// The number of keystrokes followed all the way to the screen.
+    [[nodiscard]] std::uint64_t samples() const noexcept
+    {
+        return latencies(LatencyStage::Presented).count();
+    }
+
+    /// The number of keystrokes given up on after Timeout.
+    [[nodiscard]] std::uint64_t abandoned() const noexcept
+    {
+        return _abandoned.load(std::memory_order_relaxed);
+    }
+
+    /// @return A human-readable table: per stage, the sample count and the p50, p95 and p99 of the
+    ///         time from the key event to reaching it.
+    [[nodiscard]] std::string summary() const;
+
+    void reset();
+
+  private:
+    void markArmed(LatencyStage stage, std::chrono::steady_clock::time_point now);
+    [[nodiscard]] bool reached(LatencyStage stage) const noexcept
+    {
+        return _marks[static_cast<std::size_t>(stage)].has_value();
+    }
+    void disarm() noexcept;
+
+    Clock _clock;
+    std::atomic<LatencyProbeMode> _mode = LatencyProbeMode::Disabled;
+    std::atomic<bool> _armed = false; ///< A keystroke is in flight.
+    std::atomic<std::uint64_t> _abandoned = 0;
+    std::array<DurationHistogram, AllLatencyStages.size()> _latencies;
+
+    std::mutex _mutex;
+    std::optional<std::chrono::steady_clock::time_point> _keyPressedAt;
+    std::array<std::optional<std::chrono::steady_clock::time_point>, AllLatencyStages.size()> _marks;
+};
+
+} // namespace vtbackend
+
+template <>
+struct std::formatter<vtbackend::LatencyStage>: std::formatter<std::string_view>
+{
+    auto format(vtbackend::LatencyStage value, auto& ctx) const
+    {
+        std::string_view output;
+        switch (value)
+        {
+            case vtbackend::LatencyStage::PtyWrite: output = "pty write"; break;
+            case vtbackend::LatencyStage::InputSent: output = "input sent"; break;
+            case vtbackend::LatencyStage::DeltaReceived: output = "delta received"; break;
+            case vtbackend::LatencyStage::EchoParsed: output = "echo parsed"; break;
+            case vtbackend::LatencyStage::RenderBufferSwap: output = "buffer swap"; break;
+            case vtbackend::LatencyStage::Presented: output = "presented"; break;
+        }
+        return formatter<std::string_view>::format(output, ctx);
+    }
+};
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LatencyProbe.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+
+using namespace std::chrono_literals;
+
+using std::chrono::steady_clock;
+using vtbackend::LatencyProbe;
+using vtbackend::LatencyProbeMode;
+using vtbackend::LatencyStage;
+
+namespace
+{
+/// A clock the test sets by hand.
+struct SteppedClock
+{
+    steady_clock::time_point now = steady_clock::now();
+
+    [[nodiscard]] LatencyProbe::Clock reader()
+    {
+        return [this] { return now; };
+    }
+};
+} // namespace
+
+TEST_CASE("LatencyProbe.follows_a_keystroke_to_the_screen", "[LatencyProbe]")
+{
+    auto clock = SteppedClock {};
+    auto probe = LatencyProbe { clock.reader() };
+    probe.setMode(LatencyProbeMode::Enabled);
+
+    auto const t0 = clock.now;
+    probe.keyPressed();
+    clock.now = t0 + 100us;
+    probe.mark(LatencyStage::PtyWrite);
+    clock.now = t0 + 2ms;
+    probe.mark(LatencyStage::EchoParsed);
+    clock.now = t0 + 3ms;
+    probe.mark(LatencyStage::RenderBufferSwap);
+
+    // A frame already being rendered before the swap shows the old contents.
+    clock.now = t0 + 4ms;
+    CHECK_FALSE(probe.framePresented(t0 + 2500us));
+    clock.now = t0 + 9ms;
+    CHECK(probe.framePresented(t0 + 5ms));
+
+    CHECK(probe.samples() == 1);
+    CHECK(probe.latencies(LatencyStage::PtyWrite).max() == 100us);
+    CHECK(probe.latencies(LatencyStage::EchoParsed).max() == 2ms);
+    CHECK(probe.latencies(LatencyStage::Presented).max() == 9ms);
+    // Not attached to a daemon: those stages were never reached.
+    CHECK(probe.latencies(LatencyStage::InputSent).count() == 0);
+
+    auto const summary = probe.summary();
+    CHECK(summary.find("presented") != std::string::npos);
+    CHECK(summary.find("input sent") == std::string::npos);
+}
+
+TEST_CASE("LatencyProbe.marks_stages_only_in_order", "[LatencyProbe]")
+{
+    auto clock = SteppedClock {};
+    auto probe = LatencyProbe { clock.reader() };
+    probe.setMode(LatencyProbeMode::Enabled);
+
+    auto const t0 = clock.now;
+    probe.keyPressed();
+    // Output that was already on its way before the key's bytes were written is not its echo.
+    clock.now = t0 + 1ms;
+    probe.mark(LatencyStage::EchoParsed);
+    clock.now = t0 + 1ms;
+    probe.mark(LatencyStage::RenderBufferSwap);
+    clock.now = t0 + 3ms;
+    CHECK_FALSE(probe.framePresented(t0 + 2ms));
+
+    // Attached to a daemon, the Delta stands in for the parse.
+    clock.now = t0 + 4ms;
+    probe.mark(LatencyStage::PtyWrite);
+    clock.now = t0 + 5ms;
+    probe.mark(LatencyStage::InputSent);
+    clock.now = t0 + 6ms;
+    probe.mark(LatencyStage::DeltaReceived);
+    clock.now = t0 + 7ms;
+    probe.mark(LatencyStage::RenderBufferSwap);
+    clock.now = t0 + 9ms;
+    CHECK(probe.framePresented(t0 + 8ms));
+    CHECK(probe.latencies(LatencyStage::DeltaReceived).max() == 6ms);
+}
+
+TEST_CASE("LatencyProbe.gives_up_on_a_keystroke_without_an_echo", "[LatencyProbe]")
+{
+    auto clock = SteppedClock {};
+    auto probe = LatencyProbe { clock.reader() };
+    probe.setMode(LatencyProbeMode::Enabled);
+
+    auto const t0 = clock.now;
+    probe.keyPressed();
+    clock.now = t0 + 1ms;
+    probe.mark(LatencyStage::PtyWrite);
+
+    // Still in flight: a second key is not measured.
+    clock.now = t0 + 2ms;
+    probe.keyPressed();
+    clock.now = t0 + LatencyProbe::Timeout + 1ms;
+    probe.mark(LatencyStage::EchoParsed);
+    CHECK(probe.abandoned() == 1);
+    CHECK(probe.samples() == 0);
+
+    // A key that wrote nothing (a modifier) is superseded by the next one without counting.
+    clock.now = t0 + 2s;
+    probe.keyPressed();
+    clock.now = t0 + 2s + 1ms;
+    probe.keyPressed();
+    CHECK(probe.abandoned() == 1);
+}
+
+TEST_CASE("LatencyProbe.records_nothing_while_disabled", "[LatencyProbe]")
+{
+    auto clock = SteppedClock {};
+    auto probe = LatencyProbe { clock.reader() };
+
+    auto const t0 = clock.now;
+    probe.keyPressed();
+    clock.now = t0 + 1ms;
+    probe.mark(LatencyStage::PtyWrite);
+    clock.now = t0 + 2ms;
+    probe.mark(LatencyStage::EchoParsed);
+    clock.now = t0 + 3ms;
+    probe.mark(LatencyStage::RenderBufferSwap);
+    clock.now = t0 + 5ms;
+    CHECK_FALSE(probe.framePresented(t0 + 4ms));
+    CHECK(probe.samples() == 0);
+}
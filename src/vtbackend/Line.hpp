@@ -140,6 +140,18 @@ class Line
         return *this;
     }
 
+    /// Moves @p other into this row WITHOUT counting as a change to it — the one exception to the
+    /// rule above, for a region shift the grid records as such (@see Grid::forEachChangeSince).
+    /// The row keeps the source's revision and dirty bit, so a consumer that replays the shift
+    /// sees it again only if its content changed as well.
+    Line& shiftFrom(Line&& other) noexcept
+    {
+        auto const dirty = other._dirty;
+        *this = std::move(other);
+        _dirty = dirty;
+        return *this;
+    }
+
     // --- Change tracking (the daemon's per-line delta source) -------------------------------
     //
     // A one-byte dirty bit set by every mutating entry point below, and a revision stamped
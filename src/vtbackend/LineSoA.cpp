@@ -45,7 +45,7 @@ void initializeBlankLineSoA(LineSoA& line, GraphicsAttributes const& fillAttrs)
     AlignedVector<uint8_t> {}.swap(line.widths);
     AlignedVector<uint8_t> {}.swap(line.scales);
     AlignedVector<uint16_t> {}.swap(line.textScaleExtras);
-    AlignedVector<GraphicsAttributes> {}.swap(line.sgr);
+    line.sgr.release();
     AlignedVector<HyperlinkId> {}.swap(line.hyperlinks);
     AlignedVector<uint8_t> {}.swap(line.clusterSize);
     AlignedVector<uint16_t> {}.swap(line.clusterPoolIndex);
@@ -94,7 +94,7 @@ void clearRange(LineSoA& line, size_t from, size_t count, GraphicsAttributes con
     std::fill_n(line.widths.data() + from, count, uint8_t { 1 });
     std::fill_n(line.scales.data() + from, count, uint8_t { 1 });
     std::fill_n(line.textScaleExtras.data() + from, count, uint16_t { 0 });
-    std::fill_n(line.sgr.data() + from, count, attrs);
+    line.sgr.fill(from, count, attrs);
     std::fill_n(line.hyperlinks.data() + from, count, HyperlinkId {});
     std::fill_n(line.clusterSize.data() + from, count, uint8_t { 0 });
     std::fill_n(line.clusterPoolIndex.data() + from, count, uint16_t { 0 });
@@ -169,7 +169,7 @@ void copyColumns(LineSoA const& src, size_t srcCol, LineSoA& dst, size_t dstCol,
     std::copy_n(src.widths.data() + srcCol, count, dst.widths.data() + dstCol);
     std::copy_n(src.scales.data() + srcCol, count, dst.scales.data() + dstCol);
     std::copy_n(src.textScaleExtras.data() + srcCol, count, dst.textScaleExtras.data() + dstCol);
-    std::copy_n(src.sgr.data() + srcCol, count, dst.sgr.data() + dstCol);
+    dst.sgr.copyFrom(src.sgr, srcCol, dstCol, count);
     std::copy_n(src.hyperlinks.data() + srcCol, count, dst.hyperlinks.data() + dstCol);
     std::copy_n(src.clusterSize.data() + srcCol, count, dst.clusterSize.data() + dstCol);
 
@@ -222,7 +222,7 @@ void moveColumns(LineSoA& line, size_t srcCol, size_t dstCol, size_t count)
     std::memmove(line.scales.data() + dstCol, line.scales.data() + srcCol, count * sizeof(uint8_t));
     std::memmove(
         line.textScaleExtras.data() + dstCol, line.textScaleExtras.data() + srcCol, count * sizeof(uint16_t));
-    std::memmove(line.sgr.data() + dstCol, line.sgr.data() + srcCol, count * sizeof(GraphicsAttributes));
+    line.sgr.move(srcCol, dstCol, count);
     std::memmove(
         line.hyperlinks.data() + dstCol, line.hyperlinks.data() + srcCol, count * sizeof(HyperlinkId));
     std::memmove(line.clusterSize.data() + dstCol, line.clusterSize.data() + srcCol, count * sizeof(uint8_t));
@@ -6,6 +6,7 @@
 #include <vtbackend/GraphicsAttributes.hpp>
 #include <vtbackend/Hyperlink.hpp>
 #include <vtbackend/Image.hpp>
+#include <vtbackend/InternedAttributes.hpp>
 #include <vtbackend/LineFlags.hpp>
 #include <vtbackend/Primitives.hpp>
 #include <vtbackend/TextScale.hpp>
@@ -71,8 +72,9 @@ struct LineSoA
     // --- Tier 2: Warm — SGR "pen" attributes, always read/written together ---
 
     /// Graphics attributes per cell (foreground, background, underline color + flags).
-    /// Packed as a single struct for cache locality — one write per cell instead of four.
-    AlignedVector<GraphicsAttributes> sgr;
+    /// Interned per line: each cell holds a 2-byte index into the line's table of distinct pens, so a
+    /// cell costs 2 bytes here instead of 16. Write through @c set() / @c fill(), never in place.
+    InternedAttributes sgr;
 
     // --- Tier 3: Cold — rarely non-default ---
 
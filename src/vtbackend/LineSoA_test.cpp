@@ -70,9 +70,7 @@ TEST_CASE("LineSoA.clearRange", "[LineSoA]")
     line.clusterSize[3] = 1;
     line.clusterSize[4] = 1;
     line.clusterSize[5] = 1;
-    line.sgr[3].foregroundColor = Color::Indexed(5);
-    line.sgr[4].foregroundColor = Color::Indexed(5);
-    line.sgr[5].foregroundColor = Color::Indexed(5);
+    line.sgr.fill(3, 3, GraphicsAttributes { .foregroundColor = Color::Indexed(5) });
 
     // Clear columns 3-5
     auto const clearAttrs = GraphicsAttributes { .foregroundColor = Color::Indexed(7) };
@@ -113,8 +111,8 @@ TEST_CASE("LineSoA.copyColumns", "[LineSoA]")
     src.clusterSize[1] = 1;
     src.widths[0] = 1;
     src.widths[1] = 1;
-    src.sgr[0].foregroundColor = Color::Indexed(3);
-    src.sgr[1].foregroundColor = Color::Indexed(4);
+    src.sgr.set(0, GraphicsAttributes { .foregroundColor = Color::Indexed(3) });
+    src.sgr.set(1, GraphicsAttributes { .foregroundColor = Color::Indexed(4) });
 
     LineSoA dst;
     initializeLineSoA(dst, ColumnCount(10));
@@ -138,7 +136,7 @@ TEST_CASE("LineSoA.copyColumns.trivialInvalidated", "[LineSoA]")
     initializeLineSoA(src, ColumnCount(10));
     src.codepoints[0] = U'A';
     src.clusterSize[0] = 1;
-    src.sgr[0].foregroundColor = Color::Indexed(1);
+    src.sgr.set(0, GraphicsAttributes { .foregroundColor = Color::Indexed(1) });
 
     // Destination line starts trivial
     LineSoA dst;
@@ -226,6 +224,85 @@ TEST_CASE("LineSoA.resizeLineSoA.shrink", "[LineSoA]")
     CHECK(line.usedColumns == ColumnCount(5)); // clamped
 }
 
+// =============================================================================
+// Interned graphics attributes
+// =============================================================================
+
+TEST_CASE("LineSoA.sgr.equalAttributesShareAnIndex", "[LineSoA]")
+{
+    LineSoA line;
+    initializeLineSoA(line, ColumnCount(10));
+
+    auto const red = GraphicsAttributes { .foregroundColor = Color::Indexed(1) };
+    line.sgr.set(2, red);
+    line.sgr.fill(5, 3, red);
+    line.sgr.set(9, GraphicsAttributes { .foregroundColor = Color::Indexed(2) });
+
+    CHECK(line.sgr.tableSize() == 3);
+    CHECK(line.sgr.indexAt(2) == line.sgr.indexAt(5));
+    CHECK(line.sgr.indexAt(2) == line.sgr.indexAt(7));
+    CHECK(line.sgr.indexAt(0) != line.sgr.indexAt(2));
+    CHECK(line.sgr.indexAt(2) != line.sgr.indexAt(9));
+    CHECK(line.sgr[7] == red);
+    CHECK(line.sgr[8] == GraphicsAttributes {});
+}
+
+TEST_CASE("LineSoA.sgr.tableIsCompacted", "[LineSoA]")
+{
+    LineSoA line;
+    initializeLineSoA(line, ColumnCount(4));
+
+    // Every write a new pen, all on the same cells: only the last four stay referenced.
+    for (auto const i: std::views::iota(0, 1000))
+        line.sgr.set(static_cast<size_t>(i % 4), GraphicsAttributes { .foregroundColor = RGBColor(i) });
+
+    CHECK(line.sgr.tableSize() <= InternedAttributes::MinCompactionThreshold);
+    for (auto const i: std::views::iota(996, 1000))
+        CHECK(line.sgr[static_cast<size_t>(i % 4)].foregroundColor == Color(RGBColor(i)));
+}
+
+TEST_CASE("LineSoA.sgr.aPenPerCellStaysInterned", "[LineSoA]")
+{
+    LineSoA line;
+    initializeLineSoA(line, ColumnCount(80));
+
+    // A truecolor gradient that shifts on every pass, as lolcat draws it: past the searched size the
+    // table is looked up through its hash index, and it is compacted many times over.
+    auto const penAt = [](int pass, int col) {
+        return GraphicsAttributes { .foregroundColor = RGBColor((col * 0x010203) + (pass * 7)) };
+    };
+    for (auto const pass: std::views::iota(0, 50))
+        for (auto const col: std::views::iota(0, 80))
+            line.sgr.set(static_cast<size_t>(col), penAt(pass, col));
+
+    CHECK(line.sgr.tableSize() <= 2 * 80);
+    for (auto const col: std::views::iota(0, 80))
+    {
+        CHECK(line.sgr[static_cast<size_t>(col)] == penAt(49, col));
+        CHECK(line.sgr.intern(penAt(49, col)) == line.sgr.indexAt(static_cast<size_t>(col)));
+    }
+}
+
+TEST_CASE("LineSoA.sgr.copyColumnsReinternsIntoTheDestination", "[LineSoA]")
+{
+    LineSoA src;
+    initializeLineSoA(src, ColumnCount(10));
+    auto const bold = GraphicsAttributes { .flags = CellFlag::Bold };
+    src.sgr.fill(0, 6, bold);
+
+    auto const fill = GraphicsAttributes { .backgroundColor = Color::Indexed(4) };
+    LineSoA dst;
+    initializeLineSoA(dst, ColumnCount(10), fill);
+    copyColumns(src, 0, dst, 2, 8);
+
+    CHECK(dst.sgr[0] == fill);
+    CHECK(dst.sgr[2] == bold);
+    CHECK(dst.sgr[7] == bold);
+    CHECK(dst.sgr[8] == GraphicsAttributes {});
+    CHECK(dst.sgr.indexAt(2) == dst.sgr.indexAt(7));
+    CHECK(dst.sgr.tableSize() == 3);
+}
+
 // =============================================================================
 // Grapheme cluster pool tests
 // =============================================================================
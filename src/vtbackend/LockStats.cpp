@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LockStats.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <iterator>
+#include <ranges>
+
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace vtbackend
+{
+
+std::string formatDuration(nanoseconds duration)
+{
+    auto const ns = duration.count();
+    if (ns < 10'000)
+        return std::format("{}ns", ns);
+    if (ns < 10'000'000)
+        return std::format("{:.1f}us", static_cast<double>(ns) / 1e3);
+    return std::format("{:.1f}ms", static_cast<double>(ns) / 1e6);
+}
+
+std::size_t DurationHistogram::bucketOf(std::uint64_t ns) noexcept
+{
+    if (ns < SubBucketCount)
+        return static_cast<std::size_t>(ns);
+
+    // The top SubBucketBits + 1 bits of ns: its leading one, which names the power of two, and the
+    // sub-bucket within it.
+    auto const shift = std::bit_width(ns) - 1 - SubBucketBits;
+    auto const bucket =
+        (static_cast<std::size_t>(shift) * SubBucketCount) + static_cast<std::size_t>(ns >> shift);
+    return std::min(bucket, BucketCount - 1);
+}
+
+std::uint64_t DurationHistogram::upperBoundOf(std::size_t bucket) noexcept
+{
+    if (bucket < SubBucketCount)
+        return bucket + 1;
+
+    // The inverse of bucketOf(): bucket = shift * SubBucketCount + (ns >> shift), where the latter
+    // lies in [SubBucketCount, 2 * SubBucketCount).
+    auto const shift = (bucket / SubBucketCount) - 1;
+    auto const top = (bucket % SubBucketCount) + SubBucketCount;
+    return static_cast<std::uint64_t>(top + 1) << shift;
+}
+
+void DurationHistogram::record(nanoseconds duration) noexcept
+{
+    auto const ns = static_cast<std::uint64_t>(std::max(duration.count(), std::int64_t { 0 }));
+    _buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(static_cast<std::int64_t>(ns), std::memory_order_relaxed);
+
+    auto max = _max.load(std::memory_order_relaxed);
+    while (static_cast<std::int64_t>(ns) > max
+           && !_max.compare_exchange_weak(max, static_cast<std::int64_t>(ns), std::memory_order_relaxed))
+        ;
+}
+
+std::uint64_t DurationHistogram::count() const noexcept
+{
+    auto total = std::uint64_t { 0 };
+    for (auto const& bucket: _buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    return total;
+}
+
+nanoseconds DurationHistogram::quantile(double q) const noexcept
+{
+    auto const total = count();
+    if (total == 0)
+        return nanoseconds { 0 };
+
+    auto const rank =
+        std::max(std::uint64_t { 1 }, static_cast<std::uint64_t>(q * static_cast<double>(total)));
+    auto seen = std::uint64_t { 0 };
+    for (auto const i: std::views::iota(std::size_t { 0 }, BucketCount))
+    {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        // The bucket's upper bound, but never past what was actually observed. The last bucket has no
+        // upper bound, which leaves only the latter.
+        if (seen >= rank && i + 1 < BucketCount)
+            return std::min(nanoseconds { static_cast<std::int64_t>(upperBoundOf(i)) }, max());
+    }
+    return max();
+}
+
+void DurationHistogram::reset() noexcept
+{
+    for (auto& bucket: _buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+}
+
+std::string LockStats::summary() const
+{
+    auto out = std::format("{:<13} {:>10} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+                           "site",
+                           "locks",
+                           "wait p50",
+                           "wait p99",
+                           "wait max",
+                           "hold p50",
+                           "hold p99",
+                           "hold max");
+    for (auto const site: AllLockSites)
+    {
+        auto const& waits = this->waits(site);
+        auto const& holds = this->holds(site);
+        std::format_to(std::back_inserter(out),
+                       "{:<13} {:>10} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+                       site,
+                       holds.count(),
+                       formatDuration(waits.quantile(0.5)),
+                       formatDuration(waits.quantile(0.99)),
+                       formatDuration(waits.max()),
+                       formatDuration(holds.quantile(0.5)),
+                       formatDuration(holds.quantile(0.99)),
+                       formatDuration(holds.max()));
+    }
+    return out;
+}
+
+void LockStats::reset() noexcept
+{
+    for (auto& histogram: _waits)
+        histogram.reset();
+    for (auto& histogram: _holds)
+        histogram.reset();
+}
+
+void InstrumentedMutex::lock(LockSite site)
+{
+    auto const requestedAt = steady_clock::now();
+    _mutex.lock();
+    _acquiredAt = steady_clock::now();
+    _site = site;
+    _stats.recordWait(site, std::chrono::duration_cast<nanoseconds>(_acquiredAt - requestedAt));
+}
+
+bool InstrumentedMutex::try_lock(LockSite site)
+{
+    if (!_mutex.try_lock())
+        return false;
+    _acquiredAt = steady_clock::now();
+    _site = site;
+    _stats.recordWait(site, nanoseconds { 0 });
+    return true;
+}
+
+void InstrumentedMutex::unlock()
+{
+    // Read before releasing: the next holder overwrites both.
+    auto const site = _site;
+    auto const held = std::chrono::duration_cast<nanoseconds>(steady_clock::now() - _acquiredAt);
+    _mutex.unlock();
+    // Recorded after releasing, so the bookkeeping does not count as holding.
+    _stats.recordHold(site, held);
+}
+
+} // namespace vtbackend
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LockStats.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <ranges>
+
+using namespace std::chrono_literals;
+
+using vtbackend::DurationHistogram;
+using vtbackend::InstrumentedMutex;
+using vtbackend::LockSite;
+
+TEST_CASE("DurationHistogram.quantile", "[LockStats]")
+{
+    auto histogram = DurationHistogram {};
+    CHECK(histogram.quantile(0.5) == 0ns);
+
+    for ([[maybe_unused]] auto const sample: std::views::iota(0, 99))
+        histogram.record(100ns);
+    histogram.record(5ms);
+
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.max() == 5ms);
+    // 100ns lands in the bucket [100ns, 104ns), and a quantile reports that bucket's bound.
+    CHECK(histogram.quantile(0.5) == 104ns);
+    CHECK(histogram.quantile(0.99) == 104ns);
+    // Never more than was observed, even though 5ms falls in a bucket reaching past it.
+    CHECK(histogram.quantile(1.0) == 5ms);
+
+    histogram.reset();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.max() == 0ns);
+    CHECK(histogram.sum() == 0ns);
+}
+
+TEST_CASE("DurationHistogram.resolution", "[LockStats]")
+{
+    // Power-of-two buckets reported both of these as 4.2ms.
+    auto histogram = DurationHistogram {};
+    for ([[maybe_unused]] auto const sample: std::views::iota(0, 50))
+        histogram.record(2100us);
+    for ([[maybe_unused]] auto const sample: std::views::iota(0, 50))
+        histogram.record(4ms);
+    histogram.record(10s);
+
+    auto const withinASixteenth = [](std::chrono::nanoseconds reported, std::chrono::nanoseconds actual) {
+        return reported >= actual && reported - actual <= actual / DurationHistogram::SubBucketCount;
+    };
+    CHECK(withinASixteenth(histogram.quantile(0.25), 2100us));
+    CHECK(withinASixteenth(histogram.quantile(0.75), 4ms));
+    CHECK(histogram.quantile(1.0) == 10s);
+
+    // Below SubBucketCount nanoseconds, every duration has a bucket of its own.
+    histogram.reset();
+    histogram.record(3ns);
+    CHECK(histogram.quantile(0.5) == 3ns);
+}
+
+TEST_CASE("InstrumentedMutex.attributes_holds_to_their_site", "[LockStats]")
+{
+    auto mutex = InstrumentedMutex {};
+
+    mutex.lock(LockSite::Parse);
+    mutex.unlock();
+    mutex.lock(LockSite::Selection);
+    mutex.unlock();
+    REQUIRE(mutex.try_lock(LockSite::Render));
+    mutex.unlock();
+
+    auto const& stats = mutex.stats();
+    CHECK(stats.holds(LockSite::Parse).count() == 1);
+    CHECK(stats.waits(LockSite::Parse).count() == 1);
+    CHECK(stats.holds(LockSite::Selection).count() == 1);
+    CHECK(stats.waits(LockSite::Selection).count() == 1);
+    CHECK(stats.holds(LockSite::Render).count() == 1);
+    CHECK(stats.holds(LockSite::Reflow).count() == 0);
+    CHECK(stats.summary().contains("reflow"));
+}
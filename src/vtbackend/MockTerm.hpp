@@ -267,6 +267,7 @@ inline MockTerm<PtyDevice>::MockTerm(PageSize pageSize,
                                      size_t ptyReadBufferSize):
     terminal { *this,
                crispy::defaultEnvironment(),
+               /*traceRecorder=*/nullptr,
                std::make_unique<PtyDevice>(pageSize),
                createSettings(pageSize, maxHistoryLineCount, ptyReadBufferSize),
                std::chrono::steady_clock::time_point() } // explicitly start with empty timepoint
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/PtyRecording.hpp>
+
+#include <charconv>
+#include <format>
+#include <optional>
+#include <ranges>
+
+using std::chrono::microseconds;
+
+namespace vtbackend
+{
+
+namespace
+{
+    /// Splits @p line at spaces, dropping empty fields.
+    std::vector<std::string_view> fieldsOf(std::string_view line)
+    {
+        auto fields = std::vector<std::string_view> {};
+        for (auto const field: std::views::split(line, ' '))
+            if (!field.empty())
+                fields.emplace_back(field.begin(), field.end());
+        return fields;
+    }
+
+    template <typename T>
+    std::optional<T> numberOf(std::string_view text)
+    {
+        auto value = T {};
+        auto const [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc {} || end != text.data() + text.size())
+            return std::nullopt;
+        return value;
+    }
+
+    std::optional<PageSize> pageSizeOf(std::string_view columns, std::string_view lines)
+    {
+        auto const c = numberOf<unsigned>(columns);
+        auto const l = numberOf<unsigned>(lines);
+        if (!c || !l || *c == 0 || *l == 0)
+            return std::nullopt;
+        return PageSize { .lines = LineCount::cast_from(*l), .columns = ColumnCount::cast_from(*c) };
+    }
+} // namespace
+
+std::size_t PtyRecording::outputBytes() const noexcept
+{
+    auto total = std::size_t { 0 };
+    for (auto const& record: records)
+        if (auto const* output = std::get_if<Output>(&record))
+            total += output->bytes.size();
+    return total;
+}
+
+microseconds PtyRecording::duration() const noexcept
+{
+    if (records.empty())
+        return microseconds { 0 };
+    return std::visit([](auto const& record) { return record.at; }, records.back());
+}
+
+std::expected<PtyRecording, std::string> readPtyRecording(std::istream& in)
+{
+    auto line = std::string {};
+    if (!std::getline(in, line) || line != PtyRecordingHeader)
+        return std::unexpected { std::format("not a recording (expected '{}')", PtyRecordingHeader) };
+
+    auto recording = PtyRecording {};
+    auto sawPageSize = false;
+    auto previous = microseconds { 0 };
+    auto index = 0;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line.starts_with('#'))
+            continue;
+        ++index;
+
+        auto const fields = fieldsOf(line);
+        auto const fail = [&](std::string_view why) {
+            return std::unexpected { std::format("record {} ('{}'): {}", index, line, why) };
+        };
+
+        auto const at = fields.size() >= 2 ? numberOf<std::int64_t>(fields[1]) : std::nullopt;
+        if (!at)
+            return fail("no time");
+        if (microseconds { *at } < previous)
+            return fail("out of time order");
+        previous = microseconds { *at };
+
+        if (fields[0] == "r" && fields.size() == 4)
+        {
+            auto const pageSize = pageSizeOf(fields[2], fields[3]);
+            if (!pageSize)
+                return fail("bad page size");
+            if (!sawPageSize)
+                recording.pageSize = *pageSize;
+            else
+                recording.records.emplace_back(PtyRecording::Resize { .at = previous, .pageSize = *pageSize });
+            sawPageSize = true;
+        }
+        else if (fields[0] == "o" && fields.size() == 3)
+        {
+            if (!sawPageSize)
+                return fail("output before the initial page size");
+            auto const length = numberOf<std::size_t>(fields[2]);
+            if (!length)
+                return fail("bad length");
+            auto bytes = std::string(*length, '\0');
+            if (!in.read(bytes.data(), static_cast<std::streamsize>(*length)) || in.get() != '\n')
+                return fail("truncated");
+            recording.records.emplace_back(PtyRecording::Output { .at = previous, .bytes = std::move(bytes) });
+        }
+        else
+            return fail("unknown record");
+    }
+
+    if (!sawPageSize)
+        return std::unexpected { std::string { "no page size" } };
+    return recording;
+}
+
+PtyRecordingWriter::PtyRecordingWriter(std::ostream& out, PageSize pageSize): _out { out }
+{
+    _out << PtyRecordingHeader << '\n';
+    resize(microseconds { 0 }, pageSize);
+}
+
+void PtyRecordingWriter::output(microseconds at, std::string_view bytes)
+{
+    _out << std::format("o {} {}\n", at.count(), bytes.size());
+    _out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    _out << '\n';
+}
+
+void PtyRecordingWriter::resize(microseconds at, PageSize pageSize)
+{
+    _out << std::format("r {} {} {}\n", at.count(), pageSize.columns, pageSize.lines);
+}
+
+microseconds PtyRecordingWriter::elapsed() const
+{
+    return std::chrono::duration_cast<microseconds>(std::chrono::steady_clock::now() - _start);
+}
+
+} // namespace vtbackend
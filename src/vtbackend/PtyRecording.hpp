@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// A recorded PTY output stream, for replaying real workloads (htop, vim, a cargo build) through
+/// bench-headless rather than synthetic ones.
+///
+/// The file format is meant to be attached to bug reports, so it is plain enough to write by hand
+/// and to inspect with `less`:
+///
+/// @code
+/// contour-pty-recording 1
+/// # Any line starting with '#' between records is a comment.
+/// r 0 80 24
+/// o 0 13
+/// hello, world
+/// o 1520 6
+/// ␛[?25l
+/// r 250000 120 40
+/// @endcode
+///
+/// After the header line every record starts with one line of space-separated fields:
+///
+/// - `r <us> <columns> <lines>`: from here on the page is @c columns x @c lines cells. The first
+///   record is always one of these, at time 0.
+/// - `o <us> <length>`: @c length bytes the application wrote follow, verbatim, then a newline
+///   that is not part of them.
+///
+/// @c us is the time of the record in microseconds since the recording started. Records are in
+/// time order. (The ␛ above stands for the single ESC byte the file holds.)
+
+#include <vtbackend/Primitives.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace vtbackend
+{
+
+/// The first line of every recording; the trailing number is the format version.
+inline constexpr std::string_view PtyRecordingHeader = "contour-pty-recording 1";
+
+/// A recording, read into memory in full.
+struct PtyRecording
+{
+    /// Bytes the application wrote, as one read from the PTY returned them.
+    struct Output
+    {
+        std::chrono::microseconds at;
+        std::string bytes;
+    };
+
+    /// The page size changed.
+    struct Resize
+    {
+        std::chrono::microseconds at;
+        PageSize pageSize;
+    };
+
+    using Record = std::variant<Output, Resize>;
+
+    /// The page size the recording starts with.
+    PageSize pageSize;
+    /// Every record after the initial page size, in time order.
+    std::vector<Record> records;
+
+    /// @return The number of output bytes in the whole recording.
+    [[nodiscard]] std::size_t outputBytes() const noexcept;
+
+    /// @return The time of the last record.
+    [[nodiscard]] std::chrono::microseconds duration() const noexcept;
+};
+
+/// Parses a recording.
+/// @return The recording, or a message naming the record that is malformed.
+[[nodiscard]] std::expected<PtyRecording, std::string> readPtyRecording(std::istream& in);
+
+/// Writes a recording as it happens, so a long session needs no memory for it.
+///
+/// Not thread-safe: the recorder serializes output and resizes itself.
+class PtyRecordingWriter
+{
+  public:
+    /// Writes the header and the initial page size.
+    PtyRecordingWriter(std::ostream& out, PageSize pageSize);
+
+    /// Records @p bytes as written now.
+    void output(std::string_view bytes) { output(elapsed(), bytes); }
+
+    /// Records a page size change now.
+    void resize(PageSize pageSize) { resize(elapsed(), pageSize); }
+
+    void output(std::chrono::microseconds at, std::string_view bytes);
+    void resize(std::chrono::microseconds at, PageSize pageSize);
+
+  private:
+    [[nodiscard]] std::chrono::microseconds elapsed() const;
+
+    std::ostream& _out;
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+};
+
+} // namespace vtbackend
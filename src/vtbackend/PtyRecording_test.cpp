@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/PtyRecording.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+using vtbackend::ColumnCount;
+using vtbackend::LineCount;
+using vtbackend::PageSize;
+using vtbackend::PtyRecording;
+
+TEST_CASE("PtyRecording.round_trip", "[PtyRecording]")
+{
+    auto const initial = PageSize { .lines = LineCount(24), .columns = ColumnCount(80) };
+    auto const resized = PageSize { .lines = LineCount(40), .columns = ColumnCount(120) };
+
+    auto stream = std::stringstream {};
+    {
+        auto writer = vtbackend::PtyRecordingWriter { stream, initial };
+        writer.output(0us, "hello\n");
+        // Arbitrary bytes, newlines and NULs included, survive verbatim.
+        writer.output(1500us, "\033[?25l\0\n\n"s);
+        writer.resize(250ms, resized);
+    }
+
+    auto const recording = vtbackend::readPtyRecording(stream);
+    REQUIRE(recording.has_value());
+    CHECK(recording->pageSize == initial);
+    REQUIRE(recording->records.size() == 3);
+
+    auto const& second = std::get<PtyRecording::Output>(recording->records[1]);
+    CHECK(second.at == 1500us);
+    CHECK(second.bytes == "\033[?25l\0\n\n"s);
+    auto const& resize = std::get<PtyRecording::Resize>(recording->records[2]);
+    CHECK(resize.at == 250ms);
+    CHECK(resize.pageSize == resized);
+
+    CHECK(recording->outputBytes() == 15);
+    CHECK(recording->duration() == 250ms);
+}
+
+TEST_CASE("PtyRecording.skips_comments", "[PtyRecording]")
+{
+    auto stream = std::istringstream { "contour-pty-recording 1\n"
+                                       "# htop, 80x24\n"
+                                       "r 0 80 24\n"
+                                       "\n"
+                                       "o 10 2\n"
+                                       "hi\n" };
+    auto const recording = vtbackend::readPtyRecording(stream);
+    REQUIRE(recording.has_value());
+    REQUIRE(recording->records.size() == 1);
+    CHECK(std::get<PtyRecording::Output>(recording->records[0]).bytes == "hi");
+}
+
+TEST_CASE("PtyRecording.rejects_malformed_input", "[PtyRecording]")
+{
+    auto const read = [](std::string text) {
+        auto stream = std::istringstream { std::move(text) };
+        return vtbackend::readPtyRecording(stream);
+    };
+
+    CHECK_FALSE(read("asciicast 2\n").has_value());
+    CHECK_FALSE(read("contour-pty-recording 1\n").has_value());
+    CHECK_FALSE(read("contour-pty-recording 1\no 0 2\nhi\n").has_value());
+    CHECK_FALSE(read("contour-pty-recording 1\nr 0 80 24\no 10 5\nhi\n").has_value());
+    CHECK_FALSE(read("contour-pty-recording 1\nr 0 80 24\no 10 2\nhi\no 5 0\n\n").has_value());
+    CHECK_FALSE(read("contour-pty-recording 1\nr 0 0 24\n").has_value());
+
+    auto const result = read("contour-pty-recording 1\nr 0 80 24\nx 10\n");
+    REQUIRE_FALSE(result.has_value());
+    CHECK(result.error().find("record 2") != std::string::npos);
+}
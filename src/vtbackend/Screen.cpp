@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <vtbackend/Screen.hpp>
 
+#include <vtbackend/ClipboardParser.hpp>
 #include <vtbackend/ControlCode.hpp>
 #include <vtbackend/DesktopNotification.hpp>
 #include <vtbackend/InputGenerator.hpp>
@@ -755,7 +756,7 @@ void Screen::writeTextInternal(char32_t sourceCodepoint)
     _terminal->resetInstructionCounter();
 }
 
-void Screen::writeCharToCurrentAndAdvance(char32_t codepoint) noexcept
+void Screen::writeCharToCurrentAndAdvance(char32_t codepoint)
 {
     // IRM: shift existing cells right to make room for the new character
     if (_terminal->isModeEnabled(AnsiMode::Insert))
@@ -831,7 +832,7 @@ ClusterWidthPolicy Screen::clusterWidthPolicy() const noexcept
                                                       : ClusterWidthPolicy::FirstCodepoint;
 }
 
-void Screen::applyClusterWidthChange(int delta) noexcept
+void Screen::applyClusterWidthChange(int delta)
 {
     if (delta == 0)
         return;
@@ -937,7 +938,7 @@ ColumnOffset Screen::lastWritableColumn() const noexcept
     return cursorInsideMargin ? margin().horizontal.to : boxed_cast<ColumnOffset>(pageSize().columns) - 1;
 }
 
-void Screen::clearAndAdvance(int oldWidth, int newWidth) noexcept
+void Screen::clearAndAdvance(int oldWidth, int newWidth)
 {
     // Writable cells the character has to work with: the cursor's OWN column plus every writable
     // column to the right of it. Counting only the columns strictly to the right -- as though the
@@ -982,7 +983,7 @@ std::string Screen::screenshot(function<string(LineOffset)> const& postLine) con
     return result.str();
 }
 
-optional<LineOffset> Screen::findMarkerUpwards(LineOffset startLine) const
+optional<LineOffset> Screen::findMarkerUpwards(LineOffset startLine)
 {
     // XXX startLine is an absolute history line coordinate
     if (historyLineCount() == 0)
@@ -992,14 +993,10 @@ optional<LineOffset> Screen::findMarkerUpwards(LineOffset startLine) const
 
     startLine = std::min(startLine, boxed_cast<LineOffset>(pageSize().lines - 1));
 
-    for (LineOffset i = startLine - 1; i >= -boxed_cast<LineOffset>(historyLineCount()); --i)
-        if (_grid.lineAt(i).marked())
-            return { i };
-
-    return nullopt;
+    return _grid.findFlaggedLineAbove(startLine, LineFlag::Marked);
 }
 
-optional<LineOffset> Screen::findMarkerDownwards(LineOffset startLine) const
+optional<LineOffset> Screen::findMarkerDownwards(LineOffset startLine)
 {
     if (historyLineCount() == 0)
         return nullopt;
@@ -1010,10 +1007,8 @@ optional<LineOffset> Screen::findMarkerDownwards(LineOffset startLine) const
 
     auto const bottom = LineOffset(0);
 
-    for (LineOffset i = top + 1; i <= bottom; ++i)
-        if (_grid.lineAt(i).marked())
-            return { i };
-
+    if (auto const marker = _grid.findFlaggedLineBelow(top, LineFlag::Marked); marker && *marker <= bottom)
+        return marker;
     return nullopt;
 }
 
@@ -1183,7 +1178,7 @@ void Screen::linefeed()
         && _terminal->settings().smoothLineScrolling.count() != 0)
     {
         _terminal->unlock();
-        auto const _ = crispy::Finally([&]() { _terminal->lock(); });
+        auto const _ = crispy::Finally([&]() { _terminal->lock(LockSite::Parse); });
         if (!_terminal->isModeEnabled(DECMode::BatchedRendering))
             _terminal->screenUpdated();
         sleepFor(_terminal->settings().smoothLineScrolling);
@@ -5426,13 +5421,27 @@ void Screen::resetKittyState() noexcept
     // command would be swallowed as a continuation chunk of the dead one, taking that command's
     // format and dimensions instead of its own. The same applies to a clipboard write left open, and
     // to images Terminal::hardReset() has already dropped from the image pool.
-    _kittyChunkedPayload.clear();
+    _kittyChunkedData.clear();
+    _kittyChunkedDecoder = {};
+    _kittyChunkedReceived = 0;
     _kittyChunkedCommand.reset();
     _kittyImages.clear();
     _terminal->kittyClipboardWrite().clear();
     _terminal->kittyClipboardWriteOpen() = false;
 }
 
+unique_ptr<ParserExtension> Screen::hookOSC(int code)
+{
+    // OSC 52 is streamed so that a clipboard write is not cut off at Sequence::MaxOscLength.
+    auto const* function = selectOSCommand(code, _terminal->activeSequences());
+    if (!function || *function != CLIPBOARD)
+        return nullptr;
+
+    return make_unique<ClipboardParser>(
+        [this](string_view /*selection*/, string_view data) { _terminal->copyToClipboard(data); },
+        [this](string_view selection) { _terminal->requestClipboardRead(selection); });
+}
+
 void Screen::processKittyGraphics(std::string_view body)
 {
     using namespace kitty_graphics;
@@ -5447,37 +5456,44 @@ void Screen::processKittyGraphics(std::string_view body)
     auto command = std::move(parsed.value());
 
     // A chunked transmission carries its control data only in the FIRST chunk; the rest is payload
-    // that has to be stitched onto it before anything can be decided.
+    // that has to be stitched onto it before anything can be decided. Chunks are decoded on arrival
+    // rather than concatenated and decoded at the end, which would hold the base64 text and its
+    // decoded copy at once for the largest images.
+    auto assembled = std::optional<Image::Data> {};
     if (_kittyChunkedCommand)
     {
         // A chunk stream that never terminates is otherwise an unbounded allocation driven straight
         // from the wire. Abandon the whole transmission rather than truncate it: a partial image
         // decoded against its declared dimensions is not an image.
-        if (_kittyChunkedPayload.size() + command.payload.size() > MaxChunkedPayloadSize)
+        if (_kittyChunkedReceived + command.payload.size() > MaxChunkedPayloadSize)
         {
             auto const abandoned = *_kittyChunkedCommand;
             _kittyChunkedCommand.reset();
-            _kittyChunkedPayload.clear();
-            _kittyChunkedPayload.shrink_to_fit();
+            _kittyChunkedReceived = 0;
+            _kittyChunkedDecoder = {};
+            Image::Data {}.swap(_kittyChunkedData);
             replyKittyGraphics(abandoned, "EINVAL:image transmission too large");
             return;
         }
 
-        _kittyChunkedPayload += command.payload;
+        _kittyChunkedReceived += command.payload.size();
+        crispy::base64::decode(command.payload, _kittyChunkedDecoder, _kittyChunkedData);
         if (command.moreChunksFollow)
             return;
-        auto continued = *_kittyChunkedCommand;
-        continued.payload = std::move(_kittyChunkedPayload);
-        _kittyChunkedCommand.reset();
-        _kittyChunkedPayload.clear();
-        command = std::move(continued);
+        crispy::base64::finish(_kittyChunkedDecoder, _kittyChunkedData);
+        assembled = std::exchange(_kittyChunkedData, {});
+        command = *std::exchange(_kittyChunkedCommand, std::nullopt);
+        _kittyChunkedDecoder = {};
+        _kittyChunkedReceived = 0;
     }
     else if (command.moreChunksFollow)
     {
-        _kittyChunkedPayload = command.payload;
-        auto opener = command;
-        opener.payload.clear();
-        _kittyChunkedCommand = std::move(opener);
+        _kittyChunkedData.clear();
+        _kittyChunkedDecoder = {};
+        _kittyChunkedReceived = command.payload.size();
+        crispy::base64::decode(command.payload, _kittyChunkedDecoder, _kittyChunkedData);
+        command.payload.clear();
+        _kittyChunkedCommand = std::move(command);
         return;
     }
 
@@ -5522,8 +5538,16 @@ void Screen::processKittyGraphics(std::string_view body)
         return;
     }
 
-    auto const decoded = crispy::base64::decode(command.payload);
-    auto pixmap = Image::Data(decoded.begin(), decoded.end());
+    auto pixmap = Image::Data {};
+    if (assembled)
+        pixmap = std::move(*assembled);
+    else
+    {
+        // The batch decoder, straight into the pixmap: it stops at the first character outside the
+        // alphabet, where the streaming one a chunked transmission needs skips over it instead.
+        pixmap.resize((command.payload.size() + 3) / 4 * 3);
+        pixmap.resize(crispy::base64::decode(command.payload, pixmap.data()));
+    }
 
     auto const format = [&] {
         switch (command.format)
@@ -5645,6 +5669,24 @@ void Screen::processSequence(Sequence const& seq)
         vtParserLog()("Unknown VT sequence: {}", seq);
 }
 
+void Screen::processSGR(Sequence const& seq)
+{
+#ifdef LIBTERMINAL_LOG_TRACE
+    // Traced sequences are logged with their mnemonic, which takes the lookup this path exists to skip.
+    if (vtTraceSequenceLog)
+    {
+        processSequence(seq);
+        return;
+    }
+#endif
+
+    // SGR is accepted at every operating level and always applies (it cannot be Invalid), so there is
+    // nothing for the function table to decide. @see processSequence()
+    _terminal->incrementInstructionCounter();
+    impl::applySGR(*this, seq, 0, seq.parameterCount());
+    _terminal->verifyState();
+}
+
 namespace
 {
     // DCS response status codes for SBQUERY.
@@ -5837,6 +5879,30 @@ namespace
         mutable LineOffset _head;         ///< Its first physical line.
         mutable LineOffset _previousHead; ///< The head of the logical line below it (unused at index 0).
     };
+
+    /// Where a backward command-block scan from @p line can start without changing what it finds.
+    ///
+    /// Until it meets the CommandEnd that closes a block, the scan only steps over lines — and below the
+    /// last finished command there may be a great many of them: the output of one still running, or a
+    /// scrollback no shell integration ever marked. The grid's semantic line index names that CommandEnd
+    /// directly, so the scan starts there instead.
+    /// @return The line to start at, or nullopt when no finished command is left to find.
+    std::optional<LineOffset> commandBlockScanStart(Grid& grid, LineOffset line)
+    {
+        auto const head = grid.logicalLineHead(line);
+        if (grid.lineAt(head).isFlagEnabled(LineFlag::CommandEnd))
+            return line;
+
+        auto const closing = grid.findFlaggedLineAbove(head, LineFlag::CommandEnd);
+        if (!closing)
+            return std::nullopt;
+        // Started at its head, the scan would take that logical line to end there too: start at its last
+        // physical line instead, the one right above the head of the line after it.
+        auto last = *closing;
+        while (last + 1 < head && grid.lineAt(last + 1).wrapped())
+            ++last;
+        return last;
+    }
 } // namespace
 
 void Screen::handleSemanticBlockQuery(Sequence const& seq)
@@ -5895,11 +5961,11 @@ void Screen::handleInProgressQuery(SemanticBlockTracker const& tracker)
 
     auto const cursorLine = cursor().position.line;
 
-    // Find the most recent OutputStart line by scanning backward from cursor.
+    // Find the most recent OutputStart line at or above the cursor, on the page.
     auto const [foundOutputStart, outputStartLine] = [&]() -> std::pair<bool, LineOffset> {
-        for (auto line = cursorLine; line >= LineOffset(0); --line)
-            if (_grid.lineAt(line).isFlagEnabled(LineFlag::OutputStart))
-                return { true, line };
+        auto const line = _grid.findFlaggedLineAbove(cursorLine + 1, LineFlag::OutputStart);
+        if (line && *line >= LineOffset(0))
+            return { true, *line };
         return { false, cursorLine };
     }();
 
@@ -5922,18 +5988,16 @@ void Screen::handleInProgressQuery(SemanticBlockTracker const& tracker)
     auto promptText = std::string {};
     if (foundOutputStart)
     {
-        for (auto line = outputStartLine - 1; line >= LineOffset(0); --line)
+        auto const marked = _grid.findFlaggedLineAbove(outputStartLine, LineFlag::Marked);
+        if (marked && *marked >= LineOffset(0))
         {
-            if (_grid.lineAt(line).isFlagEnabled(LineFlag::Marked))
+            auto const line = *marked;
+            for (auto pl: std::views::iota(*line, *outputStartLine))
             {
-                for (auto pl: std::views::iota(*line, *outputStartLine))
-                {
-                    auto const plOffset = LineOffset::cast_from(pl);
-                    if (plOffset != line)
-                        promptText += '\n';
-                    promptText += _grid.lineAt(plOffset).toUtf8Trimmed(false, true);
-                }
-                break;
+                auto const plOffset = LineOffset::cast_from(pl);
+                if (plOffset != line)
+                    promptText += '\n';
+                promptText += _grid.lineAt(plOffset).toUtf8Trimmed(false, true);
             }
         }
     }
@@ -5980,8 +6044,10 @@ void Screen::handleCompletedBlocksQuery(SemanticBlockTracker const& tracker,
 
     // Reconstruct each block's text from the OSC 133 marks the shell left in the grid. The tracker knows
     // HOW MANY blocks there are and what their metadata is; the grid is what still holds their text.
+    auto const scanStart = commandBlockScanStart(_grid, cursor().position.line);
     auto const blockTexts =
-        scanCommandBlocksBackward(GridCommandBlockLines { _grid, cursor().position.line }, blocks.size());
+        scanStart ? scanCommandBlocksBackward(GridCommandBlockLines { _grid, *scanStart }, blocks.size())
+                  : std::vector<CommandBlockText> {};
 
     // Build JSON response with blocks in chronological order (oldest first).
     auto json = std::string {};
@@ -5998,9 +6064,12 @@ void Screen::handleCompletedBlocksQuery(SemanticBlockTracker const& tracker,
     reply("{}{}{}", SBQueryResponseSuccess, json, DcsTerminator);
 }
 
-std::optional<CommandBlockText> Screen::lastCommandBlock() const
+std::optional<CommandBlockText> Screen::lastCommandBlock()
 {
-    auto blocks = scanCommandBlocksBackward(GridCommandBlockLines { _grid, cursor().position.line }, 1);
+    auto const scanStart = commandBlockScanStart(_grid, cursor().position.line);
+    if (!scanStart)
+        return std::nullopt;
+    auto blocks = scanCommandBlocksBackward(GridCommandBlockLines { _grid, *scanStart }, 1);
     if (blocks.empty())
         return std::nullopt;
     return std::move(blocks.front());
@@ -20,6 +20,7 @@
 
 #include <vtparser/ParserExtension.hpp>
 
+#include <crispy/Base64.hpp>
 #include <crispy/LogStore.hpp>
 #include <crispy/Size.hpp>
 #include <crispy/Utils.hpp>
@@ -203,7 +204,9 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     void writeTextEnd() override;
     void executeControlCode(char controlCode) override;
     void processSequence(Sequence const& seq) override;
+    void processSGR(Sequence const& seq) override;
     void processAPC(std::string_view body) override;
+    [[nodiscard]] std::unique_ptr<ParserExtension> hookOSC(int code) override;
 
   private:
     /// Handles one kitty graphics command (the APC body after its leading 'G').
@@ -697,7 +700,7 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     ///                   (0..-N) for savedLines area
     /// @return cursor position relative to screen origin (1, 1), that is, if line Number os >= 1, it's
     ///         in the screen area, and in the savedLines area otherwise.
-    [[nodiscard]] std::optional<LineOffset> findMarkerDownwards(LineOffset startLine) const;
+    [[nodiscard]] std::optional<LineOffset> findMarkerDownwards(LineOffset startLine);
 
     /// Finds the previous marker right next to the given line position.
     ///
@@ -705,7 +708,7 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     ///                   (0..-N) for savedLines area
     /// @return cursor position relative to screen origin (1, 1), that is, if line Number os >= 1, it's
     ///         in the screen area, and in the savedLines area otherwise.
-    [[nodiscard]] std::optional<LineOffset> findMarkerUpwards(LineOffset startLine) const;
+    [[nodiscard]] std::optional<LineOffset> findMarkerUpwards(LineOffset startLine);
 
     /// The most recently FINISHED shell command, reconstructed from the OSC 133 marks its shell left in
     /// the scrollback.
@@ -714,7 +717,7 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     /// reader protocol (DEC mode 2034) is a separate, opt-in channel and is not required here.
     ///
     /// @return The block, or nullopt when the scrollback holds no finished command.
-    [[nodiscard]] std::optional<CommandBlockText> lastCommandBlock() const;
+    [[nodiscard]] std::optional<CommandBlockText> lastCommandBlock();
 
     /// Where the shell's LIVE prompt sits in the grid — the one the user is typing at right now.
     ///
@@ -910,8 +913,8 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     /// Applies LF but also moves cursor to given column @p column.
     void linefeed(ColumnOffset column);
 
-    void writeCharToCurrentAndAdvance(char32_t codepoint) noexcept;
-    void clearAndAdvance(int oldWidth, int newWidth) noexcept;
+    void writeCharToCurrentAndAdvance(char32_t codepoint);
+    void clearAndAdvance(int oldWidth, int newWidth);
 
     /// Claims or releases columns after a grapheme cluster's width was revised by a codepoint that
     /// joined it late (a variation selector).
@@ -922,7 +925,7 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     /// @return whether a late codepoint may revise its cluster's width, per DEC mode 2027.
     [[nodiscard]] ClusterWidthPolicy clusterWidthPolicy() const noexcept;
 
-    void applyClusterWidthChange(int delta) noexcept;
+    void applyClusterWidthChange(int delta);
 
     /// @return The rightmost column that may still be written on the cursor's line: the right margin
     ///         when the cursor is inside a DECLRMM band, otherwise the last page column.
@@ -981,8 +984,12 @@ class Screen final: public SequenceHandler, public capabilities::StaticDatabase
     Cursor _savedCursor {};
 
     /// Payload accumulated across a chunked kitty graphics transmission (`m=1`), plus the command
-    /// that opened it -- the continuation chunks carry no control data of their own.
-    std::string _kittyChunkedPayload {};
+    /// that opened it -- the continuation chunks carry no control data of their own. Each chunk is
+    /// decoded as it arrives, so only the decoded bytes are held; @c _kittyChunkedReceived counts
+    /// the base64 received, which is what the transmission limit is stated in.
+    Image::Data _kittyChunkedData {};
+    crispy::base64::DecoderState _kittyChunkedDecoder {};
+    size_t _kittyChunkedReceived = 0;
     std::optional<kitty_graphics::Command> _kittyChunkedCommand {};
 
     /// Images transmitted by a kitty graphics command but not yet displayed, keyed by their `i=` id.
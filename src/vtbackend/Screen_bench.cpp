@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/MockTerm.hpp>
+#include <vtbackend/Screen.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <format>
+#include <ranges>
+#include <string>
+
+using namespace vtbackend;
+
+// Microbenchmarks of the Screen primitives the VT parser drives, one operation per BENCHMARK, so a
+// regression names the primitive that regressed. Compare two runs with scripts/compare-benchmarks.py.
+
+namespace
+{
+
+auto constexpr BenchPageSize = PageSize { .lines = LineCount(50), .columns = ColumnCount(200) };
+auto constexpr BenchHistory = LineCount(1000);
+
+/// How fillPage() renders its text.
+enum class PageStyle : uint8_t
+{
+    Plain,  ///< Plain text, one attribute for the whole page.
+    Styled, ///< A different SGR every few cells, as a syntax-highlighted editor would have it.
+};
+
+/// Fills the page with words in the given @p style.
+void fillPage(MockTerm<>& mock, PageStyle style)
+{
+    auto constexpr WordWidth = 8;
+    auto const lines = unbox(BenchPageSize.lines);
+    auto text = std::string { "\033[H" };
+    for (auto const line: std::views::iota(0, lines))
+    {
+        for (auto const word: std::views::iota(0, unbox(BenchPageSize.columns) / WordWidth))
+        {
+            if (style == PageStyle::Styled)
+                text += std::format("\033[{};{}m", 31 + word % 7, word % 2 ? 1 : 22);
+            text += "lorem ip";
+        }
+        if (line + 1 < lines)
+            text += "\r\n";
+    }
+    mock.writeToScreen(text + "\033[m");
+}
+
+} // namespace
+
+TEST_CASE("Screen.writeText", "[!benchmark][Screen]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+    auto& screen = mock.terminal.primaryScreen();
+    auto const ascii = std::string(80, 'a');
+
+    BENCHMARK("80 ASCII cells")
+    {
+        screen.moveCursorTo(LineOffset(0), ColumnOffset(0));
+        screen.writeText(ascii, ascii.size());
+    };
+}
+
+TEST_CASE("Screen.linefeed", "[!benchmark][Screen]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+    auto& screen = mock.terminal.primaryScreen();
+    fillPage(mock, PageStyle::Plain);
+    screen.moveCursorTo(LineOffset(unbox(BenchPageSize.lines) - 1), ColumnOffset(0));
+
+    // At the bottom of the page every linefeed scrolls a line into (full) history.
+    BENCHMARK("at page bottom")
+    {
+        screen.linefeed();
+    };
+}
+
+TEST_CASE("Screen.scrollUp", "[!benchmark][Screen]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+    auto& screen = mock.terminal.primaryScreen();
+    fillPage(mock, PageStyle::Plain);
+
+    mock.writeToScreen("\033[5;45r");
+    BENCHMARK("vertical margins")
+    {
+        screen.scrollUp(LineCount(1));
+    };
+
+    mock.writeToScreen("\033[?69h\033[10;190s");
+    BENCHMARK("vertical and horizontal margins")
+    {
+        screen.scrollUp(LineCount(1));
+    };
+}
+
+TEST_CASE("Screen.insertDeleteLines", "[!benchmark][Screen]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+    auto& screen = mock.terminal.primaryScreen();
+
+    // Each sample starts from a full page rather than from the blank lines the last one shifted in.
+    BENCHMARK_ADVANCED("insertLines(3)")(Catch::Benchmark::Chronometer meter)
+    {
+        fillPage(mock, PageStyle::Plain);
+        screen.moveCursorTo(LineOffset(10), ColumnOffset(0));
+        meter.measure([&] { screen.insertLines(LineCount(3)); });
+    };
+
+    BENCHMARK_ADVANCED("deleteLines(3)")(Catch::Benchmark::Chronometer meter)
+    {
+        fillPage(mock, PageStyle::Plain);
+        screen.moveCursorTo(LineOffset(10), ColumnOffset(0));
+        meter.measure([&] { screen.deleteLines(LineCount(3)); });
+    };
+}
+
+TEST_CASE("Screen.eraseArea", "[!benchmark][Screen]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+    auto& screen = mock.terminal.primaryScreen();
+
+    // Refilled for each sample: erasing a page that is already blank measures a different path.
+    BENCHMARK_ADVANCED("full page")(Catch::Benchmark::Chronometer meter)
+    {
+        fillPage(mock, PageStyle::Styled);
+        meter.measure([&] {
+            screen.eraseArea(0, 0, unbox(BenchPageSize.lines) - 1, unbox(BenchPageSize.columns) - 1);
+        });
+    };
+}
+
+TEST_CASE("RenderBufferBuilder.page", "[!benchmark][RenderBufferBuilder]")
+{
+    auto mock = MockTerm { BenchPageSize, BenchHistory };
+
+    // Plain lines take the trivial-line path; styled ones are built cell by cell.
+    fillPage(mock, PageStyle::Plain);
+    BENCHMARK("plain lines")
+    {
+        mock.terminal.refreshRenderBuffer();
+    };
+
+    fillPage(mock, PageStyle::Styled);
+    BENCHMARK("styled lines")
+    {
+        mock.terminal.refreshRenderBuffer();
+    };
+}
@@ -7,6 +7,7 @@
 #include <vtbackend/TestHelpers.hpp>
 #include <vtbackend/Viewport.hpp>
 
+#include <crispy/Base64.hpp>
 #include <crispy/Escape.hpp>
 #include <crispy/Utils.hpp>
 
@@ -7395,6 +7396,20 @@ TEST_CASE("OSC 52: clipboard write and gated read", "[screen]")
         mock.terminal.flushInput();
         CHECK(mock.replyData().empty()); // no reply: the clipboard is not exposed
     }
+
+    SECTION("a write far beyond an OSC string's limit is streamed whole")
+    {
+        auto text = std::string {};
+        while (text.size() < 4 * Sequence::MaxOscLength)
+            text += std::format("line {}\n", text.size());
+        mock.writeToScreen(std::format("\033]52;c;{}\033\\", crispy::base64::encode(text)));
+        mock.terminal.flushInput();
+        CHECK(mock.clipboardData == text);
+
+        // And the OSC after it is parsed as usual.
+        mock.writeToScreen("\033]2;title\033\\");
+        CHECK(mock.terminal.windowTitle() == "title");
+    }
 }
 
 // }}} XTSMTITLE / XTRMTITLE (Set/Reset Title Modes) Tests
@@ -8370,7 +8385,7 @@ TEST_CASE("A hard reset leaves VT52", "[screen]")
     mock.writeToScreen("\033c");
     REQUIRE(mock.terminal.isVT52Mode());
 
-    crispy::locked(mock.terminal, [&]() { mock.terminal.hardReset(); });
+    mock.terminal.locked(LockSite::Input, [&]() { mock.terminal.hardReset(); });
     CHECK_FALSE(mock.terminal.isVT52Mode());
 
     // Unlike `ESC <`, which lands at VT100, RIS restores the level the terminal was configured with.
@@ -3,6 +3,8 @@
 
 #include <vtbackend/Functions.hpp>
 
+#include <vtparser/ParserExtension.hpp>
+
 #include <gsl/pointers>
 #include <gsl/span>
 
@@ -12,6 +14,7 @@
 #include <cstddef>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -253,8 +256,8 @@ class SequenceParameterBuilder
 class Sequence
 {
   public:
-    // Make maximum size 50 kB since we need to support adding to the clipboard
-    // and the clipboard can contain large amounts of text.
+    // Bounds the OSC strings collected here. Clipboard writes (OSC 52), the one OSC that carries
+    // large amounts of data, are streamed past it instead (@see ClipboardParser).
     size_t constexpr static MaxOscLength =
         static_cast<size_t>(1024 * 50); // NOLINT(readability-identifier-naming)
 
@@ -466,11 +469,27 @@ class SequenceHandler
     virtual void executeControlCode(char controlCode) = 0;
     virtual void processSequence(Sequence const& sequence) = 0;
 
+    /// Handles a plain SGR (`CSI Ps ; ... m`, no leader, no intermediates).
+    ///
+    /// SGR is by far the most frequent sequence in colored output, so the SequenceBuilder hands it
+    /// here directly rather than through processSequence(), letting a handler skip the function
+    /// table lookup and dispatch. Handling it like any other sequence is always correct.
+    virtual void processSGR(Sequence const& sequence) { processSequence(sequence); }
+
     /// Handles an APC (Application Program Command) body, without its introducer or terminator.
     ///
     /// APC has no shared grammar the way CSI and OSC do -- each application-defined protocol carries
     /// its own -- so it is dispatched as a raw body rather than through the function table.
     virtual void processAPC(std::string_view body) = 0;
+
+    /// Offered an OSC as soon as its code is known, to take the rest of it as a stream.
+    ///
+    /// An extension returned here is passed the OSC's payload as it arrives, and finalized when it
+    /// ends, instead of the payload being collected up to Sequence::MaxOscLength and dispatched
+    /// through processSequence(). The default declines every OSC.
+    /// @param code The OSC's numeric code.
+    virtual std::unique_ptr<ParserExtension> hookOSC(int /*code*/) { return nullptr; }
+
     virtual void writeText(char32_t codepoint) = 0;
     virtual void writeText(std::string_view codepoints, size_t cellCount) = 0;
     virtual void writeTextEnd() = 0;
@@ -480,6 +499,7 @@ template <typename T>
 concept SequenceHandlerConcept = requires(T t) {
     { t.executeControlCode('\x00') } -> std::same_as<void>;
     { t.processSequence(Sequence {}) } -> std::same_as<void>;
+    { t.processSGR(Sequence {}) } -> std::same_as<void>;
     { t.processAPC(std::string_view {}) } -> std::same_as<void>;
     { t.writeText(U'a') } -> std::same_as<void>;
     { t.writeText("a", size_t(1)) } -> std::same_as<void>;
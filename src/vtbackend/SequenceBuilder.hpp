@@ -116,6 +116,15 @@ class SequenceBuilder
     {
         _sequence.setCategory(FunctionCategory::CSI);
         _sequence.setFinalChar(finalChar);
+
+        // The parameters are already in place; what SGR skips is finding its function definition.
+        if (finalChar == 'm' && _sequence.leaderSymbol() == 0 && _sequence.intermediateCharacters().empty())
+        {
+            _parameterBuilder.fixiate();
+            _handler.processSGR(_sequence);
+            return;
+        }
+
         handleSequence();
     }
 
@@ -141,12 +150,38 @@ class SequenceBuilder
 
     void putOSC(char ch)
     {
-        if (_sequence.intermediateCharacters().size() + 1 < Sequence::MaxOscLength)
-            _sequence.intermediateCharacters().push_back(ch);
+        if (_hookedOSC)
+        {
+            _hookedOSC->pass(ch);
+            return;
+        }
+
+        auto& text = _sequence.intermediateCharacters();
+        if (text.size() + 1 >= Sequence::MaxOscLength)
+            return;
+        text.push_back(ch);
+
+        // Once the code is complete, the handler may take the payload as a stream.
+        if constexpr (requires(Handler& handler) { handler.hookOSC(0); })
+        {
+            if (ch == ';' && text.find(';') == text.size() - 1)
+            {
+                _hookedOSC = _handler.hookOSC(vtparser::extractCodePrefix(text).first);
+                if (_hookedOSC)
+                    clear();
+            }
+        }
     }
 
     void dispatchOSC()
     {
+        if (_hookedOSC)
+        {
+            _hookedOSC->finalize();
+            _hookedOSC.reset();
+            return;
+        }
+
         auto const [code, skipCount] = vtparser::extractCodePrefix(_sequence.intermediateCharacters());
         _parameterBuilder.set(static_cast<Sequence::Parameter>(code));
         _sequence.intermediateCharacters().erase(0, skipCount);
@@ -246,6 +281,9 @@ class SequenceBuilder
     Handler _handler;
 
     std::unique_ptr<ParserExtension> _hookedParser {};
+
+    /// The extension streaming the current OSC's payload, if its handler took it. @see putOSC.
+    std::unique_ptr<ParserExtension> _hookedOSC {};
 };
 
 template <SequenceHandlerConcept Handler, InstructionCounterConcept IncrementInstructionCounter>
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/MockTerm.hpp>
+#include <vtbackend/Screen.hpp>
+#include <vtbackend/SequenceBuilder.hpp>
+
+#include <vtparser/Parser.hpp>
+
+#include <crispy/Escape.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <format>
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace vtbackend;
+
+namespace
+{
+
+struct Routed
+{
+    bool viaSGR;
+    Sequence sequence;
+};
+
+/// Records how the SequenceBuilder routed each sequence.
+struct RoutingRecorder
+{
+    std::vector<Routed>* routed;
+
+    void executeControlCode(char) {}
+    void processSequence(Sequence const& sequence)
+    {
+        routed->push_back({ .viaSGR = false, .sequence = sequence });
+    }
+    void processSGR(Sequence const& sequence) { routed->push_back({ .viaSGR = true, .sequence = sequence }); }
+    void processAPC(std::string_view) {}
+    void writeText(char32_t) {}
+    void writeText(std::string_view, size_t) {}
+    void writeTextEnd() {}
+    [[nodiscard]] size_t maxBulkTextSequenceWidth() const noexcept { return 0; }
+};
+
+std::vector<Routed> route(std::string_view vtStream)
+{
+    auto routed = std::vector<Routed> {};
+    auto recorder = RoutingRecorder { .routed = &routed };
+    auto sequenceBuilder = SequenceBuilder { recorder, NoOpInstructionCounter() };
+    auto parser = vtparser::Parser { sequenceBuilder };
+    parser.parseFragment(vtStream);
+    return routed;
+}
+
+/// Every SGR parameter string worth telling apart: each selector alone, the underline styles, and
+/// the extended colors in each spelling, valid and not.
+std::vector<std::string> sgrForms()
+{
+    auto forms = std::vector<std::string> { "" };
+    for (auto const n: std::views::iota(0, 110))
+        forms.emplace_back(std::format("{}", n));
+    for (auto const n: std::views::iota(0, 7))
+        forms.emplace_back(std::format("4:{}", n));
+
+    for (auto const selector: { 38, 48, 58 })
+    {
+        for (auto const index: { 0, 15, 196, 255, 256 })
+        {
+            forms.emplace_back(std::format("{};5;{}", selector, index));
+            forms.emplace_back(std::format("{}:5:{}", selector, index));
+        }
+        forms.emplace_back(std::format("{};2;1;2;3", selector));
+        forms.emplace_back(std::format("{};2;255;255;255", selector));
+        forms.emplace_back(std::format("{};2;256;0;0", selector));
+        forms.emplace_back(std::format("{};2;1", selector));
+        forms.emplace_back(std::format("{}:2::1:2:3", selector));
+        forms.emplace_back(std::format("{}:2:1:2:3", selector));
+        forms.emplace_back(std::format("{}:2::1:2:300", selector));
+        forms.emplace_back(std::format("{}:3:1:2:3:4", selector));
+        forms.emplace_back(std::format("{}:4:1:2:3:4:5", selector));
+        forms.emplace_back(std::format("{}", selector));
+        forms.emplace_back(std::format("{};7", selector));
+        // A color followed by more selectors: the index must land exactly after it.
+        forms.emplace_back(std::format("{};5;100;1;3", selector));
+        forms.emplace_back(std::format("{}:2::10:20:30;4;9", selector));
+    }
+
+    forms.emplace_back("1;31;4:3;58:2::10:20:30;48;5;17;0;7");
+    forms.emplace_back(";1;;3;");
+    forms.emplace_back("1;2;3;4;5;6;7;8;9;21;53;51;31;41;91;101");
+    return forms;
+}
+
+} // namespace
+
+TEST_CASE("SequenceBuilder.routes_only_plain_SGR_to_processSGR", "[SequenceBuilder]")
+{
+    auto const sgr = route("\033[1;31m\033[m\033[38:2::1:2:3m");
+    REQUIRE(sgr.size() == 3);
+    for (auto const& routed: sgr)
+        CHECK(routed.viaSGR);
+
+    // Same final character, different functions.
+    for (auto const* other: { "\033[>4;2m", "\033[?1m", "\033[$m", "\033[1 m", "\033[H" })
+    {
+        INFO(crispy::escape(other));
+        auto const routed = route(other);
+        REQUIRE(routed.size() == 1);
+        CHECK_FALSE(routed.front().viaSGR);
+    }
+}
+
+TEST_CASE("SequenceBuilder.SGR_fast_path_matches_generic_dispatch", "[SequenceBuilder]")
+{
+    // From the default pen, and from one with every attribute set, so that resets show as well.
+    for (auto const* initial: { "", "1;3;4:3;5;7;8;9;53;38;2;1;2;3;48;5;100;58;5;200" })
+    {
+        auto const setup = route(std::format("\033[{}m", initial));
+        REQUIRE(setup.size() == 1);
+
+        for (auto const& form: sgrForms())
+        {
+            INFO(std::format("from CSI {} m, CSI {} m", initial, form));
+            auto const routed = route(std::format("\033[{}m", form));
+            REQUIRE(routed.size() == 1);
+            REQUIRE(routed.front().viaSGR);
+
+            auto generic = MockTerm { ColumnCount(10), LineCount(2) };
+            generic.terminal.primaryScreen().processSequence(setup.front().sequence);
+            generic.terminal.primaryScreen().processSequence(routed.front().sequence);
+
+            auto fast = MockTerm { ColumnCount(10), LineCount(2) };
+            fast.terminal.primaryScreen().processSequence(setup.front().sequence);
+            fast.terminal.primaryScreen().processSGR(routed.front().sequence);
+            CHECK(fast.terminal.primaryScreen().cursor().graphicsRendition
+                  == generic.terminal.primaryScreen().cursor().graphicsRendition);
+
+            // And all the way from the byte stream.
+            auto parsed = MockTerm { ColumnCount(10), LineCount(2) };
+            parsed.writeToScreen(std::format("\033[{}m\033[{}m", initial, form));
+            CHECK(parsed.terminal.primaryScreen().cursor().graphicsRendition
+                  == generic.terminal.primaryScreen().cursor().graphicsRendition);
+        }
+    }
+}
@@ -32,6 +32,16 @@ enum class TabsNamingMode : uint8_t
     Title
 };
 
+/// How Terminal::flushInput() writes pending input to the PTY.
+enum class PtyInputWrite : uint8_t
+{
+    /// Every pending byte is written before flushInput() returns, waiting on the PTY if it is full.
+    Blocking,
+    /// Only what the PTY accepts right away is written; the host retries the rest later
+    /// (@see Terminal::hasInput()). For a host whose flushing thread must never stall, like a GUI's.
+    NonBlocking,
+};
+
 /// Terminal settings, enabling hardware reset to be easier implemented.
 struct Settings
 {
@@ -136,6 +146,7 @@ struct Settings
     //
     // This value must be integer-devisable by 16.
     size_t ptyReadBufferSize = 4096;
+    PtyInputWrite ptyInputWrite = PtyInputWrite::Blocking;
     std::u32string wordDelimiters;
     std::u32string extendedWordDelimiters;
     Modifiers mouseProtocolBypassModifiers = Modifier::Shift;
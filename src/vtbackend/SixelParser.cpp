@@ -4,8 +4,21 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cstring>
 #include <ranges>
 
+// clang-format off
+#if (__cpp_lib_simd >= 202411L)
+    #include <simd>
+    namespace simd = std;
+    #define VTBACKEND_SIMD_FOUND 1
+#elif __has_include(<experimental/simd>) && !defined(__APPLE__) && !defined(__FreeBSD__)
+    #include <experimental/simd>
+    namespace simd = std::experimental;
+    #define VTBACKEND_SIMD_FOUND 1
+#endif
+// clang-format on
+
 using std::clamp;
 using std::max;
 using std::min;
@@ -294,6 +307,15 @@ void SixelParser::pass(std::string_view bytes)
                 ++input;
             if (input != runBegin)
                 _events.renderRun(std::string_view { runBegin, static_cast<size_t>(input - runBegin) });
+
+            if (input != end && *input == '!')
+            {
+                if (auto const* const next = passRepeat(input, end); next != input)
+                {
+                    input = next;
+                    continue;
+                }
+            }
         }
         else if (auto const s = Table::index(_state);
                  isDigit(*input)
@@ -322,6 +344,23 @@ void SixelParser::pass(std::string_view bytes)
     }
 }
 
+SixelParser::iterator SixelParser::passRepeat(iterator input, iterator end)
+{
+    auto const* p = input + 1;
+    auto count = 0u;
+    // Folds exactly as paramShiftAndAddDigit() does, so an overflowing count wraps identically.
+    while (p != end && isDigit(*p))
+        count = (count * 10) + toDigit(*p++);
+    if (p == end || !isSixel(*p))
+        return input;
+
+    // Leave the parameters as the table would have: ResetParams on entry, then the folded count.
+    _paramCount = 1;
+    _params[0] = count;
+    _events.renderRepeated(toSixel(*p), count);
+    return p + 1;
+}
+
 void SixelParser::finalize()
 {
     done();
@@ -528,6 +567,75 @@ void SixelImageBuilder::paintBit(uint8_t* pixel, size_t rowBytes, RGBColor color
     }
 }
 
+#ifdef VTBACKEND_SIMD_FOUND
+namespace
+{
+    /// Where and how a run's columns are painted; fixed for the whole run.
+    struct SimdRun
+    {
+        /// The run's first column on buffer row 0.
+        uint8_t* firstPixel;
+        /// Distance between consecutive pixel rows.
+        size_t rowBytes;
+        /// Pixel rows each sixel bit covers.
+        unsigned aspectRatio;
+        /// The RGBA pixel to paint, in buffer byte order.
+        uint32_t color;
+        /// Bits whose rows all land on the canvas.
+        unsigned fittingBits;
+        /// Byte offset of each fitting bit's first pixel row.
+        std::array<size_t, SixelBitCount> const& rowOffsets;
+    };
+
+    /// Paints the leading whole vectors' worth of columns of @p sixels, band row by band row.
+    ///
+    /// The scalar path walks a run column by column and scatters a four-byte store per set bit at a
+    /// row stride. This turns the loop inside out: a vector of columns is decoded once, and each of
+    /// the band's six rows is then one contiguous load-blend-store across all of them. A blank vector
+    /// -- the common case, one colour plane per pass -- costs one compare.
+    /// @return the number of leading columns painted; the caller finishes the remainder.
+    size_t paintRunSimd(std::string_view sixels, SimdRun const& run) noexcept
+    {
+        using PixelV = ::simd::native_simd<uint32_t>;
+        constexpr auto Lanes = PixelV::size();
+
+        auto const color = PixelV(run.color);
+        auto lanes = std::array<uint32_t, Lanes> {};
+        auto const blocks = sixels.size() / Lanes;
+
+        for (auto const block: std::views::iota(size_t { 0 }, blocks))
+        {
+            auto const painted = block * Lanes;
+            auto const bits = PixelV([&](auto i) {
+                return static_cast<uint32_t>(static_cast<uint8_t>(sixels[painted + i]) - 63u) & SixelBitMask;
+            }) & PixelV(run.fittingBits);
+            if (::simd::none_of(bits != 0u))
+                continue;
+
+            auto* const column = run.firstPixel + (painted * 4);
+            for (auto remaining = run.fittingBits; remaining != 0; remaining &= remaining - 1)
+            {
+                auto const bit = static_cast<unsigned>(std::countr_zero(remaining));
+                auto const hit = (bits & PixelV(1u << bit)) != 0u;
+                if (::simd::none_of(hit))
+                    continue;
+                auto* row = column + run.rowOffsets[bit];
+                for ([[maybe_unused]] auto const repeat: std::views::iota(0u, run.aspectRatio))
+                {
+                    std::memcpy(lanes.data(), row, Lanes * 4);
+                    auto pixels = PixelV(lanes.data(), ::simd::element_aligned);
+                    ::simd::where(hit, pixels) = color;
+                    pixels.copy_to(lanes.data(), ::simd::element_aligned);
+                    std::memcpy(row, lanes.data(), Lanes * 4);
+                    row += run.rowBytes;
+                }
+            }
+        }
+        return blocks * Lanes;
+    }
+} // namespace
+#endif
+
 void SixelImageBuilder::renderRun(std::string_view sixels)
 {
     // Without an explicit raster the image grows as it is painted, so the canvas a column may write
@@ -559,8 +667,25 @@ void SixelImageBuilder::renderRun(std::string_view sixels)
     // reserve() render() calls here can only ever early-return.
     auto* const base = _buffer.data();
     auto const band = bandRows();
-
-    for (auto const ch: sixels.substr(0, run))
+    auto const columns = sixels.substr(0, run);
+    auto painted = size_t { 0 };
+
+#ifdef VTBACKEND_SIMD_FOUND
+    painted = paintRunSimd(columns,
+                           SimdRun {
+                               .firstPixel = base + (static_cast<size_t>(x) * 4),
+                               .rowBytes = rowBytes,
+                               .aspectRatio = _aspectRatio,
+                               .color = std::bit_cast<uint32_t>(
+                                   std::array<uint8_t, 4> { color.red, color.green, color.blue, 0xFF }),
+                               .fittingBits = band.fittingBits,
+                               .rowOffsets = band.rowOffsets,
+                           });
+    x += static_cast<unsigned>(painted);
+#endif
+
+    // The scalar path: the whole run without SIMD, otherwise the tail shorter than one vector.
+    for (auto const ch: columns.substr(painted))
     {
         auto const bits = static_cast<unsigned>(static_cast<int>(ch) - 63) & SixelBitMask & band.fittingBits;
         for (auto remaining = bits; remaining != 0; remaining &= remaining - 1)
@@ -269,6 +269,19 @@ class SixelParser: public ParserExtension
     /// @param digits the run's raw bytes, each in '0'..'9'.
     void foldDigits(std::string_view digits);
 
+    /// Consumes a complete `'!' digits sixel` repeat starting at @p input in one step.
+    ///
+    /// Exactly what the table does for those bytes from Ground -- enter RepeatIntroducer, fold the
+    /// count, paint on the closing sixel -- minus the three dispatches. Repeats are the second most
+    /// common construct after plain pixel runs: encoders emit one colour plane per pass, so blank
+    /// '!<n>?' skips are everywhere.
+    /// @param input points at the '!'.
+    /// @param end one past the last available byte.
+    /// @return one past the closing sixel, or @p input unchanged if the repeat is not complete within
+    ///         [@p input, @p end) -- split across fragments, or aborted by an introducer -- in which
+    ///         case the table must handle it.
+    [[nodiscard]] iterator passRepeat(iterator input, iterator end);
+
     /// Hands the gathered raster attributes to the sink, if they form a well-shaped set.
     void submitRaster();
 
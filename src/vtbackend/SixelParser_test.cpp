@@ -8,6 +8,7 @@
 
 #include <array>
 #include <format>
+#include <random>
 #include <ranges>
 #include <string_view>
 #include <tuple>
@@ -1157,3 +1158,117 @@ TEST_CASE("SixelParser.rep_matches_unrolled", "[sixel]")
         }
     }
 }
+
+namespace
+{
+
+/// The reference decoder: every batched sink entry point is routed back to the per-column render().
+///
+/// Fed byte by byte through parse(), this is the table-driven parser painting one sixel at a time --
+/// no run detection, no repeat fast path, no band fill, no SIMD. Whatever the production path does in
+/// bulk has to land on exactly the pixels this one paints.
+class ReferenceSixelImageBuilder: public SixelImageBuilder
+{
+  public:
+    using SixelImageBuilder::SixelImageBuilder;
+
+    void renderRepeated(int8_t sixel, unsigned count) override
+    {
+        // Capped like the builder's own: the count is random here and may be large.
+        auto const width = unbox<unsigned>(canvasSize().width);
+        for ([[maybe_unused]] auto const repetition: std::views::iota(0u, std::min(count, width + 1)))
+            render(sixel);
+    }
+
+    void renderRun(std::string_view sixels) override { SixelParser::Events::renderRun(sixels); }
+};
+
+/// Generates a random but well-formed-ish sixel stream: pixel runs, repeats, colour definitions and
+/// selections, rewinds and newlines, and now and then a stray or truncated introducer.
+std::string randomSixelStream(std::mt19937& rng)
+{
+    auto const pick = [&](unsigned n) {
+        return static_cast<unsigned>(rng() % n);
+    };
+    auto const sixel = [&]() {
+        // Blank columns dominate real streams, so bias towards '?'.
+        return static_cast<char>(pick(3) == 0 ? '?' : 63 + pick(64));
+    };
+
+    auto out = std::string {};
+    for ([[maybe_unused]] auto const token: std::views::iota(0u, 20 + pick(60)))
+    {
+        switch (pick(8))
+        {
+            case 0:
+            case 1:
+            case 2:
+                for ([[maybe_unused]] auto const i: std::views::iota(0u, 1 + pick(40)))
+                    out += sixel();
+                break;
+            case 3: out += std::format("!{}{}", pick(80), sixel()); break;
+            case 4: out += std::format("#{};2;{};{};{}", pick(8), pick(101), pick(101), pick(101)); break;
+            case 5: out += std::format("#{}", pick(8)); break;
+            case 6: out += pick(2) == 0 ? '$' : '-'; break;
+            default:
+                // Truncated or aborted introducers: the table takes over where the fast paths stop.
+                out += std::array { "!", "!3", "!12#", "#", "#3;", "\"1;1" }[pick(6)];
+                break;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("SixelParser.randomized_streams_match_reference", "[sixel]")
+{
+    // The bulk paths -- renderRun()'s SIMD band fill, the repeat fast path in pass(), the digit fold
+    // -- each carry an equivalence test of their own, built from hand-picked streams. This one throws
+    // random streams at the whole decoder instead, split into random fragments so every fast path
+    // also meets its input cut short, and compares against the table-driven reference byte for byte.
+    auto const seed = GENERATE(range(1u, 201u));
+    CAPTURE(seed);
+    auto rng = std::mt19937 { seed };
+
+    // Widths on either side of a vector, heights both a multiple of the band and not, and both aspect
+    // ratios: the clipping and the stretching are where a bulk path could disagree.
+    auto const rasterWidth = 1 + (rng() % 70);
+    auto const rasterHeight = 1 + (rng() % 30);
+    auto const raster = std::format("\"{};1;{};{}", 1 + (rng() % 3), rasterWidth, rasterHeight);
+    auto const explicitRaster = rng() % 4 != 0;
+    auto const input = (explicitRaster ? raster : std::string {}) + randomSixelStream(rng);
+    CAPTURE(input);
+
+    auto const palette = [] {
+        return std::make_shared<SixelColorPalette>(16, 256);
+    };
+    auto const background = RGBAColor { 0x10, 0x20, 0x30, 0xFF };
+    auto const maxSize = ImageSize { Width(80), Height(48) };
+
+    auto reference = ReferenceSixelImageBuilder(maxSize, 1, 1, background, palette());
+    {
+        auto sp = SixelParser { reference };
+        for (auto const ch: input)
+            sp.parse(ch);
+        sp.done();
+    }
+
+    auto fast = SixelImageBuilder(maxSize, 1, 1, background, palette());
+    {
+        auto sp = SixelParser { fast };
+        auto rest = std::string_view { input };
+        while (!rest.empty())
+        {
+            auto const cut = std::min(rest.size(), size_t { 1 } + (rng() % 48));
+            sp.parseFragment(rest.substr(0, cut));
+            rest.remove_prefix(cut);
+        }
+        sp.done();
+    }
+
+    CHECK(fast.size() == reference.size());
+    CHECK(fast.sixelCursor() == reference.sixelCursor());
+    CHECK(fast.aspectRatio() == reference.aspectRatio());
+    CHECK(fast.data() == reference.data());
+}
@@ -51,7 +51,7 @@ namespace
         if (!skipFills)
         {
             std::fill_n(line.widths.data() + startCol, count, uint8_t { 1 });
-            std::fill_n(line.sgr.data() + startCol, count, attrs);
+            line.sgr.fill(startCol, count, attrs);
             std::fill_n(line.hyperlinks.data() + startCol, count, hyperlink);
 
             // Ordinary text carries no sizing. Every per-cell write path resets these two; leaving
@@ -50,7 +50,7 @@ inline void writeCellToSoA(LineSoA& line,
                            char32_t codepoint,
                            uint8_t width,
                            GraphicsAttributes const& attrs,
-                           HyperlinkId hyperlink = {}) noexcept
+                           HyperlinkId hyperlink = {})
 {
     assert(col < line.codepoints.size());
     auto const oldClusterSize = line.clusterSize[col];
@@ -58,7 +58,7 @@ inline void writeCellToSoA(LineSoA& line,
     line.widths[col] = width;
     line.scales[col] = 1;
     line.textScaleExtras[col] = 0;
-    line.sgr[col] = attrs;
+    line.sgr.set(col, attrs);
     line.hyperlinks[col] = hyperlink;
     line.clusterSize[col] = (codepoint != 0) ? uint8_t { 1 } : uint8_t { 0 };
 
@@ -75,7 +75,8 @@ inline void writeCellToSoA(LineSoA& line,
     {
         auto const checkCol = (col > 0) ? size_t(0) : size_t(1);
         if (checkCol < line.codepoints.size()
-            && (line.sgr[col] != line.sgr[checkCol] || line.hyperlinks[col] != line.hyperlinks[checkCol]))
+            && (line.sgr.indexAt(col) != line.sgr.indexAt(checkCol)
+                || line.hyperlinks[col] != line.hyperlinks[checkCol]))
         {
             line.trivial = false;
         }
@@ -87,7 +88,7 @@ inline void fillWideCharContinuation(LineSoA& line,
                                      size_t col,
                                      size_t count,
                                      GraphicsAttributes const& attrs,
-                                     HyperlinkId hyperlink = {}) noexcept
+                                     HyperlinkId hyperlink = {})
 {
     auto const contAttrs = GraphicsAttributes { .foregroundColor = attrs.foregroundColor,
                                                 .backgroundColor = attrs.backgroundColor,
@@ -100,7 +101,7 @@ inline void fillWideCharContinuation(LineSoA& line,
         line.scales[col + i] = 1;
         line.textScaleExtras[col + i] = 0;
         line.clusterSize[col + i] = 0;
-        line.sgr[col + i] = contAttrs;
+        line.sgr.set(col + i, contAttrs);
         line.hyperlinks[col + i] = hyperlink;
     }
 
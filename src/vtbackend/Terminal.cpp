@@ -18,6 +18,7 @@
 #include <crispy/Base64.hpp>
 #include <crispy/Environment.hpp>
 #include <crispy/Escape.hpp>
+#include <crispy/TraceEvents.hpp>
 #include <crispy/Utils.hpp>
 
 #include <libunicode/convert.h>
@@ -164,10 +165,12 @@ namespace // {{{ helpers
 
 Terminal::Terminal(Events& eventListener,
                    crispy::Environment const& env,
+                   crispy::trace::Recorder* traceRecorder,
                    std::unique_ptr<vtpty::Pty> pty,
                    Settings factorySettings,
                    chrono::steady_clock::time_point now):
     _eventListener { eventListener },
+    _traceRecorder { traceRecorder },
     _homeDirectory { env.get("HOME").value_or("") },
     // Read here rather than per reply: what it names is how this terminal was launched, and a
     // configuration value re-read on every DA/DSR/CPR is a lookup on a path that answers thousands
@@ -321,6 +324,8 @@ std::optional<Terminal::PtyReadResult> Terminal::readFromPty()
 #else
         std::optional<std::chrono::milliseconds> { std::nullopt };
 #endif
+    // Poll rather than block while resized history still waits to be rewrapped between reads.
+    auto const pollTimeout = _historyReflowPending ? std::optional { std::chrono::milliseconds(0) } : timeout;
 
     // Request a new Buffer Object if the current one cannot sufficiently
     // store a single text line.
@@ -337,7 +342,7 @@ std::optional<Terminal::PtyReadResult> Terminal::readFromPty()
     // or after the read operation.
     auto const bufferUsedForReading = _currentPtyBuffer;
 
-    auto result = _pty->read(*bufferUsedForReading, timeout, _ptyReadBufferSize);
+    auto result = _pty->read(*bufferUsedForReading, pollTimeout, _ptyReadBufferSize);
     if (!result)
         return std::nullopt;
 
@@ -363,7 +368,7 @@ bool Terminal::processInputOnce()
         case ExecutionMode::Normal:
             if (!_traceHandler.pendingSequences().empty())
             {
-                auto const _ = std::lock_guard { *this };
+                auto const _ = SiteLock { *this, LockSite::Parse };
                 _traceHandler.flushAllPending();
                 return true;
             }
@@ -377,7 +382,7 @@ bool Terminal::processInputOnce()
         case ExecutionMode::SingleStep:
             if (!_traceHandler.pendingSequences().empty())
             {
-                auto const _ = std::lock_guard { *this };
+                auto const _ = SiteLock { *this, LockSite::Parse };
                 _executionMode = ExecutionMode::Waiting;
                 _traceHandler.flushOne();
                 return true;
@@ -386,14 +391,19 @@ bool Terminal::processInputOnce()
     }
     // clang-format on
 
+    if (_historyReflowPending)
+        continueHistoryReflow();
+
     auto const ptyReadResult = readFromPty();
 
     if (!ptyReadResult)
     {
-        terminalLog()("PTY read failed. {}", std::generic_category().message(errno));
+        // An interrupted read, or one with nothing to read yet, is no failure: the latter is what
+        // every poll between reflow slices ends in.
         if (errno == EINTR || errno == EAGAIN)
             return true;
 
+        terminalLog()("PTY read failed. {}", std::generic_category().message(errno));
         _pty->close();
         return false;
     }
@@ -408,9 +418,14 @@ bool Terminal::processInputOnce()
         return false;
     }
 
+    // Opened once the read has returned data: around the read itself, the event would time how long
+    // the application was quiet rather than anything the terminal did.
+    auto batchScope = crispy::trace::Scope { _traceRecorder, "pty", "batch" };
+    batchScope.setArgument("bytes", static_cast<int64_t>(buf.size()));
+
     auto batchedRendering = false;
     {
-        auto const _ = std::lock_guard { *this };
+        auto const _ = SiteLock { *this, LockSite::Parse };
         // Use the buffer that readFromPty() actually read into, not _currentPtyBuffer
         // which might have been changed by another thread (e.g., writeToScreen()).
         // This is critical to ensure BufferFragment in TrivialLineBuffer holds
@@ -418,9 +433,12 @@ bool Terminal::processInputOnce()
         _parsingBuffer = ptyReadResult->buffer;
         {
             auto const parseGuard = ParseDepthGuard {};
+            auto scope = crispy::trace::Scope { _traceRecorder, "vt", "parseFragment" };
+            scope.setArgument("bytes", static_cast<int64_t>(buf.size()));
             _parser.parseFragment(buf);
         }
         _parsingBuffer = nullptr;
+        _latencyProbe.mark(LatencyStage::EchoParsed);
 
         // Process any macros that were queued by DECINVM during the parse.
         processPendingMacros();
@@ -444,6 +462,22 @@ bool Terminal::processInputOnce()
     return true;
 }
 
+void Terminal::continueHistoryReflow()
+{
+    auto pending = false;
+    {
+        auto const _ = SiteLock { *this, LockSite::Reflow };
+        for (auto& page: _pages)
+            if (page->grid().historyReflowPending())
+                pending = page->grid().reflowPendingHistory(HistoryReflowSliceLineCount) || pending;
+        _historyReflowPending = pending;
+    }
+
+    // Finishing a slice does not show anything new, but splicing the last one in does.
+    if (!pending)
+        screenUpdated();
+}
+
 // {{{ RenderBuffer synchronization
 void Terminal::breakLoopAndRefreshRenderBuffer()
 {
@@ -483,6 +517,7 @@ bool Terminal::ensureFreshRenderBuffer(bool locked)
             _renderBuffer.state = RenderBufferState::RefreshBuffersAndTrySwap;
             [[fallthrough]];
         case RenderBufferState::RefreshBuffersAndTrySwap: {
+            auto const scope = crispy::trace::Scope { _traceRecorder, "vt", "refreshRenderBuffer" };
             auto& backBuffer = _renderBuffer.backBuffer();
             auto const lastCursorPos = backBuffer.cursor;
             if (!locked)
@@ -501,6 +536,8 @@ bool Terminal::ensureFreshRenderBuffer(bool locked)
         }
         case RenderBufferState::TrySwapBuffers: {
             [[maybe_unused]] auto const success = _renderBuffer.swapBuffers(_currentTime);
+            if (success)
+                _latencyProbe.mark(LatencyStage::RenderBufferSwap);
 
 #ifdef CONTOUR_PERF_STATS
             logRenderBufferSwap(success, _lastFrameID);
@@ -579,7 +616,7 @@ void Terminal::updateInputMethodPreeditString(std::string preeditString)
 
 void Terminal::fillRenderBuffer(RenderBuffer& output, bool includeSelection)
 {
-    auto const _ = std::lock_guard { *this };
+    auto const _ = SiteLock { *this, LockSite::Render };
     fillRenderBufferInternal(output, includeSelection);
 }
 
@@ -1133,9 +1170,32 @@ void Terminal::updateSelectionMatches()
     if (!_settings.visualizeSelectedWord)
         return;
 
-    auto const text = extractSelectionText();
-    auto const text32 = unicode::convert_to<char32_t>(string_view(text.data(), text.size()));
-    setNewSearchTerm(text32, true);
+    // Only a selected WORD is highlighted elsewhere, so decide from the selection's extent, before
+    // extracting anything, whether it can still be one. This runs on every mouse move of a drag, and
+    // serializing the whole selection each time made a drag over a few thousand lines lag visibly.
+    // A word may wrap onto the next line, but it never holds more cells than one line has.
+    // NB: Copies, not references into std::minmax -- from()/to() return temporaries.
+    auto const fromPos = _selection->from();
+    auto const toPos = _selection->to();
+    auto const [first, last] = std::minmax(fromPos, toPos);
+    auto const cells = (unbox<long>(last.line) - unbox<long>(first.line)) * unbox<long>(pageSize().columns)
+                       + unbox<long>(last.column) - unbox<long>(first.column) + 1;
+    auto text32 = u32string {};
+    if (cells <= unbox<long>(pageSize().columns))
+    {
+        auto const text = extractSelectionText();
+        text32 = unicode::convert_to<char32_t>(string_view(text.data(), text.size()));
+    }
+
+    auto const isWord = !text32.empty() && std::ranges::none_of(text32, [](char32_t ch) {
+        return ch == U' ' || ch == U'\t' || ch == U'\n';
+    });
+    if (isWord)
+        setNewSearchTerm(std::move(text32), true);
+    else if (_search.initiatedByDoubleClick)
+        // The selection grew past the word it started as: its highlight goes, and with an empty pattern
+        // the trivial-line render fast path comes back. A pattern the user searched for is left alone.
+        clearSearch();
 }
 
 void Terminal::setStatusLineDefinition(StatusLineDefinition&& definition)
@@ -1475,19 +1535,19 @@ bool Terminal::sendFocusOutEvent()
     return false;
 }
 
-void Terminal::sendPaste(string_view text)
+void Terminal::sendPaste(std::string text)
 {
     if (!allowInput())
         return;
 
     if (_inputHandler.isEditingSearch())
     {
-        _search.pattern += unicode::convert_to<char32_t>(text);
+        _search.pattern += unicode::convert_to<char32_t>(string_view(text));
         screenUpdated();
         return;
     }
 
-    _inputGenerator.generatePaste(text);
+    _inputGenerator.generatePaste(std::move(text));
     flushInput();
 }
 
@@ -1509,6 +1569,15 @@ void Terminal::sendRawInput(string_view text)
     flushInput();
 }
 
+void Terminal::cancelPaste()
+{
+    if (!_inputGenerator.pasteInProgress())
+        return;
+
+    _inputGenerator.cancelPaste();
+    flushInput();
+}
+
 bool Terminal::hasInput() const noexcept
 {
     return !_inputGenerator.peek().empty();
@@ -1516,8 +1585,22 @@ bool Terminal::hasInput() const noexcept
 
 void Terminal::flushInput()
 {
-    if (_inputGenerator.peek().empty())
+    if (_settings.ptyInputWrite == PtyInputWrite::NonBlocking)
+    {
+        (void) writePendingInput();
         return;
+    }
+
+    // A blocking write delivers all it is given, but a paste is pending only a chunk at a time: keep
+    // going until it is through, as the single write of the whole paste this replaced did.
+    while (writePendingInput())
+        ;
+}
+
+bool Terminal::writePendingInput()
+{
+    if (_inputGenerator.peek().empty())
+        return false;
 
     // Own the bytes before anything is allowed to touch the generator again: peek() returns a view into
     // InputGenerator::_pendingSequence, and both steps below invalidate it. consume() may clear that
@@ -1526,7 +1609,12 @@ void Terminal::flushInput()
     auto const input = std::string(_inputGenerator.peek());
 
     // XXX Should be the only location that does write to the PTY's stdin to avoid race conditions.
-    auto const rv = _pty->write(input);
+    //
+    // In NonBlocking mode a full PTY buffer is a short count (or EAGAIN), and the rest stays pending for
+    // the caller's deferred retry. With a large paste streaming through here, a blocking write would
+    // freeze the GUI thread until the application had read megabytes of it.
+    auto const rv = _settings.ptyInputWrite == PtyInputWrite::NonBlocking ? _pty->writeSome(input)
+                                                                          : _pty->write(input);
     if (rv <= 0)
     {
         // EAGAIN/EINTR is backpressure: keep the bytes pending so the caller's deferred retry sends
@@ -1535,11 +1623,15 @@ void Terminal::flushInput()
         // self-repost into an unbounded loop that logs one error per iteration. That is the
         // "Failed to write to SSH channel" flood a broken SSH session used to produce.
         if (rv < 0 && errno != EAGAIN && errno != EINTR)
+        {
+            _inputGenerator.cancelPaste();
             _inputGenerator.consume(static_cast<int>(input.size()));
-        return;
+        }
+        return false;
     }
 
     _inputGenerator.consume(rv);
+    _latencyProbe.mark(LatencyStage::PtyWrite);
 
     // SRM, reset: the terminal echoes everything it sends. This is the "local echo" a host that does not
     // echo for itself relies on, and it is off by default -- SRM is set, and the host echoes.
@@ -1552,6 +1644,7 @@ void Terminal::flushInput()
     // whose flush would re-send anything still pending here.
     if (!isModeEnabled(AnsiMode::SendReceive))
         echoLocally(std::string_view(input).substr(0, static_cast<size_t>(rv)));
+    return true;
 }
 
 void Terminal::echoLocally(std::string_view bytes)
@@ -1604,7 +1697,7 @@ void Terminal::writeToScreen(string_view vtStream)
 {
     auto batchedRendering = false;
     {
-        auto const l = std::lock_guard { *this };
+        auto const l = SiteLock { *this, LockSite::Parse };
         parseFragmentChunked(vtStream);
 
         // Any local echo the parse deferred (a sequence that replied) is safe to parse now.
@@ -1672,6 +1765,8 @@ namespace
             targetScreen.processSequence(seq);
         }
 
+        void processSGR(Sequence const& seq) { targetScreen.processSGR(seq); }
+
         void processAPC(std::string_view body) { targetScreen.processAPC(body); }
 
         void writeText(char32_t codepoint) { targetScreen.writeText(codepoint); }
@@ -2365,7 +2460,7 @@ void Terminal::selectAll()
     onSelectionUpdated();
 }
 
-std::optional<CommandBlockText> Terminal::lastCommandBlock() const
+std::optional<CommandBlockText> Terminal::lastCommandBlock()
 {
     return primaryScreen().lastCommandBlock();
 }
@@ -2380,7 +2475,7 @@ std::expected<LivePromptSpan, PromptRegionError> Terminal::livePromptSpan() cons
     return primaryScreen().livePromptSpan();
 }
 
-string Terminal::extractLastMarkRange() const
+string Terminal::extractLastMarkRange()
 {
     // -1 because we always want to start extracting one line above the cursor by default.
     // The cursor is read from the PRIMARY screen, which is also the grid the lines are read from below: an
@@ -3134,13 +3229,13 @@ void Terminal::setProgress(Progress progress)
 
 Progress Terminal::resolvedProgress() const
 {
-    auto const l = std::lock_guard { _stateMutex };
+    auto const l = SiteLock { *this, LockSite::StatusLine };
     return _progress;
 }
 
 std::string Terminal::resolvedWindowTitle() const
 {
-    auto const l = std::lock_guard { _stateMutex };
+    auto const l = SiteLock { *this, LockSite::StatusLine };
     return _windowTitle;
 }
 
@@ -3188,7 +3283,7 @@ std::optional<std::string> Terminal::resolvedTabName() const
     // under _stateMutex (setTabName()/setWindowTitle()), and this runs on the GUI thread, so reading them
     // unlocked (or across three separate locked accessor calls) would race the writer. getTabsNamingMode()
     // reads _settings, which is not mutated by the parser thread, so it needs no extra protection.
-    auto const l = std::lock_guard { _stateMutex };
+    auto const l = SiteLock { *this, LockSite::StatusLine };
     if (_tabName)
         return _tabName;
     if (_settings.tabNamingMode == TabsNamingMode::Title)
@@ -3932,6 +4027,11 @@ void Terminal::applyPageSizeToMainDisplay(ScreenType screenType)
             pageAt(_cursorPage).applyPageSizeToMainDisplay(mainDisplayPageSize);
             break;
     }
+    if (pageAt(_cursorPage).grid().historyReflowPending())
+    {
+        _historyReflowPending = true;
+        _pty->wakeupReader();
+    }
 
     (void) _hostWritableStatusLineScreen.grid().resize(PageSize { LineCount(1), _settings.pageSize.columns }, CellLocation {}, false);
     (void) _indicatorStatusScreen.grid().resize(PageSize { LineCount(1), _settings.pageSize.columns }, CellLocation {}, false);
@@ -10,6 +10,8 @@
 #include <vtbackend/Hyperlink.hpp>
 #include <vtbackend/InputGenerator.hpp>
 #include <vtbackend/InputHandler.hpp>
+#include <vtbackend/LatencyProbe.hpp>
+#include <vtbackend/LockStats.hpp>
 #include <vtbackend/Logging.hpp>
 #include <vtbackend/PointerShape.hpp>
 #include <vtbackend/Primitives.hpp>
@@ -34,6 +36,7 @@
 #include <crispy/BufferObject.hpp>
 #include <crispy/Defines.hpp>
 #include <crispy/Environment.hpp>
+#include <crispy/TraceEvents.hpp>
 
 #include <gsl/pointers>
 
@@ -409,11 +412,14 @@ class Terminal
     /// @param env             The process environment. Read here and only here: what this terminal
     ///                        takes from it (`$HOME`, `$CONTOUR_SYNC_PTY_OUTPUT`) describes how the
     ///                        session was launched, so it is resolved once, at construction.
+    /// @param traceRecorder   Where the handling of each PTY read, its parse and the render-buffer
+    ///                        refresh are traced, or nullptr to trace nothing. Must outlive the terminal.
     /// @param pty             The pseudo-terminal this drives.
     /// @param factorySettings The settings a hard reset (RIS) restores.
     /// @param now             The current time, as the caller's clock reads it.
     Terminal(Events& eventListener,
              crispy::Environment const& env,
+             crispy::trace::Recorder* traceRecorder,
              std::unique_ptr<vtpty::Pty> pty,
              Settings factorySettings,
              std::chrono::steady_clock::time_point now /* = std::chrono::steady_clock::now()*/);
@@ -868,7 +874,7 @@ class Terminal
                                   bool uiHandledHint);
     bool sendFocusInEvent();
     bool sendFocusOutEvent();
-    void sendPaste(std::string_view text); // Sends verbatim text in bracketed mode to application.
+    void sendPaste(std::string text); // Sends verbatim text in bracketed mode to application.
     void sendPasteFromClipboard(unsigned count, bool strip)
     {
         _eventListener.pasteFromClipboard(count, strip);
@@ -889,14 +895,33 @@ class Terminal
     bool applicationKeypad() const noexcept { return _inputGenerator.applicationKeypad(); }
 
     bool hasInput() const noexcept;
+
+    /// Writes pending input to the PTY, as Settings::ptyInputWrite says: all of it, or as much as the
+    /// PTY accepts right away.
     void flushInput();
 
+    /// @return whether a paste is still being streamed to the application.
+    [[nodiscard]] bool pasteInProgress() const noexcept { return _inputGenerator.pasteInProgress(); }
+
+    /// @return the number of input bytes not yet written to the PTY, including the rest of a paste.
+    [[nodiscard]] size_t pendingInputSize() const noexcept
+    {
+        return _inputGenerator.peek().size() + _inputGenerator.pendingPasteBytes();
+    }
+
+    /// Abandons the paste being streamed to the application. @see InputGenerator::cancelPaste()
+    void cancelPaste();
+
     std::string_view peekInput() const noexcept { return _inputGenerator.peek(); }
     // }}}
 
     /// Writes a given VT-sequence to screen.
     void writeToScreen(std::string_view vtStream);
 
+    /// Writes the pending input the generator hands out to the PTY, once.
+    /// @return whether any of it was written.
+    [[nodiscard]] bool writePendingInput();
+
     /// Echoes @p bytes onto our own screen, as SRM (reset) asks for.
     ///
     /// The bytes cannot always be parsed on the spot: flushInput() is also reached from *inside* the
@@ -1060,9 +1085,55 @@ class Terminal
     void updateInputMethodPreeditString(std::string preeditString);
     // }}}
 
-    void lock() const { _stateMutex.lock(); }
+    /// std::lock_guard for the state lock, attributing the wait and the hold to @p site when lock
+    /// statistics are compiled in.
+    ///
+    /// The terminal is deliberately not BasicLockable: a caller that could lock it without naming
+    /// itself would land in a catch-all, and a stutter traced there is not actionable.
+    class [[nodiscard]] SiteLock
+    {
+      public:
+        SiteLock(Terminal const& terminal, LockSite site): _terminal { terminal } { _terminal.lock(site); }
+        ~SiteLock() { _terminal.unlock(); }
+
+        SiteLock(SiteLock const&) = delete;
+        SiteLock& operator=(SiteLock const&) = delete;
+        SiteLock(SiteLock&&) = delete;
+        SiteLock& operator=(SiteLock&&) = delete;
+
+      private:
+        Terminal const& _terminal;
+    };
+
+    /// Takes the state lock on behalf of @p site. Prefer SiteLock or locked(), which release it.
+    void lock([[maybe_unused]] LockSite site) const
+    {
+#if defined(CONTOUR_PERF_STATS)
+        _stateMutex.lock(site);
+#else
+        _stateMutex.lock();
+#endif
+    }
     void unlock() const { _stateMutex.unlock(); }
 
+    /// @return @p f's result, computed under the state lock taken on behalf of @p site.
+    template <typename F>
+    auto locked(LockSite site, F const& f) const
+    {
+        auto const _ = SiteLock { *this, site };
+        return f();
+    }
+
+#if defined(CONTOUR_PERF_STATS)
+    /// Wait and hold times of the state lock, per LockSite. Only tracked in CONTOUR_PERF_STATS
+    /// builds; everywhere else the lock is a plain std::mutex and costs nothing extra.
+    [[nodiscard]] LockStats& lockStats() const noexcept { return _stateMutex.stats(); }
+#endif
+
+    /// Keypress-to-present latency of this terminal's keystrokes; off until enabled.
+    [[nodiscard]] LatencyProbe& latencyProbe() noexcept { return _latencyProbe; }
+    [[nodiscard]] LatencyProbe const& latencyProbe() const noexcept { return _latencyProbe; }
+
     [[nodiscard]] ColorPalette const& colorPalette() const noexcept { return _colorPalette; }
     [[nodiscard]] ColorPalette& colorPalette() noexcept { return _colorPalette; }
     [[nodiscard]] ColorPalette& defaultColorPalette() noexcept { return _defaultColorPalette; }
@@ -1235,7 +1306,7 @@ class Terminal
     /// write would race the shared_ptr control block.
     void setReGISTextRasterizer(std::shared_ptr<regis::ReGISTextRasterizer> const& rasterizer)
     {
-        auto const guard = std::lock_guard { *this };
+        auto const guard = SiteLock { *this, LockSite::Configure };
         for (auto& page: _pages)
             page->setReGISTextRasterizer(rasterizer);
     }
@@ -1413,7 +1484,7 @@ class Terminal
     // }}}
 
     [[nodiscard]] std::string extractSelectionText() const;
-    [[nodiscard]] std::string extractLastMarkRange() const;
+    [[nodiscard]] std::string extractLastMarkRange();
 
     /// The most recently finished shell command, reconstructed from the OSC 133 marks its shell left.
     ///
@@ -1421,7 +1492,7 @@ class Terminal
     /// keeps answering while an alt-screen app (vim, less) is on top.
     ///
     /// @return The block, or nullopt when the scrollback holds no finished command.
-    [[nodiscard]] std::optional<CommandBlockText> lastCommandBlock() const;
+    [[nodiscard]] std::optional<CommandBlockText> lastCommandBlock();
 
     /// Where the shell's LIVE prompt sits — the one the user is typing at right now.
     ///
@@ -2025,6 +2096,14 @@ class Terminal
     };
     [[nodiscard]] std::optional<PtyReadResult> readFromPty();
 
+    /// How many history lines a resize set aside are rewrapped per pass of the input loop.
+    static constexpr LineCount HistoryReflowSliceLineCount = LineCount(2048);
+
+    /// Rewraps the next slice of any history a reflowing resize set aside (@see Grid::reflowPendingHistory).
+    /// Runs on the input loop between PTY reads, so a resize returns after the page and the history right
+    /// above it, however deep the scrollback is.
+    void continueHistoryReflow();
+
     // Writes partially or all input data to the PTY buffer object and returns a string view to it.
     [[nodiscard]] std::string_view lockedWriteToPtyBuffer(std::string_view data);
 
@@ -2032,6 +2111,7 @@ class Terminal
     //
 
     Events& _eventListener;
+    crispy::trace::Recorder* _traceRecorder; ///< Null when nothing is traced.
 
     /// The user's home directory, for abbreviating and expanding `~` in the paths this terminal
     /// recognizes on screen. Empty when the environment names none.
@@ -2053,8 +2133,14 @@ class Terminal
     /// atomic, written in lockstep with _settings.pageSize, gives the render thread a consistent snapshot.
     std::atomic<PageSize> _atomicTotalPageSize { _settings.pageSize };
 
+    LatencyProbe _latencyProbe { [] { return std::chrono::steady_clock::now(); } };
+
     // synchronization
+#if defined(CONTOUR_PERF_STATS)
+    InstrumentedMutex mutable _stateMutex;
+#else
     std::mutex mutable _stateMutex;
+#endif
 
     // terminal clock
     std::chrono::steady_clock::time_point _currentTime;
@@ -2282,6 +2368,7 @@ class Terminal
     InputMethodData _inputMethodData {};
     std::atomic<HyperlinkId> _hoveringHyperlinkId = HyperlinkId {};
     std::atomic<bool> _renderBufferUpdateEnabled = true; // for "Synchronized Updates" feature
+    std::atomic<bool> _historyReflowPending = false;     // @see continueHistoryReflow()
     std::optional<HighlightRange> _highlightRange = std::nullopt;
     SupportedSequences _supportedVTSequences;
 
@@ -2428,7 +2515,12 @@ class Terminal
         {
             terminal.sequenceHandler().processSequence(sequence);
         }
+        void processSGR(Sequence const& sequence) { terminal.sequenceHandler().processSGR(sequence); }
         void processAPC(std::string_view body) { terminal.sequenceHandler().processAPC(body); }
+        std::unique_ptr<ParserExtension> hookOSC(int code)
+        {
+            return terminal.sequenceHandler().hookOSC(code);
+        }
         void writeText(char32_t codepoint) { terminal.sequenceHandler().writeText(codepoint); }
         void writeText(std::string_view codepoints, size_t cellCount)
         {
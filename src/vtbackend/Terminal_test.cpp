@@ -796,7 +796,7 @@ TEST_CASE("Terminal.clampedTotalPageSize", "[terminal]")
         mc.terminal.setStatusDisplay(StatusDisplayType::Indicator);
         auto const requested = PageSize { LineCount(1), ColumnCount(20) };
         {
-            auto const _ = std::scoped_lock { mc.terminal };
+            auto const _ = vtbackend::Terminal::SiteLock { mc.terminal, vtbackend::LockSite::Configure };
             mc.terminal.resizeScreen(requested, std::nullopt);
         }
         // resizeScreen() clamped the total internally; clampedTotalPageSize() predicts that exact result.
@@ -4711,6 +4711,42 @@ TEST_CASE("Terminal.TextSelection_multiline_drag_still_takes_the_first_line_whol
              "de");
 }
 
+TEST_CASE("Terminal.TextSelection_highlights_only_a_selected_word", "[terminal]")
+{
+    // The drag re-evaluates the highlight on every move, so past one word it must not serialize the
+    // selection at all -- and the highlight of the word it started as must go.
+    auto mock = MockTerm { ColumnCount(20), LineCount(4) };
+    auto constexpr ClockBase = chrono::steady_clock::time_point();
+    mock.terminal.tick(ClockBase);
+    mock.writeToScreen("foo bar foo\r\nbaz");
+
+    using namespace vtbackend;
+    auto constexpr UiHandledHint = false;
+    auto constexpr PixelCoordinate = vtbackend::PixelCoordinate {};
+    auto const dragTo = [&](CellLocation pos) {
+        mock.terminal.tick(1s);
+        mock.terminal.sendMouseMoveEvent(Modifier::None, pos, PixelCoordinate, UiHandledHint);
+    };
+
+    dragTo(0_lineOffset + 0_columnOffset);
+    mock.terminal.tick(1s);
+    (void) mock.terminal.sendMousePressEvent(
+        Modifier::None, MouseButton::Left, PixelCoordinate, UiHandledHint);
+
+    dragTo(0_lineOffset + 2_columnOffset);
+    CHECK(mock.terminal.search().pattern == U"foo");
+
+    dragTo(0_lineOffset + 6_columnOffset);
+    CHECK(mock.terminal.search().pattern.empty());
+
+    dragTo(1_lineOffset + 1_columnOffset);
+    CHECK(mock.terminal.search().pattern.empty());
+
+    // Shrinking back to a word brings its highlight back.
+    dragTo(0_lineOffset + 2_columnOffset);
+    CHECK(mock.terminal.search().pattern == U"foo");
+}
+
 TEST_CASE("Terminal.selection_of_a_trivial_line_survives_a_scrolled_viewport", "[terminal]")
 {
     // The renderer asks two questions about selection at two granularities: isSelected(CellLocation)
@@ -4948,7 +4984,7 @@ TEST_CASE("Terminal.IME queries answered under the state lock survive concurrent
     auto imeReader = std::thread { [&]() {
         while (!stop.load(std::memory_order_relaxed))
         {
-            auto const lock = std::lock_guard { terminal };
+            auto const lock = vtbackend::Terminal::SiteLock { terminal, vtbackend::LockSite::Query };
             if (!terminal.isCursorInViewport())
                 continue;
             auto const cursor = terminal.currentScreen().cursor().position;
@@ -4971,7 +5007,7 @@ TEST_CASE("Terminal.IME queries answered under the state lock survive concurrent
         if (round % 25 == 24)
         {
             auto const usable = usableSizes[static_cast<size_t>((round / 25) % 2)];
-            auto const lock = std::lock_guard { terminal };
+            auto const lock = vtbackend::Terminal::SiteLock { terminal, vtbackend::LockSite::Query };
             terminal.resizeScreen(
                 PageSize { .lines = usable.lines + terminal.statusLineHeight(), .columns = usable.columns });
         }
@@ -4982,7 +5018,7 @@ TEST_CASE("Terminal.IME queries answered under the state lock survive concurrent
 
     // The same query sequence once more, deterministically: the cursor of a live main page must be
     // addressable, and both grid reads must answer.
-    auto const lock = std::lock_guard { terminal };
+    auto const lock = vtbackend::Terminal::SiteLock { terminal, vtbackend::LockSite::Query };
     INFO(std::format("concurrent reader observed {} line-text bytes and cell widths", observed.load()));
     REQUIRE(terminal.isCursorInViewport());
     auto const cursor = terminal.currentScreen().cursor().position;
@@ -5478,6 +5514,7 @@ TEST_CASE("Terminal reports the identity its settings named", "[terminal]")
     auto const environment = crispy::testing::FakeEnvironment {};
     auto terminal = vtbackend::Terminal { events,
                                           environment,
+                                          /*traceRecorder=*/nullptr,
                                           std::make_unique<vtpty::MockPty>(pageSize),
                                           settings,
                                           std::chrono::steady_clock::now() };
@@ -5512,6 +5549,7 @@ TEST_CASE("a terminal constructed below VT525 narrows its sequence table too", "
         settings.terminalId = id;
         return vtbackend::Terminal { events,
                                      environment,
+                                     /*traceRecorder=*/nullptr,
                                      std::make_unique<vtpty::MockPty>(pageSize),
                                      settings,
                                      std::chrono::steady_clock::time_point() };
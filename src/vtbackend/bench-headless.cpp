@@ -1,11 +1,15 @@
 // SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/BenchWorkloads.hpp>
+#include <vtbackend/LockStats.hpp>
 #include <vtbackend/Logging.hpp>
 #include <vtbackend/MockTerm.hpp>
+#include <vtbackend/PtyRecording.hpp>
 #include <vtbackend/Terminal.hpp>
 
 #include <vtparser/ParserEvents.hpp>
 
 #include <vtpty/MockViewPty.hpp>
+#include <vtpty/Process.hpp>
 
 #include <crispy/App.hpp>
 #include <crispy/BufferObject.hpp>
@@ -13,14 +17,27 @@
 #include <crispy/Environment.hpp>
 #include <crispy/Utils.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <chrono>
+#include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <poll.h>
+    #include <sys/ioctl.h>
+    #include <termios.h>
+    #include <unistd.h>
+#endif
 
 #include <libtermbench/termbench.h>
 
@@ -46,6 +63,10 @@ std::string createText(size_t bytes)
     return text;
 }
 
+/// The page every synthetic stream is written for.
+constexpr auto BenchPageSize = vtbackend::PageSize { .lines = vtbackend::LineCount(24),
+                                                     .columns = vtbackend::ColumnCount(80) };
+
 struct BenchOptions
 {
     unsigned testSizeMB = 64;
@@ -53,14 +74,77 @@ struct BenchOptions
     bool longLines = false;
     bool sgr = false;
     bool binary = false;
+    std::vector<std::string_view> workloads; ///< Names of the vtbackend::BenchWorkload to run.
 };
 
+/// Feeds each selected vtbackend::BenchWorkload through @p writer until @p options.testSizeMB went
+/// through, then reports MB/s and cells/s per workload.
+///
+/// Cells/s is what tells the paths apart: a CJK line or a hyperlink costs many bytes per cell, so
+/// MB/s alone would flatter them.
+template <typename Writer>
+void runWorkloads(Writer& writer, BenchOptions const& options)
+{
+    auto constexpr ChunkSize = size_t { 64 } * 1024;
+    auto constexpr ChunkVariants = 16;
+
+    struct Result
+    {
+        std::string_view name;
+        uint64_t bytes = 0;
+        uint64_t cells = 0;
+        double seconds = 0;
+    };
+    auto results = std::vector<Result> {};
+
+    // A fixed seed: every run, and every build being compared, sees the same stream.
+    auto rng = std::mt19937 { 0x636f6e74 };
+    for (auto const& workload: vtbackend::benchWorkloads())
+    {
+        if (std::ranges::find(options.workloads, workload.name) == options.workloads.end())
+            continue;
+
+        cout << std::format("Running test {} ...\n", workload.name);
+        auto chunks = std::vector<vtbackend::BenchChunk> {};
+        for ([[maybe_unused]] auto const i: crispy::times(ChunkVariants))
+            chunks.emplace_back(workload.generate(BenchPageSize, ChunkSize, rng));
+
+        auto const totalBytes = uint64_t { options.testSizeMB } * 1024 * 1024;
+        auto result = Result { .name = workload.name };
+        auto const start = std::chrono::steady_clock::now();
+        // Cleared once the writer refuses a chunk; nothing after it would be measured.
+        auto writable = true;
+        while (writable && result.bytes < totalBytes)
+        {
+            for (auto const& chunk: chunks)
+            {
+                writable = writer(chunk.bytes.data(), chunk.bytes.size());
+                if (!writable)
+                    break;
+                result.bytes += chunk.bytes.size();
+                result.cells += chunk.cells;
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.emplace_back(result);
+    }
+
+    cout << std::format("\n{:<12} {:>10} {:>14}\n", "workload", "MB/s", "Mcells/s");
+    for (auto const& result: results)
+        cout << std::format("{:<12} {:>10.2f} {:>14.2f}\n",
+                            result.name,
+                            static_cast<double>(result.bytes) / result.seconds / (1024.0 * 1024.0),
+                            static_cast<double>(result.cells) / result.seconds / 1'000'000.0);
+    cout << '\n';
+}
+
 } // namespace
 
 template <typename Writer>
 static int baseBenchmark(Writer&& writer, BenchOptions options, string_view title)
 {
-    if (!(options.binary || options.longLines || options.manyLines || options.sgr))
+    auto const termbenchTests = options.binary || options.longLines || options.manyLines || options.sgr;
+    if (!termbenchTests && options.workloads.empty())
     {
         cout << "No test cases specified. Defaulting to: cat, long, sgr.\n";
         options.manyLines = true;
@@ -72,35 +156,43 @@ static int baseBenchmark(Writer&& writer, BenchOptions options, string_view titl
 
     cout << titleText << '\n' << string(titleText.size(), '=') << '\n';
 
-    auto tbp = termbench::Benchmark { std::forward<Writer>(writer),
-                                      options.testSizeMB,
-                                      termbench::TerminalSize { .columns = 80, .lines = 24 },
-                                      [&](termbench::Test const& test) {
-                                          cout << std::format("Running test {} ...\n", test.name);
-                                      } };
+    if (options.binary || options.longLines || options.manyLines || options.sgr)
+    {
+        auto tbp = termbench::Benchmark { writer,
+                                          options.testSizeMB,
+                                          termbench::TerminalSize {
+                                              .columns = unbox<unsigned short>(BenchPageSize.columns),
+                                              .lines = unbox<unsigned short>(BenchPageSize.lines) },
+                                          [&](termbench::Test const& test) {
+                                              cout << std::format("Running test {} ...\n", test.name);
+                                          } };
+
+        if (options.manyLines)
+            tbp.add(termbench::tests::many_lines());
+
+        if (options.longLines)
+            tbp.add(termbench::tests::long_lines());
+
+        if (options.sgr)
+        {
+            tbp.add(termbench::tests::sgr_fg_lines());
+            tbp.add(termbench::tests::sgr_fgbg_lines());
+        }
 
-    if (options.manyLines)
-        tbp.add(termbench::tests::many_lines());
+        if (options.binary)
+            tbp.add(termbench::tests::binary());
 
-    if (options.longLines)
-        tbp.add(termbench::tests::long_lines());
+        tbp.runAll();
 
-    if (options.sgr)
-    {
-        tbp.add(termbench::tests::sgr_fg_lines());
-        tbp.add(termbench::tests::sgr_fgbg_lines());
+        cout << '\n';
+        cout << "Results\n";
+        cout << "-------\n";
+        tbp.summarize(cout);
+        cout << '\n';
     }
 
-    if (options.binary)
-        tbp.add(termbench::tests::binary());
-
-    tbp.runAll();
-
-    cout << '\n';
-    cout << "Results\n";
-    cout << "-------\n";
-    tbp.summarize(cout);
-    cout << '\n';
+    if (!options.workloads.empty())
+        runWorkloads(writer, options);
 
     return EXIT_SUCCESS;
 }
@@ -171,6 +263,255 @@ static int benchSixelStream(std::string const& sixelData,
     return EXIT_SUCCESS;
 }
 
+#if !defined(_WIN32)
+/// @return The page size of the terminal bench-headless runs in, or 80x24 when it is not one.
+static vtbackend::PageSize controllingPageSize()
+{
+    auto ws = winsize {};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col != 0 && ws.ws_row != 0)
+        return vtbackend::PageSize { .lines = vtbackend::LineCount(ws.ws_row),
+                                     .columns = vtbackend::ColumnCount(ws.ws_col) };
+    return vtbackend::PageSize { .lines = vtbackend::LineCount(24), .columns = vtbackend::ColumnCount(80) };
+}
+#endif
+
+/// Runs @p command (the login shell when empty) on a PTY inside the terminal bench-headless runs
+/// in, recording everything it writes to @p path until it exits.
+///
+/// The session is fully interactive: keystrokes are forwarded, output is shown, and resizing the
+/// window resizes the PTY and is recorded as well.
+///
+/// @return EXIT_SUCCESS once the command exited, EXIT_FAILURE if it could not be recorded.
+static int recordPtySession(std::string const& path, std::string const& command)
+{
+#if defined(_WIN32)
+    (void) path;
+    (void) command;
+    cerr << "Recording is not supported on this platform.\n";
+    return EXIT_FAILURE;
+#else
+    auto file = std::ofstream(path, std::ios::binary);
+    if (!file)
+    {
+        cerr << std::format("Cannot write '{}'.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    auto pageSize = controllingPageSize();
+    auto const commandLine = command.empty() ? vtpty::Process::loginShell(/*escapeSandbox=*/false)
+                                             : std::vector<std::string> { "/bin/sh", "-c", command };
+    auto process =
+        vtpty::Process { vtpty::Process::ExecInfo {
+                             .program = commandLine.front(),
+                             .arguments = { std::next(commandLine.begin()), commandLine.end() },
+                             .workingDirectory = std::filesystem::current_path(),
+                             .env = {},
+                         },
+                         vtpty::createPty(pageSize, std::nullopt),
+                         /*escapeSandbox=*/false };
+    if (auto const started = process.start(); !started)
+    {
+        cerr << std::format("Cannot start '{}': {}\n", commandLine.front(), started.error());
+        return EXIT_FAILURE;
+    }
+
+    // The recorded application does its own echoing and line editing; ours would get in the way.
+    auto savedModes = termios {};
+    auto const isTerminal = tcgetattr(STDIN_FILENO, &savedModes) == 0;
+    if (isTerminal)
+    {
+        auto raw = savedModes;
+        cfmakeraw(&raw);
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+    auto restoreModes = crispy::Finally { [&]() {
+        if (isTerminal)
+            tcsetattr(STDIN_FILENO, TCSANOW, &savedModes);
+    } };
+
+    auto writerMutex = std::mutex {};
+    auto writer = vtbackend::PtyRecordingWriter { file, pageSize };
+
+    auto bufferObjectPool = crispy::BufferObjectPool<char>(4llu * 1024 * 1024);
+    auto reader = std::thread { [&]() {
+        auto bufferObject = bufferObjectPool.allocateBufferObject();
+        while (!process.isClosed())
+        {
+            auto const readResult = process.read(*bufferObject, std::chrono::seconds(1), 64 * 1024);
+            if (!readResult)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                break;
+            }
+            auto const data = readResult->data;
+            if (data.empty())
+                continue;
+            {
+                auto const l = std::scoped_lock { writerMutex };
+                writer.output(data);
+            }
+            (void) ::write(STDOUT_FILENO, data.data(), data.size());
+            bufferObject->clear();
+        }
+    } };
+
+    auto input = std::array<char, 4096> {};
+    while (process.alive())
+    {
+        auto fds = pollfd { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+        if (::poll(&fds, 1, 100) > 0 && (fds.revents & POLLIN))
+        {
+            auto const n = ::read(STDIN_FILENO, input.data(), input.size());
+            if (n <= 0)
+                break;
+            (void) process.write(std::string_view(input.data(), static_cast<size_t>(n)));
+        }
+
+        // Polled rather than signalled: nothing else in here needs a signal handler.
+        if (auto const current = controllingPageSize(); current != pageSize)
+        {
+            pageSize = current;
+            process.resizeScreen(pageSize);
+            auto const l = std::scoped_lock { writerMutex };
+            writer.resize(pageSize);
+        }
+    }
+
+    process.close();
+    reader.join();
+    restoreModes.run();
+
+    file.flush();
+    cerr << std::format("Recorded to '{}'.\n", path);
+    return EXIT_SUCCESS;
+#endif
+}
+
+/// When a replay feeds each recorded batch.
+enum class ReplayPacing : uint8_t
+{
+    FlatOut, ///< As fast as possible.
+    Paced,   ///< At the time it was recorded.
+};
+
+/// Whether a replay builds a render buffer after each batch, as a display would.
+enum class ReplayRefresh : uint8_t
+{
+    Skip,
+    PerBatch,
+};
+
+struct ReplayOptions
+{
+    ReplayPacing pacing = ReplayPacing::FlatOut;
+    ReplayRefresh refresh = ReplayRefresh::Skip;
+    unsigned fps = 60; ///< The frame rate whose budget a paced batch must meet.
+    unsigned iterations = 1;
+};
+
+/// Feeds @p recording through a headless terminal, one batch per recorded read, reporting how
+/// long the batches took.
+///
+/// Flat out, this is the terminal's throughput on a real workload. Paced, every batch is fed at
+/// the time it was recorded, and a batch that is not done within one frame of that time -- because
+/// it took too long, or because the one before it did -- missed the frame budget.
+///
+/// @return EXIT_SUCCESS.
+static int replayPtyRecording(vtbackend::PtyRecording const& recording, ReplayOptions options)
+{
+    using std::chrono::nanoseconds;
+    using std::chrono::steady_clock;
+
+    auto vt =
+        vtbackend::MockTerm<vtpty::MockViewPty>(recording.pageSize, vtbackend::LineCount(4000), 1'000'000);
+    auto* pty = dynamic_cast<vtpty::MockViewPty*>(&vt.terminal.device());
+    auto const frameBudget = std::chrono::duration_cast<nanoseconds>(std::chrono::seconds(1)) / options.fps;
+
+    auto batchTimes = vtbackend::DurationHistogram {};
+    auto lateness = vtbackend::DurationHistogram {};
+    auto missedFrames = uint64_t { 0 };
+    auto batches = uint64_t { 0 };
+
+    auto const start = steady_clock::now();
+    for ([[maybe_unused]] auto const iteration: crispy::times(options.iterations))
+    {
+        vt.terminal.resizeScreen(recording.pageSize, std::nullopt);
+        auto const iterationStart = steady_clock::now();
+        for (auto const& record: recording.records)
+        {
+            auto const at = std::visit([](auto const& r) { return r.at; }, record);
+            auto const scheduled = iterationStart + at;
+            if (options.pacing == ReplayPacing::Paced)
+                std::this_thread::sleep_until(scheduled);
+
+            auto const batchStart = steady_clock::now();
+            if (auto const* output = std::get_if<vtbackend::PtyRecording::Output>(&record))
+            {
+                // clang-format off
+                pty->setReadData(output->bytes);
+                do vt.terminal.processInputOnce();
+                while (!pty->isClosed() && !pty->stdoutBuffer().empty());
+                // clang-format on
+            }
+            else
+                vt.terminal.resizeScreen(std::get<vtbackend::PtyRecording::Resize>(record).pageSize,
+                                         std::nullopt);
+            if (options.refresh == ReplayRefresh::PerBatch)
+                vt.terminal.refreshRenderBuffer();
+            auto const batchEnd = steady_clock::now();
+
+            ++batches;
+            batchTimes.record(batchEnd - batchStart);
+            if (options.pacing == ReplayPacing::Paced)
+            {
+                auto const late = std::chrono::duration_cast<nanoseconds>(batchEnd - scheduled);
+                lateness.record(late);
+                if (late > frameBudget)
+                    ++missedFrames;
+            }
+        }
+    }
+    auto const seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+    auto const totalBytes = static_cast<double>(recording.outputBytes()) * options.iterations;
+
+    cout << std::format("PTY stream replay\n"
+                        "-----------------\n"
+                        "  recording     : {} bytes in {} records over {:.3f} s\n"
+                        "  grid          : {} x {} cells\n"
+                        "  mode          : {}{}\n"
+                        "  iterations    : {}\n"
+                        "  elapsed       : {:.3f} s\n"
+                        "  throughput    : {:.2f} MiB/s\n"
+                        "  per batch     : p50 {}, p99 {}, max {}\n",
+                        recording.outputBytes(),
+                        recording.records.size(),
+                        std::chrono::duration<double>(recording.duration()).count(),
+                        recording.pageSize.columns,
+                        recording.pageSize.lines,
+                        options.pacing == ReplayPacing::Paced ? "paced" : "flat out",
+                        options.refresh == ReplayRefresh::PerBatch ? ", render buffer per batch" : "",
+                        options.iterations,
+                        seconds,
+                        totalBytes / seconds / (1024.0 * 1024.0),
+                        vtbackend::formatDuration(batchTimes.quantile(0.5)),
+                        vtbackend::formatDuration(batchTimes.quantile(0.99)),
+                        vtbackend::formatDuration(batchTimes.max()));
+    if (options.pacing == ReplayPacing::Paced)
+        cout << std::format("  done after    : p50 {}, p99 {}, max {} past its recorded time\n"
+                            "  frame budget  : {} at {} fps, missed by {} of {} batches ({:.2f}%)\n",
+                            vtbackend::formatDuration(lateness.quantile(0.5)),
+                            vtbackend::formatDuration(lateness.quantile(0.99)),
+                            vtbackend::formatDuration(lateness.max()),
+                            vtbackend::formatDuration(frameBudget),
+                            options.fps,
+                            missedFrames,
+                            batches,
+                            batches ? 100.0 * static_cast<double>(missedFrames) / static_cast<double>(batches)
+                                    : 0.0);
+    return EXIT_SUCCESS;
+}
+
 namespace CLI = crispy::cli;
 
 namespace
@@ -194,6 +535,8 @@ class ContourHeadlessBench: public crispy::App
         link("bench-headless.grid", bind(&ContourHeadlessBench::benchGrid, this));
         link("bench-headless.sixel", bind(&ContourHeadlessBench::benchSixel, this));
         link("bench-headless.pty", bind(&ContourHeadlessBench::benchPTY));
+        link("bench-headless.record", bind(&ContourHeadlessBench::record, this));
+        link("bench-headless.replay", bind(&ContourHeadlessBench::replay, this));
         link("bench-headless.meta", bind(&ContourHeadlessBench::showMetaInfo));
 
         if (auto const logFilterString = env.get("LOG"))
@@ -205,7 +548,7 @@ class ContourHeadlessBench: public crispy::App
 
     [[nodiscard]] crispy::cli::Command parameterDefinition() const override
     {
-        auto const perfOptions = CLI::OptionList {
+        auto perfOptions = CLI::OptionList {
             CLI::Option { .name = "size",
                           .v = CLI::Value { 32u },
                           .helpText = "Number of megabyte to process per test.",
@@ -220,6 +563,9 @@ class ContourHeadlessBench: public crispy::App
             CLI::Option {
                 .name = "binary", .v = CLI::Value { false }, .helpText = "Enable binary stream test." },
         };
+        for (auto const& workload: vtbackend::benchWorkloads())
+            perfOptions.emplace_back(CLI::Option {
+                .name = workload.name, .v = CLI::Value { false }, .helpText = workload.description });
 
         return CLI::Command {
             .name = "bench-headless",
@@ -245,6 +591,45 @@ class ContourHeadlessBench: public crispy::App
                     CLI::Command { .name = "pty",
                                    .helpText = "Performs performance tests utilizing the underlying "
                                                "operating system's PTY only." },
+                    CLI::Command {
+                        .name = "record",
+                        .helpText = "Runs a command interactively, recording its PTY output stream with "
+                                    "timing and page size for replay.",
+                        .options =
+                            CLI::OptionList {
+                                CLI::Option { .name = "output",
+                                              .v = CLI::Value { "contour.ptyrec"s },
+                                              .helpText = "File to record to.",
+                                              .placeholder = "PATH" },
+                                CLI::Option { .name = "command",
+                                              .v = CLI::Value { ""s },
+                                              .helpText = "Shell command to record. Defaults to the login "
+                                                          "shell.",
+                                              .placeholder = "COMMAND" },
+                            } },
+                    CLI::Command {
+                        .name = "replay",
+                        .helpText = "Replays a recorded PTY stream through the full grid, either flat out "
+                                    "for throughput or at the recorded pace for frame budget misses.",
+                        .options =
+                            CLI::OptionList {
+                                CLI::Option { .name = "file",
+                                              .v = CLI::Value { ""s },
+                                              .helpText = "Recording to replay.",
+                                              .placeholder = "PATH" },
+                                CLI::Option { .name = "paced",
+                                              .v = CLI::Value { false },
+                                              .helpText = "Feed each batch at its recorded time." },
+                                CLI::Option { .name = "refresh",
+                                              .v = CLI::Value { false },
+                                              .helpText = "Build a render buffer after each batch." },
+                                CLI::Option { .name = "fps",
+                                              .v = CLI::Value { 60u },
+                                              .helpText = "Frame rate a paced batch must keep up with." },
+                                CLI::Option { .name = "iterations",
+                                              .v = CLI::Value { 1u },
+                                              .helpText = "How many times to replay the recording." },
+                            } },
                     CLI::Command {
                         .name = "sixel",
                         .helpText = "Measures sixel decode throughput: VT parse, sixel decode and "
@@ -294,6 +679,9 @@ class ContourHeadlessBench: public crispy::App
         opts.longLines = parameters().boolean(prefix + "long");
         opts.sgr = parameters().boolean(prefix + "sgr");
         opts.binary = parameters().boolean(prefix + "binary");
+        for (auto const& workload: vtbackend::benchWorkloads())
+            if (parameters().boolean(prefix + std::string(workload.name)))
+                opts.workloads.emplace_back(workload.name);
         return opts;
     }
 
@@ -341,6 +729,45 @@ class ContourHeadlessBench: public crispy::App
         return benchSixelStream(frame, iterations, pageSize, cellSize, maxImageSize);
     }
 
+    int record()
+    {
+        return recordPtySession(parameters().get<std::string>("bench-headless.record.output"),
+                                parameters().get<std::string>("bench-headless.record.command"));
+    }
+
+    int replay()
+    {
+        auto const path = parameters().get<std::string>("bench-headless.replay.file");
+        if (path.empty())
+        {
+            cerr << "No recording given. Use: bench-headless replay file PATH\n"
+                    "Make one with: bench-headless record output PATH command 'htop'\n";
+            return EXIT_FAILURE;
+        }
+
+        auto file = std::ifstream(path, std::ios::binary);
+        if (!file)
+        {
+            cerr << std::format("Cannot read '{}'.\n", path);
+            return EXIT_FAILURE;
+        }
+        auto const recording = vtbackend::readPtyRecording(file);
+        if (!recording)
+        {
+            cerr << std::format("'{}': {}\n", path, recording.error());
+            return EXIT_FAILURE;
+        }
+
+        auto options = ReplayOptions {};
+        if (parameters().boolean("bench-headless.replay.paced"))
+            options.pacing = ReplayPacing::Paced;
+        if (parameters().boolean("bench-headless.replay.refresh"))
+            options.refresh = ReplayRefresh::PerBatch;
+        options.fps = std::max(1u, parameters().uint("bench-headless.replay.fps"));
+        options.iterations = std::max(1u, parameters().uint("bench-headless.replay.iterations"));
+        return replayPtyRecording(*recording, options);
+    }
+
     int benchGrid()
     {
         auto pageSize = vtbackend::PageSize { vtbackend::LineCount(25), vtbackend::ColumnCount(80) };
@@ -365,7 +792,12 @@ class ContourHeadlessBench: public crispy::App
             benchOptionsFor("grid"),
             "terminal with screen buffer");
         if (rv == EXIT_SUCCESS)
+        {
             cout << std::format("{:>12}: {}\n\n", "history size", *vt.terminal.maxHistoryLineCount());
+#if defined(CONTOUR_PERF_STATS)
+            cout << "Terminal state lock\n-------------------\n" << vt.terminal.lockStats().summary() << '\n';
+#endif
+        }
         return rv;
     }
 
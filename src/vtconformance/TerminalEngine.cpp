@@ -47,7 +47,12 @@ TerminalEngine::TerminalEngine(std::unique_ptr<vtpty::Pty> device, Options optio
     settings.allowClipboardRead = true;
 
     _terminal = std::make_unique<vtbackend::Terminal>(
-        *this, crispy::defaultEnvironment(), std::move(device), settings, std::chrono::steady_clock::now());
+        *this,
+        crispy::defaultEnvironment(),
+        /*traceRecorder=*/nullptr,
+        std::move(device),
+        settings,
+        std::chrono::steady_clock::now());
 
     // The frontend's half of the window: a headless engine has no font and no screen, so nothing else
     // would fill these in -- and a terminal that reports a cell of zero pixels, or a screen exactly as
@@ -159,13 +164,13 @@ void TerminalEngine::requestWindowFullScreen(vtbackend::WindowFullScreen how)
 
 std::string TerminalEngine::screenText() const
 {
-    auto const guard = std::lock_guard { *_terminal };
+    auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Query };
     return _terminal->currentScreen().renderMainPageText();
 }
 
 std::string TerminalEngine::dump(DumpOptions const& options) const
 {
-    auto const guard = std::lock_guard { *_terminal };
+    auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Query };
     return dumpScreen(*_terminal, options);
 }
 
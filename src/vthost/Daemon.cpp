@@ -12,9 +12,12 @@
 
 #include <vthost/Daemon.hpp>
 
+#include <vtpty/PtyPool.hpp>
+
 #include <crispy/Environment.hpp>
 #include <crispy/Utils.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <charconv>
 #include <chrono>
@@ -40,6 +43,7 @@
 #include <net/Sockets.hpp>
 #include <net/Tls.hpp>
 #include <vthost/ConnectionAcceptor.hpp>
+#include <vthost/DaemonMetrics.hpp>
 #include <vthost/LastSessionWatcher.hpp>
 #include <vthost/Logging.hpp>
 #include <vthost/NativeSession.hpp>
@@ -80,6 +84,23 @@ namespace
         };
     }
 
+    /// The shells started ahead of time for the daemon's sessions, or null when none are configured.
+    [[nodiscard]] std::unique_ptr<vtpty::PtyPool> makePrespawnedShells(DaemonConfig const& config)
+    {
+        if (config.prespawnedShells == 0)
+            return nullptr;
+        return std::make_unique<vtpty::PtyPool>(
+            makeShellPtyFactory(config.shell), config.prespawnedShells, config.settings.pageSize);
+    }
+
+    /// The sessions' PTY factory: hands out @p prespawned's started shells when there is a pool.
+    [[nodiscard]] PtyFactory makeSessionPtyFactory(DaemonConfig const& config, vtpty::PtyPool* prespawned)
+    {
+        if (!prespawned)
+            return makeShellPtyFactory(config.shell);
+        return [prespawned](vtbackend::PageSize pageSize) { return prespawned->acquire(pageSize); };
+    }
+
     /// Reads the whole file at @p path, or nullopt if it cannot be opened.
     [[nodiscard]] std::optional<std::string> readFileToString(std::string const& path)
     {
@@ -89,6 +110,38 @@ namespace
         return crispy::readFileAsString(path);
     }
 
+    /// Binds the opt-in metrics listener into @p slot and adds it to @p servers.
+    /// @return Whether it is serving; false after logging why not.
+    [[nodiscard]] bool serveMetrics(net::EventLoop& loop,
+                                    MetricsListenerConfig const& config,
+                                    DaemonMetrics const& metrics,
+                                    SessionHost const& host,
+                                    std::optional<ConnectionAcceptor>& slot,
+                                    std::vector<ConnectionAcceptor*>& servers)
+    {
+        // Checked here and not only where the option is parsed: this is the one place every
+        // configuration passes through on its way to a socket.
+        if (!isLoopbackHost(config.host))
+        {
+            errorLog()("refusing to serve metrics on {}: only loopback addresses are allowed", config.host);
+            return false;
+        }
+        auto listener = net::listen(loop, config.host, config.port);
+        if (!listener)
+        {
+            errorLog()("cannot listen on {}:{}: {}", config.host, config.port, listener.error().toString());
+            return false;
+        }
+        auto const boundPort = (*listener)->localPort();
+        slot.emplace(loop,
+                     "metrics",
+                     std::move(*listener),
+                     makeMetricsHandler(metrics, [&host] { return host.traceJson(); }));
+        servers.push_back(&*slot);
+        daemonLog()("metrics served at http://{}:{}/metrics", config.host, boundPort);
+        return true;
+    }
+
     /// Builds the TLS server context for the native TCP listener: an ephemeral
     /// self-signed certificate when none is configured (the TOFU default), else
     /// the configured PEM cert + key. The TCP transport is always encrypted.
@@ -528,6 +581,15 @@ std::optional<std::pair<std::string, std::uint16_t>> parseHostPort(std::string_v
     return std::pair { std::string { host }, static_cast<std::uint16_t>(port) };
 }
 
+bool isLoopbackHost(std::string_view host) noexcept
+{
+    if (host == "localhost" || host == "::1" || host == "[::1]")
+        return true;
+    // Digits and dots only, so a host NAME that merely starts with "127." does not pass.
+    return host.starts_with("127.")
+           && std::ranges::all_of(host, [](char ch) { return ch == '.' || (ch >= '0' && ch <= '9'); });
+}
+
 #ifndef _WIN32
 
 int runDaemon(DaemonConfig const& config)
@@ -535,10 +597,20 @@ int runDaemon(DaemonConfig const& config)
     auto source = net::PollEventSource {};
     auto loop = net::EventLoop { source };
 
+    // Before the host, which hands each session and connection a handle into it.
+    auto metrics = std::optional<DaemonMetrics> {};
+    if (config.metrics)
+        metrics.emplace();
+
+    // Before the host as well: its sessions are handed the shells, and are gone before the pool is.
+    auto const prespawned = makePrespawnedShells(config);
+
     auto host = SessionHost { loop,
-                              makeShellPtyFactory(config.shell),
+                              makeSessionPtyFactory(config, prespawned.get()),
                               config.settings,
                               crispy::defaultEnvironment(),
+                              metrics ? &*metrics : nullptr,
+                              config.traceFile,
                               /*startPumps=*/true,
                               config.sizePolicy };
 
@@ -612,6 +684,11 @@ int runDaemon(DaemonConfig const& config)
         daemonLog()("native TCP listener on {}:{}", config.nativeTcp->host, boundPort);
     }
 
+    auto metricsServer = std::optional<ConnectionAcceptor> {};
+    if (config.metrics
+        && !serveMetrics(loop, *config.metrics, *metrics, host, metricsServer, servers))
+        return EXIT_FAILURE;
+
     // An auto-spawned daemon ends with its last session; a user-started one persists. Declared after
     // `servers` is complete (it is captured by reference) and after `host`, so it unsubscribes while
     // the host is still alive.
@@ -720,10 +797,20 @@ int runDaemon(DaemonConfig const& config)
     auto source = net::PollEventSource {};
     auto loop = net::EventLoop { source };
 
+    // Before the host, which hands each session and connection a handle into it.
+    auto metrics = std::optional<DaemonMetrics> {};
+    if (config.metrics)
+        metrics.emplace();
+
+    // Before the host as well: its sessions are handed the shells, and are gone before the pool is.
+    auto const prespawned = makePrespawnedShells(config);
+
     auto host = SessionHost { loop,
-                              makeShellPtyFactory(config.shell),
+                              makeSessionPtyFactory(config, prespawned.get()),
                               config.settings,
                               crispy::defaultEnvironment(),
+                              metrics ? &*metrics : nullptr,
+                              config.traceFile,
                               /*startPumps=*/true,
                               config.sizePolicy };
 
@@ -769,6 +856,11 @@ int runDaemon(DaemonConfig const& config)
         daemonLog()("native TCP listener on {}:{}", config.nativeTcp->host, boundPort);
     }
 
+    auto metricsServer = std::optional<ConnectionAcceptor> {};
+    if (config.metrics
+        && !serveMetrics(loop, *config.metrics, *metrics, host, metricsServer, servers))
+        return EXIT_FAILURE;
+
     // An auto-spawned daemon ends with its last session; a user-started one persists. See the
     // POSIX body above for why this is declared here.
     auto lastSession = std::optional<LastSessionWatcher> {};
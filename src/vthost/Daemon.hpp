@@ -56,6 +56,16 @@ struct NativeTcpListenerConfig
     std::string tlsKeyPath;
 };
 
+/// Opt-in HTTP listener serving the daemon's metrics at `GET /metrics`, in the Prometheus text
+/// format, and the frame trace of its live sessions at `GET /trace`. Unauthenticated and unencrypted,
+/// which is why the daemon refuses to bind it anywhere but a loopback address: per-session byte counts
+/// say a lot about what a user is doing.
+struct MetricsListenerConfig
+{
+    std::string host = "127.0.0.1"; ///< Bind address; must be a loopback one.
+    std::uint16_t port = 0;         ///< TCP port (0 = OS-assigned ephemeral).
+};
+
 /// Whether a daemon outlives its last hosted session.
 enum class DaemonLifecycle : std::uint8_t
 {
@@ -72,6 +82,8 @@ struct DaemonConfig
 {
     /// When set, ALSO serves the native protocol over TCP (opt-in; see the struct).
     std::optional<NativeTcpListenerConfig> nativeTcp;
+    /// When set, ALSO serves metrics over HTTP on a loopback address (opt-in; see the struct).
+    std::optional<MetricsListenerConfig> metrics;
     /// The control-socket file (see muxSocketPath for derivation).
     std::filesystem::path socketPath;
     /// Factory settings for every hosted session's terminal. Defaulted rather than left
@@ -80,6 +92,12 @@ struct DaemonConfig
     vtbackend::Settings settings = defaultSessionSettings();
     /// The shell each new session runs.
     vtpty::Process::ExecInfo shell;
+    /// How many shells to keep started ahead of the sessions that will run them
+    /// (@see vtpty::PtyPool). 0, the default, starts each one on demand.
+    unsigned prespawnedShells = 0;
+    /// When set, every session records its pipeline from the start and writes it to this path with
+    /// the session's number appended (@see crispy::trace::sessionTracePath) once it ends.
+    std::optional<std::filesystem::path> traceFile;
     /// When set, ALSO binds tmux's own discovery path
     /// `/tmp/tmux-<uid>/<label>` for the imsg endpoint, so a plain
     /// `tmux -L <label> -C attach-session` finds this daemon. Opt-in only.
@@ -148,6 +166,10 @@ using AttachEndpoint = std::variant<UnixEndpoint, TcpEndpoint>;
 /// @return The host and port, or nullopt if @p spec is malformed.
 [[nodiscard]] std::optional<std::pair<std::string, std::uint16_t>> parseHostPort(std::string_view spec);
 
+/// @param host A bind address or host name.
+/// @return Whether @p host names the local machine only: `localhost`, `::1`, or 127.0.0.0/8.
+[[nodiscard]] bool isLoopbackHost(std::string_view host) noexcept;
+
 /// The preshared token an endpoint carries (empty for the unix socket, whose
 /// filesystem permissions are the gate; the ClientHello sends it verbatim).
 [[nodiscard]] std::string endpointToken(AttachEndpoint const& endpoint);
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vthost/DaemonMetrics.hpp>
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <net/HttpServer.hpp>
+
+namespace vthost
+{
+
+namespace
+{
+    /// @return @p value as a label value of the text exposition format: backslash, double quote and
+    ///         line feed escaped, so that a socket path holding one cannot end the label early.
+    [[nodiscard]] std::string escapeLabelValue(std::string_view value)
+    {
+        auto escaped = std::string {};
+        escaped.reserve(value.size());
+        for (auto const ch: value)
+        {
+            switch (ch)
+            {
+                case '\\': escaped += "\\\\"; break;
+                case '"': escaped += "\\\""; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += ch; break;
+            }
+        }
+        return escaped;
+    }
+
+    /// Writes the `# HELP` / `# TYPE` header every metric family opens with.
+    void appendFamily(std::string& out, std::string_view name, std::string_view type, std::string_view help)
+    {
+        std::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+    }
+
+    /// Writes one histogram series, turning the per-bucket counts into Prometheus' cumulative ones.
+    void appendHistogram(std::string& out,
+                         std::string_view name,
+                         std::string_view labels,
+                         MetricHistogram const& histogram)
+    {
+        auto const sample = histogram.sample();
+        auto cumulative = std::uint64_t { 0 };
+        for (auto const i: std::views::iota(size_t { 0 }, MetricHistogram::LatencyBounds.size()))
+        {
+            cumulative += sample.buckets[i];
+            std::format_to(std::back_inserter(out),
+                           "{}_bucket{{{},le=\"{}\"}} {}\n",
+                           name,
+                           labels,
+                           MetricHistogram::LatencyBounds[i],
+                           cumulative);
+        }
+        cumulative += sample.buckets.back();
+        std::format_to(std::back_inserter(out), "{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels, cumulative);
+        std::format_to(std::back_inserter(out), "{}_sum{{{}}} {}\n", name, labels, sample.sum);
+        std::format_to(std::back_inserter(out), "{}_count{{{}}} {}\n", name, labels, cumulative);
+    }
+
+    /// Writes the per-site quantiles of one lock histogram as a Prometheus summary series.
+    void appendLockSummary(std::string& out,
+                           std::string_view name,
+                           std::uint64_t session,
+                           vtbackend::LockSite site,
+                           vtbackend::DurationHistogram const& histogram)
+    {
+        auto const labels = std::format("session=\"{}\",site=\"{}\"", session, site);
+        for (auto const quantile: { 0.5, 0.99 })
+            std::format_to(std::back_inserter(out),
+                           "{}{{{},quantile=\"{}\"}} {}\n",
+                           name,
+                           labels,
+                           quantile,
+                           std::chrono::duration<double>(histogram.quantile(quantile)).count());
+        std::format_to(std::back_inserter(out),
+                       "{}_sum{{{}}} {}\n",
+                       name,
+                       labels,
+                       std::chrono::duration<double>(histogram.sum()).count());
+        std::format_to(std::back_inserter(out), "{}_count{{{}}} {}\n", name, labels, histogram.count());
+    }
+
+    /// Answers one scrape. A free coroutine rather than the handler lambda itself, so nothing it
+    /// uses lives in a closure that could be gone before the flow is.
+    coro::Task<void> serveMetricsRequest(DaemonMetrics const* metrics,
+                                         std::function<std::string()> traceJson,
+                                         std::unique_ptr<net::ISocket> socket)
+    {
+        auto request = co_await net::readRequest(socket.get());
+        if (!request)
+            co_return;
+
+        auto response = net::HttpResponse {};
+        if (request->method != "GET")
+            response = net::HttpResponse::withStatus(405, "Only GET is supported.\n");
+        else if (request->path == "/metrics")
+        {
+            response = net::HttpResponse::ok(metrics->render());
+            response.headers.emplace_back("Content-Type", PrometheusContentType);
+        }
+        else if (request->path == "/trace")
+        {
+            // Whatever has been recorded (--trace-file), or just the metadata events when nothing is.
+            response = net::HttpResponse::ok(traceJson());
+            response.headers.emplace_back("Content-Type", "application/json");
+        }
+        else
+            response = net::HttpResponse::withStatus(404, "Metrics are served at /metrics.\n");
+        std::ignore = co_await net::writeResponse(socket.get(), std::move(response));
+    }
+} // namespace
+
+void MetricHistogram::observe(double value) noexcept
+{
+    auto const bound = std::ranges::lower_bound(LatencyBounds, value);
+    auto const index = static_cast<size_t>(std::distance(LatencyBounds.begin(), bound));
+    _buckets[index].fetch_add(1, std::memory_order_relaxed);
+
+    // No atomic<double>::fetch_add on every standard library this builds with.
+    auto sum = _sum.load(std::memory_order_relaxed);
+    while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+        ;
+}
+
+MetricHistogram::Sample MetricHistogram::sample() const noexcept
+{
+    auto result = Sample {};
+    for (auto const i: std::views::iota(size_t { 0 }, _buckets.size()))
+        result.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    result.sum = _sum.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::shared_ptr<SessionMetrics> DaemonMetrics::addSession(std::uint64_t session, SessionGauges gauges)
+{
+    std::erase_if(_sessions, [](auto const& entry) { return entry.second.expired(); });
+    auto metrics = std::make_shared<SessionMetrics>(std::move(gauges));
+    _sessions[session] = metrics;
+    return metrics;
+}
+
+std::shared_ptr<ConnectionMetrics> DaemonMetrics::addConnection(
+    ConnectionId const& id, std::function<std::size_t()> writeBacklogBytes)
+{
+    std::erase_if(_connections, [](auto const& entry) { return entry.second.expired(); });
+    auto metrics = std::make_shared<ConnectionMetrics>(std::move(writeBacklogBytes));
+    _connections[std::format("{}#{}", id.endpoint, id.index)] = metrics;
+    return metrics;
+}
+
+std::string DaemonMetrics::render() const
+{
+    auto out = std::string {};
+
+    auto sessions = std::vector<std::pair<std::uint64_t, std::shared_ptr<SessionMetrics>>> {};
+    for (auto const& [session, weak]: _sessions)
+        if (auto metrics = weak.lock())
+            sessions.emplace_back(session, std::move(metrics));
+
+    appendFamily(out, "contour_daemon_sessions", "gauge", "Hosted sessions.");
+    std::format_to(std::back_inserter(out), "contour_daemon_sessions {}\n", sessions.size());
+
+    appendFamily(out,
+                 "contour_daemon_pty_bytes_total",
+                 "counter",
+                 "Bytes read from a session's PTY and handed to its parser.");
+    for (auto const& [session, metrics]: sessions)
+        std::format_to(std::back_inserter(out),
+                       "contour_daemon_pty_bytes_total{{session=\"{}\"}} {}\n",
+                       session,
+                       metrics->ptyBytes.value());
+
+    appendFamily(out,
+                 "contour_daemon_parse_seconds",
+                 "histogram",
+                 "Time from a PTY read returning to the terminal having processed it.");
+    for (auto const& [session, metrics]: sessions)
+        appendHistogram(out,
+                        "contour_daemon_parse_seconds",
+                        std::format("session=\"{}\"", session),
+                        metrics->parseSeconds);
+
+    appendFamily(out, "contour_daemon_image_bytes", "gauge", "Pixel bytes held by a session's image pool.");
+    for (auto const& [session, metrics]: sessions)
+        if (metrics->gauges.imageBytes)
+            std::format_to(std::back_inserter(out),
+                           "contour_daemon_image_bytes{{session=\"{}\"}} {}\n",
+                           session,
+                           metrics->gauges.imageBytes());
+
+    // Sampled once, so the wait and hold families cover the same sessions.
+    auto lockStats = std::vector<std::pair<std::uint64_t, vtbackend::LockStats const*>> {};
+    for (auto const& [session, metrics]: sessions)
+        if (metrics->gauges.lockStats)
+            if (auto const* stats = metrics->gauges.lockStats())
+                lockStats.emplace_back(session, stats);
+
+    appendFamily(out,
+                 "contour_daemon_lock_wait_seconds",
+                 "summary",
+                 "Time spent waiting for a session's terminal lock, by who waited.");
+    for (auto const& [session, stats]: lockStats)
+        for (auto const site: vtbackend::AllLockSites)
+            appendLockSummary(out, "contour_daemon_lock_wait_seconds", session, site, stats->waits(site));
+
+    appendFamily(out,
+                 "contour_daemon_lock_hold_seconds",
+                 "summary",
+                 "Time a session's terminal lock was held, by who held it.");
+    for (auto const& [session, stats]: lockStats)
+        for (auto const site: vtbackend::AllLockSites)
+            appendLockSummary(out, "contour_daemon_lock_hold_seconds", session, site, stats->holds(site));
+
+    auto connections = std::vector<std::pair<std::string, std::shared_ptr<ConnectionMetrics>>> {};
+    for (auto const& [name, weak]: _connections)
+        if (auto metrics = weak.lock())
+            connections.emplace_back(escapeLabelValue(name), std::move(metrics));
+
+    appendFamily(out, "contour_daemon_connections", "gauge", "Attached native-protocol connections.");
+    std::format_to(std::back_inserter(out), "contour_daemon_connections {}\n", connections.size());
+
+    appendFamily(out,
+                 "contour_daemon_delta_frames_total",
+                 "counter",
+                 "Delta frames sent to a connection, snapshots included.");
+    for (auto const& [name, metrics]: connections)
+        std::format_to(std::back_inserter(out),
+                       "contour_daemon_delta_frames_total{{connection=\"{}\"}} {}\n",
+                       name,
+                       metrics->deltaFrames.value());
+
+    appendFamily(
+        out, "contour_daemon_delta_bytes_total", "counter", "Encoded bytes of the delta frames sent.");
+    for (auto const& [name, metrics]: connections)
+        std::format_to(std::back_inserter(out),
+                       "contour_daemon_delta_bytes_total{{connection=\"{}\"}} {}\n",
+                       name,
+                       metrics->deltaBytes.value());
+
+    appendFamily(out, "contour_daemon_snapshots_total", "counter", "Full snapshots sent to a connection.");
+    for (auto const& [name, metrics]: connections)
+        std::format_to(std::back_inserter(out),
+                       "contour_daemon_snapshots_total{{connection=\"{}\"}} {}\n",
+                       name,
+                       metrics->snapshots.value());
+
+    appendFamily(out,
+                 "contour_daemon_write_backlog_bytes",
+                 "gauge",
+                 "Bytes queued for a connection behind its socket.");
+    for (auto const& [name, metrics]: connections)
+        if (metrics->writeBacklogBytes)
+            std::format_to(std::back_inserter(out),
+                           "contour_daemon_write_backlog_bytes{{connection=\"{}\"}} {}\n",
+                           name,
+                           metrics->writeBacklogBytes());
+
+    appendFamily(out,
+                 "contour_daemon_input_to_push_seconds",
+                 "histogram",
+                 "Time from a client's input reaching the daemon to the next delta of that session.");
+    for (auto const& [name, metrics]: connections)
+        appendHistogram(out,
+                        "contour_daemon_input_to_push_seconds",
+                        std::format("connection=\"{}\"", name),
+                        metrics->inputToPushSeconds);
+
+    return out;
+}
+
+ConnectionHandler makeMetricsHandler(DaemonMetrics const& metrics, std::function<std::string()> traceJson)
+{
+    return [metrics = &metrics, traceJson = std::move(traceJson)](ConnectionId /*id*/,
+                                                                  std::unique_ptr<net::ISocket> connection) {
+        return serveMetricsRequest(metrics, traceJson, std::move(connection));
+    };
+}
+
+} // namespace vthost
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// `DaemonMetrics` — the counters and histograms `contour daemon --metrics-listen` exposes.
+///
+/// Until this existed the only way to see what a daemon was doing was its log categories, which
+/// answer "what happened" but not "how much": sizing a shared daemon host needs parse throughput,
+/// per-connection push volume and latency as numbers a scraper can collect. The endpoint speaks the
+/// Prometheus text exposition format, since that is what every common collector reads.
+///
+/// Threading: sessions and connections are registered, removed and rendered on the loop thread.
+/// Counters and histograms are atomics, because session pump threads bump theirs directly; gauges
+/// are sampled by callbacks that run on the loop thread at scrape time.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <vtbackend/LockStats.hpp>
+
+#include <vthost/ConnectionAcceptor.hpp>
+#include <vthost/ConnectionId.hpp>
+
+namespace vthost
+{
+
+/// A monotonically increasing count, safe to bump from any thread.
+class MetricCounter
+{
+  public:
+    void add(std::uint64_t n = 1) noexcept { _value.fetch_add(n, std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t value() const noexcept { return _value.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::uint64_t> _value = 0;
+};
+
+/// A Prometheus-style histogram over fixed upper bounds, safe to observe from any thread.
+///
+/// Each observation lands in exactly one bucket; the cumulative counts Prometheus expects are
+/// summed at render time, so a scrape racing an observation still sees a self-consistent series.
+class MetricHistogram
+{
+  public:
+    /// Upper bounds, in seconds, for the latency histograms: 50µs to 1s.
+    static constexpr auto LatencyBounds = std::array {
+        0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0,
+    };
+
+    /// A snapshot of the histogram, bucket counts NOT cumulative.
+    struct Sample
+    {
+        std::array<std::uint64_t, LatencyBounds.size() + 1> buckets {}; ///< The last one is +Inf.
+        double sum = 0.0;
+    };
+
+    void observe(double value) noexcept;
+    void observe(std::chrono::steady_clock::duration elapsed) noexcept
+    {
+        observe(std::chrono::duration<double>(elapsed).count());
+    }
+
+    [[nodiscard]] Sample sample() const noexcept;
+
+  private:
+    std::array<std::atomic<std::uint64_t>, LatencyBounds.size() + 1> _buckets {};
+    std::atomic<double> _sum = 0.0;
+};
+
+/// Where one hosted session's gauges are sampled from; either may be left empty to omit its series.
+struct SessionGauges
+{
+    std::function<std::size_t()> imageBytes; ///< Pixel bytes held by the session's image pool.
+    /// The terminal's state-lock statistics, or nullptr when it has none; only tracked in
+    /// CONTOUR_PERF_STATS builds.
+    std::function<vtbackend::LockStats const*()> lockStats;
+};
+
+/// What one hosted session reports.
+struct SessionMetrics
+{
+    explicit SessionMetrics(SessionGauges gauges): gauges { std::move(gauges) } {}
+
+    MetricCounter ptyBytes;        ///< Bytes read from the PTY and handed to the parser.
+    MetricHistogram parseSeconds;  ///< Time from a PTY read returning to its batch being processed.
+    SessionGauges const gauges;    ///< Fixed at registration.
+
+    /// Records a chunk read from the PTY. Pump thread only.
+    void chunkRead(std::size_t bytes) noexcept
+    {
+        ptyBytes.add(bytes);
+        _readAt = std::chrono::steady_clock::now();
+    }
+
+    /// Closes the parse interval opened by the last chunkRead(), if any. Pump thread only.
+    void batchProcessed() noexcept
+    {
+        if (!_readAt)
+            return;
+        parseSeconds.observe(std::chrono::steady_clock::now() - *_readAt);
+        _readAt.reset();
+    }
+
+  private:
+    std::optional<std::chrono::steady_clock::time_point> _readAt; ///< Touched by the pump thread only.
+};
+
+/// What one native-protocol connection reports.
+struct ConnectionMetrics
+{
+    explicit ConnectionMetrics(std::function<std::size_t()> writeBacklogBytes):
+        writeBacklogBytes { std::move(writeBacklogBytes) }
+    {
+    }
+
+    MetricCounter deltaFrames;           ///< Delta PDUs sent, snapshots included.
+    MetricCounter deltaBytes;            ///< Encoded bytes of those PDUs.
+    MetricCounter snapshots;             ///< Of those, full snapshots.
+    MetricHistogram inputToPushSeconds;  ///< From a client's Input to the next delta of that session.
+    std::function<std::size_t()> const writeBacklogBytes; ///< Frames queued behind the socket.
+};
+
+/// Every metric the daemon exposes, and their Prometheus text rendering.
+class DaemonMetrics
+{
+  public:
+    /// Registers @p session; its series appear until the returned handle is released.
+    /// @param gauges Sampled on the loop thread at every scrape while the handle lives.
+    [[nodiscard]] std::shared_ptr<SessionMetrics> addSession(std::uint64_t session, SessionGauges gauges);
+
+    /// Registers the connection @p id; its series appear until the returned handle is released.
+    /// @param writeBacklogBytes Sampled on the loop thread at every scrape while the handle lives.
+    [[nodiscard]] std::shared_ptr<ConnectionMetrics> addConnection(
+        ConnectionId const& id, std::function<std::size_t()> writeBacklogBytes);
+
+    /// @return Every metric in the Prometheus text exposition format (version 0.0.4).
+    [[nodiscard]] std::string render() const;
+
+  private:
+    // Weak: a session's or a connection's series go away with it, with no removal call to forget
+    // on any of the paths that tear one down.
+    std::map<std::uint64_t, std::weak_ptr<SessionMetrics>> _sessions;
+    std::map<std::string, std::weak_ptr<ConnectionMetrics>> _connections;
+};
+
+/// The MIME type of the Prometheus text exposition format.
+inline constexpr auto PrometheusContentType = "text/plain; version=0.0.4; charset=utf-8";
+
+/// The connection handler serving `GET /metrics` from @p metrics, which is not owned and must
+/// outlive it, and `GET /trace` from what @p traceJson returns, called on the loop thread.
+[[nodiscard]] ConnectionHandler makeMetricsHandler(DaemonMetrics const& metrics,
+                                                   std::function<std::string()> traceJson);
+
+} // namespace vthost
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+
+#include <vthost/DaemonMetrics.hpp>
+
+using vthost::ConnectionId;
+using vthost::DaemonMetrics;
+using vthost::MetricHistogram;
+
+using namespace std::chrono_literals;
+
+TEST_CASE("MetricHistogram files each observation under exactly one bucket", "[vthost][metrics]")
+{
+    auto histogram = MetricHistogram {};
+    histogram.observe(0.00001); // below the first bound
+    histogram.observe(0.001);   // exactly on a bound: Prometheus' `le` is inclusive
+    histogram.observe(5.0);     // beyond the last bound
+
+    auto const sample = histogram.sample();
+    CHECK(sample.buckets.front() == 1);
+    CHECK(sample.buckets[4] == 1); // 0.001
+    CHECK(sample.buckets.back() == 1);
+    CHECK(sample.sum == 0.00001 + 0.001 + 5.0);
+}
+
+TEST_CASE("DaemonMetrics renders cumulative buckets and totals", "[vthost][metrics]")
+{
+    auto metrics = DaemonMetrics {};
+    auto session = metrics.addSession(7, { .imageBytes = [] { return std::size_t { 1024 }; } });
+    session->ptyBytes.add(4096);
+    session->parseSeconds.observe(200us);
+    session->parseSeconds.observe(2s);
+
+    auto const text = metrics.render();
+    CHECK(text.contains("# TYPE contour_daemon_parse_seconds histogram\n"));
+    CHECK(text.contains("contour_daemon_sessions 1\n"));
+    CHECK(text.contains("contour_daemon_pty_bytes_total{session=\"7\"} 4096\n"));
+    CHECK(text.contains("contour_daemon_image_bytes{session=\"7\"} 1024\n"));
+    CHECK(text.contains("contour_daemon_parse_seconds_bucket{session=\"7\",le=\"0.0001\"} 0\n"));
+    CHECK(text.contains("contour_daemon_parse_seconds_bucket{session=\"7\",le=\"0.00025\"} 1\n"));
+    CHECK(text.contains("contour_daemon_parse_seconds_bucket{session=\"7\",le=\"1\"} 1\n"));
+    CHECK(text.contains("contour_daemon_parse_seconds_bucket{session=\"7\",le=\"+Inf\"} 2\n"));
+    CHECK(text.contains("contour_daemon_parse_seconds_count{session=\"7\"} 2\n"));
+}
+
+TEST_CASE("DaemonMetrics drops a series once its owner releases it", "[vthost][metrics]")
+{
+    auto metrics = DaemonMetrics {};
+    auto session = metrics.addSession(1, {});
+    auto connection = metrics.addConnection(ConnectionId { .endpoint = "native", .index = 3 },
+                                            [] { return std::size_t { 512 }; });
+    connection->deltaFrames.add(2);
+
+    auto const before = metrics.render();
+    CHECK(before.contains("contour_daemon_delta_frames_total{connection=\"native#3\"} 2\n"));
+    CHECK(before.contains("contour_daemon_write_backlog_bytes{connection=\"native#3\"} 512\n"));
+
+    session.reset();
+    connection.reset();
+
+    auto const after = metrics.render();
+    CHECK(after.contains("contour_daemon_sessions 0\n"));
+    CHECK(after.contains("contour_daemon_connections 0\n"));
+    CHECK_FALSE(after.contains("native#3"));
+    CHECK_FALSE(after.contains("session=\"1\""));
+}
+
+TEST_CASE("DaemonMetrics escapes the connection label", "[vthost][metrics]")
+{
+    auto metrics = DaemonMetrics {};
+    auto connection = metrics.addConnection(ConnectionId { .endpoint = "/tmp/a\"b\\c\nd", .index = 1 },
+                                            [] { return std::size_t { 0 }; });
+
+    CHECK(metrics.render().contains(
+        "contour_daemon_snapshots_total{connection=\"/tmp/a\\\"b\\\\c\\nd#1\"} 0\n"));
+}
+
+TEST_CASE("DaemonMetrics renders a session's lock statistics per site", "[vthost][metrics]")
+{
+    auto lockStats = vtbackend::LockStats {};
+    lockStats.recordHold(vtbackend::LockSite::Render, 3ms);
+
+    auto metrics = DaemonMetrics {};
+    auto session = metrics.addSession(2, { .lockStats = [&] { return &lockStats; } });
+
+    auto const text = metrics.render();
+    CHECK(text.contains("# TYPE contour_daemon_lock_hold_seconds summary\n"));
+    CHECK(text.contains("contour_daemon_lock_hold_seconds_count{session=\"2\",site=\"render\"} 1\n"));
+    CHECK(text.contains("contour_daemon_lock_hold_seconds_sum{session=\"2\",site=\"render\"} 0.003\n"));
+    CHECK(text.contains(
+        "contour_daemon_lock_hold_seconds{session=\"2\",site=\"render\",quantile=\"0.5\"} 0.003\n"));
+    CHECK(text.contains("contour_daemon_lock_wait_seconds_count{session=\"2\",site=\"parse\"} 0\n"));
+}
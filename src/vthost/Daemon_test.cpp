@@ -232,6 +232,17 @@ TEST_CASE("a daemon hosts sessions with scrollback by default", "[vthost][daemon
           == std::get<vtbackend::LineCount>(settings.maxHistoryLineCount));
 }
 
+TEST_CASE("isLoopbackHost admits the local machine only", "[vthost][daemon]")
+{
+    CHECK(vthost::isLoopbackHost("127.0.0.1"));
+    CHECK(vthost::isLoopbackHost("127.1.2.3"));
+    CHECK(vthost::isLoopbackHost("localhost"));
+    CHECK(vthost::isLoopbackHost("::1"));
+    CHECK_FALSE(vthost::isLoopbackHost("0.0.0.0"));
+    CHECK_FALSE(vthost::isLoopbackHost("192.168.1.10"));
+    CHECK_FALSE(vthost::isLoopbackHost("127.example.com")); // a name, not an address
+}
+
 TEST_CASE("joinCommandLine quotes every argument, argv[0] included", "[vthost][spawn]")
 {
     // The Windows spawn path used to quote only the socket VALUE, leaving argv[0] bare — which
@@ -113,10 +113,11 @@ proto::WireCell toWireCell(vtbackend::LineSoA const& soa, std::size_t column)
     cell.scale = soa.scales[column];
     cell.textScaleExtras = soa.textScaleExtras[column];
     cell.hyperlink = unbox<uint16_t>(soa.hyperlinks[column]);
-    cell.foreground = rawColor(soa.sgr[column].foregroundColor);
-    cell.background = rawColor(soa.sgr[column].backgroundColor);
-    cell.underlineColor = rawColor(soa.sgr[column].underlineColor);
-    cell.flags = static_cast<uint32_t>(soa.sgr[column].flags.value());
+    auto const attrs = soa.sgr[column];
+    cell.foreground = rawColor(attrs.foregroundColor);
+    cell.background = rawColor(attrs.backgroundColor);
+    cell.underlineColor = rawColor(attrs.underlineColor);
+    cell.flags = static_cast<uint32_t>(attrs.flags.value());
     return cell;
 }
 
@@ -46,6 +46,8 @@ struct WatcherHarness
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        vtbackend::Settings {},
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false };
     int shutdowns = 0;
     LastSessionWatcher watcher { host, loop, [this] { ++shutdowns; } };
@@ -157,6 +159,8 @@ TEST_CASE("the last session's exit unwinds the daemon's accept loop", "[vthost][
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
 
     auto listener = net::listenUnix(loop, socketPath);
@@ -213,6 +217,8 @@ TEST_CASE("the watcher unsubscribes itself before the host outlives it", "[vthos
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     auto shutdowns = 0;
     {
@@ -4,6 +4,8 @@
 #include <vtbackend/Image.hpp>
 #include <vtbackend/Line.hpp>
 
+#include <crispy/TraceEvents.hpp>
+
 #include <algorithm>
 #include <bit>
 #include <chrono>
@@ -27,6 +29,10 @@
 #include <vtworkspace/Pane.hpp>
 #include <vtworkspace/Tab.hpp>
 
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
 namespace vthost
 {
 
@@ -144,19 +150,47 @@ NativeSession::NativeSession(net::EventLoop& loop,
     _layoutObserver.onChange = [this] {
         pushLayout();
     };
+
+    if (auto* metrics = _host.metrics())
+    {
+        _metrics = metrics->addConnection(_id, [this] { return _writer.queuedBytes(); });
+    }
 }
 
-void NativeSession::send(uint64_t serial, proto::DecodedPdu const& pdu, uint64_t sessionTag)
+void NativeSession::send(uint64_t serial, proto::DecodedPdu const& pdu, uint64_t sessionTag, int fd)
 {
     if (_closed)
+    {
+#ifndef _WIN32
+        if (fd >= 0)
+            ::close(fd);
+#endif
         return;
+    }
+    // Traced for the session the frame describes; a frame describing none is not traced.
+    auto scope = crispy::trace::Scope { _host.traceRecorder(SessionId { sessionTag }), "daemon", "send" };
     auto sink = proto::Writer {};
     proto::encodePdu(sink, serial, pdu);
     auto const bytes = sink.view();
+    scope.setArgument("bytes", static_cast<int64_t>(bytes.size()));
     if (protocolTraceLog)
         protocolTraceLog()("{} {}", _id, proto::traceLine(proto::Direction::Send, serial, pdu, bytes.size()));
-    if (!_writer.enqueue(std::string { reinterpret_cast<char const*>(bytes.data()), bytes.size() },
-                         sessionTag))
+
+    // What crosses the socket: the frame itself, or only where the shared segment holds it.
+    auto wire = bytes;
+    auto notice = proto::Writer {};
+    if (auto const shared = shareDelta(pdu, bytes))
+    {
+        auto const announced = proto::DecodedPdu { *shared };
+        proto::encodePdu(notice, serial, announced);
+        wire = notice.view();
+        if (protocolTraceLog)
+            protocolTraceLog()(
+                "{} {}", _id, proto::traceLine(proto::Direction::Send, serial, announced, wire.size()));
+    }
+    auto frame = std::string { reinterpret_cast<char const*>(wire.data()), wire.size() };
+    if (!(fd >= 0 ? _writer.enqueueWithFd(std::move(frame), fd)
+                  : _writer.enqueue(std::move(frame), sessionTag)))
     {
         // The queue's overflow contract: a client too slow to drain the byte bound
         // is disconnected, not silently under-served — the delta cursor has already
@@ -170,7 +204,60 @@ void NativeSession::send(uint64_t serial, proto::DecodedPdu const& pdu, uint64_t
         _closed = true;
         _writer.close();
         _connection->close();
+        return;
+    }
+
+    if (_metrics)
+    {
+        if (auto const* delta = std::get_if<proto::Delta>(&pdu))
+        {
+            _metrics->deltaFrames.add();
+            _metrics->deltaBytes.add(bytes.size());
+            if (delta->snapshot != 0)
+                _metrics->snapshots.add();
+            if (auto const it = _inputAwaitingPush.find(sessionTag); it != _inputAwaitingPush.end())
+            {
+                _metrics->inputToPushSeconds.observe(std::chrono::steady_clock::now() - it->second);
+                _inputAwaitingPush.erase(it);
+            }
+        }
+    }
+}
+
+std::optional<proto::SharedDelta> NativeSession::shareDelta(proto::DecodedPdu const& pdu,
+                                                             std::span<std::byte const> frame)
+{
+    if (!_sharedRing || frame.size() < SharedRing::MinFrameBytes
+        || !std::holds_alternative<proto::Delta>(pdu))
+        return std::nullopt;
+    // No room means the client has not applied what is already there. The socket carries this
+    // one as it always did; the segment is used again once the client releases some of it.
+    auto const offset = _sharedRing->write(frame);
+    if (!offset)
+        return std::nullopt;
+    return proto::SharedDelta { .offset = *offset, .length = static_cast<uint32_t>(frame.size()) };
+}
+
+int NativeSession::offerSharedRing(proto::ClientHello const& hello)
+{
+    if (!hello.sharedMemory)
+        return -1;
+    if (!_connection->passesDescriptors())
+    {
+        connectionLog()("{}: shared memory declined: this transport cannot pass the segment", _id);
+        return -1;
+    }
+    auto ring = SharedRing::create(SharedRing::DefaultBytes);
+    if (!ring)
+    {
+        errorLog()("{}: shared memory declined: {}", _id, ring.error());
+        return -1;
     }
+    auto const fd = ring->releaseDescriptor();
+    _sharedRing = std::move(*ring);
+    connectionLog()(
+        "{}: large updates go through a {} KiB shared segment", _id, _sharedRing->capacity() / 1024);
+    return fd;
 }
 
 void NativeSession::sessionScreenUpdated(SessionId session)
@@ -188,6 +275,7 @@ void NativeSession::sessionClosed(SessionId session)
 {
     _followed.erase(session.value);
     _pendingSessions.erase(session.value);
+    _inputAwaitingPush.erase(session.value);
 }
 
 void NativeSession::sessionResized(SessionId session)
@@ -257,13 +345,18 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
                                      uint8_t screenTypeValue,
                                      bool snapshot)
 {
+    // A resumed mirror holds whatever the previous connection last told it, which this one never
+    // saw: every value below goes out as changed once, defaults included, rather than diffed
+    // against a record of what was sent that does not exist.
+    auto const restate = std::exchange(follow.restate, false);
+
     // Live window title (OSC 0/2): the snapshot carries it in SessionState
     // below; an incremental delta carries it only when it changed since last
     // sent, so a title-only batch still re-titles the mirror. Compare the
     // string_view windowTitle() returns directly and allocate only when it
     // actually changed — the title almost never differs frame-to-frame, so a
     // per-delta heap copy just to compare it was pure waste under a busy PTY.
-    if (auto const title = terminal.windowTitle(); title != follow.lastTitle)
+    if (auto const title = terminal.windowTitle(); restate || title != follow.lastTitle)
     {
         if (!snapshot)
         {
@@ -278,7 +371,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     auto const cursorPs = decscusrPs(terminal.cursorShape(), terminal.cursorDisplay());
     auto const cursorShapePs =
         static_cast<int>(cursorPs); // widened to diff against the -1 "unknown" sentinel
-    if (cursorShapePs != follow.lastCursorShape)
+    if (restate || cursorShapePs != follow.lastCursorShape)
     {
         if (!snapshot)
         {
@@ -291,7 +384,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     // Live working directory (OSC 7): pull+diff; the snapshot carries it in
     // SessionState below. Only propagate once one was actually set.
     auto const& cwd = terminal.currentWorkingDirectory();
-    if (!cwd.empty() && (!follow.cwdKnown || cwd != follow.lastCwd))
+    if (!cwd.empty() && (restate || !follow.cwdKnown || cwd != follow.lastCwd))
     {
         if (!snapshot)
         {
@@ -307,7 +400,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     auto const& colors = terminal.colorPalette();
     auto const fg = static_cast<int>(colors.defaultForeground.value());
     auto const bg = static_cast<int>(colors.defaultBackground.value());
-    if (fg != follow.lastDefaultForeground || bg != follow.lastDefaultBackground)
+    if (restate || fg != follow.lastDefaultForeground || bg != follow.lastDefaultBackground)
     {
         if (!snapshot)
         {
@@ -323,7 +416,8 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     // multi-page support: which status line is shown and where the app writes.
     auto const statusType = static_cast<int>(std::to_underlying(terminal.statusDisplayType()));
     auto const activeStatus = static_cast<int>(std::to_underlying(terminal.activeStatusDisplay()));
-    if (statusType != follow.lastStatusDisplayType || activeStatus != follow.lastActiveStatusDisplay)
+    if (restate || statusType != follow.lastStatusDisplayType
+        || activeStatus != follow.lastActiveStatusDisplay)
     {
         if (!snapshot)
         {
@@ -345,7 +439,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
         for (auto const i: std::views::iota(0, unbox<int>(statusGrid.pageSize().lines)))
             rows.push_back(toWireLine(
                 statusGrid, vtbackend::LineOffset(i), statusGrid.lineAt(vtbackend::LineOffset(i))));
-        if (snapshot || rows != follow.lastStatusLines)
+        if (snapshot || restate || rows != follow.lastStatusLines)
         {
             delta.statusLinesChanged = 1;
             delta.statusLines = rows;
@@ -358,7 +452,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     // it to send input the way the app negotiated. Only the effective (current)
     // flags matter to a mirror — the stack itself stays server-side.
     auto const kittyFlags = static_cast<int>(terminal.keyboardProtocol().flags().value());
-    if (kittyFlags != follow.lastKittyKeyboardFlags)
+    if (restate || kittyFlags != follow.lastKittyKeyboardFlags)
     {
         if (!snapshot)
         {
@@ -372,7 +466,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     // uses to ask for modified keys as escape sequences. Mirrored for the same reason as
     // the Kitty flags: the client's InputGenerator, not the server's, encodes the keys.
     auto const modifyOtherKeys = terminal.modifyOtherKeys();
-    if (modifyOtherKeys != follow.lastModifyOtherKeys)
+    if (restate || modifyOtherKeys != follow.lastModifyOtherKeys)
     {
         if (!snapshot)
         {
@@ -391,7 +485,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
         .transport = static_cast<uint8_t>(terminal.mouseTransport()),
         .wheelMode = static_cast<uint8_t>(terminal.mouseWheelMode()),
     };
-    if (mouse != follow.lastMouse)
+    if (restate || mouse != follow.lastMouse)
     {
         if (!snapshot)
         {
@@ -404,7 +498,7 @@ void NativeSession::collectLiveState(vtbackend::Terminal& terminal,
     // The progress indicator (OSC 9;4), pull+diff as one value: its two fields change together, and
     // the snapshot carries it in SessionState below so a re-attaching client sees a bar still in flight.
     auto const progress = terminal.progress();
-    if (progress != follow.lastProgress)
+    if (restate || progress != follow.lastProgress)
     {
         if (!snapshot)
         {
@@ -445,6 +539,7 @@ void NativeSession::pushDelta(SessionId session, bool forceSnapshot)
     auto* terminal = _host.terminal(session);
     if (terminal == nullptr)
         return;
+    auto const scope = crispy::trace::Scope { _host.traceRecorder(session), "daemon", "encodeDelta" };
     auto& follow = _followed[session.value];
 
     auto delta = proto::Delta {};
@@ -458,7 +553,7 @@ void NativeSession::pushDelta(SessionId session, bool forceSnapshot)
         // happen under the terminal's state lock — and so does every terminal
         // read below (pageSize/screenType/windowTitle mutate on the session's
         // pump thread; windowTitle() in particular is an unlocked reference).
-        auto const guard = std::lock_guard { *terminal };
+        auto const guard = vtbackend::Terminal::SiteLock { *terminal, vtbackend::LockSite::Mirror };
 
         // Mirror exactly what the fat GUI paints: the DISPLAYED page, which is what
         // the user sees. It coincides with the cursor page while DECPCCM couples
@@ -492,9 +587,15 @@ void NativeSession::pushDelta(SessionId session, bool forceSnapshot)
                 if (cell.hyperlink != 0 && referencedLinks.insert(cell.hyperlink).second)
                     hyperlinkIds.push_back(cell.hyperlink);
         };
+        // A margin scroll is sent as the shift it is, so the client moves the rows it already has
+        // rather than receiving every row of the region again.
+        auto const shift = [&](vtbackend::GridRowShift const& rowShift) {
+            delta.rowShifts.push_back(
+                proto::RowShift { .top = rowShift.top, .bottom = rowShift.bottom, .count = rowShift.count });
+        };
 
         // Both conditions mean the same thing: an incremental delta cannot describe this
-        // batch. forEachLineChangedSince scans back only as far as scrolledOutDepthSince,
+        // batch. forEachChangeSince scans back only as far as scrolledOutDepthSince,
         // which clamps at the scrollback floor — so rows that scrolled past the floor since
         // this connection last looked are unnameable, and a client scrolls every unreported
         // id through its page as a BLANK row. A snapshot leaves them honestly absent.
@@ -502,11 +603,12 @@ void NativeSession::pushDelta(SessionId session, bool forceSnapshot)
                                       && follow.cursor.stableBase < grid.stableRangeFloor();
         if (!snapshot
             && (cursorBelowFloor
-                || grid.forEachLineChangedSince(follow.cursor, collect)
+                || grid.forEachChangeSince(follow.cursor, shift, collect)
                        == vtbackend::GridDeltaResult::ResyncRequired))
             snapshot = true;
         if (snapshot)
         {
+            delta.rowShifts.clear();
             delta.lines.clear();
             delta.imageCells.clear();
             hyperlinkIds.clear();
@@ -627,6 +729,10 @@ void NativeSession::handlePdu(proto::DecodedFrame const& frame)
         }
         std::ignore = terminal->device().write(
             std::string_view { reinterpret_cast<char const*>(input->data.data()), input->data.size() });
+        // The oldest unanswered input is what the latency is measured from: a burst of keystrokes
+        // is answered by one delta, and it is the first keystroke that waited longest.
+        if (_metrics)
+            _inputAwaitingPush.try_emplace(input->session, std::chrono::steady_clock::now());
         return;
     }
     if (auto const* resize = std::get_if<proto::ResizeRequest>(&frame.pdu))
@@ -754,6 +860,14 @@ void NativeSession::handlePdu(proto::DecodedFrame const& frame)
         _host.handleSessionExit(vtworkspace::SessionId { close->session });
         return;
     }
+    if (auto const* release = std::get_if<proto::SharedRelease>(&frame.pdu))
+    {
+        if (!_sharedRing || !_sharedRing->release(release->offset))
+            errorLog()("{}: ignoring SharedRelease to {} (no segment, or not a position it reached)",
+                       _id,
+                       release->offset);
+        return;
+    }
     // Unknown/unexpected PDUs are ignored: forward compatibility with a newer peer. Recorded
     // all the same — "the daemon ignored what I sent" is otherwise indistinguishable from "the
     // daemon never received it".
@@ -790,7 +904,15 @@ bool NativeSession::completeHandshake(proto::DecodedFrame const& frame)
         send(frame.serial, proto::DecodedPdu { proto::ServerHello {} });
         return false;
     }
-    send(frame.serial, proto::DecodedPdu { proto::ServerHello {} });
+    // The segment's descriptor rides on the ServerHello, so the client holds it before it can be told
+    // of anything written there.
+    auto const sharedFd = offerSharedRing(*hello);
+    send(frame.serial,
+         proto::DecodedPdu { proto::ServerHello {
+             .instance = _host.instance(),
+             .sharedBytes = _sharedRing ? static_cast<uint32_t>(_sharedRing->capacity()) : 0 } },
+         /*sessionTag=*/0,
+         sharedFd);
     _handshaken = true;
     connectionLog()("{}: handshake complete (codec v{})", _id, proto::CodecVersion);
 
@@ -810,20 +932,58 @@ bool NativeSession::completeHandshake(proto::DecodedFrame const& frame)
         std::ignore = _host.createTab(spawnRequest());
     }
 
+    if (!hello->resume.empty())
+    {
+        auto const resumed = adoptResumeCursors(*hello);
+        connectionLog()("{}: resuming {} of {} mirrored sessions", _id, resumed, hello->resume.size());
+    }
+
     // The window/tab/pane layout first, so the client builds its tabs and split
     // trees before the per-session content streams into them.
     pushLayout();
 
-    // The attach snapshot: every hosted session of every window, full state.
+    // The attach push: every hosted session of every window. Not forced to a snapshot, so that a
+    // resumed session gets only what changed; any other session was never pushed on this
+    // connection, and its first push is a snapshot regardless.
     _host.model().forEachTab([this](vtworkspace::Window&, vtworkspace::Tab& tab) {
         tab.rootPane()->walkTree([&](vtworkspace::Pane& pane) {
             if (pane.isLeaf())
-                pushDelta(pane.session(), /*forceSnapshot=*/true);
+                pushDelta(pane.session(), /*forceSnapshot=*/false);
         });
     });
     return true;
 }
 
+std::size_t NativeSession::adoptResumeCursors(proto::ClientHello const& hello)
+{
+    if (hello.resumeInstance != _host.instance())
+        return 0;
+
+    auto adopted = std::size_t { 0 };
+    for (auto const& resume: hello.resume)
+    {
+        auto* terminal = _host.terminal(SessionId { resume.session });
+        if (terminal == nullptr)
+            continue;
+        auto const guard = vtbackend::Terminal::SiteLock { *terminal, vtbackend::LockSite::Mirror };
+        auto& grid = terminal->displayedPage().grid();
+        // The cursor is the peer's claim, so each part of it is checked against the grid rather
+        // than trusted: a seqno past the stream head is one this grid never handed out.
+        if (terminal->displayedPageIndex() != vtbackend::PageIndex(0)
+            || resume.generation != grid.generation() || resume.seqno > grid.seqno()
+            || resume.stableBase < grid.stableRangeFloor())
+            continue;
+        auto& follow = _followed[resume.session];
+        follow.cursor = vtbackend::GridDeltaCursor {
+            .generation = resume.generation, .seqno = resume.seqno, .stableBase = resume.stableBase
+        };
+        follow.lastDisplayedPage = vtbackend::PageIndex(0);
+        follow.restate = true;
+        ++adopted;
+    }
+    return adopted;
+}
+
 void NativeSession::reportPumpOutcome(PumpResult const& outcome) const
 {
     if (auto const reason = describe(outcome))
@@ -9,17 +9,22 @@
 /// snapshot Delta per hosted session), then per-line deltas driven by the
 /// host's screen-updated signal, debounced so bursts coalesce into one Delta.
 /// Grid rows are addressed by stable id; a generation change triggers one
-/// resync snapshot. Hyperlink URIs ship once per connection on first
-/// reference; image pixels only on FetchImage.
+/// resync snapshot. A reconnecting client names the cursors it still holds in
+/// its ClientHello and gets only what changed since, where the grid can still
+/// describe it. Hyperlink URIs ship once per connection on first reference;
+/// image pixels only on FetchImage. A same-host client that asks gets the
+/// large deltas through a shared segment instead (@see SharedRing).
 
 #include <vtbackend/Primitives.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -32,6 +37,7 @@
 #include <vthost/ConnectionAcceptor.hpp>
 #include <vthost/PduPump.hpp>
 #include <vthost/SessionHost.hpp>
+#include <vthost/SharedRing.hpp>
 #include <vthost/proto/Pdu.hpp>
 
 namespace vthost
@@ -193,6 +199,10 @@ class NativeSession final: public SessionStreamEvents
         /// its two fields change together and mean nothing apart. Zero here is likewise the genuine
         /// state of a fresh terminal ("nothing shown"), not an "unknown" sentinel.
         vtbackend::Progress lastProgress {};
+
+        /// Set when the cursor was adopted from the client's resume request rather than earned by a
+        /// snapshot: the next delta restates every live value (@see collectLiveState).
+        bool restate = false;
     };
 
     void handlePdu(proto::DecodedFrame const& frame);
@@ -203,7 +213,21 @@ class NativeSession final: public SessionStreamEvents
     /// @param sessionTag The session this frame describes, or 0 when it describes none
     ///        (hello, layout). A later snapshot for the same session supersedes the
     ///        tagged ones still unwritten — @see net::WriteQueue::dropTagged.
-    void send(uint64_t serial, proto::DecodedPdu const& pdu, uint64_t sessionTag = 0);
+    /// @param fd A descriptor to pass along with the frame (ownership transferred), or -1.
+    ///        Such a frame is never dropped for a later snapshot.
+    void send(uint64_t serial, proto::DecodedPdu const& pdu, uint64_t sessionTag = 0, int fd = -1);
+
+    /// Creates this connection's shared segment when the client asked for one and the transport
+    /// can pass it (@see SharedRing). Declining is never an error: everything then travels over
+    /// the socket.
+    /// @return The segment's descriptor to send with the ServerHello, or -1 when declined.
+    [[nodiscard]] int offerSharedRing(proto::ClientHello const& hello);
+
+    /// Places an encoded Delta @p frame in the shared segment, when there is one, the frame is
+    /// large enough to be worth it and the segment has room.
+    /// @return What to send over the socket in the frame's place, or nullopt to send it as is.
+    [[nodiscard]] std::optional<proto::SharedDelta> shareDelta(proto::DecodedPdu const& pdu,
+                                                               std::span<std::byte const> frame);
 
     /// Records why this connection's read loop ended.
     ///
@@ -230,6 +254,15 @@ class NativeSession final: public SessionStreamEvents
     /// @return False when the hello was missing or version-mismatched.
     [[nodiscard]] bool completeHandshake(proto::DecodedFrame const& frame);
 
+    /// Seeds the follow state of each session the client asked to resume, so the attach push sends
+    /// it only what changed since (@see proto::ClientHello::resume).
+    ///
+    /// A cursor is adopted only when the grid can still honor it: this daemon instance, a session
+    /// still hosted with its primary page displayed, the same generation, a seqno the stream reached
+    /// and a base at or above the scrollback floor. Any other session gets the usual snapshot.
+    /// @return How many cursors were adopted.
+    std::size_t adoptResumeCursors(proto::ClientHello const& hello);
+
     /// Sends SessionState + a snapshot/delta for @p session (under its lock).
     void pushDelta(vtworkspace::SessionId session, bool forceSnapshot);
 
@@ -274,6 +307,13 @@ class NativeSession final: public SessionStreamEvents
     LayoutObserver _layoutObserver;
     std::unordered_map<uint64_t, FollowState> _followed;
     std::unordered_set<uint64_t> _pendingSessions;
+    /// This connection's series; null unless the daemon serves metrics.
+    std::shared_ptr<ConnectionMetrics> _metrics;
+    /// Where large Deltas go for a same-host client that asked; nullopt otherwise.
+    std::optional<SharedRing> _sharedRing;
+    /// Per session: when this client's oldest input not yet answered by a delta arrived. Only
+    /// kept while metrics are served.
+    std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> _inputAwaitingPush;
     bool _flushScheduled = false;
     bool _handshaken = false;
     bool _closed = false;
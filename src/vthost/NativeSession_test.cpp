@@ -20,11 +20,13 @@
 
 #include <coro/WhenAll.hpp>
 #include <net/EventLoop.hpp>
+#include <net/IoResult.hpp>
 #include <net/PollEventSource.hpp>
 #include <net/testing/CoroTestSupport.hpp>
 #include <net/testing/InMemoryTransport.hpp>
 #include <vthost/NativeSession.hpp>
 #include <vthost/SessionHost.hpp>
+#include <vthost/SharedRing.hpp>
 #include <vthost/TappingPty.hpp>
 #include <vtworkspace/Pane.hpp>
 #include <vtworkspace/Tab.hpp>
@@ -47,7 +49,11 @@ Task<void> feedBytes(net::ISocket* client, std::vector<std::byte> const* bytes)
 
 /// Decodes server PDUs until @p expected arrived (or the stream ended), then
 /// closes the client end — the session's read loop sees EOF and finishes.
-Task<void> collectPdus(net::ISocket* client, std::size_t expected, std::vector<proto::DecodedFrame>* out)
+/// @param fd When set, receives the descriptor the server passed along (the caller owns it).
+Task<void> collectPdus(net::ISocket* client,
+                       std::size_t expected,
+                       std::vector<proto::DecodedFrame>* out,
+                       int* fd = nullptr)
 {
     auto buffer = std::vector<std::byte> {};
     auto scratch = std::array<std::byte, 4096> {};
@@ -62,7 +68,16 @@ Task<void> collectPdus(net::ISocket* client, std::size_t expected, std::vector<p
         }
         if (decoded.error() != proto::DecodeError::NeedMoreData)
             break;
-        auto const n = co_await client->read(scratch);
+        auto n = net::IoResult {};
+        if (fd)
+        {
+            auto const received = co_await client->readWithFd(scratch);
+            if (received && received->fd >= 0)
+                *fd = received->fd;
+            n = received ? net::IoResult { received->bytesRead } : std::unexpected(received.error());
+        }
+        else
+            n = co_await client->read(scratch);
         if (!n.has_value() || *n == 0)
             break;
         buffer.insert(buffer.end(), scratch.begin(), scratch.begin() + static_cast<long>(*n));
@@ -130,6 +145,8 @@ struct NativeHarness
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        hostSettings(options.history),
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false };
     net::testing::SocketPair pair = *net::testing::makeSocketPair(loop);
     std::unique_ptr<NativeSession> session =
@@ -248,6 +265,8 @@ struct TwoClientHarness
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        hostSettings(vtbackend::LineCount(0)),
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false };
     net::testing::SocketPair firstPair = *net::testing::makeSocketPair(loop);
     net::testing::SocketPair secondPair = *net::testing::makeSocketPair(loop);
@@ -339,6 +358,7 @@ TEST_CASE("the native handshake answers ServerHello and a full snapshot", "[vtho
     auto const* hello = std::get_if<proto::ServerHello>(&received[0].pdu);
     REQUIRE(hello != nullptr);
     CHECK(hello->codecVersion == proto::CodecVersion);
+    CHECK(hello->sharedBytes == 0); // nothing offered to a client that did not ask
 
     // The layout leads the snapshot so the client builds its tabs before content.
     auto const* layout = std::get_if<proto::LayoutState>(&received[1].pdu);
@@ -400,6 +420,50 @@ TEST_CASE("the attach snapshot carries scrollback that predates the attach", "[v
     CHECK(carries("row-39"));
 }
 
+#ifndef _WIN32
+TEST_CASE("a same-host client gets a large snapshot through the shared segment", "[vthost][native][shm]")
+{
+    auto h = NativeHarness { { .history = vtbackend::LineCount(200) } };
+    h.host.createTab();
+    auto const sessionId = h.host.model().window(h.host.windowId())->activeTab()->rootPane()->session();
+    auto lines = std::string {};
+    for (auto const i: std::views::iota(0, 200))
+        lines += std::format("row-{}.{}\r\n", i, std::string(60, '.'));
+    h.host.terminal(sessionId)->writeToScreen(lines);
+
+    // Expect: ServerHello (with the segment), LayoutState, SessionState, SharedDelta.
+    auto const request = encodeRequest({ proto::ClientHello { .sharedMemory = true } });
+    auto received = std::vector<proto::DecodedFrame> {};
+    auto fd = -1;
+    h.loop.blockOn(coro::whenAll(h.session->run(),
+                                 feedBytes(h.pair.second.get(), &request),
+                                 collectPdus(h.pair.second.get(), 4, &received, &fd)));
+    REQUIRE(received.size() == 4);
+
+    auto const* hello = std::get_if<proto::ServerHello>(&received[0].pdu);
+    REQUIRE(hello != nullptr);
+    CHECK(hello->sharedBytes == vthost::SharedRing::DefaultBytes);
+    REQUIRE(fd >= 0);
+    auto ring = vthost::SharedRing::map(fd, hello->sharedBytes);
+    REQUIRE(ring.has_value());
+
+    // The socket carried only where the snapshot is; the segment holds the very frame it replaced.
+    auto const* notice = std::get_if<proto::SharedDelta>(&received[3].pdu);
+    REQUIRE(notice != nullptr);
+    CHECK(received[3].consumed < 64);
+    auto const frame = ring->read(notice->offset, notice->length);
+    REQUIRE(frame.has_value());
+    auto const decoded = proto::decodePdu(*frame);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->consumed == notice->length);
+    auto const* delta = std::get_if<proto::Delta>(&decoded->pdu);
+    REQUIRE(delta != nullptr);
+    CHECK(delta->snapshot == 1);
+    CHECK(std::ranges::any_of(delta->lines,
+                              [](auto const& line) { return textOf(line).starts_with("row-0."); }));
+}
+#endif
+
 TEST_CASE("a row's trailing fill cells do not travel", "[vthost][native]")
 {
     // The mirror clears every row under its fill before writing the cells it received, so
@@ -844,6 +908,8 @@ TEST_CASE("a token mismatch is reported without either token", "[vthost][native]
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     auto pair = *net::testing::makeSocketPair(loop);
     auto session = std::make_unique<NativeSession>(
@@ -1072,3 +1138,100 @@ TEST_CASE("a resize one client asked for resyncs EVERY attached client", "[vthos
     // second client had simply attached late, after the resize.
     CHECK(sessionStateCount(fromTwo) == 2);
 }
+
+namespace
+{
+/// Runs one whole connection of @p h: feeds @p pdus, drains the answer, disconnects.
+/// @return Every PDU the server sent.
+std::vector<proto::DecodedFrame> attachOnce(TwoClientHarness& h,
+                                            NativeSession& server,
+                                            net::ISocket& client,
+                                            std::vector<proto::DecodedPdu> const& pdus)
+{
+    auto const bytes = encodeRequest(pdus);
+    auto received = std::vector<proto::DecodedFrame> {};
+    h.loop.blockOn(net::testing::allOf(server.run(),
+                                       feedAfter(&h.loop, &client, &bytes, 0ms),
+                                       closeAfter(&h.loop, &client, 60ms),
+                                       collectPdus(&client, 1000, &received)));
+    return received;
+}
+
+/// @return The first Delta in @p frames, or nullptr if there is none.
+[[nodiscard]] proto::Delta const* firstDelta(std::vector<proto::DecodedFrame> const& frames)
+{
+    for (auto const& frame: frames)
+        if (auto const* delta = std::get_if<proto::Delta>(&frame.pdu))
+            return delta;
+    return nullptr;
+}
+} // namespace
+
+TEST_CASE("a reconnecting client resumes with only what changed", "[vthost][native]")
+{
+    auto h = TwoClientHarness {};
+    h.host.createTab();
+    auto const sessionId = h.host.model().window(h.host.windowId())->activeTab()->rootPane()->session();
+    h.host.terminal(sessionId)->writeToScreen("before the drop\r\n");
+
+    auto const first = attachOnce(h, *h.serverOne, *h.firstPair.second, { proto::ClientHello {} });
+    REQUIRE(!first.empty());
+    auto const* hello = std::get_if<proto::ServerHello>(&first.front().pdu);
+    REQUIRE(hello != nullptr);
+    CHECK(hello->instance == h.host.instance());
+    auto const* snapshot = firstDelta(first);
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->snapshot == 1);
+
+    // Output the client missed while it was away.
+    h.host.terminal(sessionId)->writeToScreen("after the drop");
+
+    auto const second = attachOnce(h,
+                                   *h.serverTwo,
+                                   *h.secondPair.second,
+                                   { proto::ClientHello {
+                                       .resumeInstance = hello->instance,
+                                       .resume = { proto::ResumeCursor {
+                                           .session = sessionId.value,
+                                           .generation = snapshot->generation,
+                                           .seqno = snapshot->seqno,
+                                           .stableBase = snapshot->stableViewportBase } } } });
+    // No SessionState: the live values ride the delta as changes instead.
+    CHECK(sessionStateCount(second) == 0);
+    auto const* resumed = firstDelta(second);
+    REQUIRE(resumed != nullptr);
+    CHECK(resumed->snapshot == 0);
+    REQUIRE(resumed->lines.size() == 1);
+    CHECK(textOf(resumed->lines.front()) == "after the drop");
+    // Restated even though nothing about them changed: this connection never sent them.
+    CHECK(resumed->colorsChanged == 1);
+    CHECK(resumed->mouseChanged == 1);
+}
+
+TEST_CASE("a resume cursor from another daemon instance gets a snapshot", "[vthost][native]")
+{
+    // Session ids, generations and seqnos all restart with the daemon, so this cursor names a
+    // position the grid really has — it is the instance alone that says it was not this grid's.
+    auto h = TwoClientHarness {};
+    h.host.createTab();
+    auto const sessionId = h.host.model().window(h.host.windowId())->activeTab()->rootPane()->session();
+
+    auto const first = attachOnce(h, *h.serverOne, *h.firstPair.second, { proto::ClientHello {} });
+    auto const* snapshot = firstDelta(first);
+    REQUIRE(snapshot != nullptr);
+
+    auto const second = attachOnce(h,
+                                   *h.serverTwo,
+                                   *h.secondPair.second,
+                                   { proto::ClientHello {
+                                       .resumeInstance = h.host.instance() + 1,
+                                       .resume = { proto::ResumeCursor {
+                                           .session = sessionId.value,
+                                           .generation = snapshot->generation,
+                                           .seqno = snapshot->seqno,
+                                           .stableBase = snapshot->stableViewportBase } } } });
+    CHECK(sessionStateCount(second) == 1);
+    auto const* delta = firstDelta(second);
+    REQUIRE(delta != nullptr);
+    CHECK(delta->snapshot == 1);
+}
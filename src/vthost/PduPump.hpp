@@ -105,9 +105,13 @@ struct PumpResult
 /// @param socket The transport to read from (not owned; a pointer, since
 ///        coroutine reference parameters can dangle).
 /// @param handler Consumes one decoded frame; false stops the pump.
+/// @param onFd When set, the socket is read with `readWithFd`, and each descriptor that arrives is
+///        handed to it (ownership included) before any frame of the chunk it came with is decoded.
+///        A descriptor sent with a frame thus always reaches it before that frame does.
 /// @return Why the loop ended.
 [[nodiscard]] inline coro::Task<PumpResult> pumpPdus(net::ISocket* socket,
-                                                     std::function<bool(proto::DecodedFrame const&)> handler)
+                                                     std::function<bool(proto::DecodedFrame const&)> handler,
+                                                     std::function<void(int fd)> onFd = {})
 {
     auto buffer = std::vector<std::byte> {};
     auto consumed = std::size_t { 0 };
@@ -124,7 +128,10 @@ struct PumpResult
             if (decoded.error() != proto::DecodeError::NeedMoreData)
                 co_return PumpResult::protocolError(decoded.error());
 
-            auto const appended = co_await net::appendReadChunk(socket, &buffer);
+            auto fd = -1;
+            auto const appended = co_await net::appendReadChunk(socket, &buffer, onFd ? &fd : nullptr);
+            if (fd >= 0)
+                onFd(fd);
             if (!appended)
                 co_return PumpResult::transportFailure(appended.error());
             if (*appended == 0)
@@ -1,12 +1,17 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <vthost/SessionHost.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <format>
 #include <mutex>
+#include <random>
 #include <ranges>
 #include <utility>
 #include <vector>
 
+#include <crispy/TraceEvents.hpp>
+
 #include <vthost/Logging.hpp>
 #include <vthost/SessionSettings.hpp>
 #include <vthost/TappingPty.hpp>
@@ -29,23 +34,31 @@ using vtworkspace::WindowId;
 
 HostedSession::HostedSession(SessionId id,
                              crispy::Environment const& env,
+                             std::optional<std::filesystem::path> traceFile,
                              std::unique_ptr<vtpty::Pty> pty,
                              vtbackend::Settings settings,
                              std::function<void()> onScreenUpdated,
                              std::function<void()> onBell,
                              std::function<void(std::string, std::string)> onNotify,
                              std::function<void(std::string)> onCopyToClipboard,
-                             std::function<void()> onClosed):
+                             std::function<void()> onClosed,
+                             std::shared_ptr<SessionMetrics> metrics):
     _id(id),
+    _traceFile(std::move(traceFile)),
+    _traceRecorder(std::format("session {}", id.value)),
     _events(std::move(onScreenUpdated), std::move(onBell), std::move(onNotify), std::move(onCopyToClipboard)),
-    _terminal(_events, env, std::move(pty), std::move(settings), std::chrono::steady_clock::now()),
-    _onClosed(std::move(onClosed))
+    _terminal(
+        _events, env, &_traceRecorder, std::move(pty), std::move(settings), std::chrono::steady_clock::now()),
+    _onClosed(std::move(onClosed)),
+    _metrics(std::move(metrics))
 {
     // DECSSDT 2 only REQUESTS the host-writable status line; the frontend decides.
     // The daemon honors it (the GUI does the same), so an app's status line works.
     _events.onShowHostWritableStatusLine = [this] {
         _terminal.setStatusDisplay(vtbackend::StatusDisplayType::HostWritable);
     };
+    if (_traceFile)
+        _traceRecorder.start();
 }
 
 HostedSession::~HostedSession()
@@ -53,6 +66,14 @@ HostedSession::~HostedSession()
     terminate();
     if (_pumpThread && _pumpThread->joinable())
         _pumpThread->join();
+
+    if (_traceFile)
+    {
+        _traceRecorder.stop();
+        auto const path = crispy::trace::sessionTracePath(*_traceFile, _id.value);
+        if (auto const written = _traceRecorder.writeJson(path); !written)
+            errorLog()("session {}: cannot write its trace: {}", _id.value, written.error());
+    }
 }
 
 void HostedSession::start()
@@ -98,8 +119,13 @@ void HostedSession::pumpLoop()
     // SIGTERM as soon as it hosted a single session. The GUI's mainLoop ends for the same reason,
     // via its own `_terminating` flag; deriving the condition from the device instead keeps
     // one source of truth, since the device is what terminate() actually mutates.
+    crispy::trace::setThreadName(std::format("pty session {}", _id.value));
     while (!_terminal.device().isClosed() && _terminal.processInputOnce())
+    {
+        if (_metrics)
+            _metrics->batchProcessed();
         _terminal.flushInput();
+    }
     if (_onClosed)
         _onClosed();
 }
@@ -107,10 +133,23 @@ void HostedSession::pumpLoop()
 // ---------------------------------------------------------------------------
 // SessionHost
 
+namespace
+{
+    /// A fresh, non-zero host instance id (@see SessionHost::instance).
+    [[nodiscard]] uint64_t mintInstance()
+    {
+        auto device = std::random_device {};
+        auto const instance = (uint64_t { device() } << 32) | uint64_t { device() };
+        return instance != 0 ? instance : 1;
+    }
+} // namespace
+
 SessionHost::SessionHost(net::EventLoop& loop,
                          PtyFactory ptyFactory,
                          vtbackend::Settings settings,
                          crispy::Environment const& env,
+                         DaemonMetrics* metrics,
+                         std::optional<std::filesystem::path> traceFile,
                          bool startPumps,
                          ClientSizePolicy sizePolicy):
     _loop(loop),
@@ -122,6 +161,9 @@ SessionHost::SessionHost(net::EventLoop& loop,
     _pageSize(_settings.pageSize),
     _startPumps(startPumps),
     _sizePolicy(sizePolicy),
+    _metrics(metrics),
+    _traceFile(std::move(traceFile)),
+    _instance(mintInstance()),
     _model(*this,
            [this]() -> SessionId {
                // The allocator hand-back half of the pre-mint handshake (the GUI's
@@ -158,9 +200,29 @@ std::optional<SessionId> SessionHost::seedSession(SessionSpawnRequest const& req
         return std::nullopt;
     }
 
+    // Sampled at scrape time, on the loop thread, which is also the only thread that adds or destroys a
+    // session: a gauge finds the session's terminal, or no session at all.
+    auto gauges = SessionGauges {
+        .imageBytes =
+            [this, id] {
+                auto const* terminal = this->terminal(id);
+                return terminal ? terminal->imagePool().liveBytes() : std::size_t { 0 };
+            },
+    };
+#if defined(CONTOUR_PERF_STATS)
+    gauges.lockStats = [this, id]() -> vtbackend::LockStats const* {
+        auto const* terminal = this->terminal(id);
+        return terminal ? &terminal->lockStats() : nullptr;
+    };
+#endif
+    auto metrics = _metrics ? _metrics->addSession(id.value, std::move(gauges)) : nullptr;
+
     // The control-mode byte tap: fires on the session's PUMP thread with a view
     // into the read buffer, so the bytes are copied before crossing to the loop.
-    auto tapped = std::make_unique<TappingPty>(std::move(pty), [this, id](std::string_view data) {
+    // Every read passes through it, which also makes it where the PTY byte count is taken.
+    auto tapped = std::make_unique<TappingPty>(std::move(pty), [this, id, metrics](std::string_view data) {
+        if (metrics)
+            metrics->chunkRead(data.size());
         _loop.post([this, id, copy = std::string { data }] {
             if (!_sessions.contains(id.value))
                 return;
@@ -185,6 +247,7 @@ std::optional<SessionId> SessionHost::seedSession(SessionSpawnRequest const& req
     auto session = std::make_unique<HostedSession>(
         id,
         _environment,
+        _traceFile,
         std::move(tapped),
         std::move(settings),
         /*onScreenUpdated=*/
@@ -226,7 +289,8 @@ std::optional<SessionId> SessionHost::seedSession(SessionSpawnRequest const& req
             });
         },
         /*onClosed=*/
-        [this, id] { _loop.post([this, id] { handleSessionExit(id); }); });
+        [this, id] { _loop.post([this, id] { handleSessionExit(id); }); },
+        metrics);
 
     if (_startPumps)
         session->start();
@@ -361,7 +425,7 @@ SizeChange SessionHost::applyPaneSize(vtworkspace::SessionId session, vtpty::Pag
 SizeChange SessionHost::resizeLocked(SessionId session, vtbackend::Terminal& backing, vtpty::PageSize size)
 {
     {
-        auto const guard = std::lock_guard { backing };
+        auto const guard = vtbackend::Terminal::SiteLock { backing, vtbackend::LockSite::Configure };
         // Ask the terminal what this request becomes rather than comparing the raw request:
         // resizeScreen clamps it (a total page must leave room for the status line), so a size
         // that differs from the current one can still be a no-op once clamped.
@@ -410,6 +474,28 @@ vtbackend::Terminal* SessionHost::terminal(SessionId session) noexcept
     return it != _sessions.end() ? &it->second->terminal() : nullptr;
 }
 
+crispy::trace::Recorder* SessionHost::traceRecorder(SessionId session) noexcept
+{
+    auto const it = _sessions.find(session.value);
+    return it != _sessions.end() ? &it->second->traceRecorder() : nullptr;
+}
+
+std::string SessionHost::traceJson() const
+{
+    // In the order the sessions were created, rather than the map's.
+    auto ids = std::vector<uint64_t> {};
+    ids.reserve(_sessions.size());
+    for (auto const& [id, session]: _sessions)
+        ids.push_back(id);
+    std::ranges::sort(ids);
+
+    auto recorders = std::vector<crispy::trace::Recorder const*> {};
+    recorders.reserve(ids.size());
+    for (auto const id: ids)
+        recorders.push_back(&_sessions.at(id)->traceRecorder());
+    return crispy::trace::toJson(recorders);
+}
+
 void SessionHost::subscribe(vtworkspace::ModelEvents* observer)
 {
     _subscribers.push_back(observer);
@@ -20,7 +20,9 @@
 #include <vtpty/Pty.hpp>
 
 #include <crispy/Environment.hpp>
+#include <crispy/TraceEvents.hpp>
 
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -33,6 +35,7 @@
 // Part of this header's contract, not an implementation detail: the settings a host is constructed
 // with — and any a SessionSpawnRequest carries — are normalized through hostedSessionSettings.
 #include <vthost/ClientSizePolicy.hpp>
+#include <vthost/DaemonMetrics.hpp>
 #include <vthost/SessionSettings.hpp>
 #include <vtworkspace/ModelEvents.hpp>
 #include <vtworkspace/SessionModel.hpp>
@@ -120,17 +123,24 @@ class HostedSession
     /// @param onClosed Invoked on the PUMP thread once the PTY closed and the
     ///        pump loop ended (the host marshals it onto the loop).
     /// @param env The process environment the hosted terminal reads through.
+    /// @param traceFile Where the session's trace goes once it ends: when set, the terminal and its
+    ///        pump record from the start, and write to this path with the session's number appended.
+    /// @param metrics Where the pump reports its parse times, or nullptr when the daemon serves
+    ///        no metrics.
     HostedSession(vtworkspace::SessionId id,
                   crispy::Environment const& env,
+                  std::optional<std::filesystem::path> traceFile,
                   std::unique_ptr<vtpty::Pty> pty,
                   vtbackend::Settings settings,
                   std::function<void()> onScreenUpdated,
                   std::function<void()> onBell,
                   std::function<void(std::string, std::string)> onNotify,
                   std::function<void(std::string)> onCopyToClipboard,
-                  std::function<void()> onClosed);
+                  std::function<void()> onClosed,
+                  std::shared_ptr<SessionMetrics> metrics);
 
-    /// Joins the pump thread; the PTY must have been closed first (terminate()).
+    /// Joins the pump thread, then writes the trace if one is being recorded; the PTY must have been
+    /// closed first (terminate()).
     ~HostedSession();
 
     HostedSession(HostedSession const&) = delete;
@@ -148,6 +158,9 @@ class HostedSession
     [[nodiscard]] vtworkspace::SessionId id() const noexcept { return _id; }
     [[nodiscard]] vtbackend::Terminal& terminal() noexcept { return _terminal; }
 
+    /// @return This session's trace: its pump, and the connections' work on its behalf.
+    [[nodiscard]] crispy::trace::Recorder& traceRecorder() noexcept { return _traceRecorder; }
+
   private:
     /// The Terminal::Events glue: forwards the terminal events the daemon
     /// mirrors — the per-batch screen update, the bell, desktop notifications
@@ -211,9 +224,12 @@ class HostedSession
     void pumpLoop();
 
     vtworkspace::SessionId _id;
-    Events _events; ///< Must outlive _terminal (referenced by it).
+    std::optional<std::filesystem::path> _traceFile;
+    crispy::trace::Recorder _traceRecorder; ///< Must outlive _terminal (records into it).
+    Events _events;                         ///< Must outlive _terminal (referenced by it).
     vtbackend::Terminal _terminal;
     std::function<void()> _onClosed;
+    std::shared_ptr<SessionMetrics> _metrics; ///< Null unless the daemon serves metrics.
     std::unique_ptr<std::thread> _pumpThread;
 };
 
@@ -243,16 +259,22 @@ class SessionHost final: public vtworkspace::ModelEvents
     ///        @ref hostedSessionSettings — so a caller handing over a bare `vtbackend::Settings`
     ///        still gets a host whose sessions can be served, rather than one whose every scrolling
     ///        batch degenerates to a full snapshot.
+    /// @param env The process environment every session this host spawns reads through.
+    /// @param metrics Where each session registers its series, or nullptr when the daemon serves
+    ///        no metrics. Not owned; must outlive the host.
+    /// @param traceFile When set, every session records its trace from the start and writes it,
+    ///        once it ends, to this path with its number appended (@see HostedSession).
     /// @param startPumps Whether new sessions start their PTY pump thread
     ///        (disabled by tests that drive terminals directly).
     /// @param sizePolicy How the authoritative client area is resolved when several attached
     ///        clients report different ones. Fixed at construction: two differently-configured
     ///        daemons are two different daemons, not one in two states.
-    /// @param env The process environment every session this host spawns reads through.
     SessionHost(net::EventLoop& loop,
                 PtyFactory ptyFactory,
                 vtbackend::Settings settings,
                 crispy::Environment const& env,
+                DaemonMetrics* metrics,
+                std::optional<std::filesystem::path> traceFile,
                 bool startPumps = true,
                 ClientSizePolicy sizePolicy = ClientSizePolicy::Latest);
     ~SessionHost() override;
@@ -270,6 +292,22 @@ class SessionHost final: public vtworkspace::ModelEvents
     ///         preference onto the daemon's own settings need this as their base.
     [[nodiscard]] vtbackend::Settings const& settings() const noexcept { return _settings; }
 
+    /// @return The daemon's metrics, or nullptr when it serves none.
+    [[nodiscard]] DaemonMetrics* metrics() const noexcept { return _metrics; }
+
+    /// @return Where @p session is traced, or nullptr if it is unknown.
+    [[nodiscard]] crispy::trace::Recorder* traceRecorder(vtworkspace::SessionId session) noexcept;
+
+    /// @return The traces of every live session, merged into one Chrome trace-event JSON object.
+    [[nodiscard]] std::string traceJson() const;
+
+    /// @return A random value minted once per host, naming this daemon lifetime to clients.
+    ///
+    /// Session ids, grid generations and seqnos all start over when the daemon restarts, so a
+    /// reconnecting client's resume cursor could otherwise pass for one of a different session that
+    /// happens to reuse its id. Never 0, which the wire reserves for "no resume".
+    [[nodiscard]] uint64_t instance() const noexcept { return _instance; }
+
     /// @return The host's window (the daemon starts with exactly one).
     [[nodiscard]] vtworkspace::WindowId windowId() const noexcept { return _window; }
 
@@ -467,6 +505,9 @@ class SessionHost final: public vtworkspace::ModelEvents
     vtpty::PageSize _pageSize; ///< The RESOLVED authoritative client area (see pageSize()).
     bool _startPumps;
     ClientSizePolicy _sizePolicy;
+    DaemonMetrics* _metrics;
+    std::optional<std::filesystem::path> _traceFile;
+    uint64_t _instance; ///< @see instance().
     /// What each attached client reported it can display, keyed by its stream subscription so the
     /// entry lives exactly as long as the client does (@see unsubscribeStream). `_pageSize` is
     /// resolved from these, never assigned from one of them.
@@ -192,6 +192,8 @@ struct HostHarness
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        vtbackend::Settings {},
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false,
                        policy };
 };
@@ -500,6 +502,8 @@ TEST_CASE("stream events fan out to every subscriber independently", "[vthost][h
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     auto first = StreamRecorder {};
     auto second = StreamRecorder {};
@@ -561,6 +565,8 @@ TEST_CASE("a failing PTY factory is reported", "[vthost][host][diagnostics]")
                               [](vtbackend::PageSize) { return std::unique_ptr<vtpty::Pty> {}; },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
 
     CHECK(host.createTab() == nullptr);
@@ -623,6 +629,8 @@ TEST_CASE("a hosted session with a parked pump can still be torn down", "[vthost
         },
         vtbackend::Settings {},
         crispy::defaultEnvironment(),
+        /*metrics=*/nullptr,
+        /*traceFile=*/std::nullopt,
         /*startPumps=*/true);
 
     REQUIRE(host->createTab() != nullptr);
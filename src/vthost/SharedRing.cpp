@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vthost/SharedRing.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <tuple>
+#include <utility>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+
+    #include <atomic>
+
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace vthost
+{
+
+namespace
+{
+#ifndef _WIN32
+    /// @param what The call that failed.
+    /// @return Its failure, worded for a log line.
+    [[nodiscard]] std::string failed(char const* what)
+    {
+        return std::format("{}: {}", what, std::strerror(errno));
+    }
+
+    /// An anonymous shared-memory object: nothing in the filesystem names it once this returns.
+    [[nodiscard]] int anonymousSegment()
+    {
+    #if defined(__linux__)
+        return ::memfd_create("vthost-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    #else
+        static auto counter = std::atomic<unsigned> { 0 };
+        auto const name = std::format("/vthost-ring-{}-{}", ::getpid(), counter++);
+        auto const fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0)
+            ::shm_unlink(name.c_str());
+        return fd;
+    #endif
+    }
+#endif
+} // namespace
+
+std::expected<SharedRing, std::string> SharedRing::create(std::size_t bytes)
+{
+#ifndef _WIN32
+    auto const fd = anonymousSegment();
+    if (fd < 0)
+        return std::unexpected(failed("shared memory"));
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+    {
+        auto error = failed("ftruncate");
+        ::close(fd);
+        return std::unexpected(std::move(error));
+    }
+    #if defined(__linux__)
+    // The client holds this descriptor too. Sealed, it cannot truncate the segment under the
+    // daemon's mapping, which would turn the daemon's next write into a SIGBUS.
+    if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+    {
+        auto error = failed("F_ADD_SEALS");
+        ::close(fd);
+        return std::unexpected(std::move(error));
+    }
+    #endif
+    auto* const data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        auto error = failed("mmap");
+        ::close(fd);
+        return std::unexpected(std::move(error));
+    }
+    return SharedRing { static_cast<std::byte*>(data), bytes, fd };
+#else
+    std::ignore = bytes;
+    return std::unexpected(std::string { "shared memory is not offered on this platform" });
+#endif
+}
+
+std::expected<SharedRing, std::string> SharedRing::map(int fd, std::size_t bytes)
+{
+#ifndef _WIN32
+    // A mapping past the end of the object faults on first touch, so the size is checked rather
+    // than taken on the daemon's word.
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 || std::cmp_less(status.st_size, bytes) || bytes == 0)
+    {
+        ::close(fd);
+        return std::unexpected(std::format("shared segment smaller than the announced {} bytes", bytes));
+    }
+    auto* const data = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    auto error = data == MAP_FAILED ? failed("mmap") : std::string {};
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return std::unexpected(std::move(error));
+    return SharedRing { static_cast<std::byte*>(data), bytes, -1 };
+#else
+    std::ignore = fd;
+    std::ignore = bytes;
+    return std::unexpected(std::string { "shared memory is not offered on this platform" });
+#endif
+}
+
+SharedRing::~SharedRing()
+{
+#ifndef _WIN32
+    if (_data != nullptr)
+        ::munmap(_data, _capacity);
+    if (_fd >= 0)
+        ::close(_fd);
+#endif
+}
+
+SharedRing::SharedRing(SharedRing&& other) noexcept:
+    _data(std::exchange(other._data, nullptr)),
+    _capacity(std::exchange(other._capacity, 0)),
+    _fd(std::exchange(other._fd, -1)),
+    _head(other._head),
+    _released(other._released)
+{
+}
+
+SharedRing& SharedRing::operator=(SharedRing&& other) noexcept
+{
+    if (this != &other)
+    {
+        auto discarded = std::move(*this);
+        _data = std::exchange(other._data, nullptr);
+        _capacity = std::exchange(other._capacity, 0);
+        _fd = std::exchange(other._fd, -1);
+        _head = other._head;
+        _released = other._released;
+    }
+    return *this;
+}
+
+int SharedRing::releaseDescriptor() noexcept
+{
+    return std::exchange(_fd, -1);
+}
+
+std::optional<uint64_t> SharedRing::write(std::span<std::byte const> frame)
+{
+    if (frame.empty() || frame.size() > _capacity)
+        return std::nullopt;
+    auto start = _head;
+    if (auto const at = start % _capacity; at + frame.size() > _capacity)
+        start += _capacity - at; // the tail is too short: wrap, leaving it unused
+    if (start + frame.size() - _released > _capacity)
+        return std::nullopt;
+    std::memcpy(_data + (start % _capacity), frame.data(), frame.size());
+    _head = start + frame.size();
+    return start;
+}
+
+bool SharedRing::release(uint64_t offset) noexcept
+{
+    if (offset < _released || offset > _head)
+        return false;
+    _released = offset;
+    return true;
+}
+
+std::optional<std::span<std::byte const>> SharedRing::read(uint64_t offset, std::size_t length) const noexcept
+{
+    if (length == 0 || length > _capacity)
+        return std::nullopt;
+    auto const at = static_cast<std::size_t>(offset % _capacity);
+    if (at + length > _capacity)
+        return std::nullopt;
+    return std::span<std::byte const> { _data + at, length };
+}
+
+} // namespace vthost
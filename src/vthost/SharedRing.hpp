@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// `SharedRing` — the shared-memory segment a same-host native client reads large updates from.
+///
+/// A Delta for a busy pane — a full-screen redraw, a snapshot with scrollback — runs to tens or
+/// hundreds of kilobytes. Over the socket every byte of it is copied into the kernel by the daemon
+/// and out again by the client, one buffer-full and one wakeup at a time. When both ends share a
+/// host (the AF_UNIX endpoint) the daemon instead writes the encoded frame once into a segment the
+/// client has mapped, and the socket carries only where it is (@see proto::SharedDelta).
+///
+/// **Layout.** A byte ring addressed by a stream offset that only grows. A frame occupies one
+/// contiguous span, so a frame that would straddle the end starts over at the beginning. The
+/// writer never reuses bytes the reader has not released (@see proto::SharedRelease); a frame that
+/// does not fit simply travels over the socket as it always did.
+///
+/// **Creation.** A sealed memfd on Linux, so a client cannot shrink the segment out from under the
+/// daemon's mapping; an unlinked POSIX shared-memory object elsewhere. None on Windows, where no
+/// transport passes descriptors either.
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace vthost
+{
+
+/// One mapped ring: the daemon's writable view of it, or a client's read-only one.
+class SharedRing
+{
+  public:
+    /// The segment a daemon offers each connection that asks: a few full-screen snapshots.
+    static constexpr std::size_t DefaultBytes = std::size_t { 8 } * 1024 * 1024;
+
+    /// Frames smaller than this travel over the socket. Below a page, the copy saved is worth less
+    /// than the notification that replaces it and the release the client sends back.
+    static constexpr std::size_t MinFrameBytes = 4096;
+
+    /// Creates a segment for the daemon to write into.
+    /// @param bytes Its size.
+    /// @return The ring, holding the descriptor to pass to the client (@see releaseDescriptor), or
+    ///         why the platform could not provide one.
+    [[nodiscard]] static std::expected<SharedRing, std::string> create(std::size_t bytes);
+
+    /// Maps the segment a daemon passed, read-only.
+    /// @param fd The received descriptor. Always consumed: closed once mapped, or on refusal.
+    /// @param bytes The size the ServerHello announced; a segment smaller than that is refused.
+    /// @return The ring, or why it could not be mapped.
+    [[nodiscard]] static std::expected<SharedRing, std::string> map(int fd, std::size_t bytes);
+
+    ~SharedRing();
+    SharedRing(SharedRing&& other) noexcept;
+    SharedRing& operator=(SharedRing&& other) noexcept;
+    SharedRing(SharedRing const&) = delete;
+    SharedRing& operator=(SharedRing const&) = delete;
+
+    /// @return The segment size in bytes.
+    [[nodiscard]] std::size_t capacity() const noexcept { return _capacity; }
+
+    /// Yields the creator's descriptor, for passing to the peer. The mapping does not need it.
+    /// @return The descriptor (ownership included), or -1 once taken and on a mapped ring.
+    [[nodiscard]] int releaseDescriptor() noexcept;
+
+    /// Writer side: copies @p frame into the ring.
+    /// @return The stream offset the frame starts at, or nullopt when the bytes the reader has not
+    ///         released leave no room for it.
+    [[nodiscard]] std::optional<uint64_t> write(std::span<std::byte const> frame);
+
+    /// Writer side: the reader is done with every frame that ends at or before @p offset.
+    /// @return False, changing nothing, for an offset the writer never reached or one behind an
+    ///         earlier release.
+    bool release(uint64_t offset) noexcept;
+
+    /// Reader side: the frame the writer announced at @p offset.
+    /// @return Its bytes, or nullopt where no frame of @p length can lie.
+    [[nodiscard]] std::optional<std::span<std::byte const>> read(uint64_t offset,
+                                                                 std::size_t length) const noexcept;
+
+  private:
+    SharedRing(std::byte* data, std::size_t capacity, int fd) noexcept:
+        _data(data), _capacity(capacity), _fd(fd)
+    {
+    }
+
+    std::byte* _data = nullptr;
+    std::size_t _capacity = 0;
+    int _fd = -1;           ///< The creator's descriptor until released.
+    uint64_t _head = 0;     ///< Writer: where the next frame may start.
+    uint64_t _released = 0; ///< Writer: the reader is done with everything below this.
+};
+
+} // namespace vthost
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+#ifndef _WIN32
+
+    #include <catch2/catch_test_macros.hpp>
+
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <vector>
+
+    #include <unistd.h>
+
+    #include <vthost/SharedRing.hpp>
+
+using vthost::SharedRing;
+
+namespace
+{
+
+/// @return @p size bytes, all @p value.
+std::vector<std::byte> frameOf(std::size_t size, uint8_t value)
+{
+    return std::vector<std::byte>(size, std::byte { value });
+}
+
+/// @return Whether @p view holds exactly @p frame.
+bool holds(std::optional<std::span<std::byte const>> view, std::vector<std::byte> const& frame)
+{
+    return view && std::ranges::equal(*view, frame);
+}
+
+} // namespace
+
+TEST_CASE("a frame the daemon writes is read through the client's mapping", "[vthost][shm]")
+{
+    auto writer = SharedRing::create(16384);
+    REQUIRE(writer.has_value());
+    auto reader = SharedRing::map(writer->releaseDescriptor(), 16384);
+    REQUIRE(reader.has_value());
+    CHECK(writer->releaseDescriptor() == -1);
+
+    auto const frame = frameOf(5000, 0xA5);
+    auto const offset = writer->write(frame);
+    REQUIRE(offset == 0);
+    CHECK(holds(reader->read(*offset, frame.size()), frame));
+}
+
+TEST_CASE("the ring reuses only what the reader released", "[vthost][shm]")
+{
+    auto writer = SharedRing::create(16384);
+    REQUIRE(writer.has_value());
+    auto reader = SharedRing::map(writer->releaseDescriptor(), 16384);
+    REQUIRE(reader.has_value());
+
+    CHECK(writer->write(frameOf(6000, 1)) == 0);
+    CHECK(writer->write(frameOf(6000, 2)) == 6000);
+
+    // The third would straddle the end, so it starts over at the beginning: still unreleased.
+    auto const third = frameOf(6000, 3);
+    CHECK(!writer->write(third).has_value());
+
+    REQUIRE(writer->release(6000));
+    auto const offset = writer->write(third);
+    REQUIRE(offset == 16384);
+    CHECK(holds(reader->read(*offset, third.size()), third));
+}
+
+TEST_CASE("a release the writer cannot have earned changes nothing", "[vthost][shm]")
+{
+    auto writer = SharedRing::create(16384);
+    REQUIRE(writer.has_value());
+    CHECK(writer->write(frameOf(100, 1)) == 0);
+
+    CHECK(!writer->release(101)); // beyond anything written
+    CHECK(writer->release(100));
+    CHECK(!writer->release(50)); // behind an earlier release
+    CHECK(writer->write(frameOf(16284, 2)) == 100); // exactly the room the release made
+}
+
+TEST_CASE("the client refuses what cannot be a frame in the segment", "[vthost][shm]")
+{
+    auto writer = SharedRing::create(16384);
+    REQUIRE(writer.has_value());
+    auto const fd = writer->releaseDescriptor();
+
+    // A segment smaller than announced would fault on first touch instead.
+    CHECK(!SharedRing::map(::dup(fd), 32768).has_value());
+
+    auto reader = SharedRing::map(fd, 16384);
+    REQUIRE(reader.has_value());
+    CHECK(!reader->read(0, 0).has_value());
+    CHECK(!reader->read(16000, 1000).has_value()); // straddles the end
+    CHECK(!reader->read(0, 16385).has_value());
+    CHECK(reader->read(16384 + 16000, 384).has_value());
+}
+
+#endif
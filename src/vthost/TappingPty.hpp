@@ -52,6 +52,7 @@ class TappingPty final: public vtpty::Pty
 
     void wakeupReader() override { _inner->wakeupReader(); }
     [[nodiscard]] int write(std::string_view buf) override { return _inner->write(buf); }
+    [[nodiscard]] int writeSome(std::string_view buf) override { return _inner->writeSome(buf); }
     [[nodiscard]] vtpty::PageSize pageSize() const noexcept override { return _inner->pageSize(); }
 
     void resizeScreen(vtpty::PageSize cells, std::optional<vtpty::ImageSize> pixels = std::nullopt) override
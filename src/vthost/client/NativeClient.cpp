@@ -16,6 +16,10 @@
 #include <vthost/SessionSettings.hpp>
 #include <vthost/proto/PduTrace.hpp>
 
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
 namespace vthost::client
 {
 
@@ -31,6 +35,42 @@ void appendCluster(std::string& out, proto::WireCell const& cell)
 // ---------------------------------------------------------------------------
 // RemoteScreen
 
+namespace
+{
+    /// Applies @p shift to @p map, keyed by stable row id, calling @p restamp(value, newId) on each
+    /// entry that moved. Rows the shift pushed past the end of its block are dropped; the rows it
+    /// exposed are left absent, for the lines of the same delta to fill.
+    ///
+    /// The range is the peer's, so nothing here iterates it: the work is bounded by the rows held.
+    template <typename Map, typename Restamp>
+    void applyRowShift(Map& map, proto::RowShift const& shift, Restamp restamp)
+    {
+        if (shift.count == 0 || shift.bottom < shift.top)
+            return;
+        // Unsigned, so that no id the peer names can overflow the arithmetic.
+        auto const span = static_cast<uint64_t>(shift.bottom) - static_cast<uint64_t>(shift.top);
+        auto const distance = shift.count > 0 ? static_cast<uint64_t>(shift.count)
+                                              : static_cast<uint64_t>(-int64_t { shift.count });
+
+        // Take the whole block out first, so that no entry lands on one that has yet to move.
+        auto block = std::vector<typename Map::node_type> {};
+        auto const end = map.upper_bound(shift.bottom);
+        for (auto it = map.lower_bound(shift.top); it != end;)
+            block.push_back(map.extract(it++));
+
+        for (auto& node: block)
+        {
+            auto const offset = static_cast<uint64_t>(node.key()) - static_cast<uint64_t>(shift.top);
+            if (shift.count > 0 ? offset < distance : span - offset < distance)
+                continue;
+            auto const id = static_cast<uint64_t>(node.key());
+            node.key() = static_cast<int64_t>(shift.count > 0 ? id - distance : id + distance);
+            restamp(node.mapped(), node.key());
+            map.insert(std::move(node));
+        }
+    }
+} // namespace
+
 void RemoteScreen::apply(proto::SessionState const& state)
 {
     session = state.session;
@@ -64,6 +104,7 @@ void RemoteScreen::apply(proto::Delta const& delta)
         // generation-scoped, so a rebuild does not invalidate a fetched image.
     }
 
+    deltaApplied = true;
     generation = delta.generation;
     seqno = delta.seqno;
     viewportBase = delta.stableViewportBase;
@@ -103,6 +144,17 @@ void RemoteScreen::apply(proto::Delta const& delta)
         progressPercentage = delta.progressPercentage;
     }
 
+    // Shifts first: they move the rows as the client held them, and the lines then carry the final
+    // content of every row that changed besides.
+    for (auto const& shift: delta.rowShifts)
+    {
+        applyRowShift(rows, shift, [](proto::WireLine& line, int64_t id) { line.stableId = id; });
+        applyRowShift(imageCells, shift, [](auto& cells, int64_t id) {
+            for (auto& [column, entry]: cells)
+                entry.stableId = id;
+        });
+    }
+
     for (auto const& line: delta.lines)
     {
         rows.insert_or_assign(line.stableId, line);
@@ -150,6 +202,11 @@ void RemoteScreen::dropImage(uint32_t imageId)
     std::erase_if(imageCells, [](auto const& pair) { return pair.second.empty(); });
 }
 
+void RemoteScreen::releaseHistory()
+{
+    rows.erase(rows.begin(), rows.lower_bound(viewportBase));
+}
+
 proto::WireLine const* RemoteScreen::rowAt(int32_t line) const
 {
     auto const it = rows.find(viewportBase + line);
@@ -201,6 +258,14 @@ NativeClient::NativeClient(net::EventLoop& loop,
 {
 }
 
+NativeClient::~NativeClient()
+{
+#ifndef _WIN32
+    if (_sharedFd >= 0)
+        ::close(_sharedFd);
+#endif
+}
+
 std::optional<int64_t> NativeClient::resolveHistoryKeep(HandshakeOptions const& handshake)
 {
     // No stated profile means no opinion, so the mirror's own ceiling applies -- @see
@@ -304,6 +369,64 @@ void NativeClient::detach()
     _connection->close();
 }
 
+bool NativeClient::mapSharedRing(uint32_t bytes)
+{
+    if (_sharedFd < 0)
+    {
+        errorLog()("attach: the daemon announced a {} byte shared segment but passed none", bytes);
+        return false;
+    }
+    auto ring = SharedRing::map(std::exchange(_sharedFd, -1), bytes);
+    if (!ring)
+    {
+        errorLog()("attach: cannot map the daemon's shared segment: {}", ring.error());
+        return false;
+    }
+    _sharedRing = std::move(*ring);
+    _sharedConsumed = 0;
+    _sharedReleased = 0;
+    clientLog()("attach: large updates arrive through a {} KiB shared segment", bytes / 1024);
+    return true;
+}
+
+bool NativeClient::applySharedDelta(proto::SharedDelta const& notice)
+{
+    auto const bytes = _sharedRing ? _sharedRing->read(notice.offset, notice.length) : std::nullopt;
+    if (!bytes)
+    {
+        errorLog()("attach: SharedDelta at {} ({} bytes) names nothing in a shared segment",
+                   notice.offset,
+                   notice.length);
+        return false;
+    }
+    // The daemon wrote a whole frame there, in the same encoding the socket carries.
+    auto decoded = proto::decodePdu(*bytes);
+    if (!decoded || decoded->consumed != notice.length || !std::holds_alternative<proto::Delta>(decoded->pdu))
+    {
+        errorLog()(
+            "attach: SharedDelta at {} ({} bytes) does not hold one Delta", notice.offset, notice.length);
+        return false;
+    }
+    handlePdu(*decoded);
+
+    // Released in bulk: one message per quarter of the segment rather than one per frame. A
+    // release covers every frame before it, including any whose notice the daemon dropped
+    // unwritten in favour of a newer snapshot.
+    _sharedConsumed = std::max(_sharedConsumed, notice.offset + notice.length);
+    if (_sharedConsumed - _sharedReleased >= _sharedRing->capacity() / 4)
+    {
+        _sharedReleased = _sharedConsumed;
+        send(proto::DecodedPdu { proto::SharedRelease { .offset = _sharedReleased } });
+    }
+    return true;
+}
+
+void NativeClient::releaseHistory(uint64_t session)
+{
+    if (auto const screen = _screens.find(session); screen != _screens.end())
+        screen->second.releaseHistory();
+}
+
 void NativeClient::handlePdu(proto::DecodedFrame const& frame)
 {
     auto const& pdu = frame.pdu;
@@ -313,18 +436,28 @@ void NativeClient::handlePdu(proto::DecodedFrame const& frame)
 
     if (auto const* hello = std::get_if<proto::ServerHello>(&pdu))
     {
-        if (hello->codecVersion == proto::CodecVersion)
-        {
-            _connected = true;
-            clientLog()("attach: connected (codec v{})", proto::CodecVersion);
-        }
-        else
+        if (hello->codecVersion != proto::CodecVersion)
         {
             errorLog()("attach: daemon speaks codec v{}, we speak v{}; detaching",
                        hello->codecVersion,
                        proto::CodecVersion);
             _versionMismatch = true;
         }
+        else if (_instance != 0 && hello->instance != _instance && !_screens.empty())
+        {
+            clientLog()("attach: daemon instance {} is not {}, whose sessions are mirrored here; detaching",
+                        hello->instance,
+                        _instance);
+            _daemonRestarted = true;
+        }
+        else
+        {
+            _connected = true;
+            _instance = hello->instance;
+            clientLog()("attach: connected (codec v{})", proto::CodecVersion);
+            if (hello->sharedBytes != 0 && !mapSharedRing(hello->sharedBytes))
+                detach();
+        }
         return;
     }
     if (auto const* state = std::get_if<proto::SessionState>(&pdu))
@@ -350,6 +483,12 @@ void NativeClient::handlePdu(proto::DecodedFrame const& frame)
             _onUpdate(screen, *delta);
         return;
     }
+    if (auto const* notice = std::get_if<proto::SharedDelta>(&pdu))
+    {
+        if (!applySharedDelta(*notice))
+            detach();
+        return;
+    }
     if (auto const* image = std::get_if<proto::ImageData>(&pdu))
     {
         // The reply carries no session; the request serial is what routes it.
@@ -414,16 +553,63 @@ void NativeClient::reportPumpOutcome(PumpResult const& outcome)
     }
 }
 
-coro::Task<void> NativeClient::run()
+NativeClient::ResumeState NativeClient::takeResumeState()
 {
-    send(proto::DecodedPdu { proto::ClientHello { .codecVersion = proto::CodecVersion,
-                                                  .token = _handshake.token,
-                                                  .sessionSettings = _handshake.sessionSettings } });
+    auto state = ResumeState { .instance = _instance, .screens = std::exchange(_screens, {}) };
+    // A fetch still in flight died with this connection and will never be answered. Forgotten, so
+    // that the successor asks again.
+    for (auto& [session, screen]: state.screens)
+        std::erase_if(screen.requestedImages, [&](uint32_t id) { return !screen.images.contains(id); });
+    _pendingImages.clear();
+    return state;
+}
 
-    auto const outcome = co_await pumpPdus(_connection.get(), [this](proto::DecodedFrame const& frame) {
-        handlePdu(frame);
-        return !_detached && !_versionMismatch;
-    });
+void NativeClient::resumeFrom(ResumeState state)
+{
+    _instance = state.instance;
+    _screens = std::move(state.screens);
+}
+
+coro::Task<void> NativeClient::run()
+{
+    auto hello = proto::ClientHello { .codecVersion = proto::CodecVersion,
+                                      .token = _handshake.token,
+                                      .sessionSettings = _handshake.sessionSettings,
+                                      .resumeInstance = _instance,
+                                      .sharedMemory = _handshake.sharedMemory };
+    // Only primary pages are offered: @see proto::ResumeCursor for why no other page can be.
+    for (auto const& [session, screen]: _screens)
+        if (screen.deltaApplied && screen.screenType == 0)
+            hello.resume.push_back(proto::ResumeCursor { .session = session,
+                                                         .generation = screen.generation,
+                                                         .seqno = screen.seqno,
+                                                         .stableBase = screen.viewportBase });
+    send(proto::DecodedPdu { std::move(hello) });
+
+    // An adopted mirror may reference images whose fetch the previous connection never saw
+    // answered; nothing the daemon sends from here on would mention them again.
+    for (auto& [session, screen]: _screens)
+        for (auto const& [stableId, cells]: screen.imageCells)
+            for (auto const& [column, entry]: cells)
+                if (!screen.images.contains(entry.imageId)
+                    && screen.requestedImages.insert(entry.imageId).second)
+                    fetchImage(session, entry.imageId);
+
+    auto const outcome = co_await pumpPdus(
+        _connection.get(),
+        [this](proto::DecodedFrame const& frame) {
+            handlePdu(frame);
+            return !_detached && !_versionMismatch && !_daemonRestarted;
+        },
+        [this](int fd) {
+            // Only the ServerHello carries one, so anything after the first is the daemon's mistake.
+            if (_sharedFd < 0)
+                _sharedFd = fd;
+#ifndef _WIN32
+            else
+                ::close(fd);
+#endif
+        });
     reportPumpOutcome(outcome);
 
     if (!_detached)
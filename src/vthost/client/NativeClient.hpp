@@ -26,6 +26,7 @@
 #include <net/ISocket.hpp>
 #include <net/WriteQueue.hpp>
 #include <vthost/PduPump.hpp>
+#include <vthost/SharedRing.hpp>
 #include <vthost/proto/Pdu.hpp>
 
 namespace vthost::client
@@ -74,6 +75,9 @@ struct RemoteScreen
     uint64_t seqno = 0;
     int64_t viewportBase = 0; ///< Stable id of viewport row 0.
     int64_t stableFloor = 0;  ///< Oldest stable id the server still holds; rows below are evicted.
+    /// Whether a Delta was applied yet. Before one is, the stream position above names nothing the
+    /// server ever sent, so it cannot be offered for a resume (@see NativeClient::resumeFrom).
+    bool deltaApplied = false;
 
     /// Rows by stable id (ordered, so eviction trims the oldest first).
     std::map<int64_t, proto::WireLine> rows;
@@ -135,6 +139,17 @@ struct RemoteScreen
     /// Drops @p imageId: forgets its pixels and clears every cell referencing it
     /// (those cells render blank until redrawn). Called on ImageGone.
     void dropImage(uint32_t imageId);
+
+    /// Drops every row above the viewport, for a consumer that keeps the scrollback itself.
+    ///
+    /// A `ScreenMirror` streams each row into its terminal's own history as it scrolls by, so once
+    /// it has applied an update the rows above the viewport exist twice, and with many deep-history
+    /// panes attached the mirrored copy is most of the client's memory. Nothing reads them again:
+    /// an update carries every row it changes, and a replay that rebuilds history does so from a
+    /// snapshot, which carries them all.
+    ///
+    /// Image cells are kept. They are few, and an image whose top scrolled off is placed from them.
+    void releaseHistory();
 };
 
 /// One attached native-protocol connection.
@@ -164,6 +179,9 @@ class NativeClient final
         /// The emulation settings to ask for the sessions THIS client creates; absent means
         /// "whatever the daemon hosts with". @see proto::WireSessionSettings.
         std::optional<proto::WireSessionSettings> sessionSettings = std::nullopt;
+        /// Ask for large updates through a shared segment (@see SharedRing). Only meaningful on the
+        /// daemon's own host; the daemon declines over any transport that cannot pass the segment.
+        bool sharedMemory = false;
     };
 
     /// @param loop The event loop everything runs on.
@@ -182,11 +200,36 @@ class NativeClient final
                  ImageHandler onImage,
                  SessionEventHandler onSessionEvent,
                  LayoutHandler onLayout);
+    ~NativeClient();
+    NativeClient(NativeClient const&) = delete;
+    NativeClient& operator=(NativeClient const&) = delete;
+
+    /// What a reconnecting client carries from the connection it replaces into the next one.
+    ///
+    /// The mirrors themselves, not just their stream positions: a resumed session is sent only
+    /// what changed, so the rows that did not change must already be here.
+    struct ResumeState
+    {
+        uint64_t instance = 0; ///< The daemon instance the mirrors follow; 0 resumes nothing.
+        std::map<uint64_t, RemoteScreen> screens;
+    };
 
     /// The connection flow: sends ClientHello, mirrors server pushes until the
     /// server disconnects or detach() is called.
     [[nodiscard]] coro::Task<void> run();
 
+    /// Hands this connection's mirrors to a successor, leaving this one without any. Call once run()
+    /// has returned, so that nothing is applied to a mirror after its position was taken.
+    [[nodiscard]] ResumeState takeResumeState();
+
+    /// Adopts a predecessor's mirrors, so that run()'s ClientHello asks the daemon to resume them
+    /// instead of snapshotting every session again. Call before run().
+    ///
+    /// A daemon that is not the instance they follow ends run() at its ServerHello
+    /// (@see daemonRestarted()).
+    /// @param state What the predecessor's takeResumeState() returned.
+    void resumeFrom(ResumeState state);
+
     /// Replaces the update handler at runtime. The constructor is the primary
     /// configuration path; use this only when a handler must be swapped mid-life.
     void setUpdateHandler(UpdateHandler handler) { _onUpdate = std::move(handler); }
@@ -238,15 +281,27 @@ class NativeClient final
     /// Closes the connection; run() finishes.
     void detach();
 
+    /// Drops @p session's rows above the viewport once a consumer holds them.
+    /// @see RemoteScreen::releaseHistory.
+    void releaseHistory(uint64_t session);
+
     /// @return All mirrored screens, keyed by session id.
     [[nodiscard]] std::map<uint64_t, RemoteScreen> const& screens() const noexcept { return _screens; }
 
     /// @return True once the ServerHello arrived with a matching version.
     [[nodiscard]] bool connected() const noexcept { return _connected; }
 
+    /// @return True once the daemon's shared segment is mapped, so large updates arrive through it.
+    [[nodiscard]] bool sharedMemory() const noexcept { return _sharedRing.has_value(); }
+
     /// @return True if the server answered with an incompatible codec version.
     [[nodiscard]] bool versionMismatch() const noexcept { return _versionMismatch; }
 
+    /// @return True if the mirrors adopted through resumeFrom() follow a daemon instance other than
+    ///         the one that answered. That daemon numbers its sessions from scratch, so an id the
+    ///         mirrors share with it may name a different shell; run() stops rather than mix them.
+    [[nodiscard]] bool daemonRestarted() const noexcept { return _daemonRestarted; }
+
     /// How many rows above the viewport a mirror keeps; `nullopt` is unbounded.
     ///
     /// Public because it is a pure decision about @p handshake with no state behind it, and one
@@ -274,6 +329,15 @@ class NativeClient final
     /// @return Its mirror.
     [[nodiscard]] RemoteScreen& screenFor(uint64_t session);
 
+    /// Maps the segment the ServerHello announced, from the descriptor that came with it.
+    /// @return False, having logged why, when the daemon announced one that cannot be mapped.
+    [[nodiscard]] bool mapSharedRing(uint32_t bytes);
+
+    /// Decodes the Delta @p notice points at in the shared segment and applies it as if it had come
+    /// over the socket; then releases what was consumed once enough of it piled up.
+    /// @return False, having logged why, when the notice names no well-formed Delta.
+    [[nodiscard]] bool applySharedDelta(proto::SharedDelta const& notice);
+
     std::unique_ptr<net::ISocket> _connection;
     net::WriteQueue _writer;
     /// Declared before _handshake so the constructor can resolve it from its own parameter, rather
@@ -289,8 +353,17 @@ class NativeClient final
     /// carries no session, so the serial is what routes it to the right screen.
     std::unordered_map<uint64_t, std::pair<uint64_t, uint32_t>> _pendingImages;
     uint64_t _nextSerial = 1;
+    /// The daemon instance the mirrors follow: adopted by resumeFrom(), then whatever the
+    /// ServerHello named.
+    uint64_t _instance = 0;
+    /// The descriptor received with the ServerHello, until mapSharedRing consumes it.
+    int _sharedFd = -1;
+    std::optional<SharedRing> _sharedRing;
+    uint64_t _sharedConsumed = 0; ///< The end of the last frame read from the segment.
+    uint64_t _sharedReleased = 0; ///< The end of the last SharedRelease sent.
     bool _connected = false;
     bool _versionMismatch = false;
+    bool _daemonRestarted = false;
     bool _detached = false;
 };
 
@@ -59,12 +59,17 @@ namespace
 /// NativeSession serves what the REAL NativeClient mirrors.
 struct EndToEndHarness
 {
+    explicit EndToEndHarness(NativeClient::HandshakeOptions options = {}): handshake { std::move(options) } {}
+
+    NativeClient::HandshakeOptions handshake; ///< Set by the constructor, before `client` reads it.
     net::PollEventSource source;
     net::EventLoop loop { source };
     SessionHost host { loop,
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        vtbackend::Settings {},
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false };
     net::testing::SocketPair pair = *net::testing::makeSocketPair(loop);
     net::ISocket* serverConn = pair.first.get(); ///< Captured before the move, to simulate a daemon exit.
@@ -73,7 +78,7 @@ struct EndToEndHarness
     std::unique_ptr<NativeClient> client =
         std::make_unique<NativeClient>(loop,
                                        std::move(pair.second),
-                                       NativeClient::HandshakeOptions {},
+                                       handshake,
                                        NativeClient::UpdateHandler {},
                                        NativeClient::ImageHandler {},
                                        NativeClient::SessionEventHandler {},
@@ -135,6 +140,24 @@ Task<void> driveEndToEnd(EndToEndHarness* h, vtworkspace::SessionId sessionId)
     co_await coro::whenAll(h->server->run(), h->client->run(), scenario(h, sessionId));
 }
 
+#ifndef _WIN32
+/// Mirrors a screen too large for one socket-sized Delta, then an incremental update on top of it.
+Task<void> sharedScenario(EndToEndHarness* h, vtworkspace::SessionId sessionId, std::string const* row)
+{
+    co_await net::testing::waitUntil(&h->loop, [&] { return !h->client->screens().empty(); });
+    REQUIRE(h->client->connected());
+    CHECK(h->client->sharedMemory());
+    CHECK(h->client->screens().at(sessionId.value).viewportText().starts_with(*row));
+
+    h->host.terminal(sessionId)->writeToScreen("\r\nafter the snapshot");
+    h->server->sessionScreenUpdated(sessionId);
+    co_await net::testing::waitUntil(&h->loop, [&] {
+        return h->client->screens().at(sessionId.value).viewportText().contains("after the snapshot");
+    });
+    h->client->detach();
+}
+#endif
+
 } // namespace
 
 TEST_CASE("attach mirrors, updates, inputs and resizes end to end", "[vthost][attach]")
@@ -151,6 +174,22 @@ TEST_CASE("attach mirrors, updates, inputs and resizes end to end", "[vthost][at
     CHECK(h.client->screens().at(sessionId.value).columns == 70);
 }
 
+#ifndef _WIN32
+TEST_CASE("a same-host attach mirrors large updates through shared memory", "[vthost][attach][shm]")
+{
+    auto h = EndToEndHarness { NativeClient::HandshakeOptions { .sharedMemory = true } };
+    h.host.createTab();
+    auto const sessionId = h.host.model().window(h.host.windowId())->activeTab()->rootPane()->session();
+    // A full page of text: far more than SharedRing::MinFrameBytes once encoded.
+    auto const row = std::string(79, 'x');
+    for (auto const line: std::views::iota(0, 24))
+        h.host.terminal(sessionId)->writeToScreen(line == 0 ? row : "\r\n" + row);
+
+    h.loop.blockOn(coro::whenAll(h.server->run(), h.client->run(), sharedScenario(&h, sessionId, &row)));
+    CHECK(h.client->screens().at(sessionId.value).viewportText().contains("after the snapshot"));
+}
+#endif
+
 TEST_CASE("RemoteScreen renders blank rows and trims trailing space", "[vthost][attach]")
 {
     auto screen = RemoteScreen {};
@@ -210,6 +249,33 @@ TEST_CASE("RemoteScreen drops history the server discarded via the floor", "[vth
     CHECK(screen.rows.contains(10)); // the viewport row survives
 }
 
+TEST_CASE("RemoteScreen.releaseHistory keeps the viewport and image cells", "[vthost][attach]")
+{
+    auto screen = RemoteScreen {};
+    screen.columns = 5;
+    screen.lines = 2;
+
+    auto seed = proto::Delta {};
+    seed.stableViewportBase = 10;
+    seed.stableFloor = 7;
+    for (auto const id: { 7, 8, 9, 10, 11 })
+    {
+        auto line = proto::WireLine {};
+        line.stableId = id;
+        line.columns = 5;
+        seed.lines.push_back(line);
+    }
+    seed.imageCells.push_back(proto::ImageCellEntry { .stableId = 8, .column = 0, .imageId = 1 });
+    screen.apply(seed);
+
+    screen.releaseHistory();
+    CHECK(screen.rows.size() == 2);
+    CHECK(screen.rowAt(0) != nullptr);
+    CHECK(screen.rowAt(1) != nullptr);
+    // An image anchored in history is still placed from its cells there.
+    CHECK(screen.imageAt(8, 0) != nullptr);
+}
+
 TEST_CASE("the mirror's retention bound follows the client's profile", "[vthost][attach]")
 {
     // The bound used to be a hardcoded 10 000, which silently contradicted a user who had asked
@@ -335,6 +401,65 @@ TEST_CASE("RemoteScreen tracks, replaces and evicts image cells", "[vthost][atta
     CHECK(screen.imageAt(7, 1) == nullptr);
 }
 
+TEST_CASE("RemoteScreen applies row shifts before the lines", "[vthost][attach]")
+{
+    auto screen = RemoteScreen {};
+    screen.columns = 5;
+    screen.lines = 5;
+
+    auto const lineOf = [](int64_t id, char32_t text) {
+        auto line = proto::WireLine {};
+        line.stableId = id;
+        line.columns = 5;
+        line.cells.push_back(proto::WireCell { .codepoint = text });
+        return line;
+    };
+    auto const textAt = [&](int64_t id) {
+        auto const row = screen.rows.find(id);
+        return row != screen.rows.end() && !row->second.cells.empty() ? row->second.cells.front().codepoint
+                                                                       : U'?';
+    };
+
+    auto seed = proto::Delta {};
+    seed.snapshot = 1;
+    seed.stableViewportBase = 10;
+    seed.stableFloor = 10;
+    for (auto const id: std::views::iota(10, 15))
+        seed.lines.push_back(lineOf(id, static_cast<char32_t>(U'A' + (id - 10))));
+    seed.imageCells.push_back(proto::ImageCellEntry { .stableId = 13, .column = 2, .imageId = 4 });
+    screen.apply(seed);
+
+    // A margin scroll of rows 11..13 by one: two rows move up, the exposed one arrives as a line,
+    // and the rows outside the block are left alone.
+    auto scrolled = proto::Delta {};
+    scrolled.stableViewportBase = 10;
+    scrolled.stableFloor = 10;
+    scrolled.rowShifts.push_back(proto::RowShift { .top = 11, .bottom = 13, .count = 1 });
+    scrolled.lines.push_back(lineOf(13, U'x'));
+    screen.apply(scrolled);
+
+    CHECK(textAt(10) == U'A');
+    CHECK(textAt(11) == U'C');
+    CHECK(textAt(12) == U'D');
+    CHECK(textAt(13) == U'x');
+    CHECK(textAt(14) == U'E');
+    CHECK(screen.rows.at(12).stableId == 12);
+    // The image moved with its row, and the exposed row has none.
+    REQUIRE(screen.imageAt(12, 2) != nullptr);
+    CHECK(screen.imageAt(12, 2)->stableId == 12);
+    CHECK(screen.imageAt(13, 2) == nullptr);
+
+    // Reversed, by more rows than the block has: everything in it is gone, the rest untouched.
+    auto cleared = proto::Delta {};
+    cleared.stableViewportBase = 10;
+    cleared.stableFloor = 10;
+    cleared.rowShifts.push_back(proto::RowShift { .top = 11, .bottom = 13, .count = -7 });
+    screen.apply(cleared);
+    CHECK_FALSE(screen.rows.contains(11));
+    CHECK_FALSE(screen.rows.contains(13));
+    CHECK(textAt(14) == U'E');
+}
+
 TEST_CASE("RemoteScreen.dropImage clears pixels and the cells that referenced it", "[vthost][attach]")
 {
     auto screen = RemoteScreen {};
@@ -483,6 +608,8 @@ void tokenAttach(std::string serverToken, std::string clientToken, bool* gotSnap
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab();
     auto pair = *net::testing::makeSocketPair(loop);
@@ -514,6 +641,72 @@ void tokenAttach(std::string serverToken, std::string clientToken, bool* gotSnap
 
 } // namespace
 
+namespace
+{
+
+/// Records the ClientHello it receives, then hangs up.
+Task<void> captureHello(net::ISocket* socket, std::optional<proto::ClientHello>* hello)
+{
+    co_await vthost::pumpPdus(socket, [&](proto::DecodedFrame const& frame) {
+        if (auto const* received = std::get_if<proto::ClientHello>(&frame.pdu))
+            *hello = *received;
+        return false;
+    });
+    socket->close();
+}
+
+/// @return A mirror of @p session that applied one delta at the given stream position.
+RemoteScreen mirrorAt(uint64_t session, uint8_t screenType, uint64_t generation, uint64_t seqno, int64_t base)
+{
+    auto screen = RemoteScreen {};
+    screen.screenType = screenType;
+    auto delta = proto::Delta {};
+    delta.session = session;
+    delta.generation = generation;
+    delta.seqno = seqno;
+    delta.stableViewportBase = base;
+    screen.apply(delta);
+    return screen;
+}
+
+} // namespace
+
+TEST_CASE("a resuming client offers the positions of its primary-page mirrors", "[vthost][attach]")
+{
+    auto source = net::PollEventSource {};
+    auto loop = net::EventLoop { source };
+    auto pair = *net::testing::makeSocketPair(loop);
+    auto* serverSock = pair.first.get();
+    auto client = NativeClient { loop,
+                                 std::move(pair.second),
+                                 NativeClient::HandshakeOptions {},
+                                 NativeClient::UpdateHandler {},
+                                 NativeClient::ImageHandler {},
+                                 NativeClient::SessionEventHandler {},
+                                 NativeClient::LayoutHandler {} };
+
+    auto state = NativeClient::ResumeState { .instance = 42, .screens = {} };
+    state.screens.emplace(1, mirrorAt(1, /*screenType=*/0, 3, 9, 5));
+    state.screens.emplace(2, mirrorAt(2, /*screenType=*/1, 3, 9, 5)); // alternate: never offered
+    state.screens.emplace(3, RemoteScreen {});                        // no delta yet: nothing to offer
+    client.resumeFrom(std::move(state));
+
+    auto hello = std::optional<proto::ClientHello> {};
+    loop.blockOn(net::testing::allOf(client.run(), captureHello(serverSock, &hello)));
+
+    REQUIRE(hello.has_value());
+    CHECK(hello->resumeInstance == 42);
+    REQUIRE(hello->resume.size() == 1);
+    CHECK(hello->resume.front()
+          == proto::ResumeCursor { .session = 1, .generation = 3, .seqno = 9, .stableBase = 5 });
+
+    // No ServerHello arrived, so the mirrors still follow the instance they were adopted from.
+    auto const carried = client.takeResumeState();
+    CHECK(carried.instance == 42);
+    CHECK(carried.screens.size() == 3);
+    CHECK(client.screens().empty());
+}
+
 TEST_CASE("attach enforces a preshared auth token", "[vthost][attach]")
 {
     auto accepted = false;
@@ -599,6 +792,8 @@ TEST_CASE("attach mirrors over a real TCP transport with token auth", "[vthost][
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab();
 
@@ -657,6 +852,8 @@ TEST_CASE("attach mirrors over TLS-encrypted TCP with token auth", "[vthost][att
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab();
 
@@ -693,6 +890,8 @@ TEST_CASE("attach mirrors over TLS with a generated self-signed dev certificate"
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab();
 
@@ -769,6 +968,8 @@ TEST_CASE("attach receives the daemon's tab and pane layout", "[vthost][attach]"
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     auto* tab = host.createTab();
     // Split the tab into two panes (a vertical divider at 60/40).
@@ -812,6 +1013,8 @@ TEST_CASE("a client authors a tab, honored by the daemon and mirrored back", "[v
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab(); // the daemon starts with one tab
 
@@ -851,6 +1054,8 @@ TEST_CASE("a client authors a new window, honored by the daemon (B4)", "[vthost]
                               [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                               vtbackend::Settings {},
                               crispy::defaultEnvironment(),
+                              /*metrics=*/nullptr,
+                              /*traceFile=*/std::nullopt,
                               /*startPumps=*/false };
     host.createTab(); // the daemon starts with one window (with one tab)
 
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vthost/client/PredictiveEcho.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <utility>
+
+namespace vthost::client
+{
+
+namespace
+{
+    /// The smoothing TCP and mosh use for a round-trip estimate: each sample moves it an eighth.
+    constexpr auto SrttWeight = 8;
+
+    /// An erased cell and a space look alike, and a line editor erasing a character may leave either.
+    [[nodiscard]] constexpr bool isBlank(char32_t codepoint) noexcept
+    {
+        return codepoint == 0 || codepoint == U' ';
+    }
+
+    [[nodiscard]] constexpr bool sameGlyph(char32_t a, char32_t b) noexcept
+    {
+        return a == b || (isBlank(a) && isBlank(b));
+    }
+
+    /// Whether a keystroke's effect on @p screen can be predicted at all.
+    [[nodiscard]] bool predictable(RemoteScreen const& screen) noexcept
+    {
+        return screen.screenType == 0 && screen.mouse.protocol == 0 && screen.columns > 1
+               && screen.cursorLine >= 0 && std::cmp_less(screen.cursorLine, screen.lines)
+               && screen.cursorColumn >= 0 && std::cmp_less(screen.cursorColumn, screen.columns);
+    }
+} // namespace
+
+void PredictiveEcho::predict(RemoteScreen const& screen, std::string_view input, Clock::time_point now)
+{
+    reconcile(screen, now);
+    if (!predictable(screen))
+    {
+        // Back on a prompt later, the first keystrokes must prove the echo again.
+        becomeTentative();
+        return;
+    }
+
+    auto const columns = static_cast<int>(screen.columns);
+    while (!input.empty())
+    {
+        if (_pending.size() >= MaxPending)
+        {
+            becomeTentative();
+            return;
+        }
+        auto const column = int { base(screen).column };
+        auto const byte = input.front();
+
+        // Typing and erasing only at the end of the line: a line editor inserting or deleting in
+        // the middle shifts the rest of it, which is a redraw rather than an echo.
+        if (byte >= 0x20 && byte < 0x7f && column + 1 < columns && blankFrom(screen, column))
+        {
+            push(screen, static_cast<char32_t>(byte), column, column + 1, now);
+            input.remove_prefix(1);
+            continue;
+        }
+        if ((byte == 0x7f || byte == 0x08) && column > 0 && blankFrom(screen, column))
+        {
+            push(screen, U'\0', column - 1, column - 1, now);
+            input.remove_prefix(1);
+            continue;
+        }
+        // CSI or SS3, as DECCKM has it. A line editor moves right only over text it holds.
+        if (byte == '\033' && input.size() > 2 && (input[1] == '[' || input[1] == 'O'))
+        {
+            auto const final = input[2];
+            if (final == 'D' && column > 0)
+            {
+                push(screen, std::nullopt, column, column - 1, now);
+                input.remove_prefix(3);
+                continue;
+            }
+            if (final == 'C' && column + 1 < columns && !isBlank(expectedAt(screen, column, _pending.size())))
+            {
+                push(screen, std::nullopt, column, column + 1, now);
+                input.remove_prefix(3);
+                continue;
+            }
+        }
+
+        // Enter, a control key, a non-ASCII byte, any other sequence: the rest of the input lands
+        // somewhere this cannot follow.
+        becomeTentative();
+        return;
+    }
+}
+
+void PredictiveEcho::reconcile(RemoteScreen const& screen, Clock::time_point now)
+{
+    if (_pending.empty())
+        return;
+    if (screen.generation != _generation || !predictable(screen))
+    {
+        // The stable ids no longer name the rows they did, or the page is one nothing is predicted
+        // on. Either way nothing outstanding can be checked any more; nothing was shown wrong either.
+        _pending.clear();
+        return;
+    }
+
+    auto const cursor = PredictedCursor { .stableId = screen.viewportBase + screen.cursorLine,
+                                          .column = static_cast<uint16_t>(screen.cursorColumn) };
+    if (cursor.stableId != _pending.front().cursor.stableId)
+    {
+        // The server already acted on something that left the line (an Enter, a redraw). What is
+        // outstanding can no longer be confirmed, only judged.
+        if (cellsShown(screen, _pending.size()))
+            _pending.clear();
+        else
+            withdraw();
+        return;
+    }
+
+    // The LATEST prediction the screen shows confirms every one before it: the server processes
+    // the keys in order, so an update showing the third echo has already handled the first two.
+    for (auto const count: std::views::iota(std::size_t { 1 }, _pending.size() + 1) | std::views::reverse)
+    {
+        auto const& last = _pending[count - 1];
+        if (last.cursor != cursor || !cellsShown(screen, count))
+            continue;
+        auto const sample = now - last.sentAt;
+        _srtt = _srtt ? (*_srtt * (SrttWeight - 1) + sample) / SrttWeight : sample;
+        _confirmedEpoch = std::max(_confirmedEpoch, last.epoch);
+        _pending.erase(_pending.begin(), _pending.begin() + static_cast<std::ptrdiff_t>(count));
+        break;
+    }
+    if (_srtt && *_srtt > DisplayAbove)
+        _display = Display::Shown;
+    else if (_srtt && *_srtt < HideBelow)
+        _display = Display::Hidden;
+
+    // A cell showing something neither it held before nor any outstanding key could have put there
+    // is a contradiction, not a late echo.
+    auto const row = cursor.stableId;
+    for (auto const& prediction: _pending)
+    {
+        if (!prediction.cell)
+            continue;
+        auto const shown = cellAt(screen, row, prediction.cell->column);
+        auto const explains = [&](Prediction const& other) {
+            return other.cell && other.cell->column == prediction.cell->column
+                   && sameGlyph(shown, other.cell->codepoint);
+        };
+        if (!sameGlyph(shown, prediction.original) && std::ranges::none_of(_pending, explains))
+        {
+            withdraw();
+            return;
+        }
+    }
+
+    auto const expiry = std::max<Clock::duration>(MinExpiry, _srtt.value_or(Clock::duration {}) * 4);
+    if (!_pending.empty() && now - _pending.front().sentAt > expiry)
+        withdraw();
+}
+
+EchoOverlay PredictiveEcho::overlay() const
+{
+    auto overlay = EchoOverlay {};
+    if (_display == Display::Hidden)
+        return overlay;
+    // Epochs only grow along the queue, so the shown predictions are a prefix of it.
+    for (auto const& prediction: _pending)
+    {
+        if (prediction.epoch > _confirmedEpoch)
+            break;
+        if (prediction.cell)
+        {
+            auto const same = std::ranges::find_if(overlay.cells, [&](PredictedCell const& cell) {
+                return cell.stableId == prediction.cell->stableId && cell.column == prediction.cell->column;
+            });
+            if (same != overlay.cells.end())
+                *same = *prediction.cell;
+            else
+                overlay.cells.push_back(*prediction.cell);
+        }
+        overlay.cursor = prediction.cursor;
+    }
+    return overlay;
+}
+
+void PredictiveEcho::push(RemoteScreen const& screen,
+                          std::optional<char32_t> codepoint,
+                          int cellColumn,
+                          int cursorColumn,
+                          Clock::time_point now)
+{
+    auto const row = base(screen).stableId;
+    if (_pending.empty())
+        _generation = screen.generation;
+
+    auto prediction = Prediction { .cell = std::nullopt,
+                                   .original = cellAt(screen, row, cellColumn),
+                                   .cursor = PredictedCursor { .stableId = row,
+                                                               .column = static_cast<uint16_t>(cursorColumn) },
+                                   .epoch = _epoch,
+                                   .sentAt = now };
+    if (codepoint)
+        prediction.cell = PredictedCell {
+            .stableId = row, .column = static_cast<uint16_t>(cellColumn), .codepoint = *codepoint
+        };
+    _pending.push_back(prediction);
+}
+
+char32_t PredictiveEcho::cellAt(RemoteScreen const& screen, int64_t stableId, int column)
+{
+    auto const row = screen.rows.find(stableId);
+    if (row == screen.rows.end() || std::cmp_greater_equal(column, row->second.cells.size()))
+        return 0; // an omitted trailing column wears the fill, and holds no text
+    return row->second.cells[static_cast<std::size_t>(column)].codepoint;
+}
+
+char32_t PredictiveEcho::expectedAt(RemoteScreen const& screen, int column, std::size_t count) const
+{
+    for (auto const i: std::views::iota(std::size_t { 0 }, count) | std::views::reverse)
+        if (auto const& cell = _pending[i].cell; cell && cell->column == column)
+            return cell->codepoint;
+    return cellAt(screen, base(screen).stableId, column);
+}
+
+bool PredictiveEcho::blankFrom(RemoteScreen const& screen, int column) const
+{
+    for (auto const at: std::views::iota(column, static_cast<int>(screen.columns)))
+        if (!isBlank(expectedAt(screen, at, _pending.size())))
+            return false;
+    return true;
+}
+
+bool PredictiveEcho::cellsShown(RemoteScreen const& screen, std::size_t count) const
+{
+    for (auto const i: std::views::iota(std::size_t { 0 }, count))
+    {
+        auto const& cell = _pending[i].cell;
+        if (cell
+            && !sameGlyph(cellAt(screen, cell->stableId, cell->column),
+                          expectedAt(screen, cell->column, count)))
+            return false;
+    }
+    return true;
+}
+
+PredictedCursor PredictiveEcho::base(RemoteScreen const& screen) const
+{
+    if (!_pending.empty())
+        return _pending.back().cursor;
+    return PredictedCursor { .stableId = screen.viewportBase + screen.cursorLine,
+                             .column = static_cast<uint16_t>(screen.cursorColumn) };
+}
+
+void PredictiveEcho::withdraw() noexcept
+{
+    _pending.clear();
+    becomeTentative();
+}
+
+} // namespace vthost::client
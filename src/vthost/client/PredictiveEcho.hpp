@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// `PredictiveEcho` — speculative local echo for a daemon-hosted pane on a slow link.
+///
+/// Every keystroke in an attached pane travels to the daemon, into the hosted shell, and back as a
+/// Delta before the user sees it. On a loopback socket that is invisible; over `--connect-tcp` to
+/// a distant host, each character appears one round trip late. This class guesses what the echo
+/// will be — the way mosh does — so the mirror can show it at once, and checks each guess against
+/// the authoritative screen when the Delta arrives.
+///
+/// **What is predicted.** Deliberately little: printable ASCII and backspace at the END of the
+/// line being edited, and the left/right arrow keys. Those are what a line editor echoes verbatim.
+/// Anything else (Enter, a control key, a non-ASCII byte, any other sequence) has an effect this
+/// cannot follow, so it ends the run of predictions instead of guessing.
+///
+/// **When predictions show.** Only while the measured round trip is long enough to be worth it,
+/// and only for an EPOCH the server has already confirmed. Every unpredictable key opens a new
+/// epoch, and the predictions made in it stay hidden until one of them is echoed correctly. The
+/// terminal's echo flag is the pty's, and does not travel: this is how a password typed after
+/// Enter stays off the screen — nothing typed at a prompt that does not echo is ever confirmed.
+///
+/// **Where it is off.** On the alternate screen and while the application tracks the mouse: a
+/// full-screen program draws its own cursor and text, and nothing about a keystroke's effect
+/// there is predictable.
+///
+/// No timer drives it: a wrong guess the server never contradicts is withdrawn by the next update
+/// or keystroke after it expires.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <vthost/client/NativeClient.hpp>
+
+namespace vthost::client
+{
+
+/// A position on the mirrored screen, by the row's stable id.
+struct PredictedCursor
+{
+    int64_t stableId = 0;
+    uint16_t column = 0;
+    bool operator==(PredictedCursor const&) const = default;
+};
+
+/// One cell as a keystroke is expected to leave it once the server echoes it.
+struct PredictedCell
+{
+    int64_t stableId = 0;
+    uint16_t column = 0;
+    char32_t codepoint = 0; ///< 0 = erased; the row's fill shows through.
+    bool operator==(PredictedCell const&) const = default;
+};
+
+/// What to draw over the authoritative screen: the cells the confirmed predictions change (at
+/// most one per position), and where they leave the cursor.
+struct EchoOverlay
+{
+    std::vector<PredictedCell> cells;
+    std::optional<PredictedCursor> cursor; ///< nullopt: the server's cursor stands.
+};
+
+/// Whether a client predicts the echo of its panes at all.
+enum class PredictiveEchoMode : uint8_t
+{
+    /// The echo is shown as the server sends it; right on a fast link, where it is there at once.
+    Disabled,
+    /// Typing shows before the server echoes it, once the link is slow enough to be worth it.
+    Enabled,
+};
+
+/// The per-pane predictor. Owned next to the pane's `ScreenMirror`; all calls on the thread that
+/// applies the pane's updates.
+class PredictiveEcho
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Predictions start showing once the smoothed round trip exceeds this...
+    static constexpr auto DisplayAbove = std::chrono::milliseconds(30);
+    /// ...and stop once it falls below this. The gap keeps a jittery link from flickering.
+    static constexpr auto HideBelow = std::chrono::milliseconds(20);
+    /// How long an unconfirmed prediction may stand before it counts as wrong, at least.
+    static constexpr auto MinExpiry = std::chrono::milliseconds(1000);
+    /// Predictions outstanding at most; input beyond it is sent unpredicted. Typing faster than
+    /// this per round trip is a paste, which the shell does not echo key by key anyway.
+    static constexpr std::size_t MaxPending = 64;
+
+    /// Predicts the echo of @p input, which was just sent to the session @p screen mirrors.
+    /// @param screen The authoritative screen as last updated.
+    /// @param input The bytes sent, as the terminal encoded them.
+    /// @param now When they were sent.
+    void predict(RemoteScreen const& screen, std::string_view input, Clock::time_point now);
+
+    /// Checks the outstanding predictions against @p screen: confirms those it shows, withdraws
+    /// them all on any it contradicts, and expires those it never got to.
+    /// @param screen The authoritative screen, just updated.
+    /// @param now The current time.
+    void reconcile(RemoteScreen const& screen, Clock::time_point now);
+
+    /// @return What the mirror should draw over the authoritative screen now.
+    [[nodiscard]] EchoOverlay overlay() const;
+
+    /// @return The smoothed keystroke-to-echo time, or nullopt before the first echo confirmed.
+    [[nodiscard]] std::optional<Clock::duration> smoothedRtt() const noexcept { return _srtt; }
+
+    /// @return How many predictions await their echo.
+    [[nodiscard]] std::size_t pendingCount() const noexcept { return _pending.size(); }
+
+  private:
+    struct Prediction
+    {
+        std::optional<PredictedCell> cell; ///< nullopt for a pure cursor motion.
+        char32_t original = 0;             ///< What the cell held when the key was pressed.
+        PredictedCursor cursor;            ///< Where the cursor is expected afterwards.
+        uint64_t epoch = 0;
+        Clock::time_point sentAt;
+    };
+
+    /// Queues one prediction on the row new input is predicted on (@see base).
+    /// @param codepoint What the key leaves at @p cellColumn; nullopt for a pure cursor motion.
+    void push(RemoteScreen const& screen,
+              std::optional<char32_t> codepoint,
+              int cellColumn,
+              int cursorColumn,
+              Clock::time_point now);
+
+    /// The authoritative codepoint at @p column of @p stableId, blank where the row omits it.
+    [[nodiscard]] static char32_t cellAt(RemoteScreen const& screen, int64_t stableId, int column);
+
+    /// What @p column of the predicted row is expected to hold: the newest prediction for it of the
+    /// first @p count, else the authoritative cell.
+    [[nodiscard]] char32_t expectedAt(RemoteScreen const& screen, int column, std::size_t count) const;
+
+    /// Whether every column from @p column to the margin is expected to be blank.
+    [[nodiscard]] bool blankFrom(RemoteScreen const& screen, int column) const;
+
+    /// Whether the screen shows every cell the first @p count predictions leave.
+    [[nodiscard]] bool cellsShown(RemoteScreen const& screen, std::size_t count) const;
+
+    /// The cursor new input is predicted from: the last prediction's, else the server's.
+    [[nodiscard]] PredictedCursor base(RemoteScreen const& screen) const;
+
+    /// Ends the current epoch; predictions made from here on stay hidden until one is confirmed.
+    void becomeTentative() noexcept { ++_epoch; }
+
+    /// A misprediction: drops every prediction and starts a tentative epoch.
+    void withdraw() noexcept;
+
+    /// Whether confirmed predictions are drawn, as the smoothed round trip decides.
+    enum class Display : uint8_t
+    {
+        Hidden,
+        Shown,
+    };
+
+    std::deque<Prediction> _pending;
+    uint64_t _epoch = 1;
+    /// The newest epoch the server confirmed a prediction of. Starts behind `_epoch`, so nothing
+    /// shows until the first echo proves the pane echoes at all.
+    uint64_t _confirmedEpoch = 0;
+    uint64_t _generation = 0; ///< The grid the outstanding predictions' stable ids name.
+    std::optional<Clock::duration> _srtt;
+    Display _display = Display::Hidden;
+};
+
+} // namespace vthost::client
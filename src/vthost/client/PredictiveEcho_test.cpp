@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string_view>
+
+#include <vthost/client/PredictiveEcho.hpp>
+
+using vthost::client::PredictedCell;
+using vthost::client::PredictedCursor;
+using vthost::client::PredictiveEcho;
+using vthost::client::RemoteScreen;
+namespace proto = vthost::proto;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/// A 20x3 primary screen showing a `$ ` prompt on row 0, with the cursor after it.
+RemoteScreen promptScreen()
+{
+    auto screen = RemoteScreen {};
+    screen.columns = 20;
+    screen.lines = 3;
+    auto row = proto::WireLine {};
+    for (auto const ch: std::string_view { "$ " })
+        row.cells.push_back(proto::WireCell { .codepoint = static_cast<char32_t>(ch) });
+    screen.rows[0] = row;
+    screen.cursorColumn = 2;
+    return screen;
+}
+
+/// Echoes @p text at the cursor the way a line editor would, as the server's next update shows it.
+void echo(RemoteScreen& screen, std::string_view text)
+{
+    auto& cells = screen.rows[screen.viewportBase + screen.cursorLine].cells;
+    for (auto const ch: text)
+    {
+        auto const column = static_cast<std::size_t>(screen.cursorColumn++);
+        if (cells.size() <= column)
+            cells.resize(column + 1);
+        cells[column].codepoint = static_cast<char32_t>(ch);
+    }
+}
+
+/// A predictor that has seen one keystroke echoed after @p rtt, so its epoch is confirmed.
+PredictiveEcho confirmedAfter(RemoteScreen& screen, PredictiveEcho::Clock::duration rtt)
+{
+    auto predictor = PredictiveEcho {};
+    auto const sent = PredictiveEcho::Clock::time_point {};
+    predictor.predict(screen, "l", sent);
+    echo(screen, "l");
+    predictor.reconcile(screen, sent + rtt);
+    REQUIRE(predictor.pendingCount() == 0);
+    return predictor;
+}
+
+} // namespace
+
+TEST_CASE("predicted typing shows once an echo is confirmed on a slow link", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = PredictiveEcho {};
+    auto const t0 = PredictiveEcho::Clock::time_point {};
+
+    // The first keystroke proves nothing yet: the pane may not echo at all.
+    predictor.predict(screen, "l", t0);
+    CHECK(predictor.overlay().cells.empty());
+
+    echo(screen, "l");
+    predictor.reconcile(screen, t0 + 120ms);
+    CHECK(predictor.pendingCount() == 0);
+    REQUIRE(predictor.smoothedRtt() == 120ms);
+
+    predictor.predict(screen, "s", t0 + 200ms);
+    auto const overlay = predictor.overlay();
+    REQUIRE(overlay.cells.size() == 1);
+    CHECK(overlay.cells[0] == PredictedCell { .stableId = 0, .column = 3, .codepoint = U's' });
+    CHECK(overlay.cursor == PredictedCursor { .stableId = 0, .column = 4 });
+
+    // The echo lands: nothing is left to draw over it.
+    echo(screen, "s");
+    predictor.reconcile(screen, t0 + 320ms);
+    CHECK(predictor.pendingCount() == 0);
+    CHECK(predictor.overlay().cells.empty());
+}
+
+TEST_CASE("predictions stay hidden on a fast link", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 2ms);
+    predictor.predict(screen, "s", PredictiveEcho::Clock::time_point {} + 10ms);
+    CHECK(predictor.pendingCount() == 1);
+    CHECK(predictor.overlay().cells.empty());
+}
+
+TEST_CASE("one update confirms every predicted key it echoes", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 100ms);
+    auto const t0 = PredictiveEcho::Clock::time_point {} + 1s;
+
+    predictor.predict(screen, "s -", t0);
+    CHECK(predictor.overlay().cells.size() == 3);
+
+    // The server has handled the first two keys so far.
+    echo(screen, "s ");
+    predictor.reconcile(screen, t0 + 100ms);
+    CHECK(predictor.pendingCount() == 1);
+    auto const overlay = predictor.overlay();
+    REQUIRE(overlay.cells.size() == 1);
+    CHECK(overlay.cells[0].codepoint == U'-');
+}
+
+TEST_CASE("erasing and moving along the line are predicted", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 100ms);
+    auto const t0 = PredictiveEcho::Clock::time_point {} + 1s;
+
+    predictor.predict(screen, "ab\x7f", t0);
+    auto const overlay = predictor.overlay();
+    REQUIRE(overlay.cells.size() == 2);
+    CHECK(overlay.cells[1] == PredictedCell { .stableId = 0, .column = 4, .codepoint = 0 });
+    CHECK(overlay.cursor == PredictedCursor { .stableId = 0, .column = 4 });
+
+    // Right only over text the line holds; the cell after it is blank.
+    predictor.predict(screen, "\033[D\033OC", t0);
+    CHECK(predictor.overlay().cursor == PredictedCursor { .stableId = 0, .column = 4 });
+    auto const before = predictor.pendingCount();
+    predictor.predict(screen, "\033[C", t0);
+    CHECK(predictor.pendingCount() == before);
+
+    // Inserting mid-line shifts the text after it, which is not an echo.
+    predictor.predict(screen, "\033[D", t0);
+    auto const moved = predictor.pendingCount();
+    predictor.predict(screen, "x", t0);
+    CHECK(predictor.pendingCount() == moved);
+}
+
+TEST_CASE("what is typed after Enter stays hidden until it echoes", "[vthost][echo]")
+{
+    // A password prompt: the pty stopped echoing, which nothing on the wire says.
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 100ms);
+    auto const t0 = PredictiveEcho::Clock::time_point {} + 1s;
+
+    predictor.predict(screen, "\r", t0);
+    screen.cursorLine = 1;
+    screen.cursorColumn = 10; // "Password: "
+    predictor.reconcile(screen, t0 + 100ms);
+
+    predictor.predict(screen, "hunter2", t0 + 200ms);
+    CHECK(predictor.pendingCount() == 7);
+    CHECK(predictor.overlay().cells.empty());
+
+    // Never echoed, so never confirmed — and eventually given up on.
+    predictor.reconcile(screen, t0 + 200ms + PredictiveEcho::MinExpiry + 1ms);
+    CHECK(predictor.pendingCount() == 0);
+    predictor.predict(screen, "x", t0 + 2s);
+    CHECK(predictor.overlay().cells.empty());
+}
+
+TEST_CASE("a contradicted prediction withdraws them all", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 100ms);
+    auto const t0 = PredictiveEcho::Clock::time_point {} + 1s;
+
+    predictor.predict(screen, "sx", t0);
+    REQUIRE(predictor.overlay().cells.size() == 2);
+
+    // The application echoed something else entirely where the prediction stood.
+    echo(screen, "S");
+    predictor.reconcile(screen, t0 + 100ms);
+    CHECK(predictor.pendingCount() == 0);
+    CHECK(predictor.overlay().cells.empty());
+
+    // And it must prove itself again before anything shows.
+    predictor.predict(screen, "y", t0 + 200ms);
+    CHECK(predictor.overlay().cells.empty());
+}
+
+TEST_CASE("nothing is predicted for full-screen applications", "[vthost][echo]")
+{
+    auto screen = promptScreen();
+    auto predictor = confirmedAfter(screen, 100ms);
+    auto const t0 = PredictiveEcho::Clock::time_point {} + 1s;
+
+    screen.screenType = 1;
+    predictor.predict(screen, "j", t0);
+    CHECK(predictor.pendingCount() == 0);
+
+    screen.screenType = 0;
+    screen.mouse.protocol = 1000;
+    predictor.predict(screen, "j", t0);
+    CHECK(predictor.pendingCount() == 0);
+
+    // Back at the prompt, the first keystroke has to echo again before predictions show.
+    screen.mouse.protocol = 0;
+    predictor.predict(screen, "j", t0);
+    CHECK(predictor.pendingCount() == 1);
+    CHECK(predictor.overlay().cells.empty());
+}
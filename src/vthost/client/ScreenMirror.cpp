@@ -84,6 +84,42 @@ namespace
         }
         return placements;
     }
+
+    /// What an omitted trailing column of @p row decodes back to: no text, the row's whole fill.
+    [[nodiscard]] proto::WireCell fillOf(proto::WireLine const& row)
+    {
+        auto cell = proto::WireCell {};
+        cell.foreground = row.fillForeground;
+        cell.background = row.fillBackground;
+        cell.underlineColor = row.fillUnderlineColor;
+        cell.flags = row.fillFlags;
+        return cell;
+    }
+
+    /// @p row with @p cells written over it, padded with its fill out to the rightmost of them.
+    [[nodiscard]] proto::WireLine predictedRow(proto::WireLine row, std::vector<PredictedCell> const& cells)
+    {
+        for (auto const& predicted: cells)
+        {
+            if (predicted.stableId != row.stableId)
+                continue;
+            if (row.cells.size() <= predicted.column)
+                row.cells.resize(predicted.column + 1u, fillOf(row));
+            auto& cell = row.cells[predicted.column];
+            if (predicted.codepoint == 0)
+            {
+                cell = fillOf(row);
+                continue;
+            }
+            // The rendition stays the cell's own: the pen the application will echo with is not
+            // known until it does.
+            cell.codepoint = predicted.codepoint;
+            cell.clusterExtras.clear();
+            cell.width = 1;
+            cell.hyperlink = 0;
+        }
+        return row;
+    }
 } // namespace
 
 vtbackend::Screen& ScreenMirror::activePage() const noexcept
@@ -229,7 +265,7 @@ void ScreenMirror::apply(RemoteScreen const& screen, proto::Delta const& delta)
     _floor = screen.stableFloor;
 
     {
-        auto const guard = std::lock_guard { *_terminal };
+        auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Mirror };
         syncHyperlinks(screen); // before any row: a cell's link id is unresolvable without it
         auto& page = activePage();
         auto const lines = unbox<int64_t>(page.pageSize().lines);
@@ -248,6 +284,16 @@ void ScreenMirror::apply(RemoteScreen const& screen, proto::Delta const& delta)
         for (auto const& row: delta.lines)
             if (row.stableId >= _alignedFloor && row.stableId < oldBase + lines)
                 writeRow(page, screen, row.stableId, row.stableId - oldBase);
+        //    A row a margin scroll moved arrives as no line at all: its new content is already in
+        //    `screen`, which applied the shift, so repaint the shifted range from there. Clamped to
+        //    the page, since the range is peer-announced and a shift only ever moves page rows.
+        for (auto const& shift: delta.rowShifts)
+        {
+            auto const top = std::max({ shift.top, oldBase, _alignedFloor });
+            auto const bottom = std::min(shift.bottom, oldBase + lines - 1);
+            for (auto const id: std::views::iota(top, std::max(top, bottom + 1)))
+                writeRow(page, screen, id, id - oldBase);
+        }
 
         // 2. Scroll the viewport advance in, row by row, so rows that pass straight through
         //    (entering and leaving within one update) still land in local history.
@@ -315,7 +361,7 @@ void ScreenMirror::fullReplay(RemoteScreen const& screen, LocalHistory history)
     _lines = screen.lines;
 
     {
-        auto const guard = std::lock_guard { *_terminal };
+        auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Mirror };
         syncHyperlinks(screen); // before any row: a cell's link id is unresolvable without it
         // The page has to be the right one BEFORE _screenType is adopted: activePage() reads it.
         auto const wantAlternate = screen.screenType == 1;
@@ -598,7 +644,7 @@ void ScreenMirror::applyImages(RemoteScreen const& screen)
 void ScreenMirror::applyImage(RemoteScreen const& screen, uint32_t imageId)
 {
     {
-        auto const guard = std::lock_guard { *_terminal };
+        auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Mirror };
         if (screen.imageData(imageId) == nullptr)
             // Dropped server-side: forget the local copy so a reused id can never show stale
             // pixels. The cells referencing it were already cleared by RemoteScreen::dropImage
@@ -627,6 +673,59 @@ void ScreenMirror::applyEvent(proto::SessionEventPdu const& event)
         event);
 }
 
+void ScreenMirror::applyOverlay(RemoteScreen const& screen, EchoOverlay const& overlay)
+{
+    if (!_primed || (_overlay == Overlay::Absent && overlay.cells.empty() && !overlay.cursor))
+        return;
+    {
+        auto const guard = vtbackend::Terminal::SiteLock { *_terminal, vtbackend::LockSite::Mirror };
+        auto& page = activePage();
+        auto const lines = unbox<int64_t>(page.pageSize().lines);
+        auto const onPage = [&](int64_t stableId) {
+            return stableId >= _viewportBase && stableId < _viewportBase + lines;
+        };
+
+        // Restored rather than trusted to the update just applied: that only rewrote the rows the
+        // server changed, and a prediction it contradicted sits on one it may not have touched.
+        for (auto const stableId: std::exchange(_overlaidRows, {}))
+            writeRow(page, screen, stableId, stableId - _viewportBase);
+
+        for (auto const& predicted: overlay.cells)
+        {
+            auto const drawn = std::ranges::find(_overlaidRows, predicted.stableId) != _overlaidRows.end();
+            if (drawn || !onPage(predicted.stableId))
+                continue;
+            auto row = proto::WireLine {};
+            if (auto const* authoritative = rowOrNull(screen, predicted.stableId))
+                row = *authoritative;
+            else
+            {
+                auto const fill = wireCellOf(vtbackend::GraphicsAttributes {});
+                row.stableId = predicted.stableId;
+                row.fillForeground = fill.foreground;
+                row.fillBackground = fill.background;
+                row.fillUnderlineColor = fill.underlineColor;
+                row.fillFlags = fill.flags;
+            }
+            auto const target = vtbackend::LineOffset::cast_from(predicted.stableId - _viewportBase);
+            auto& line = page.grid().lineAt(target);
+            applyWireLine(line, predictedRow(std::move(row), overlay.cells), _linkIds);
+            _overlaidRows.push_back(predicted.stableId);
+        }
+
+        _overlay = !_overlaidRows.empty() || overlay.cursor.has_value() ? Overlay::Drawn : Overlay::Absent;
+        if (overlay.cursor && onPage(overlay.cursor->stableId))
+        {
+            page.moveCursorTo(vtbackend::LineOffset::cast_from(overlay.cursor->stableId - _viewportBase),
+                              vtbackend::ColumnOffset::cast_from(overlay.cursor->column));
+            _terminal->markScreenDirty();
+        }
+        else
+            finish(screen);
+    }
+    _terminal->screenUpdated();
+}
+
 void ScreenMirror::finish(RemoteScreen const& screen)
 {
     activePage().moveCursorTo(vtbackend::LineOffset::cast_from(screen.cursorLine),
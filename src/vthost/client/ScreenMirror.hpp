@@ -29,7 +29,9 @@
 ///
 /// The mirror OWNS its terminal's screen, and its scrollback is real scrollback built by scrolling
 /// rows through the page — so a resync must not erase it unless the server actually discarded its
-/// own (@see LocalHistory).
+/// own (@see LocalHistory). It is also the ONLY copy: once an update is applied, the owner lets the
+/// `RemoteScreen` drop its rows above the viewport (@see RemoteScreen::releaseHistory), which is
+/// why nothing here may read a history row that the update being applied did not carry.
 
 #include <vtbackend/Image.hpp>
 #include <vtbackend/Screen.hpp>
@@ -38,8 +40,10 @@
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <vthost/client/NativeClient.hpp>
+#include <vthost/client/PredictiveEcho.hpp>
 #include <vthost/proto/Pdu.hpp>
 
 namespace vthost::client
@@ -91,6 +95,9 @@ class ScreenMirror
     {
     }
 
+    /// The terminal this mirror keeps in sync.
+    [[nodiscard]] vtbackend::Terminal& terminal() const noexcept { return *_terminal; }
+
     /// Brings the mirror terminal up to date with @p screen after @p delta was applied to it.
     /// Falls back to a full replay on the first call, on snapshot deltas, and on generation,
     /// size or screen-type changes.
@@ -115,6 +122,14 @@ class ScreenMirror
     /// it — what the client's image handler calls so the image appears where the delta put it.
     void applyImage(RemoteScreen const& screen, uint32_t imageId);
 
+    /// Draws @p overlay — predicted local echo (@see PredictiveEcho) — over the page, after first
+    /// restoring from @p screen whatever the previous overlay drew on. Called after every update
+    /// and keystroke while prediction is on, so the overlay is redrawn on top of each update rather
+    /// than merged into it: the grid the mirror maintains stays the server's.
+    /// @param screen The authoritative screen the page was last brought up to date with.
+    /// @param overlay What to draw over it; empty to show the server's screen alone.
+    void applyOverlay(RemoteScreen const& screen, EchoOverlay const& overlay);
+
     /// Reproduces a transient session event (bell / desktop notification / OSC 52 clipboard write)
     /// on the mirror terminal, so the frontend's own bell, notify and clipboard handling — and its
     /// permissions — apply. Stateless: the event carries everything it needs.
@@ -209,6 +224,17 @@ class ScreenMirror
     uint32_t _columns = 0;
     uint32_t _lines = 0;
     uint8_t _screenType = 0;
+    /// Whether the last overlay left anything on the page: rows, or the cursor it moved.
+    enum class Overlay : uint8_t
+    {
+        Absent,
+        Drawn,
+    };
+
+    /// The rows the last overlay drew on, by stable id, to restore from the screen before the next
+    /// one; and whether it drew anything at all. @see applyOverlay.
+    std::vector<int64_t> _overlaidRows;
+    Overlay _overlay = Overlay::Absent;
     /// Wire hyperlink id → this terminal's own id, so a URI is registered once and every later
     /// cell referencing it resolves without a lookup by string. Re-pointed, never merely inserted:
     /// the sender's id space wraps, and @see syncHyperlinks for what a reused id must do.
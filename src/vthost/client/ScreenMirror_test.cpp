@@ -92,6 +92,8 @@ struct MirrorHarness
                        [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                        gipSettings(ServerHistoryLines),
                        crispy::defaultEnvironment(),
+                       /*metrics=*/nullptr,
+                       /*traceFile=*/std::nullopt,
                        /*startPumps=*/false };
     net::testing::SocketPair pair = *net::testing::makeSocketPair(loop);
     std::unique_ptr<NativeSession> server = std::make_unique<NativeSession>(
@@ -109,6 +111,7 @@ struct MirrorHarness
         auto settings = gipSettings(MirrorHistoryLines);
         mirror = std::make_unique<vtbackend::Terminal>(mirrorEvents,
                                                        crispy::defaultEnvironment(),
+                                                       /*traceRecorder=*/nullptr,
                                                        std::make_unique<vtpty::MockPty>(settings.pageSize),
                                                        std::move(settings),
                                                        std::chrono::steady_clock::now());
@@ -241,6 +244,7 @@ struct BareMirror
         settings.maxHistoryLineCount = history;
         terminal = std::make_unique<vtbackend::Terminal>(events,
                                                          crispy::defaultEnvironment(),
+                                                         /*traceRecorder=*/nullptr,
                                                          std::make_unique<vtpty::MockPty>(settings.pageSize),
                                                          std::move(settings),
                                                          std::chrono::steady_clock::now());
@@ -938,6 +942,50 @@ TEST_CASE("attaching to a session with scrollback receives it as local scrollbac
     h.loop.blockOn(drive(&h, std::move(scenario)));
 }
 
+TEST_CASE("a mirror that owns the scrollback lets the client drop its copy", "[vthost][mirror]")
+{
+    // What NativeController does: once the mirror applied an update, the rows above the viewport
+    // live in the mirror terminal's history, and the client's copy of them is released. Neither the
+    // history already there at attach time nor rows scrolling by later may go missing for it.
+    auto h = MirrorHarness {};
+    h.host.createTab();
+    auto const session = h.host.model().window(h.host.windowId())->activeTab()->rootPane()->session();
+    h.serverTerminal(session)->writeToScreen(numberedRows(40));
+
+    h.client->setUpdateHandler(
+        [h = &h](vthost::client::RemoteScreen const& screen, proto::Delta const& delta) {
+            h->populator->apply(screen, delta);
+            h->client->releaseHistory(screen.session);
+        });
+
+    auto scenario = [](MirrorHarness* h, vtworkspace::SessionId session) -> Task<void> {
+        co_await waitUntil(&h->loop, [h] {
+            return h->mirror->primaryScreen().grid().renderMainPageText().contains("row-39");
+        });
+
+        auto scrolled = std::string {};
+        for (auto const i: std::views::iota(0, 30))
+            scrolled += std::format("\r\nline-{}", i);
+        serverWrites(h, session, scrolled);
+        co_await waitUntil(&h->loop, [&] {
+            return h->mirror->primaryScreen().grid().renderMainPageText().contains("line-29");
+        });
+
+        auto const& remote = h->client->screens().at(session.value);
+        CHECK(!remote.rows.empty());
+        CHECK(remote.rows.begin()->first >= remote.viewportBase);
+
+        auto const& serverGrid = h->serverTerminal(session)->primaryScreen().grid();
+        auto const& mirrorGrid = h->mirror->primaryScreen().grid();
+        CHECK(mirrorGrid.renderMainPageText() == serverGrid.renderMainPageText());
+        checkHistoryMatches(mirrorGrid, serverGrid);
+
+        h->client->detach();
+    }(&h, session);
+
+    h.loop.blockOn(drive(&h, std::move(scenario)));
+}
+
 TEST_CASE("a client that attached on the alternate screen gets the primary's scrollback", "[vthost][mirror]")
 {
     // Attaching does not always find a session on the primary page. The daemon snapshots the
@@ -2240,3 +2288,36 @@ TEST_CASE("LNM mirrors so the client encodes Return the way the app asked", "[vt
     CHECK(lnmAfterSet);
     CHECK_FALSE(lnmAfterReset);
 }
+
+// Predicted local echo is drawn OVER the rows the server sent and never merged into them: the next
+// overlay first restores whatever the previous one drew on, so a withdrawn prediction leaves
+// nothing behind, not even on a row the server's own update did not touch.
+TEST_CASE("a predicted echo overlay is drawn over the page and withdrawn cleanly", "[vthost][mirror]")
+{
+    auto bare = BareMirror { vtbackend::LineCount(100) };
+    auto screen = vthost::client::RemoteScreen {};
+    screen.columns = 5;
+    screen.lines = 1;
+
+    auto seed = proto::Delta {};
+    seed.snapshot = 1;
+    seed.stableViewportBase = 10;
+    seed.stableFloor = 10;
+    seed.cursorColumn = 2;
+    seed.lines.push_back(rowAt(10, "$ "));
+    screen.apply(seed);
+    bare.mirror->apply(screen, seed);
+
+    auto const& page = bare.terminal->primaryScreen();
+    auto overlay = vthost::client::EchoOverlay {};
+    overlay.cells.push_back({ .stableId = 10, .column = 2, .codepoint = U'l' });
+    overlay.cells.push_back({ .stableId = 10, .column = 3, .codepoint = U's' });
+    overlay.cursor = vthost::client::PredictedCursor { .stableId = 10, .column = 4 };
+    bare.mirror->applyOverlay(screen, overlay);
+    CHECK(page.grid().lineText(vtbackend::LineOffset(0)).starts_with("$ ls"));
+    CHECK(page.cursor().position.column == vtbackend::ColumnOffset(4));
+
+    bare.mirror->applyOverlay(screen, vthost::client::EchoOverlay {});
+    CHECK(page.grid().lineTextTrimmed(vtbackend::LineOffset(0)) == "$");
+    CHECK(page.cursor().position.column == vtbackend::ColumnOffset(2));
+}
@@ -194,6 +194,14 @@ namespace
     {
         return std::to_underlying(PduType::ResizeSplit);
     }
+    [[nodiscard]] constexpr uint64_t tagOf(SharedDelta const&) noexcept
+    {
+        return std::to_underlying(PduType::SharedDelta);
+    }
+    [[nodiscard]] constexpr uint64_t tagOf(SharedRelease const&) noexcept
+    {
+        return std::to_underlying(PduType::SharedRelease);
+    }
 
     // --- body encoders ------------------------------------------------------
 
@@ -244,10 +252,22 @@ namespace
         out.u8(pdu.sessionSettings.has_value() ? 1 : 0);
         if (pdu.sessionSettings)
             encodeSessionSettings(out, *pdu.sessionSettings);
+        out.varint(pdu.resumeInstance);
+        out.varint(pdu.resume.size());
+        for (auto const& cursor: pdu.resume)
+        {
+            out.varint(cursor.session);
+            out.varint(cursor.generation);
+            out.varint(cursor.seqno);
+            out.svarint(cursor.stableBase);
+        }
+        out.u8(pdu.sharedMemory ? 1 : 0);
     }
     void encodeBody(Writer& out, ServerHello const& pdu)
     {
         out.u32(pdu.codecVersion);
+        out.varint(pdu.instance);
+        out.varint(pdu.sharedBytes);
     }
 
     void encodeBody(Writer& out, Input const& pdu)
@@ -358,6 +378,14 @@ namespace
         out.svarint(pdu.cursorLine);
         out.svarint(pdu.cursorColumn);
 
+        out.varint(pdu.rowShifts.size());
+        for (auto const& shift: pdu.rowShifts)
+        {
+            out.svarint(shift.top);
+            out.svarint(shift.bottom);
+            out.svarint(shift.count);
+        }
+
         out.varint(pdu.lines.size());
         for (auto const& line: pdu.lines)
             encodeLine(out, line);
@@ -464,6 +492,17 @@ namespace
         out.u16(pdu.ratio);
     }
 
+    void encodeBody(Writer& out, SharedDelta const& pdu)
+    {
+        out.varint(pdu.offset);
+        out.varint(pdu.length);
+    }
+
+    void encodeBody(Writer& out, SharedRelease const& pdu)
+    {
+        out.varint(pdu.offset);
+    }
+
     /// Encodes one split-tree node pre-order (recurses into its children).
     void encodePane(Writer& out, WirePane const& pane)
     {
@@ -542,6 +581,25 @@ namespace
                 return std::unexpected(settings.error());
             pdu.sessionSettings = *std::move(settings);
         }
+        if (!assign(in.varint(), pdu.resumeInstance, error))
+            return std::unexpected(error);
+        if (auto const decoded =
+                decodeVector(in,
+                             pdu.resume,
+                             [](Reader& reader) -> std::expected<ResumeCursor, DecodeError> {
+                                 auto cursor = ResumeCursor {};
+                                 auto error = DecodeError {};
+                                 if (!assign(reader.varint(), cursor.session, error)
+                                     || !assign(reader.varint(), cursor.generation, error)
+                                     || !assign(reader.varint(), cursor.seqno, error)
+                                     || !assign(reader.svarint(), cursor.stableBase, error))
+                                     return std::unexpected(error);
+                                 return cursor;
+                             });
+            !decoded)
+            return std::unexpected(decoded.error());
+        if (!assign(in.u8(), pdu.sharedMemory, error))
+            return std::unexpected(error);
         return pdu;
     }
 
@@ -549,7 +607,8 @@ namespace
     {
         auto pdu = ServerHello {};
         auto error = DecodeError {};
-        if (!assign(in.u32(), pdu.codecVersion, error))
+        if (!assign(in.u32(), pdu.codecVersion, error) || !assign(in.varint(), pdu.instance, error)
+            || !assign(in.varint(), pdu.sharedBytes, error))
             return std::unexpected(error);
         return pdu;
     }
@@ -699,6 +758,20 @@ namespace
             || !assign(in.svarint(), pdu.cursorColumn, error))
             return std::unexpected(error);
 
+        if (auto const decoded = decodeVector(in,
+                                              pdu.rowShifts,
+                                              [](Reader& reader) -> std::expected<RowShift, DecodeError> {
+                                                  auto shift = RowShift {};
+                                                  auto error = DecodeError {};
+                                                  if (!assign(reader.svarint(), shift.top, error)
+                                                      || !assign(reader.svarint(), shift.bottom, error)
+                                                      || !assign(reader.svarint(), shift.count, error))
+                                                      return std::unexpected(error);
+                                                  return shift;
+                                              });
+            !decoded)
+            return std::unexpected(decoded.error());
+
         if (auto const decoded = decodeVector(in, pdu.lines, decodeLine); !decoded)
             return std::unexpected(decoded.error());
 
@@ -848,6 +921,24 @@ namespace
         return pdu;
     }
 
+    DecodeResult decodeSharedDelta(Reader& in)
+    {
+        auto pdu = SharedDelta {};
+        auto error = DecodeError {};
+        if (!assign(in.varint(), pdu.offset, error) || !assign(in.varint(), pdu.length, error))
+            return std::unexpected(error);
+        return pdu;
+    }
+
+    DecodeResult decodeSharedRelease(Reader& in)
+    {
+        auto pdu = SharedRelease {};
+        auto error = DecodeError {};
+        if (!assign(in.varint(), pdu.offset, error))
+            return std::unexpected(error);
+        return pdu;
+    }
+
     /// Decodes one split-tree node (recursing into its children). @p depth bounds
     /// the recursion so a hostile deeply-nested tree cannot overflow the stack.
     std::expected<WirePane, DecodeError> decodePane(Reader& in, int depth)
@@ -936,6 +1027,8 @@ namespace
         DecodeRow { PduType::ClosePane, decodeClosePane },
         DecodeRow { PduType::NewWindow, decodeNewWindow },
         DecodeRow { PduType::ResizeSplit, decodeResizeSplit },
+        DecodeRow { PduType::SharedDelta, decodeSharedDelta },
+        DecodeRow { PduType::SharedRelease, decodeSharedRelease },
     };
 
     // The catalog and its decode half must stay in step. Invalid is the one alternative with
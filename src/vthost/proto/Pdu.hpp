@@ -56,6 +56,8 @@ enum class PduType : uint8_t
     NewWindow = 17,
     ResizePane = 18,
     ResizeSplit = 19,
+    SharedDelta = 20,
+    SharedRelease = 21,
 };
 
 /// The wire encoding of a split's first-child share: a fraction in (0, 1) carried as an integer
@@ -133,6 +135,21 @@ struct WireSessionSettings
     bool operator==(WireSessionSettings const&) const = default;
 };
 
+/// Where a reconnecting client's mirror of one session's PRIMARY page stands: the stream position
+/// of the last Delta it applied (@see ClientHello::resume).
+///
+/// Primary only. Every page is a grid with its own generation counter, and the counters collide
+/// across pages — while the wire's screen type cannot tell DEC page 3 from the xterm alternate
+/// screen. An alternate-like page is one screenful, which is all a snapshot of it costs anyway.
+struct ResumeCursor
+{
+    uint64_t session = 0;
+    uint64_t generation = 0; ///< Delta::generation as last applied.
+    uint64_t seqno = 0;      ///< Delta::seqno as last applied.
+    int64_t stableBase = 0;  ///< Delta::stableViewportBase as last applied.
+    bool operator==(ResumeCursor const&) const = default;
+};
+
 /// Client's first PDU: its codec revision, (for TCP) a preshared auth token, and optionally the
 /// emulation settings it wants the sessions it creates to have. Anything before it is a protocol
 /// error.
@@ -145,6 +162,16 @@ struct ClientHello
     /// The client's preference for sessions it creates; absent means "whatever the daemon hosts
     /// with", which is what a client with no configuration of its own wants.
     std::optional<WireSessionSettings> sessionSettings = std::nullopt;
+    /// The ServerHello::instance the cursors below were taken against; 0 asks for no resume.
+    uint64_t resumeInstance = 0;
+    /// The mirrors a reconnecting client still holds. The server answers each one it can still
+    /// describe incrementally with a Delta carrying only what changed since, and everything else
+    /// — an unknown session, a new generation, a cursor below the scrollback floor — with the
+    /// usual snapshot.
+    std::vector<ResumeCursor> resume = {};
+    /// Asks for large updates through shared memory (@see vthost::SharedRing). Only a client on
+    /// the same host sets it, and the daemon grants it only where the socket can pass the segment.
+    bool sharedMemory = false;
     bool operator==(ClientHello const&) const = default;
 };
 
@@ -152,6 +179,13 @@ struct ClientHello
 struct ServerHello
 {
     uint32_t codecVersion = CodecVersion;
+    /// Names this daemon lifetime (@see vthost::SessionHost::instance). Session ids, generations
+    /// and seqnos all start over in a restarted daemon, so a resume cursor only means something to
+    /// the instance it was taken from. 0 on a rejected handshake.
+    uint64_t instance = 0;
+    /// The size of the shared segment granted for ClientHello::sharedMemory, 0 for none. Its
+    /// descriptor travels with this very frame (SCM_RIGHTS), so it is in hand when this arrives.
+    uint32_t sharedBytes = 0;
     bool operator==(ServerHello const&) const = default;
 };
 
@@ -363,6 +397,20 @@ struct ImageCellEntry
     bool operator==(ImageCellEntry const&) const = default;
 };
 
+/// A block of page rows that moved as a whole, by stable id: a margin scroll (DECSTBM), or lines
+/// inserted or deleted under one. Sent instead of every row in the block.
+///
+/// With @ref count n > 0 the rows [top + n, bottom] move up to [top, bottom - n]; with n < 0 the
+/// rows [top, bottom + n] move down to [top - n, bottom]. The |n| rows a shift leaves behind are
+/// always sent as changed rows of the same delta, so a receiver simply forgets them.
+struct RowShift
+{
+    int64_t top = 0;    ///< The block's first row.
+    int64_t bottom = 0; ///< The block's last row, inclusive.
+    int32_t count = 0;  ///< Rows the content moves up by; negative moves it down.
+    bool operator==(RowShift const&) const = default;
+};
+
 /// A batch of changed rows plus the side tables they reference. `snapshot`
 /// marks a full resync (attach or generation change) rather than an increment.
 struct Delta
@@ -381,6 +429,10 @@ struct Delta
     int64_t stableFloor = 0;
     int32_t cursorLine = 0;
     int32_t cursorColumn = 0;
+    /// The region shifts of this batch, in the order they happened. A receiver applies them to the
+    /// rows it holds BEFORE `lines`, which carry each row's final content: a row that only moved is
+    /// named here and not sent again.
+    std::vector<RowShift> rowShifts;
     std::vector<WireLine> lines;
     std::vector<HyperlinkEntry> hyperlinks;
     std::vector<ImageCellEntry> imageCells;
@@ -454,10 +506,10 @@ struct Delta
     /// @return True when the delta is worth sending.
     [[nodiscard]] bool hasChanges() const noexcept
     {
-        return snapshot != 0 || !lines.empty() || titleChanged != 0 || cursorShapeChanged != 0
-               || cwdChanged != 0 || colorsChanged != 0 || statusChanged != 0 || statusLinesChanged != 0
-               || kittyKeyboardChanged != 0 || modifyOtherKeysChanged != 0 || mouseChanged != 0
-               || progressChanged != 0;
+        return snapshot != 0 || !rowShifts.empty() || !lines.empty() || titleChanged != 0
+               || cursorShapeChanged != 0 || cwdChanged != 0 || colorsChanged != 0 || statusChanged != 0
+               || statusLinesChanged != 0 || kittyKeyboardChanged != 0 || modifyOtherKeysChanged != 0
+               || mouseChanged != 0 || progressChanged != 0;
     }
 
     bool operator==(Delta const&) const = default;
@@ -613,6 +665,28 @@ struct ResizeSplit
     bool operator==(ResizeSplit const&) const = default;
 };
 
+/// Server→client: a Delta too large to be worth the socket, written to the shared segment instead.
+///
+/// The bytes at @p offset are one whole encoded Delta frame, exactly as it would have travelled on
+/// the socket, so the client decodes it with the same decoder. Its place in the stream is this
+/// notification's: everything sent before it applies first.
+struct SharedDelta
+{
+    uint64_t offset = 0; ///< The frame's stream offset in the ring (@see vthost::SharedRing).
+    uint32_t length = 0; ///< Its encoded size.
+    bool operator==(SharedDelta const&) const = default;
+};
+
+/// Client→server: every shared frame ending at or before @p offset is applied, so the daemon may
+/// write over it. Cumulative, and sent only once a fair share of the segment is spent: a
+/// notification the daemon dropped unsent (a snapshot supersedes the deltas queued before it) is
+/// covered by the next release that lands past it.
+struct SharedRelease
+{
+    uint64_t offset = 0;
+    bool operator==(SharedRelease const&) const = default;
+};
+
 using DecodedPdu = std::variant<Invalid,
                                 ClientHello,
                                 ServerHello,
@@ -632,7 +706,9 @@ using DecodedPdu = std::variant<Invalid,
                                 ClosePane,
                                 NewWindow,
                                 ResizePane,
-                                ResizeSplit>;
+                                ResizeSplit,
+                                SharedDelta,
+                                SharedRelease>;
 
 /// Encodes @p pdu (body + frame) into @p sink.
 /// @param sink The output writer.
@@ -35,15 +35,21 @@ namespace
                        // The token authenticates the peer: report its PRESENCE, never its bytes. The
                        // session settings get the same treatment for a different reason -- they are
                        // a block of the user's configuration, and a trace is not a config dump.
-                       return std::format("version={} token={} settings={}",
+                       return std::format("version={} token={} settings={} resume={} shm={}",
                                           value.codecVersion,
                                           value.token.empty() ? "no" : "yes",
-                                          value.sessionSettings ? "yes" : "no");
+                                          value.sessionSettings ? "yes" : "no",
+                                          value.resume.size(),
+                                          value.sharedMemory ? "yes" : "no");
                    } },
         TraceRow { PduType::ServerHello,
                    "ServerHello",
                    +[](DecodedPdu const& pdu) {
-                       return std::format("version={}", std::get<ServerHello>(pdu).codecVersion);
+                       auto const& value = std::get<ServerHello>(pdu);
+                       return std::format("version={} instance={:x} shm={}",
+                                          value.codecVersion,
+                                          value.instance,
+                                          value.sharedBytes);
                    } },
         TraceRow { PduType::Input,
                    "Input",
@@ -106,12 +112,13 @@ namespace
                    "Delta",
                    +[](DecodedPdu const& pdu) {
                        auto const& value = std::get<Delta>(pdu);
-                       return std::format("session={} gen={} seq={} snapshot={} lines={} links={} "
-                                          "imagecells={} statuslines={} progress={}/{}",
+                       return std::format("session={} gen={} seq={} snapshot={} shifts={} lines={} "
+                                          "links={} imagecells={} statuslines={} progress={}/{}",
                                           value.session,
                                           value.generation,
                                           value.seqno,
                                           value.snapshot,
+                                          value.rowShifts.size(),
                                           value.lines.size(),
                                           value.hyperlinks.size(),
                                           value.imageCells.size(),
@@ -183,6 +190,17 @@ namespace
                                           value.secondSession,
                                           value.ratio);
                    } },
+        TraceRow { PduType::SharedDelta,
+                   "SharedDelta",
+                   +[](DecodedPdu const& pdu) {
+                       auto const& value = std::get<SharedDelta>(pdu);
+                       return std::format("offset={} length={}", value.offset, value.length);
+                   } },
+        TraceRow { PduType::SharedRelease,
+                   "SharedRelease",
+                   +[](DecodedPdu const& pdu) {
+                       return std::format("offset={}", std::get<SharedRelease>(pdu).offset);
+                   } },
     };
 
     static_assert(TraceTable.size() == std::variant_size_v<DecodedPdu>,
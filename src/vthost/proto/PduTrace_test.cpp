@@ -83,6 +83,8 @@ namespace
         { PduType::NewWindow, DecodedPdu { NewWindow {} } },
         { PduType::ResizeSplit,
           DecodedPdu { ResizeSplit { .firstSession = 4, .secondSession = 7, .ratio = 6000 } } },
+        { PduType::SharedDelta, DecodedPdu { SharedDelta { .offset = 4096, .length = 65536 } } },
+        { PduType::SharedRelease, DecodedPdu { SharedRelease { .offset = 69632 } } },
     };
 }
 } // namespace
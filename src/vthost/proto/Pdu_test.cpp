@@ -86,7 +86,15 @@ TEST_CASE("every catalog PDU round-trips", "[vthost][proto]")
                                           .wordDelimiters = " /\\()\"'-.,:;<>~!@#$%^&*|+=[]{}~?",
                                           .frozenModes = { WireFrozenMode { .mode = 2027, .frozenAs = 1 },
                                                            WireFrozenMode { .mode = 12, .frozenAs = 0 } } } },
-            ServerHello { .codecVersion = CodecVersion },
+            // A reconnect: stable ids are signed, so one cursor sits below the origin.
+            ClientHello {
+                .codecVersion = CodecVersion,
+                .resumeInstance = 0xFEEDFACECAFEBEEF,
+                .resume = { ResumeCursor { .session = 9, .generation = 3, .seqno = 7, .stableBase = 120 },
+                            ResumeCursor { .session = 2, .generation = 0, .seqno = 1, .stableBase = -4 } } },
+            ServerHello { .codecVersion = CodecVersion, .instance = 0xFEEDFACECAFEBEEF },
+            ClientHello { .codecVersion = CodecVersion, .sharedMemory = true },
+            ServerHello { .codecVersion = CodecVersion, .instance = 7, .sharedBytes = 8 * 1024 * 1024 },
             Input { .session = 9, .data = { std::byte { 0x1B }, std::byte { '[' }, std::byte { 'A' } } },
             ResizeRequest { .columns = 120, .lines = 40 },
             ResizePane { .session = 9, .columns = 50, .lines = 30 },
@@ -123,6 +131,8 @@ TEST_CASE("every catalog PDU round-trips", "[vthost][proto]")
                     .stableFloor = -5,
                     .cursorLine = 5,
                     .cursorColumn = 10,
+                    .rowShifts = { RowShift { .top = 2, .bottom = 20, .count = 3 },
+                                   RowShift { .top = -4, .bottom = 7, .count = -1 } },
                     .lines = { line },
                     .hyperlinks = { HyperlinkEntry { .id = 7, .uri = "https://example.com" } },
                     .imageCells = { ImageCellEntry { .stableId = -3,
@@ -182,6 +192,8 @@ TEST_CASE("every catalog PDU round-trips", "[vthost][proto]")
             ClosePane { .session = 100 },
             ResizeSplit { .firstSession = 5, .secondSession = 9, .ratio = 7250 },
             NewWindow {},
+            SharedDelta { .offset = (uint64_t { 1 } << 40) + 4096, .length = 262144 },
+            SharedRelease { .offset = uint64_t { 1 } << 40 },
         };
 
     for (auto const& pdu: pdus)
@@ -643,6 +655,11 @@ TEST_CASE("Delta::hasChanges answers for every gated field", "[vthost][proto]")
     withLines.lines = { WireLine {} };
     CHECK(withLines.hasChanges());
 
+    // Shifts move rows the receiver already holds, so a delta carrying nothing else still has news.
+    auto withShift = Delta {};
+    withShift.rowShifts = { RowShift { .top = 0, .bottom = 9, .count = 1 } };
+    CHECK(withShift.hasChanges());
+
     // The two peer-relative facts are deliberately NOT the delta's business: it cannot know what
     // this peer was last told, so the sender adds them.
     auto moved = Delta {};
@@ -186,6 +186,8 @@ struct ControlHarness
                [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
                std::move(settings),
                crispy::defaultEnvironment(),
+               /*metrics=*/nullptr,
+               /*traceFile=*/std::nullopt,
                /*startPumps=*/false }
     {
         // A fixed clock so guard timestamps are deterministic.
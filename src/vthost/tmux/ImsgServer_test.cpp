@@ -191,6 +191,8 @@ struct ImsgHarness
                                },
                                vtbackend::Settings {},
                                crispy::defaultEnvironment(),
+                               /*metrics=*/nullptr,
+                               /*traceFile=*/std::nullopt,
                                /*startPumps=*/false };
     FakeTmuxClient client;
     std::unique_ptr<net::ISocket> serverEnd;
@@ -508,6 +510,8 @@ TEST_CASE("a real tmux binary attaches over imsg", "[vthost][imsgserver][oracle]
         [](vtbackend::PageSize size) { return std::make_unique<vtpty::MockPty>(size); },
         vtbackend::Settings {},
         crispy::defaultEnvironment(),
+        /*metrics=*/nullptr,
+        /*traceFile=*/std::nullopt,
         /*startPumps=*/false,
     };
     host.createTab();
@@ -39,6 +39,7 @@ PaneView::PaneView(int columns, int lines, vtbackend::LineCount history)
     // rendered, so nothing it reads from there describes anything but the client it runs in.
     _terminal = std::make_unique<vtbackend::Terminal>(_events,
                                                       crispy::defaultEnvironment(),
+                                                      /*traceRecorder=*/nullptr,
                                                       std::make_unique<vtpty::MockPty>(pageSize),
                                                       std::move(settings),
                                                       std::chrono::steady_clock::now());
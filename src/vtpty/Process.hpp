@@ -86,9 +86,12 @@ class [[nodiscard]] Process: public Pty
     [[nodiscard]] Pty& pty() noexcept;
     [[nodiscard]] Pty const& pty() const noexcept;
 
+    /// Spawns the child. Calling it again once that succeeded spawns nothing and reports the first
+    /// outcome, so a process started ahead of time (@see PtyPool) can be handed to code that starts it.
+    [[nodiscard]] StartResult start() override;
+
     // Pty overrides
     // clang-format off
-    [[nodiscard]] StartResult start() override;
     [[nodiscard]] PtySlave& slave() noexcept override { return pty().slave(); }
     void close() override { pty().close(); }
     void waitForClosed() override;
@@ -96,6 +99,7 @@ class [[nodiscard]] Process: public Pty
     [[nodiscard]] std::optional<ReadResult> read(crispy::BufferObject<char>& storage, std::optional<std::chrono::milliseconds> timeout, size_t n) override { return pty().read(storage, timeout, n); }
     void wakeupReader() override { pty().wakeupReader(); }
     [[nodiscard]] int write(std::string_view data) override { return pty().write(data); }
+    [[nodiscard]] int writeSome(std::string_view data) override { return pty().writeSome(data); }
     [[nodiscard]] PageSize pageSize() const noexcept override { return pty().pageSize(); }
     void resizeScreen(PageSize cells, std::optional<ImageSize> pixels = std::nullopt) override { pty().resizeScreen(cells, pixels); }
     // clang-format on
@@ -191,6 +191,7 @@ struct Process::Private
     bool escapeSandbox;
 
     unique_ptr<Pty> pty {};
+    std::optional<StartOutcome> started {};
     mutable pid_t pid {};
     mutable std::mutex exitStatusMutex {};
     mutable std::optional<Process::ExitStatus> exitStatus {};
@@ -222,6 +223,9 @@ bool Process::isFlatpak()
 
 StartResult Process::start()
 {
+    if (_d->started)
+        return *_d->started;
+
     if (auto started = _d->pty->start(); !started)
         return started;
 
@@ -394,7 +398,8 @@ StartResult Process::start()
     // Nothing to report: on POSIX a working directory that cannot be entered, or a program that
     // cannot be executed, is discovered in the CHILD, which writes its own diagnostic onto the pty
     // (see the fallback ladder above) and exits. The parent only fails when fork() itself does.
-    return {};
+    _d->started = StartOutcome {};
+    return *_d->started;
 }
 
 Process::~Process()
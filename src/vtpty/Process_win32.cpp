@@ -158,6 +158,7 @@ struct Process::Private
     fs::path cwd;
     Environment env;
     std::unique_ptr<Pty> pty {};
+    std::optional<StartOutcome> started {};
 
     mutable HANDLE pid {};
     mutable std::mutex exitStatusMutex {};
@@ -190,6 +191,9 @@ StartResult Process::start()
 {
     Require(static_cast<ConPty const*>(_d->pty.get()));
 
+    if (_d->started)
+        return *_d->started;
+
     if (auto started = _d->pty->start(); !started)
         return started;
 
@@ -267,7 +271,8 @@ StartResult Process::start()
 
         // The child is running; the only thing left to say is what this rung had to give up to get
         // there, which is empty for the rung that ran exactly what was asked for.
-        return StartOutcome { .diagnostic = std::move(attempt.diagnostic) };
+        _d->started = StartOutcome { .diagnostic = std::move(attempt.diagnostic) };
+        return *_d->started;
     }
 
     return std::unexpected(StartFailure { .error = StartError::SpawnFailed,
@@ -144,6 +144,16 @@ class Pty
     /// @returns Number of bytes written or -1 on error.
     [[nodiscard]] virtual int write(std::string_view buf) = 0;
 
+    /// Writes as much of @p buf as the PTY device accepts right now, without waiting for the other
+    /// end to drain it.
+    ///
+    /// Unlike write(), which may block until all of @p buf is delivered, a short count here is
+    /// backpressure: the caller keeps the rest and retries later. Devices that cannot tell the two
+    /// apart fall back to write().
+    ///
+    /// @returns Number of bytes written or -1 on error (EAGAIN if nothing could be written yet).
+    [[nodiscard]] virtual int writeSome(std::string_view buf) { return write(buf); }
+
     /// @returns current underlying window size in characters width and height.
     [[nodiscard]] virtual PageSize pageSize() const noexcept = 0;
 
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtpty/Process.hpp>
+#include <vtpty/PtyPool.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace vtpty
+{
+
+namespace
+{
+    /// Whether @p pty can still be handed out: a shell that exited while it waited (killed from
+    /// outside, or one whose startup script failed) would open a pane that closes right away.
+    [[nodiscard]] bool isUsable(Pty const& pty)
+    {
+        if (pty.isClosed())
+            return false;
+        if (auto const* process = dynamic_cast<Process const*>(&pty))
+            return process->alive();
+        return true;
+    }
+} // namespace
+
+PtyPool::PtyPool(Spawn spawn, std::size_t capacity, PageSize pageSize):
+    _spawn { std::move(spawn) }, _capacity { capacity }, _pageSize { pageSize }
+{
+    if (_capacity != 0)
+        _replenisher = std::thread { [this] { replenish(); } };
+}
+
+PtyPool::~PtyPool()
+{
+    {
+        auto const lock = std::scoped_lock { _mutex };
+        _state = State::Stopping;
+    }
+    _wakeup.notify_one();
+    if (_replenisher.joinable())
+        _replenisher.join();
+
+    // Closing the master hangs up on the child, which is what lets a Process's destructor reap it.
+    for (auto& pty: _ready)
+        pty->close();
+}
+
+std::unique_ptr<Pty> PtyPool::acquire(PageSize pageSize)
+{
+    auto pty = std::unique_ptr<Pty> {};
+    auto unusable = std::vector<std::unique_ptr<Pty>> {};
+    {
+        auto const lock = std::scoped_lock { _mutex };
+        _pageSize = pageSize;
+        if (_state == State::Stalled)
+            _state = State::Replenishing;
+        while (!pty && !_ready.empty())
+        {
+            auto candidate = std::move(_ready.front());
+            _ready.pop_front();
+            if (isUsable(*candidate))
+                pty = std::move(candidate);
+            else
+                unusable.push_back(std::move(candidate));
+        }
+    }
+    _wakeup.notify_one();
+
+    for (auto& dead: unusable)
+        dead->close();
+
+    if (!pty)
+    {
+        ptyLog()("No started PTY ready; spawning one on demand.");
+        return _spawn(pageSize);
+    }
+
+    if (pty->pageSize() != pageSize)
+        pty->resizeScreen(pageSize);
+    return pty;
+}
+
+std::size_t PtyPool::readyCount() const
+{
+    auto const lock = std::scoped_lock { _mutex };
+    return _ready.size();
+}
+
+void PtyPool::replenish()
+{
+    auto lock = std::unique_lock { _mutex };
+    while (true)
+    {
+        _wakeup.wait(lock, [this] {
+            return _state == State::Stopping
+                   || (_state == State::Replenishing && _ready.size() < _capacity);
+        });
+        if (_state == State::Stopping)
+            return;
+
+        // Spawned unlocked: a fork, and the child's exec, must not hold up acquire().
+        auto const pageSize = _pageSize;
+        lock.unlock();
+        auto pty = _spawn(pageSize);
+        auto const started = pty ? pty->start() : StartResult {};
+        if (pty && !started)
+        {
+            ptyLog()("Starting a PTY ahead of time failed: {}", started.error());
+            pty->close();
+            pty.reset();
+        }
+        lock.lock();
+
+        if (!pty)
+        {
+            // Stopping wins over the failure: the destructor is waiting for this thread.
+            if (_state == State::Replenishing)
+                _state = State::Stalled;
+            continue;
+        }
+        if (_state == State::Stopping)
+        {
+            pty->close();
+            lock.unlock();
+            return;
+        }
+        _ready.push_back(std::move(pty));
+    }
+}
+
+} // namespace vtpty
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+/// @file
+/// `PtyPool` — PTYs whose child process was started ahead of time.
+///
+/// Starting a shell with a heavy startup script (a plugin framework, a conda init) takes hundreds
+/// of milliseconds, and for all of them the new pane is blank. The pool keeps a few shells started
+/// in the background and hands one out the moment a session asks, replacing it behind the scenes.
+
+#include <vtpty/PageSize.hpp>
+#include <vtpty/Pty.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace vtpty
+{
+
+/// A bounded set of started PTYs, all created by one spawn function and kept topped up by a
+/// background thread.
+///
+/// A pooled PTY has been start()ed already, and the one acquire() has to spawn on the spot when
+/// the pool is empty has not; callers start whatever they get either way. That relies on start()
+/// being idempotent for what @c Spawn creates, as it is for vtpty::Process.
+///
+/// Everything a pooled child was spawned with is fixed by the spawn function, except for the page
+/// size: that only becomes known when a session asks, so acquire() resizes the PTY to it (the
+/// child sees an ordinary SIGWINCH) and spawns the replacements at it.
+class PtyPool
+{
+  public:
+    /// Creates a PTY, unstarted, at the given page size. Called on the pool's own thread as well.
+    using Spawn = std::function<std::unique_ptr<Pty>(PageSize)>;
+
+    /// @param spawn    Creates each PTY; it must be safe to call from another thread.
+    /// @param capacity How many started PTYs to keep ready.
+    /// @param pageSize The page size to spawn them at until acquire() names another.
+    PtyPool(Spawn spawn, std::size_t capacity, PageSize pageSize);
+
+    /// Stops replenishing and closes every PTY that was never handed out.
+    ~PtyPool();
+
+    PtyPool(PtyPool const&) = delete;
+    PtyPool& operator=(PtyPool const&) = delete;
+    PtyPool(PtyPool&&) = delete;
+    PtyPool& operator=(PtyPool&&) = delete;
+
+    /// Hands out a started PTY resized to @p pageSize, or spawns one (unstarted) when none is ready.
+    ///
+    /// Either way the pool starts replacing it in the background. PTYs whose child exited while
+    /// they were waiting are dropped rather than handed out.
+    [[nodiscard]] std::unique_ptr<Pty> acquire(PageSize pageSize);
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return _capacity; }
+
+    /// @return How many started PTYs are waiting to be handed out.
+    [[nodiscard]] std::size_t readyCount() const;
+
+  private:
+    /// What the background thread is up to.
+    enum class State : uint8_t
+    {
+        /// Keeping the pool full.
+        Replenishing,
+        /// A spawn failed, so that a shell that cannot start is not retried in a tight loop; the
+        /// next acquire() resumes replenishing.
+        Stalled,
+        /// The pool is being destroyed.
+        Stopping,
+    };
+
+    void replenish();
+
+    Spawn _spawn;
+    std::size_t _capacity;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::deque<std::unique_ptr<Pty>> _ready;
+    PageSize _pageSize;
+    State _state = State::Replenishing;
+
+    std::thread _replenisher;
+};
+
+} // namespace vtpty
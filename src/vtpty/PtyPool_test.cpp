@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtpty/MockPty.hpp>
+#include <vtpty/PtyPool.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+using namespace std::chrono_literals;
+using vtpty::MockPty;
+using vtpty::PageSize;
+using vtpty::PtyPool;
+
+namespace
+{
+
+PageSize pageSize(int lines, int columns)
+{
+    return PageSize { vtpty::LineCount(lines), vtpty::ColumnCount(columns) };
+}
+
+/// A MockPty that counts its start() calls, and is born closed, as a PTY is before it starts.
+class CountingPty final: public MockPty
+{
+  public:
+    explicit CountingPty(PageSize size): MockPty { size } { MockPty::close(); }
+
+    [[nodiscard]] vtpty::StartResult start() override
+    {
+        ++starts;
+        return MockPty::start();
+    }
+
+    int starts = 0;
+};
+
+/// Waits until @p condition holds, giving up after a generous timeout.
+bool waitUntil(std::function<bool()> const& condition)
+{
+    auto const deadline = std::chrono::steady_clock::now() + 5s;
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+/// Waits until @p pool holds @p count ready PTYs, giving up after a generous timeout.
+bool waitForReady(PtyPool const& pool, std::size_t count)
+{
+    return waitUntil([&] { return pool.readyCount() >= count; });
+}
+
+} // namespace
+
+TEST_CASE("PtyPool.fills_up_to_its_capacity_with_started_ptys", "[vtpty][ptypool]")
+{
+    auto spawned = std::atomic<int> { 0 };
+    auto pool = PtyPool { [&](PageSize size) {
+                             ++spawned;
+                             return std::make_unique<CountingPty>(size);
+                         },
+                          2,
+                          pageSize(24, 80) };
+    REQUIRE(waitForReady(pool, 2));
+    // A full pool waits for an acquire() rather than spawning ahead.
+    CHECK(spawned == 2);
+
+    auto pty = pool.acquire(pageSize(24, 80));
+    REQUIRE(pty != nullptr);
+    CHECK(!pty->isClosed());
+    CHECK(dynamic_cast<CountingPty&>(*pty).starts == 1);
+
+    // The one handed out is replaced.
+    REQUIRE(waitForReady(pool, 2));
+    CHECK(spawned == 3);
+}
+
+TEST_CASE("PtyPool.resizes_on_adoption_and_spawns_replacements_at_the_new_size", "[vtpty][ptypool]")
+{
+    auto pool =
+        PtyPool { [](PageSize size) { return std::make_unique<CountingPty>(size); },
+                  1,
+                  pageSize(24, 80) };
+    REQUIRE(waitForReady(pool, 1));
+
+    auto first = pool.acquire(pageSize(40, 120));
+    CHECK(first->pageSize() == pageSize(40, 120));
+
+    REQUIRE(waitForReady(pool, 1));
+    auto second = pool.acquire(pageSize(40, 120));
+    CHECK(second->pageSize() == pageSize(40, 120));
+}
+
+TEST_CASE("PtyPool.spawns_on_demand_when_empty", "[vtpty][ptypool]")
+{
+    auto pool =
+        PtyPool { [](PageSize size) { return std::make_unique<CountingPty>(size); },
+                  0,
+                  pageSize(24, 80) };
+
+    auto pty = pool.acquire(pageSize(30, 100));
+    REQUIRE(pty != nullptr);
+    CHECK(pty->pageSize() == pageSize(30, 100));
+    // Not started: the caller does that, exactly as with a PTY it created itself.
+    CHECK(dynamic_cast<CountingPty&>(*pty).starts == 0);
+    CHECK(pool.readyCount() == 0);
+}
+
+TEST_CASE("PtyPool.skips_ptys_that_closed_while_waiting", "[vtpty][ptypool]")
+{
+    auto last = std::atomic<CountingPty*> { nullptr };
+    auto pool = PtyPool { [&](PageSize size) {
+                             auto pty = std::make_unique<CountingPty>(size);
+                             last = pty.get();
+                             return pty;
+                         },
+                          1,
+                          pageSize(24, 80) };
+    REQUIRE(waitForReady(pool, 1));
+
+    // The child went away before anyone asked for it: it is dropped, and one is spawned instead.
+    auto* dead = last.load();
+    dead->close();
+    auto pty = pool.acquire(pageSize(24, 80));
+    REQUIRE(pty != nullptr);
+    CHECK(pty.get() != dead);
+    CHECK(dynamic_cast<CountingPty&>(*pty).starts == 0);
+}
+
+TEST_CASE("PtyPool.stops_spawning_after_a_failure_until_asked_again", "[vtpty][ptypool]")
+{
+    auto spawned = std::atomic<int> { 0 };
+    auto pool = PtyPool { [&](PageSize) -> std::unique_ptr<vtpty::Pty> {
+                             ++spawned;
+                             return nullptr;
+                         },
+                          3,
+                          pageSize(24, 80) };
+    REQUIRE(waitUntil([&] { return spawned >= 1; }));
+
+    // One retry in the background, plus the on-demand spawn. Had the failure not stalled the pool,
+    // it would have kept spawning all along and overshot by now.
+    CHECK(pool.acquire(pageSize(24, 80)) == nullptr);
+    REQUIRE(waitUntil([&] { return spawned >= 3; }));
+    CHECK(spawned == 3);
+}
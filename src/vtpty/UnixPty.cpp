@@ -379,6 +379,35 @@ int UnixPty::write(std::string_view data)
     // rare fallback (PTY buffer full) bounded by the child draining its side, and holding _mutex
     // across it pins the fd open for the duration -- the invariant the fd-validity check relies on.
     auto const _ = std::scoped_lock { _mutex };
+    auto const rv = writeNonBlocking(data);
+
+    if (0 <= rv && std::cmp_less(rv, size))
+    {
+        util::setFileBlocking(_masterFd, true);
+        auto const rv2 = ::write(_masterFd, buf + rv, size - rv);
+        util::setFileBlocking(_masterFd, false);
+        if (rv2 >= 0)
+        {
+            if (ptyOutLog)
+                ptyOutLog()("Sending bytes: \"{}\"", crispy::escape(buf + rv, buf + rv + rv2));
+            return static_cast<int>(rv + rv2);
+        }
+    }
+
+    return rv;
+}
+
+int UnixPty::writeSome(std::string_view data)
+{
+    auto const _ = std::scoped_lock { _mutex };
+    return writeNonBlocking(data);
+}
+
+int UnixPty::writeNonBlocking(std::string_view data)
+{
+    auto const* buf = data.data();
+    auto const size = data.size();
+
     if (_masterFd.isClosed())
     {
         errno = EPIPE;
@@ -402,19 +431,6 @@ int UnixPty::write(std::string_view data)
         // clang-format on
     }
 
-    if (0 <= rv && std::cmp_less(rv, size))
-    {
-        util::setFileBlocking(_masterFd, true);
-        auto const rv2 = ::write(_masterFd, buf + rv, size - rv);
-        util::setFileBlocking(_masterFd, false);
-        if (rv2 >= 0)
-        {
-            if (ptyOutLog)
-                ptyOutLog()("Sending bytes: \"{}\"", crispy::escape(buf + rv, buf + rv + rv2));
-            return static_cast<int>(rv + rv2);
-        }
-    }
-
     return static_cast<int>(rv);
 }
 
@@ -57,6 +57,7 @@ class UnixPty final: public Pty
                                                  std::optional<std::chrono::milliseconds> timeout,
                                                  size_t size) override;
     int write(std::string_view data) override;
+    int writeSome(std::string_view data) override;
     [[nodiscard]] PageSize pageSize() const noexcept override;
     void resizeScreen(PageSize cells, std::optional<ImageSize> pixels = std::nullopt) override;
 
@@ -65,6 +66,9 @@ class UnixPty final: public Pty
   private:
     std::optional<std::string_view> readSome(int fd, char* target, size_t n) noexcept;
 
+    /// The non-blocking ::write() shared by write() and writeSome(). Expects _mutex to be held.
+    int writeNonBlocking(std::string_view data);
+
     [[nodiscard]] bool started() const noexcept { return _masterFd != -1; }
 
     FileDescriptor _masterFd;
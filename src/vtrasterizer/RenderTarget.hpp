@@ -12,6 +12,7 @@
 
 #include <crispy/Size.hpp>
 
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -110,6 +111,30 @@ class RenderTarget
 
     virtual atlas::AtlasBackend& textureScheduler() = 0;
 
+    /// Identifies the graphics context this target draws into.
+    ///
+    /// Targets in one context can sample each other's textures, and a glyph atlas is only shared between
+    /// renderers whose targets report the same context. Defaults to the target itself, sharing nothing.
+    [[nodiscard]] virtual void const* graphicsContext() const noexcept { return this; }
+
+    /// Creates an atlas backend that every target of graphicsContext() can draw from, or returns nullptr
+    /// if this target can only draw from its own textureScheduler().
+    ///
+    /// Only configureAtlas() and uploadTile() reach the returned backend; tiles are still rendered
+    /// through each target's own textureScheduler().
+    [[nodiscard]] virtual std::shared_ptr<atlas::AtlasBackend> createSharedAtlasBackend() { return nullptr; }
+
+    /// Makes this target draw text from @p backend, one returned by createSharedAtlasBackend() of a target
+    /// in the same graphics context.
+    ///
+    /// @return true if @p backend holds none of the tiles its atlas says it holds -- because it is new,
+    ///         or its texture was lost with its last target -- and the atlas must therefore be rebuilt.
+    [[nodiscard]] virtual bool useSharedAtlasBackend(std::shared_ptr<atlas::AtlasBackend> const& backend)
+    {
+        (void) backend;
+        return false;
+    }
+
     /// Schedules whole-image textures, as opposed to textureScheduler()'s fixed-size tiles.
     ///
     /// Commands issued here and through textureScheduler() composite in the order they were issued.
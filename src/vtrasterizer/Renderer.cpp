@@ -2,6 +2,8 @@
 #include <vtrasterizer/Renderer.hpp>
 
 #include <vtrasterizer/AtlasBudget.hpp>
+#include <vtrasterizer/SharedGlyphAtlas.hpp>
+#include <vtrasterizer/SharedTextCache.hpp>
 #include <vtrasterizer/TextRenderer.hpp>
 #include <vtrasterizer/Utils.hpp>
 
@@ -23,6 +25,7 @@
 #include <stdexcept>
 
 using std::initializer_list;
+using std::make_shared;
 using std::make_unique;
 using std::optional;
 using std::scoped_lock;
@@ -137,6 +140,8 @@ Renderer::Renderer(vtbackend::PageSize pageSize,
                    crispy::LRUCapacity atlasTileCount,
                    bool atlasDirectMapping,
                    text::FontLocator& fontLocator,
+                   SharedTextCacheRegistry& textCaches,
+                   crispy::trace::Recorder* traceRecorder,
                    Decorator hyperlinkNormal,
                    Decorator hyperlinkHover,
                    GlyphScalingMethod textScalingMethod):
@@ -146,15 +151,13 @@ Renderer::Renderer(vtbackend::PageSize pageSize,
         atlasHashtableSlotCount, atlasbudget::tileCountFor(atlasTileCount, pageSize)) },
     _atlasTileCount { atlasbudget::tileCountFor(atlasTileCount, pageSize) },
     _atlasDirectMapping { atlasDirectMapping },
+    _textScalingMethod { textScalingMethod },
     //.
     _fontLocator { fontLocator },
+    _textCaches { textCaches },
+    _traceRecorder { traceRecorder },
     _fontDescriptions { std::move(fontDescriptions) },
-    _textShaper { [&] {
-        auto shaper =
-            createTextShaper(_fontDescriptions.textShapingEngine, _fontDescriptions.dpi, fontLocator);
-        shaper->setFontFallbackLimit(_fontDescriptions.maxFallbackCount);
-        return shaper;
-    }() },
+    _textShaper { _textCaches.acquire(_fontDescriptions, fontLocator, createTextShaper) },
     _fonts { loadFontKeys(_fontDescriptions, *_textShaper) },
     _gridMetrics { loadGridMetrics(_fonts.regular, pageSize, pageMargin, *_textShaper) },
     _publishedMetrics { _gridMetrics },
@@ -163,8 +166,13 @@ Renderer::Renderer(vtbackend::PageSize pageSize,
     //.
     _backgroundRenderer { _gridMetrics, colorPalette.defaultBackground },
     _imageRenderer { _gridMetrics, cellSize() },
-    _textRenderer { _gridMetrics, *_textShaper,   _fontDescriptions,
-                    _fonts,       _imageRenderer, glyphScalerFor(textScalingMethod) },
+    _textRenderer { _gridMetrics,
+                    *_textShaper,
+                    _fontDescriptions,
+                    _fonts,
+                    _imageRenderer,
+                    glyphScalerFor(textScalingMethod),
+                    _textShaper->shapedRuns() },
     _decorationRenderer { _gridMetrics, hyperlinkNormal, hyperlinkHover },
     _cursorRenderer { _gridMetrics, vtbackend::CursorShape::Block }
 {
@@ -182,8 +190,20 @@ Renderer::Renderer(vtbackend::PageSize pageSize,
     // clang-format on
 }
 
+Renderer::~Renderer()
+{
+    if (!_sharedAtlas)
+        return;
+    auto const frameLock = lockForFrame();
+    _sharedAtlas->release(this);
+}
+
 void Renderer::setRenderTarget(RenderTarget& renderTarget)
 {
+    auto const applyGuard = std::scoped_lock { _applyMutex };
+    _contextMutex = _textCaches.contextLock(renderTarget.graphicsContext());
+    auto const frameLock = lockForFrame();
+
     _renderTarget = &renderTarget;
 
     // Reset DirectMappingAllocator (also skipping zero-tile).
@@ -206,10 +226,17 @@ void Renderer::setRenderTarget(RenderTarget& renderTarget)
 
 void Renderer::detachRenderTarget() noexcept
 {
+    auto const frameLock = lockForFrame();
+
     _renderTarget = nullptr;
-    // The atlas references the dead target's texture scheduler; drop it with the target. The next
-    // setRenderTarget() rebuilds it (configureTextureAtlas) and re-points every renderable.
+    // The atlas references the dead target's texture scheduler, or a backend the next target may not be
+    // able to draw from; drop it with the target. The next setRenderTarget() rebuilds it
+    // (configureTextureAtlas) and re-points every renderable.
+    if (_sharedAtlas)
+        _sharedAtlas->release(this);
+    _sharedAtlas.reset();
     _textureAtlas.reset();
+    _contextMutex.reset();
     for (gsl::not_null<Renderable*> const& renderable: renderables())
         renderable->detachRenderTarget();
 }
@@ -256,21 +283,52 @@ void Renderer::configureTextureAtlas()
 
     Require(atlasProperties.tileCount.value > 0);
 
-    _textureAtlas = make_unique<Renderable::TextureAtlas>(_renderTarget->textureScheduler(), atlasProperties);
+    // Shared with the panes of the same window drawing the same text, which fill it together rather than
+    // each uploading every glyph into a texture of its own. The properties above are this renderer's claim
+    // on it; the atlas is as large as all claims together.
+    auto sharedAtlas = _textCaches.acquireAtlas(
+        _textShaper, _fontDescriptions, *_renderTarget, _atlasDirectMapping, _textScalingMethod);
+    if (_sharedAtlas && _sharedAtlas != sharedAtlas)
+        _sharedAtlas->release(this);
+    _sharedAtlas = std::move(sharedAtlas);
+
+    if (_sharedAtlas && _renderTarget->useSharedAtlasBackend(_sharedAtlas->backend()))
+        _sharedAtlas->invalidate();
+    auto atlas = _sharedAtlas ? _sharedAtlas->reserve(this, atlasProperties)
+                              : make_shared<Renderable::TextureAtlas>(_renderTarget->textureScheduler(),
+                                                                      atlasProperties);
 
     // clang-format off
     rendererLog()("Configuring texture atlas.\n", atlasProperties);
     rendererLog()("- Atlas properties     : {}\n", atlasProperties);
-    rendererLog()("- Atlas texture size   : {} pixels\n", _textureAtlas->atlasSize());
+    rendererLog()("- Atlas texture size   : {} pixels\n", atlas->atlasSize());
     rendererLog()("- Atlas hashtable      : {} slots\n", _atlasHashtableSlotCount.value);
-    rendererLog()("- Atlas tile count     : {} = {}x * {}y\n", _textureAtlas->capacity(), _textureAtlas->tilesInX(), _textureAtlas->tilesInY());
+    rendererLog()("- Atlas tile count     : {} = {}x * {}y\n", atlas->capacity(), atlas->tilesInX(), atlas->tilesInY());
     rendererLog()("- Atlas direct mapping : {} (for text rendering)", _atlasDirectMapping ? "enabled" : "disabled");
+    rendererLog()("- Atlas shared         : {}", _sharedAtlas ? "yes" : "no");
     // clang-format on
 
+    useTextureAtlas(std::move(atlas));
+}
+
+void Renderer::useTextureAtlas(std::shared_ptr<Renderable::TextureAtlas> atlas)
+{
+    _textureAtlas = std::move(atlas);
     for (gsl::not_null<Renderable*> const& renderable: renderables())
         renderable->setTextureAtlas(*_textureAtlas);
 }
 
+void Renderer::followSharedAtlas()
+{
+    // Another pane sharing the atlas has outgrown it since this one's last frame. Every tile location
+    // this renderer cached points into the atlas it replaced.
+    if (!_sharedAtlas || !_sharedAtlas->current() || _sharedAtlas->current() == _textureAtlas)
+        return;
+
+    useTextureAtlas(_sharedAtlas->current());
+    clearCache();
+}
+
 void Renderer::growAtlasForPage(vtbackend::PageSize pageSize)
 {
     // The budget was previously fixed at construction, from the page size the renderer happened to start
@@ -412,15 +470,9 @@ void Renderer::applyFontDescriptions(FontDescriptions fontDescriptions)
     if (fontDescriptions == _fontDescriptions)
         return;
 
-    // When only DPI changed, the enhanced setDPI() updates existing FT_Face
-    // objects in-place. Skip clearCache() to avoid destroying them.
-    auto descriptionsWithSameDpi = fontDescriptions;
-    descriptionsWithSameDpi.dpi = _fontDescriptions.dpi;
-    auto const onlyDpiChanged = (descriptionsWithSameDpi == _fontDescriptions);
-
-    // Said out loud rather than dropped on the floor: neither branch below can honour a new
-    // FontLocatorEngine -- the locator is constructor-injected and both the same-engine path and the
-    // replacement shaper resolve through _fontLocator. Committing _fontDescriptions further down then
+    // Said out loud rather than dropped on the floor: acquire() below cannot honour a new
+    // FontLocatorEngine -- the locator is constructor-injected and every shaper acquire() can hand
+    // back resolves through _fontLocator. Committing _fontDescriptions further down then
     // makes the configuration model report the new engine while the fonts on screen keep coming from
     // the old one, and without this line the only symptom is "my font_locator setting does nothing".
     if (_fontDescriptions.fontLocator != fontDescriptions.fontLocator)
@@ -428,49 +480,44 @@ void Renderer::applyFontDescriptions(FontDescriptions fontDescriptions)
                       "lifetime; restart to apply it.",
                       fontDescriptions.fontLocator);
 
-    // A replacement shaper, when the engine changed. Built and loaded into BEFORE anything is
-    // committed, and only then swapped in: loadFontKeys() throws whenever the regular font will not
-    // load, and installing the new shaper first left the renderer holding it alongside FontKeys issued
-    // by the OLD one. applyPendingReconfig()'s try/catch then reports "keeping the previous font" over a
-    // renderer that can no longer shape at all -- every lookup is a miss in the new shaper's font map,
-    // which throws from inside the frame. Windows CI caught exactly that: DirectWrite cannot load the
-    // BDF test font, so the switch fails there on every attempt.
-    auto replacementShaper = unique_ptr<text::Shaper> {};
-
-    if (_fontDescriptions.textShapingEngine == fontDescriptions.textShapingEngine)
-    {
-        // Mutating the shaper we already have is safe to have run on a failed attempt: it is
-        // render-thread-owned, and re-applying the same DPI and fallback limit is idempotent.
-        if (!onlyDpiChanged)
-            _textShaper->clearCache();
-        _textShaper->setDPI(fontDescriptions.dpi);
-        _textShaper->setFontFallbackLimit(fontDescriptions.maxFallbackCount);
-    }
-    else
-    {
-        replacementShaper =
-            createTextShaper(fontDescriptions.textShapingEngine, fontDescriptions.dpi, _fontLocator);
-        replacementShaper->setFontFallbackLimit(fontDescriptions.maxFallbackCount);
-    }
+    // The shaper to serve the new descriptions, acquired and loaded into BEFORE anything is committed,
+    // and only then swapped in: loadFontKeys() throws whenever the regular font will not load, and
+    // installing the new shaper first left the renderer holding it alongside FontKeys issued by the OLD
+    // one. applyPendingReconfig()'s try/catch then reports "keeping the previous font" over a renderer
+    // that can no longer shape at all -- every lookup is a miss in the new shaper's font map, which
+    // throws from inside the frame. Windows CI caught exactly that: DirectWrite cannot load the BDF test
+    // font, so the switch fails there on every attempt.
+    //
+    // acquire() hands back the shaper we already have when the change does not touch its font set, size
+    // or DPI, or when nothing else shares it and the change is confined to the size, the DPI and the
+    // fallback limit (then updating it in place, which is safe to have run on a failed attempt:
+    // re-applying them is idempotent, and a size only loads faces beside the current ones). Anything else
+    // is another renderer's shaper or a new one, and ours is left exactly as it was -- and freed, faces
+    // and all, once its last renderer has moved on.
+    auto replacementShaper =
+        _textCaches.acquire(fontDescriptions, _fontLocator, createTextShaper, _textShaper);
+    if (replacementShaper == _textShaper)
+        replacementShaper.reset();
 
     // Load the fonts against the NEW descriptions, through whichever shaper is going to serve them, but
     // only commit once the load succeeds. loadFontKeys()/updateFontMetrics() (atlas reconfiguration) can
     // throw, and this is called from applyPendingReconfig()'s try/catch which keeps the previous font on
     // failure. Committing _fontDescriptions first (as before) would leave it at a never-loaded value: the
     // change-detection guard at the top of this function and helper.cpp::applyFontDescription would then
-    // both early-return on retry, permanently stranding the wrong font. This mirrors the size-only branch
-    // in applyPendingReconfig().
+    // both early-return on retry, permanently stranding the wrong font. applyPendingReconfig()'s
+    // size-only branch relies on this too.
     auto fonts = loadFontKeys(fontDescriptions, replacementShaper ? *replacementShaper : *_textShaper);
 
     if (replacementShaper)
     {
-        // The assignment destroys the shaper _textRenderer was constructed against, and TextRenderer
-        // holds it for the whole frame path (shape, resizeFont, rasterize). Without the rebind every
-        // draw after an engine switch runs through freed memory. The FontKeys above and the
-        // updateFontMetrics() below supply the other half setTextShaper() requires: fresh keys, and
-        // caches emptied of everything naming the old shaper's glyphs.
+        // The assignment releases the shaper _textRenderer was constructed against -- destroying it when
+        // this renderer was its last user -- and TextRenderer holds it for the whole frame path (shape,
+        // resizeFont, rasterize). Without the rebind every draw after the switch runs through freed
+        // memory. The FontKeys above and the updateFontMetrics() below supply the other half
+        // setTextShaper() requires: fresh keys, and caches emptied of everything naming the old shaper's
+        // glyphs.
         _textShaper = std::move(replacementShaper);
-        _textRenderer.setTextShaper(*_textShaper);
+        _textRenderer.setTextShaper(*_textShaper, _textShaper->shapedRuns());
     }
 
     _fonts = fonts;
@@ -600,15 +647,14 @@ void Renderer::applyPendingReconfig()
             }
             else // pending.fontSize
             {
-                // Stage the size into a copy first; only commit it to _fontDescriptions once the font
-                // actually loaded, so a load failure does not leave _fontDescriptions.size at a value
-                // whose glyphs were never loaded (which would corrupt later change-detection and the
-                // size reported to the UI).
+                // Through the same path as a full change, since the text cache is keyed by size: loading
+                // the new size into the current one would hand it to every renderer sharing it.
+                // applyFontDescriptions() only commits the size once the font actually loaded, so a load
+                // failure does not leave _fontDescriptions.size at a value whose glyphs were never loaded
+                // (which would corrupt later change-detection and the size reported to the UI).
                 auto descriptions = _fontDescriptions;
                 descriptions.size = *pending.fontSize;
-                _fonts = loadFontKeys(descriptions, *_textShaper);
-                _fontDescriptions = std::move(descriptions);
-                updateFontMetrics();
+                applyFontDescriptions(std::move(descriptions));
             }
             applied = true;
         }
@@ -676,14 +722,18 @@ bool Renderer::renderImpl(vtbackend::Terminal& terminal, bool pressure)
     // applyStagedReconfigDuringSetup() (the minimized/occluded path) wait for an in-flight frame to
     // finish reading those, rather than mutating them mid-render. Uncontended in the steady state (the
     // GUI thread only contends it on the rare not-renderable reconfig), so it adds no per-frame cost
-    // beyond one uncontended lock.
-    auto const applyGuard = std::scoped_lock { _applyMutex };
+    // beyond one uncontended lock. The context lock that comes with it does the same for the atlas this
+    // renderer shares with the other panes of its window.
+    auto const frameLock = lockForFrame();
+    auto const scope = crispy::trace::Scope { _traceRecorder, "render", "renderImpl" };
 
     // Apply any geometry/font reconfiguration requested by the UI thread before rendering.
     // This is the only point at which _gridMetrics and the texture atlas are mutated after
     // construction, keeping all such mutation on the render thread (see applyPendingReconfig()).
     applyPendingReconfig();
 
+    followSharedAtlas();
+
     auto const statusLineHeight = terminal.statusLineHeight();
 
     // Reconcile the page size with the terminal's *total* page size. Most page-size changes flow
@@ -737,6 +787,7 @@ bool Renderer::renderImpl(vtbackend::Terminal& terminal, bool pressure)
 
     // Wraps a render pass: begins image/text passes, invokes the content callback, then ends both.
     auto const renderPass = [&](bool withPressure, auto&& content) {
+        auto const passScope = crispy::trace::Scope { _traceRecorder, "render", "pass" };
         _imageRenderer.beginPass();
         _textRenderer.beginFrame();
         _textRenderer.setPressure(withPressure);
@@ -931,7 +982,8 @@ size_t Renderer::findLinePartitionPoint(std::vector<vtbackend::RenderLine> const
 
 void Renderer::inspect(std::ostream& textOutput) const
 {
-    _textureAtlas->inspect(textOutput);
+    if (_textureAtlas)
+        _textureAtlas->inspect(textOutput);
     for (auto const& renderable: renderables())
         renderable->inspect(textOutput);
 }
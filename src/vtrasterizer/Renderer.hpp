@@ -13,10 +13,12 @@
 #include <vtrasterizer/GridMetrics.hpp>
 #include <vtrasterizer/ImageRenderer.hpp>
 #include <vtrasterizer/RenderTarget.hpp>
+#include <vtrasterizer/SharedTextCache.hpp>
 #include <vtrasterizer/TextRenderer.hpp>
 
 #include <crispy/Size.hpp>
 #include <crispy/StrongLRUHashtable.hpp>
+#include <crispy/TraceEvents.hpp>
 
 #include <gsl/pointers>
 
@@ -77,12 +79,24 @@ class Renderer
              /// rather than fetched from FontLocatorProvider so a renderer can be built against
              /// MockFontLocator, and fixed for the renderer's lifetime like every other collaborator.
              text::FontLocator& fontLocator,
+             /// Where this renderer's shaper comes from, and with whom it is shared. Owned by the
+             /// composition root and outliving every renderer it serves.
+             SharedTextCacheRegistry& textCaches,
+             /// Where this renderer's frames are traced, or nullptr when nothing is. Outlives the
+             /// renderer, like textCaches.
+             crispy::trace::Recorder* traceRecorder,
              Decorator hyperlinkNormal,
              Decorator hyperlinkHover,
              // Must match Config's `text_scaling_method` default. When these disagreed, every
              // renderer test silently exercised the method the app does NOT ship.
              GlyphScalingMethod textScalingMethod = GlyphScalingMethod::Rerasterize);
 
+    Renderer(Renderer const&) = delete;
+    Renderer& operator=(Renderer const&) = delete;
+    Renderer(Renderer&&) = delete;
+    Renderer& operator=(Renderer&&) = delete;
+    ~Renderer();
+
     /// Returns the live cell size from the grid metrics.
     ///
     /// @warning Reads the live _gridMetrics without synchronization; intended for render-thread /
@@ -96,6 +110,10 @@ class Renderer
     RenderTarget& renderTarget() noexcept { return *_renderTarget; }
     [[nodiscard]] bool hasRenderTarget() const noexcept { return _renderTarget != nullptr; }
 
+    /// Traces the frames that follow into @p traceRecorder, the recorder of the session now shown, or
+    /// into nothing if it is nullptr. Called with the render thread idle.
+    void setTraceRecorder(crispy::trace::Recorder* traceRecorder) noexcept { _traceRecorder = traceRecorder; }
+
     /// Severs this renderer's (and every renderable's) references into the render target BEFORE the
     /// target is destroyed, when the renderer itself survives the target.
     ///
@@ -252,6 +270,15 @@ class Renderer
      */
     [[nodiscard]] bool render(vtbackend::Terminal& terminal, bool pressureHint);
 
+    /// The locks lockForFrame() hands out, released in reverse order of their members.
+    struct FrameLock
+    {
+        std::unique_lock<std::recursive_mutex> renderer;
+        /// Kept alive here, since detachRenderTarget() may drop the renderer's reference mid-frame.
+        std::shared_ptr<std::recursive_mutex> contextMutex;
+        std::unique_lock<std::recursive_mutex> context;
+    };
+
     /// Synchronously applies any staged font/geometry reconfiguration.
     ///
     /// Used during display setup (before any frame, when a caller must read the resulting cell metrics
@@ -267,7 +294,7 @@ class Renderer
     ///         thread's render() from racing the GUI thread for the same one-shot signal.
     [[nodiscard]] bool applyStagedReconfigDuringSetup()
     {
-        auto const applyGuard = std::scoped_lock { _applyMutex };
+        auto const frameLock = lockForFrame();
         applyPendingReconfig();
         return consumeFontReconfigApplied();
     }
@@ -285,10 +312,18 @@ class Renderer
     /// multi-millisecond atlas texture allocation, and every glyph rasterized afterwards addressed the
     /// pre-rebuild texture size.
     ///
-    /// @return a lock guard the caller keeps for the duration of the frame phase.
-    [[nodiscard]] std::unique_lock<std::recursive_mutex> lockForFrame()
+    /// Once a render target is attached this also takes the lock of its graphics context
+    /// (SharedTextCacheRegistry::contextLock()), after this renderer's own: the glyph atlas may be shared
+    /// with the other panes of the window, and a GUI-thread reconfiguration of any of them can rebuild it.
+    ///
+    /// @return the locks the caller keeps for the duration of the frame phase.
+    [[nodiscard]] FrameLock lockForFrame()
     {
-        return std::unique_lock { _applyMutex };
+        auto frameLock = FrameLock { .renderer = std::unique_lock { _applyMutex } };
+        frameLock.contextMutex = _contextMutex;
+        if (frameLock.contextMutex)
+            frameLock.context = std::unique_lock { *frameLock.contextMutex };
+        return frameLock;
     }
 
     /// Raises the glyph atlas budget to cover @p pageSize, before a render target is attached.
@@ -305,7 +340,7 @@ class Renderer
     /// @param pageSize the page the pane will actually render.
     void reserveAtlasForPage(vtbackend::PageSize pageSize)
     {
-        auto const applyGuard = std::scoped_lock { _applyMutex };
+        auto const frameLock = lockForFrame();
         growAtlasForPage(pageSize);
     }
 
@@ -353,6 +388,14 @@ class Renderer
 
     void configureTextureAtlas();
 
+    /// Makes every renderable draw from @p atlas. The caller clears what they cached against the previous
+    /// one.
+    void useTextureAtlas(std::shared_ptr<Renderable::TextureAtlas> atlas);
+
+    /// Moves onto the shared atlas' current one if another renderer of this graphics context has rebuilt
+    /// it since this renderer's last frame, dropping every tile location cached against the old one.
+    void followSharedAtlas();
+
     /// Clamps a wanted tile budget to what the GPU can actually hold at the current cell size.
     ///
     /// The page-derived budget has no upper bound of its own — a maximized pane on a high-DPI display
@@ -400,17 +443,32 @@ class Renderer
     crispy::StrongHashtableSize _atlasHashtableSlotCount;
     crispy::LRUCapacity _atlasTileCount;
     bool _atlasDirectMapping;
+    GlyphScalingMethod _textScalingMethod;
 
     RenderTarget* _renderTarget = nullptr;
 
+    /// The render target's graphics context's lock; null while no render target is attached.
+    std::shared_ptr<std::recursive_mutex> _contextMutex;
+
     Renderable::DirectMappingAllocator _directMappingAllocator;
-    std::unique_ptr<Renderable::TextureAtlas> _textureAtlas;
+    /// The atlas this renderer shares with the like-configured renderers of its graphics context, or null
+    /// if its render target cannot share one. @see SharedTextCacheRegistry::acquireAtlas().
+    std::shared_ptr<SharedGlyphAtlas> _sharedAtlas;
+    /// The atlas every renderable draws from: _sharedAtlas's current one, or a private one.
+    std::shared_ptr<Renderable::TextureAtlas> _textureAtlas;
 
     /// Resolves font descriptions to files. Constructor-injected and fixed thereafter.
     text::FontLocator& _fontLocator;
 
+    /// Constructor-injected; reconfiguration goes back through it for a fitting shaper.
+    SharedTextCacheRegistry& _textCaches;
+
+    /// The shown session's recorder; null when nothing is traced.
+    crispy::trace::Recorder* _traceRecorder;
+
     FontDescriptions _fontDescriptions;
-    std::unique_ptr<text::Shaper> _textShaper;
+    /// Shared with every other renderer of _textCaches whose shaper would be configured the same way.
+    SharedTextCache::Ptr _textShaper;
     FontKeys _fonts;
 
     /// The live grid metrics, mutated *only* on the render thread (at the start of renderImpl()).
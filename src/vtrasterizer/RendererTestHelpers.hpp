@@ -8,6 +8,7 @@
 
 #include <chrono>
 #include <format>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <ranges>
@@ -161,6 +162,24 @@ class MockRenderTarget: public vtrasterizer::RenderTarget
     MockAtlasBackend& getMockBackend() { return _textureScheduler; }
     MockImageTextureBackend& getMockImageBackend() { return _imageScheduler; }
 
+    /// Puts this target into the graphics context @p context, whose targets share glyph atlases. By
+    /// default a mock target is a context of its own and shares nothing.
+    void shareGraphicsContext(void const* context) noexcept { _context = context; }
+
+    [[nodiscard]] void const* graphicsContext() const noexcept override { return _context ? _context : this; }
+
+    [[nodiscard]] std::shared_ptr<vtrasterizer::atlas::AtlasBackend> createSharedAtlasBackend() override
+    {
+        return _context ? std::make_shared<MockAtlasBackend>() : nullptr;
+    }
+
+    [[nodiscard]] bool useSharedAtlasBackend(
+        std::shared_ptr<vtrasterizer::atlas::AtlasBackend> const& backend) override
+    {
+        // A backend nobody configured yet holds no tiles.
+        return std::static_pointer_cast<MockAtlasBackend>(backend)->configureCount == 0;
+    }
+
     void renderRectangle(int, int, vtbackend::Width, vtbackend::Height, vtbackend::RGBAColor) override {}
     void setScissorRect(int, int, int, int) override {}
     void clearScissorRect() override {}
@@ -172,6 +191,7 @@ class MockRenderTarget: public vtrasterizer::RenderTarget
 
   private:
     vtbackend::ImageSize _size {};
+    void const* _context = nullptr;
     MockAtlasBackend _textureScheduler;
     MockImageTextureBackend _imageScheduler;
 };
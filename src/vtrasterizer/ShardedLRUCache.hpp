@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <crispy/StrongHash.hpp>
+#include <crispy/StrongLRUHashtable.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace vtrasterizer
+{
+
+/// An LRU cache that any render thread may read and fill, split into independently locked shards.
+///
+/// One lock for the whole cache made every window's render thread queue behind every other one for
+/// each lookup, hit or miss. A hash picks its shard, so two threads contend only when they touch the
+/// same shard at the same moment, and the lock is never held across the work that fills a miss: the
+/// caller computes the value between tryGet() and emplace(), and two threads racing to fill the same
+/// key both compute it and the second write wins, which is harmless for a cache of pure results.
+///
+/// Values are handed out by copy, since another thread may evict the entry the moment the shard's
+/// lock is released; a value that is expensive to copy is stored behind a std::shared_ptr.
+template <typename Value, size_t ShardCount = 8>
+class ShardedLRUCache
+{
+    static_assert(std::has_single_bit(ShardCount));
+
+  public:
+    /// @param slotsPerShard    hashtable slots of each shard; a power of two.
+    /// @param capacityPerShard entries each shard holds before it evicts.
+    /// @param name             shown by inspect().
+    ShardedLRUCache(crispy::StrongHashtableSize slotsPerShard,
+                    crispy::LRUCapacity capacityPerShard,
+                    std::string const& name)
+    {
+        for (auto& shard: _shards)
+            shard.entries = crispy::StrongLRUHashtable<Value>::create(slotsPerShard, capacityPerShard, name);
+    }
+
+    /// @return a copy of the value cached under @p hash, marking it most recently used.
+    [[nodiscard]] std::optional<Value> tryGet(crispy::StrongHash const& hash)
+    {
+        auto& shard = shardOf(hash);
+        auto const l = std::scoped_lock { shard.mutex };
+        if (auto const* value = shard.entries->tryGet(hash))
+            return *value;
+        return std::nullopt;
+    }
+
+    /// Caches @p value under @p hash, replacing what was there.
+    void emplace(crispy::StrongHash const& hash, Value value)
+    {
+        auto& shard = shardOf(hash);
+        auto const l = std::scoped_lock { shard.mutex };
+        shard.entries->emplace(hash, std::move(value));
+    }
+
+    void clear()
+    {
+        for (auto& shard: _shards)
+        {
+            auto const l = std::scoped_lock { shard.mutex };
+            shard.entries->clear();
+        }
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        auto total = size_t { 0 };
+        for (auto const& shard: _shards)
+        {
+            auto const l = std::scoped_lock { shard.mutex };
+            total += shard.entries->size();
+        }
+        return total;
+    }
+
+    void inspect(std::ostream& output) const
+    {
+        for (auto const& shard: _shards)
+        {
+            auto const l = std::scoped_lock { shard.mutex };
+            shard.entries->inspect(output);
+        }
+    }
+
+  private:
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        typename crispy::StrongLRUHashtable<Value>::Ptr entries;
+    };
+
+    /// Fibonacci hashing of d(), keeping the product's top bits: each shard's hashtable picks its slot
+    /// from d()'s low bits, and a shard chosen from those too would leave most of every shard's slots
+    /// unused.
+    [[nodiscard]] Shard& shardOf(crispy::StrongHash const& hash) noexcept
+    {
+        constexpr auto ShardBits = std::countr_zero(ShardCount);
+        if constexpr (ShardBits == 0)
+            return _shards[0];
+        else
+            return _shards[(hash.d() * uint32_t { 2654435769u }) >> (32 - ShardBits)];
+    }
+
+    std::array<Shard, ShardCount> _shards;
+};
+
+} // namespace vtrasterizer
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/AtlasBudget.hpp>
+#include <vtrasterizer/SharedGlyphAtlas.hpp>
+#include <vtrasterizer/Utils.hpp>
+
+#include <algorithm>
+
+using std::make_shared;
+using std::shared_ptr;
+
+namespace vtrasterizer
+{
+
+SharedGlyphAtlas::SharedGlyphAtlas(std::shared_ptr<atlas::AtlasBackend> backend):
+    _backend { std::move(backend) }
+{
+}
+
+shared_ptr<SharedGlyphAtlas::TextureAtlas> SharedGlyphAtlas::reserve(void const* member,
+                                                                     atlas::AtlasProperties const& properties)
+{
+    auto claims = _claims;
+    auto const claim = std::ranges::find(claims, member, [](auto const& entry) { return entry.first; });
+    if (claim != claims.end())
+        claim->second = properties;
+    else
+        claims.emplace_back(member, properties);
+
+    // Every claim was sized for one page; the atlas has to hold all of those pages at once. Re-quantized
+    // and re-bounded because a sum of budgets is itself a budget the GPU has to be able to hold.
+    auto const direct = properties.directMappingCount;
+    auto tileCount = uint32_t { 0 };
+    auto hashCount = uint32_t { 0 };
+    for (auto const& [_, claimed]: claims)
+    {
+        tileCount += claimed.tileCount.value;
+        hashCount = std::max(hashCount, claimed.hashCount.value);
+    }
+    auto const ceiling =
+        atlasbudget::maxTileCountFor(properties.tileSize, direct, atlasbudget::MaxAtlasTextureEdge);
+    auto const required = std::min(
+        atlasbudget::quantizedTileCountFor(crispy::LRUCapacity { tileCount }, direct).value, ceiling.value);
+
+    auto const fits = [&](TextureAtlas const& atlas) {
+        auto const& current = atlas.properties();
+        return current.format == properties.format && current.tileSize == properties.tileSize
+               && current.directMappingCount == direct && current.tileCount.value >= required;
+    };
+
+    if (!_atlas || _invalidated || !fits(*_atlas))
+    {
+        // Grow-only while the tiles keep their size: a pane that closed must not shrink the texture the
+        // moment another one needs a rebuild for some other reason.
+        auto const previous = _atlas && _atlas->properties().tileSize == properties.tileSize
+                                  ? _atlas->properties().tileCount.value
+                                  : 0u;
+        auto combined = properties;
+        combined.tileCount = crispy::LRUCapacity { std::min(std::max(required, previous), ceiling.value) };
+        combined.hashCount =
+            atlasbudget::slotCountFor(crispy::StrongHashtableSize { hashCount }, combined.tileCount);
+
+        rendererLog()("Building shared texture atlas for {} renderers: {} tiles of {}.",
+                      claims.size(),
+                      combined.tileCount.value,
+                      combined.tileSize);
+        _atlas = make_shared<TextureAtlas>(*_backend, combined);
+        _invalidated = false;
+    }
+
+    _claims = std::move(claims);
+    return _atlas;
+}
+
+void SharedGlyphAtlas::release(void const* member) noexcept
+{
+    std::erase_if(_claims, [member](auto const& entry) { return entry.first == member; });
+}
+
+} // namespace vtrasterizer
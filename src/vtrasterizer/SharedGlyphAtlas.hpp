@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtrasterizer/RenderTarget.hpp>
+#include <vtrasterizer/TextureAtlas.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace vtrasterizer
+{
+
+/// One texture atlas shared by every renderer that draws the same text into the same graphics context.
+///
+/// Panes of one window render through one graphics context, and those configured alike shape through
+/// one SharedTextCache and so rasterize identical tiles under identical keys. Each used to fill an atlas
+/// of its own anyway: the same glyphs uploaded once per pane, and a texture per pane sized for that
+/// pane's page. Handed out by SharedTextCacheRegistry::acquireAtlas(), this holds the one atlas they
+/// fill together instead.
+///
+/// Each renderer claims room for its own page through reserve(), and the atlas holds the SUM of the
+/// claims. Every renderer's frame is staged before any is drawn, so the tiles one pane's frame needs
+/// must survive every other pane's frame in the same round: an atlas sized for one page would recycle a
+/// tile another pane has already baked into its vertices. Grow-only, like the per-renderer budget it
+/// replaces, and quantized the same way, so panes opening one after another rebuild it once per
+/// power-of-two band rather than once per pane.
+///
+/// A rebuild replaces the atlas object, and with it every tile location. reserve()'s caller re-points
+/// its renderables itself; every other renderer notices at its next frame that current() is no longer
+/// the atlas it draws from and does the same.
+///
+/// Not synchronized: every member is called with the context's lock held
+/// (SharedTextCacheRegistry::contextLock()).
+class SharedGlyphAtlas
+{
+  public:
+    using TextureAtlas = Renderable::TextureAtlas;
+
+    /// @param backend the atlas' backend in this graphics context; see
+    ///                RenderTarget::createSharedAtlasBackend().
+    explicit SharedGlyphAtlas(std::shared_ptr<atlas::AtlasBackend> backend);
+
+    SharedGlyphAtlas(SharedGlyphAtlas const&) = delete;
+    SharedGlyphAtlas& operator=(SharedGlyphAtlas const&) = delete;
+    SharedGlyphAtlas(SharedGlyphAtlas&&) = delete;
+    SharedGlyphAtlas& operator=(SharedGlyphAtlas&&) = delete;
+    ~SharedGlyphAtlas() = default;
+
+    [[nodiscard]] std::shared_ptr<atlas::AtlasBackend> const& backend() const noexcept { return _backend; }
+
+    /// The atlas every claimant should be drawing from, or nullptr before the first reserve().
+    [[nodiscard]] std::shared_ptr<TextureAtlas> const& current() const noexcept { return _atlas; }
+
+    /// Records @p member's claim and returns an atlas that satisfies every claim, rebuilding it when the
+    /// current one does not.
+    ///
+    /// @param member     the claiming renderer; only its identity is used.
+    /// @param properties the atlas @p member would have built for itself. Its tile size, format and
+    ///                   direct-mapping count must match every other claim's, and win if they do not.
+    /// @throws whatever building the atlas throws, leaving the previous atlas and claims in place.
+    [[nodiscard]] std::shared_ptr<TextureAtlas> reserve(void const* member,
+                                                        atlas::AtlasProperties const& properties);
+
+    /// Withdraws @p member's claim. The atlas keeps its size.
+    void release(void const* member) noexcept;
+
+    /// Makes the next reserve() rebuild the atlas, e.g. because the backend has lost its texture or the
+    /// bitmaps behind the tile keys have changed.
+    void invalidate() noexcept { _invalidated = true; }
+
+  private:
+    std::shared_ptr<atlas::AtlasBackend> _backend;
+    std::shared_ptr<TextureAtlas> _atlas;
+    std::vector<std::pair<void const*, atlas::AtlasProperties>> _claims;
+    bool _invalidated = false;
+};
+
+} // namespace vtrasterizer
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/RenderTarget.hpp>
+#include <vtrasterizer/SharedGlyphAtlas.hpp>
+#include <vtrasterizer/SharedTextCache.hpp>
+#include <vtrasterizer/Utils.hpp>
+
+#include <text_shaper/FontLocator.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using std::optional;
+using std::scoped_lock;
+using std::shared_ptr;
+using std::u32string_view;
+using std::unique_ptr;
+
+namespace vtrasterizer
+{
+
+namespace
+{
+    crispy::StrongHash hashOf(text::GlyphKey const& glyph, text::RenderMode mode, float outlineThickness)
+    {
+        // The FontKey already names the face at its size; the size is hashed anyway because
+        // GlyphKey::size is part of GlyphKey's own equality.
+        return crispy::StrongHash { glyph.font.value,
+                                    glyph.index.value,
+                                    std::bit_cast<uint32_t>(static_cast<float>(glyph.size.pt)),
+                                    static_cast<uint32_t>(mode) }
+               * std::bit_cast<uint32_t>(outlineThickness);
+    }
+
+    /// @p descriptions without what only changes how a renderer uses the shaper -- the render mode and the
+    /// outline are passed to each rasterize(), built-in box drawing never reaches the shaper -- so that
+    /// renderers differing in those alone still share a cache.
+    FontDescriptions cacheKeyOf(FontDescriptions descriptions) noexcept
+    {
+        descriptions.renderMode = {};
+        descriptions.builtinBoxDrawing = true;
+        descriptions.textOutline = {};
+        return descriptions;
+    }
+
+    /// Whether a cache configured as @p from can become @p to by reconfiguring its shaper in place.
+    ///
+    /// A FontKey already names a face at a size, so a size change only loads the new size beside the old;
+    /// the DPI and the fallback limit are shaper settings the loaded faces follow. Anything else -- the font
+    /// set or the engine -- would leave faces loaded that the new configuration never uses.
+    bool reconfigurableInPlace(FontDescriptions const& from, FontDescriptions const& to) noexcept
+    {
+        auto adjusted = from;
+        adjusted.size = to.size;
+        adjusted.dpi = to.dpi;
+        adjusted.dpiScale = to.dpiScale;
+        adjusted.maxFallbackCount = to.maxFallbackCount;
+        return adjusted == to;
+    }
+} // namespace
+
+SharedTextCache::SharedTextCache(Identity identity, unique_ptr<text::Shaper> shaper):
+    _identity { std::move(identity) },
+    _shaper { std::move(shaper) },
+    _shapedRuns { std::make_shared<ShapedRunCache>(
+        crispy::StrongHashtableSize { 2048 }, ShapedRunShardSize, "Shared text shaping cache") },
+    _rasterizedGlyphs { crispy::StrongHashtableSize { 1024 },
+                        RasterizedGlyphShardSize,
+                        "Shared rasterized glyph cache" }
+{
+}
+
+SharedTextCache::Ptr SharedTextCacheRegistry::acquire(FontDescriptions const& descriptions,
+                                                      text::FontLocator& locator,
+                                                      ShaperFactory const& createShaper,
+                                                      SharedTextCache::Ptr const& current)
+{
+    auto identity = SharedTextCache::Identity { .fonts = cacheKeyOf(descriptions), .locator = &locator };
+
+    auto const l = scoped_lock { _mutex };
+
+    std::erase_if(_caches, [](auto const& weak) { return weak.expired(); });
+
+    for (auto const& weak: _caches)
+        if (auto cache = weak.lock(); cache && cache->_identity == identity)
+            return cache;
+
+    // Every other reference is handed out under this lock, so a count of one cannot grow behind our back.
+    if (current && current.use_count() == 1 && current->_identity.locator == identity.locator
+        && reconfigurableInPlace(current->_identity.fonts, identity.fonts))
+    {
+        if (current->_identity.fonts.dpi != identity.fonts.dpi)
+            current->setDPI(identity.fonts.dpi);
+        if (current->_identity.fonts.maxFallbackCount != identity.fonts.maxFallbackCount)
+            current->setFontFallbackLimit(identity.fonts.maxFallbackCount);
+        current->_identity = std::move(identity);
+        return current;
+    }
+
+    rendererLog()("Creating shared text cache for {} at {}pt, {}.",
+                  identity.fonts.regular,
+                  identity.fonts.size.pt,
+                  identity.fonts.dpi);
+    auto shaper = createShaper(identity.fonts.textShapingEngine, identity.fonts.dpi, locator);
+    shaper->setFontFallbackLimit(identity.fonts.maxFallbackCount);
+    auto cache = SharedTextCache::Ptr(new SharedTextCache(std::move(identity), std::move(shaper)));
+    _caches.emplace_back(cache);
+    return cache;
+}
+
+shared_ptr<SharedGlyphAtlas> SharedTextCacheRegistry::acquireAtlas(SharedTextCache::Ptr const& cache,
+                                                                   FontDescriptions const& descriptions,
+                                                                   RenderTarget& target,
+                                                                   bool directMapping,
+                                                                   GlyphScalingMethod scaling)
+{
+    auto const* const context = target.graphicsContext();
+
+    auto const l = scoped_lock { _mutex };
+
+    std::erase_if(_atlases, [](auto const& entry) { return entry.atlas.expired(); });
+
+    for (auto const& entry: _atlases)
+        if (entry.context == context && entry.directMapping == directMapping && entry.scaling == scaling
+            && entry.fonts == descriptions && entry.cache.lock() == cache)
+            if (auto atlas = entry.atlas.lock())
+                return atlas;
+
+    auto backend = target.createSharedAtlasBackend();
+    if (!backend)
+        return nullptr;
+
+    auto atlas = std::make_shared<SharedGlyphAtlas>(std::move(backend));
+    _atlases.emplace_back(AtlasEntry { .cache = cache,
+                                       .fonts = descriptions,
+                                       .context = context,
+                                       .directMapping = directMapping,
+                                       .scaling = scaling,
+                                       .atlas = atlas });
+    return atlas;
+}
+
+shared_ptr<std::recursive_mutex> SharedTextCacheRegistry::contextLock(void const* context)
+{
+    auto const l = scoped_lock { _mutex };
+
+    std::erase_if(_contextLocks, [](auto const& entry) { return entry.mutex.expired(); });
+
+    for (auto const& entry: _contextLocks)
+        if (entry.context == context)
+            if (auto mutex = entry.mutex.lock())
+                return mutex;
+
+    auto mutex = std::make_shared<std::recursive_mutex>();
+    _contextLocks.emplace_back(ContextLockEntry { .context = context, .mutex = mutex });
+    return mutex;
+}
+
+void SharedTextCache::clearResults()
+{
+    _shapedRuns->clear();
+    _rasterizedGlyphs.clear();
+}
+
+void SharedTextCache::setDPI(DPI dpi)
+{
+    {
+        auto const l = scoped_lock { _shaperMutex };
+        _shaper->setDPI(dpi);
+    }
+    // Every cached run was positioned, and every cached bitmap rasterized, at the old resolution.
+    clearResults();
+}
+
+void SharedTextCache::setLocator(text::FontLocator& locator)
+{
+    auto const l = scoped_lock { _shaperMutex };
+    _shaper->setLocator(locator);
+}
+
+void SharedTextCache::clearCache()
+{
+    {
+        auto const l = scoped_lock { _shaperMutex };
+        _shaper->clearCache();
+    }
+    clearResults();
+}
+
+void SharedTextCache::setFontFallbackLimit(int limit)
+{
+    {
+        auto const l = scoped_lock { _shaperMutex };
+        _shaper->setFontFallbackLimit(limit);
+    }
+    // A cached run may have resolved a glyph through a fallback face the new limit no longer reaches.
+    clearResults();
+}
+
+optional<text::FontKey> SharedTextCache::loadFont(text::FontDescription const& description,
+                                                  text::FontSize size)
+{
+    auto const l = scoped_lock { _shaperMutex };
+    return _shaper->loadFont(description, size);
+}
+
+text::FontMetrics SharedTextCache::metrics(text::FontKey key) const
+{
+    auto const l = scoped_lock { _shaperMutex };
+    return _shaper->metrics(key);
+}
+
+text::FontKey SharedTextCache::resizeFont(text::FontKey key, text::FontSize size)
+{
+    auto const l = scoped_lock { _shaperMutex };
+    return _shaper->resizeFont(key, size);
+}
+
+void SharedTextCache::shape(text::FontKey font,
+                            u32string_view text,
+                            gsl::span<unsigned> clusters,
+                            unicode::Script script,
+                            unicode::PresentationStyle presentation,
+                            text::ShapeResult& result)
+{
+    auto const l = scoped_lock { _shaperMutex };
+    _shaper->shape(font, text, clusters, script, presentation, result);
+}
+
+optional<text::GlyphPosition> SharedTextCache::shape(text::FontKey font, char32_t codepoint)
+{
+    auto const l = scoped_lock { _shaperMutex };
+    return _shaper->shape(font, codepoint);
+}
+
+optional<text::RasterizedGlyph> SharedTextCache::rasterize(text::GlyphKey glyph,
+                                                           text::RenderMode mode,
+                                                           float outlineThickness)
+{
+    auto const hash = hashOf(glyph, mode, outlineThickness);
+
+    if (auto cached = _rasterizedGlyphs.tryGet(hash))
+        return cached;
+
+    // Rasterized outside the cache's lock, so a miss here does not hold up another thread's hits. A
+    // failed rasterization is not cached, so the next attempt, e.g. after a fallback font was loaded,
+    // still reaches the rasterizer.
+    auto rasterized = [&] {
+        auto const l = scoped_lock { _shaperMutex };
+        return _shaper->rasterize(glyph, mode, outlineThickness);
+    }();
+    if (rasterized)
+        _rasterizedGlyphs.emplace(hash, *rasterized);
+    return rasterized;
+}
+
+} // namespace vtrasterizer
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtrasterizer/FontDescriptions.hpp>
+#include <vtrasterizer/GlyphScaling.hpp>
+#include <vtrasterizer/ShardedLRUCache.hpp>
+
+#include <text_shaper/Shaper.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace text
+{
+class FontLocator;
+}
+
+namespace vtrasterizer
+{
+
+class RenderTarget;
+class SharedGlyphAtlas;
+class SharedTextCacheRegistry;
+
+/// Shaped runs, keyed by TextRenderer's hash of the run's text, style, font and size.
+///
+/// Behind a shared_ptr so that a renderer can keep drawing from a run another thread's renderer has
+/// just evicted.
+using ShapedRunCache = ShardedLRUCache<std::shared_ptr<text::ShapeResult const>>;
+
+/// A text shaper, the runs it has shaped and the glyphs it has rasterized, shared by every renderer
+/// drawing the same font set at the same size and DPI.
+///
+/// Each pane and each window used to own a private shaper: its own FreeType faces, its own fontconfig
+/// answers, its own fallback coverage, its own shaped runs, and its own copy of every glyph it ever
+/// rasterized -- so ten panes with the same font paid for all of it ten times over, and a new pane
+/// started cold. Renderers now acquire one of these from a SharedTextCacheRegistry instead, and every
+/// renderer asking for the same font set at the same size and DPI, through the same shaping engine and
+/// locator, gets the same instance.
+///
+/// A FontKey names a face at a size, so one cache per size is not needed for correctness. It is what
+/// makes the cache and every glyph atlas built from it interchangeable between renderers: two renderers
+/// sharing a cache shape to the same FontKeys and, configured alike, rasterize to the same bitmaps, so a
+/// glyph atlas keyed by cache and configuration (see SharedTextCacheRegistry::acquireAtlas()) can serve
+/// both without their tiles colliding.
+/// It is also what lets a font change free the previous font's faces: the old cache goes away with the
+/// last renderer that held it.
+///
+/// Shaper calls serialize on one lock, since the faces inside are not thread-safe. The shaped-run and
+/// rasterized-glyph caches in front of them are sharded with their own locks, so a render thread whose
+/// frame hits in them never waits on another thread's shaping or rasterization. The mutators
+/// (setDPI(), setFontFallbackLimit(), setLocator(), clearCache()) would change the shaper under every
+/// renderer sharing it, which is why a configuration change goes back through the registry instead.
+class SharedTextCache final: public text::Shaper
+{
+  public:
+    using Ptr = std::shared_ptr<SharedTextCache>;
+
+    /// Number of rasterized glyphs kept for all renderers together, per shard.
+    static constexpr auto RasterizedGlyphShardSize = crispy::LRUCapacity { 512 };
+
+    /// Number of shaped runs kept for all renderers together, per shard.
+    static constexpr auto ShapedRunShardSize = crispy::LRUCapacity { 1024 };
+
+    SharedTextCache(SharedTextCache const&) = delete;
+    SharedTextCache& operator=(SharedTextCache const&) = delete;
+    SharedTextCache(SharedTextCache&&) = delete;
+    SharedTextCache& operator=(SharedTextCache&&) = delete;
+    ~SharedTextCache() override = default;
+
+    /// The runs shaped through this cache, for TextRenderer to look up before it shapes.
+    [[nodiscard]] std::shared_ptr<ShapedRunCache> const& shapedRuns() const noexcept { return _shapedRuns; }
+
+    // text::Shaper
+    void setDPI(DPI dpi) override;
+    void setLocator(text::FontLocator& locator) override;
+    void clearCache() override;
+    void setFontFallbackLimit(int limit) override;
+    [[nodiscard]] std::optional<text::FontKey> loadFont(text::FontDescription const& description,
+                                                        text::FontSize size) override;
+    [[nodiscard]] text::FontMetrics metrics(text::FontKey key) const override;
+    [[nodiscard]] text::FontKey resizeFont(text::FontKey key, text::FontSize size) override;
+    void shape(text::FontKey font,
+               std::u32string_view text,
+               gsl::span<unsigned> clusters,
+               unicode::Script script,
+               unicode::PresentationStyle presentation,
+               text::ShapeResult& result) override;
+    [[nodiscard]] std::optional<text::GlyphPosition> shape(text::FontKey font, char32_t codepoint) override;
+    [[nodiscard]] std::optional<text::RasterizedGlyph> rasterize(text::GlyphKey glyph,
+                                                                 text::RenderMode mode,
+                                                                 float outlineThickness = 0.0f) override;
+
+  private:
+    friend class SharedTextCacheRegistry;
+
+    /// Everything that makes two caches interchangeable: the font set, size and DPI, plus the shaping
+    /// engine and fallback limit the shaper was built with. Settings the shaper never sees, such as the
+    /// render mode, are left at their defaults here.
+    struct Identity
+    {
+        FontDescriptions fonts;
+        text::FontLocator const* locator = nullptr;
+
+        bool operator==(Identity const&) const noexcept = default;
+    };
+
+    using RasterizedGlyphCache = ShardedLRUCache<text::RasterizedGlyph>;
+
+    SharedTextCache(Identity identity, std::unique_ptr<text::Shaper> shaper);
+
+    /// Forgets every shaped run and rasterized glyph, keeping the faces.
+    void clearResults();
+
+    /// Read and rewritten only by SharedTextCacheRegistry::acquire(), under the registry's lock rather
+    /// than _shaperMutex.
+    Identity _identity;
+
+    mutable std::mutex _shaperMutex;
+    std::unique_ptr<text::Shaper> _shaper;
+
+    std::shared_ptr<ShapedRunCache> _shapedRuns;
+    RasterizedGlyphCache _rasterizedGlyphs;
+};
+
+/// The SharedTextCache instances a set of renderers share, and the glyph atlases built from them, handed
+/// to each Renderer at construction.
+///
+/// Owned by the composition root -- one per GUI application -- so renderers configured alike share
+/// a cache only when they were given the same registry. A test builds its own and shares nothing with
+/// any other test.
+class SharedTextCacheRegistry
+{
+  public:
+    /// Builds the shaper a new cache wraps; in production this is Renderer's createTextShaper().
+    using ShaperFactory =
+        std::function<std::unique_ptr<text::Shaper>(TextShapingEngine, DPI, text::FontLocator&)>;
+
+    SharedTextCacheRegistry() = default;
+    SharedTextCacheRegistry(SharedTextCacheRegistry const&) = delete;
+    SharedTextCacheRegistry& operator=(SharedTextCacheRegistry const&) = delete;
+    SharedTextCacheRegistry(SharedTextCacheRegistry&&) = delete;
+    SharedTextCacheRegistry& operator=(SharedTextCacheRegistry&&) = delete;
+    ~SharedTextCacheRegistry() = default;
+
+    /// Returns the cache serving @p descriptions through @p locator.
+    ///
+    /// A cache another renderer already holds is preferred. Failing that, @p current is reconfigured in
+    /// place when nothing else holds it and the change is confined to the size, the DPI and the fallback
+    /// limit -- a zoom or a monitor switch then keeps the loaded faces rather than reopening them from
+    /// disk. Otherwise a new cache is built, and @p current is freed once its last holder lets go.
+    [[nodiscard]] SharedTextCache::Ptr acquire(FontDescriptions const& descriptions,
+                                               text::FontLocator& locator,
+                                               ShaperFactory const& createShaper,
+                                               SharedTextCache::Ptr const& current = {});
+
+    /// Returns the glyph atlas that renderers drawing @p descriptions through @p cache into @p target's
+    /// graphics context share, or nullptr if @p target cannot share one
+    /// (RenderTarget::createSharedAtlasBackend()).
+    ///
+    /// The full @p descriptions, direct mapping and the scaling method all change which bitmap a renderer
+    /// uploads under a tile's key, or where, so renderers only share an atlas when all of them agree.
+    [[nodiscard]] std::shared_ptr<SharedGlyphAtlas> acquireAtlas(SharedTextCache::Ptr const& cache,
+                                                                 FontDescriptions const& descriptions,
+                                                                 RenderTarget& target,
+                                                                 bool directMapping,
+                                                                 GlyphScalingMethod scaling);
+
+    /// Returns the lock that serializes the frames of every renderer drawing into @p context.
+    ///
+    /// The glyph atlases of one context are written by each of its renderers' frames, and by the GUI
+    /// thread applying a staged reconfiguration to any one of them. A renderer's own lock cannot keep
+    /// those apart; this one, held in Renderer::lockForFrame() after the renderer's own, does.
+    [[nodiscard]] std::shared_ptr<std::recursive_mutex> contextLock(void const* context);
+
+  private:
+    struct AtlasEntry
+    {
+        /// Weak rather than a pointer compared by address: FontKeys are only unique within one shaper, so
+        /// an atlas outliving its cache must never be handed to a new cache allocated at the same address.
+        std::weak_ptr<SharedTextCache> cache;
+        FontDescriptions fonts;
+        void const* context = nullptr;
+        bool directMapping = false;
+        GlyphScalingMethod scaling {};
+        std::weak_ptr<SharedGlyphAtlas> atlas;
+    };
+
+    struct ContextLockEntry
+    {
+        void const* context = nullptr;
+        std::weak_ptr<std::recursive_mutex> mutex;
+    };
+
+    std::mutex _mutex;
+    /// All weak, so the last renderer to let go of a cache, an atlas or a lock frees it.
+    std::vector<std::weak_ptr<SharedTextCache>> _caches;
+    std::vector<AtlasEntry> _atlases;
+    std::vector<ContextLockEntry> _contextLocks;
+};
+
+} // namespace vtrasterizer
@@ -244,6 +244,15 @@ namespace
             return TextStyle::Italic;
         return TextStyle::Regular;
     }
+
+    /// The shaping cache of a renderer whose shaper nobody shares, cut into as many shards as
+    /// SharedTextCache's.
+    std::shared_ptr<ShapedRunCache> createPrivateShapingCache(uint32_t capacity)
+    {
+        return std::make_shared<ShapedRunCache>(crispy::StrongHashtableSize { 16384 / 8 },
+                                                crispy::LRUCapacity { capacity / 8 },
+                                                "Text shaping cache");
+    }
 } // namespace
 
 text::FontLocator& createFontLocator(FontLocatorEngine engine)
@@ -266,15 +275,16 @@ TextRenderer::TextRenderer(GridMetrics const& gridMetrics,
                            FontDescriptions& fontDescriptions,
                            FontKeys const& fontKeys,
                            TextRendererEvents& eventHandler,
-                           GlyphScaler const& glyphScaler):
+                           GlyphScaler const& glyphScaler,
+                           std::shared_ptr<ShapedRunCache> shapedRuns):
     Renderable { gridMetrics },
     _textClusterGrouper { *this },
     _textRendererEvents { eventHandler },
     _fontDescriptions { fontDescriptions },
     _fonts { fontKeys },
-    _textShapingCache { ShapingResultCache::create(crispy::StrongHashtableSize { 16384 },
-                                                   crispy::LRUCapacity { TextShapingCacheSize },
-                                                   "Text shaping cache") },
+    _textShapingCacheScope { shapedRuns ? ShapingCacheScope::Shared : ShapingCacheScope::Private },
+    _textShapingCache { shapedRuns ? std::move(shapedRuns)
+                                   : createPrivateShapingCache(TextShapingCacheSize) },
     _textShaper { &textShaper },
     _boxDrawingRenderer { gridMetrics },
     _glyphScaler { &glyphScaler }
@@ -292,6 +302,13 @@ GlyphScaler const& TextRenderer::defaultGlyphScaler() noexcept
     return scaler;
 }
 
+void TextRenderer::setTextShaper(text::Shaper& textShaper, std::shared_ptr<ShapedRunCache> shapedRuns)
+{
+    _textShaper = &textShaper;
+    _textShapingCacheScope = shapedRuns ? ShapingCacheScope::Shared : ShapingCacheScope::Private;
+    _textShapingCache = shapedRuns ? std::move(shapedRuns) : createPrivateShapingCache(TextShapingCacheSize);
+}
+
 void TextRenderer::inspect(ostream& textOutput) const
 {
     textOutput << "TextRenderer:\n";
@@ -322,7 +339,11 @@ void TextRenderer::clearCache()
     if (_textureAtlas && _directMapping)
         initializeDirectMapping();
 
-    _textShapingCache->clear();
+    // A shared shaping cache is left to its owner, which clears it whenever the shaper under it changes
+    // (SharedTextCache::setDPI(), setFontFallbackLimit()); clearing it here would throw away every other
+    // pane's runs each time this one grows its atlas.
+    if (_textShapingCacheScope == ShapingCacheScope::Private)
+        _textShapingCache->clear();
 
     _boxDrawingRenderer.clearCache();
 }
@@ -369,7 +390,7 @@ void TextRenderer::restrictToTileSize(TextureAtlas::TileCreateData& tileCreateDa
     tileCreateData.bitmap = std::move(slicedBitmap);
 
     // NB: Also adjust the normalized width to not render the empty space.
-    auto const atlasSize = _textureScheduler->atlasSize();
+    auto const atlasSize = _textureAtlas->atlasSize();
     tileCreateData.metadata.normalizedLocation.width =
         unbox<float>(tileCreateData.bitmapSize.width) / unbox<float>(atlasSize.width);
 }
@@ -1271,27 +1292,27 @@ text::ShapeResult const& TextRenderer::getOrCreateCachedGlyphPositions(StrongHas
                                                                        gsl::span<unsigned> clusters,
                                                                        TextStyle style)
 {
-    // getOrTryEmplace, not getOrEmplace: a shaper that fails mid-run (DirectWrite's GetGlyphPlacements
+    // A failed shape is never cached: a shaper that fails mid-run (DirectWrite's GetGlyphPlacements
     // is the documented case) yields no positions at all for a non-empty run, and caching THAT turns one
     // transient failure into a permanent hole -- every later occurrence of the same text in the same
     // style and size hits the cached emptiness and draws nothing, until a font or size change happens to
     // change the key. Refusing to cache it costs a re-shape per occurrence and lets the next frame
     // recover.
-    auto const* cached =
-        _textShapingCache->getOrTryEmplace(hash, [&](auto) -> std::optional<text::ShapeResult> {
-            auto shaped = createTextShapedGlyphPositions(codepoints, clusters, style);
-            if (shaped.empty() && !codepoints.empty())
-            {
-                // Rejected for the cache, but the caller still gets what was shaped, so park it in the
-                // scratch slot rather than shaping the run a second time. One text group is drawn at a
-                // time and the caller is done with the result before the next one is shaped.
-                _uncachedShapeResult = std::move(shaped);
-                return std::nullopt;
-            }
-            return shaped;
-        });
+    //
+    // Either way the result is pinned in _shapedGroup: one text group is drawn at a time and the caller is
+    // done with it before the next one is shaped, but the cache is shared with other render threads, any of
+    // which may evict the entry in between.
+    if (auto cached = _textShapingCache->tryGet(hash))
+        _shapedGroup = std::move(*cached);
+    else
+    {
+        _shapedGroup = std::make_shared<text::ShapeResult const>(
+            createTextShapedGlyphPositions(codepoints, clusters, style));
+        if (!_shapedGroup->empty() || codepoints.empty())
+            _textShapingCache->emplace(hash, _shapedGroup);
+    }
 
-    return cached ? *cached : _uncachedShapeResult;
+    return *_shapedGroup;
 }
 
 text::ShapeResult TextRenderer::createTextShapedGlyphPositions(u32string_view codepoints,
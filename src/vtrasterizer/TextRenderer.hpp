@@ -10,6 +10,7 @@
 #include <vtrasterizer/GlyphScaling.hpp>
 #include <vtrasterizer/GlyphSlicing.hpp>
 #include <vtrasterizer/RenderTarget.hpp>
+#include <vtrasterizer/SharedTextCache.hpp>
 #include <vtrasterizer/TextClusterGrouper.hpp>
 #include <vtrasterizer/TextureAtlas.hpp>
 
@@ -29,6 +30,7 @@
 #include <gsl/span>
 #include <gsl/span_ext>
 
+#include <memory>
 #include <vector>
 
 namespace vtrasterizer
@@ -64,7 +66,10 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
                  FontDescriptions& fontDescriptions,
                  FontKeys const& fontKeys,
                  TextRendererEvents& eventHandler,
-                 GlyphScaler const& glyphScaler = defaultGlyphScaler());
+                 GlyphScaler const& glyphScaler = defaultGlyphScaler(),
+                 /// The shaped runs shared with every other renderer shaping through @p textShaper, or
+                 /// nullptr to keep them to this renderer. @see SharedTextCache::shapedRuns().
+                 std::shared_ptr<ShapedRunCache> shapedRuns = nullptr);
 
     /// The strategy used when no other is injected. @see GlyphScalingMethod.
     [[nodiscard]] static GlyphScaler const& defaultGlyphScaler() noexcept;
@@ -91,7 +96,9 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
     /// keys and call updateFontMetrics() (which clears the caches) after this, exactly as
     /// Renderer::applyFontDescriptions() does.
     /// @param textShaper The shaper to shape and rasterize through from now on.
-    void setTextShaper(text::Shaper& textShaper) noexcept { _textShaper = &textShaper; }
+    /// @param shapedRuns The runs shaped through @p textShaper, or nullptr for a cache of this renderer's
+    ///                   own.
+    void setTextShaper(text::Shaper& textShaper, std::shared_ptr<ShapedRunCache> shapedRuns = nullptr);
 
     void updateFontMetrics();
 
@@ -232,13 +239,20 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
     //
     bool _pressure = false;
 
-    using ShapingResultCache = crispy::StrongLRUHashtable<text::ShapeResult>;
-    using ShapingResultCachePtr = ShapingResultCache::Ptr;
+    /// Whether _textShapingCache is this renderer's own, for clearCache() to clear.
+    enum class ShapingCacheScope : uint8_t
+    {
+        Private,
+        Shared,
+    };
 
-    ShapingResultCachePtr _textShapingCache;
-    /// Holds a shaping result the cache refused (an empty result for a non-empty run, i.e. a shaper
-    /// failure) for as long as the caller needs it. @see getOrCreateCachedGlyphPositions().
-    text::ShapeResult _uncachedShapeResult {};
+    ShapingCacheScope _textShapingCacheScope;
+    /// Shared with the other renderers of the same SharedTextCache, whose keys name the same fonts.
+    std::shared_ptr<ShapedRunCache> _textShapingCache;
+    /// The text group being drawn, held for as long as the caller needs it: another render thread may
+    /// evict it from the shared cache meanwhile, and a result the cache refused (an empty result for a
+    /// non-empty run, i.e. a shaper failure) lives nowhere else. @see getOrCreateCachedGlyphPositions().
+    std::shared_ptr<text::ShapeResult const> _shapedGroup;
     // TODO: make unique_ptr, get owned, export cref for other users in Renderer impl.
     // A pointer rather than a reference so setTextShaper() can rebind it; the owner (Renderer)
     // replaces the shaper wholesale when the shaping engine changes, and a reference member would
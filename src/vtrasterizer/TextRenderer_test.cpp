@@ -94,6 +94,24 @@ class RendererTest
     /// The renderer's live text shaper, so a test can rasterize through the same faces the frame does.
     [[nodiscard]] static text::Shaper& textShaper(Renderer& renderer) { return *renderer._textShaper; }
 
+    /// The text cache behind textShaper(), for the shaped runs it shares.
+    [[nodiscard]] static SharedTextCache& textCache(Renderer& renderer) { return *renderer._textShaper; }
+
+    /// The atlas every renderable of @p renderer draws from, or nullptr with no render target attached.
+    [[nodiscard]] static Renderable::TextureAtlas const* textureAtlas(Renderer const& renderer)
+    {
+        return renderer._textureAtlas.get();
+    }
+
+    /// The tile budget @p renderer claims for its own page.
+    [[nodiscard]] static crispy::LRUCapacity atlasTileCount(Renderer const& renderer)
+    {
+        return renderer._atlasTileCount;
+    }
+
+    /// Runs the step of renderImpl() that moves @p renderer onto a shared atlas another renderer rebuilt.
+    static void followSharedAtlas(Renderer& renderer) { renderer.followSharedAtlas(); }
+
     /// Seeds self-consistent grid metrics into the live and published metrics.
     ///
     /// The minimal BDF test font yields zero line metrics from the shaper, which a real TextureAtlas
@@ -939,6 +957,8 @@ struct ReconfigFixture
     MockRenderTarget renderTarget {};
     // Declared before `renderer`: the renderer holds it by reference for its whole lifetime.
     MockFontLocator fontLocator {};
+    // Likewise; one per fixture, so no test shares a shaper with another.
+    SharedTextCacheRegistry textCaches {};
     Renderer renderer;
 
     ReconfigFixture():
@@ -950,6 +970,8 @@ struct ReconfigFixture
                  crispy::LRUCapacity { 4096 },
                  /* atlasDirectMapping */ false,
                  fontLocator,
+                 textCaches,
+                 /*traceRecorder=*/nullptr,
                  Decorator::Underline,
                  Decorator::Underline)
     {
@@ -2102,6 +2124,183 @@ TEST_CASE("Renderer.reconfig.tiles_follow_the_atlas_across_a_rebuild", "[rendere
           == Catch::Approx(unbox<float>(tile->bitmapSize.height)));
 }
 
+TEST_CASE("Renderer.text_shaper_is_shared_between_like_renderers", "[renderer][shaping]")
+{
+    // Panes configured alike load their faces and rasterize their glyphs once, into one shaper. A pane
+    // whose shaper configuration changes must leave that shaper as it is for the others, and only a
+    // pane holding it alone may reconfigure it in place.
+    configureMockFont();
+    ReconfigFixture fixture;
+    auto& first = fixture.renderer;
+    auto& shaper = vtrasterizer::RendererTest::textShaper(first);
+
+    auto changed = fixture.fontDescriptions;
+    changed.maxFallbackCount += 1; // Part of the shaper's identity, but loads the same font.
+
+    SECTION("shared, a change moves only the renderer that made it")
+    {
+        auto second = Renderer { vtbackend::PageSize { LineCount(24), ColumnCount(80) },
+                                 vtrasterizer::PageMargin {},
+                                 fixture.fontDescriptions,
+                                 fixture.colorPalette,
+                                 crispy::StrongHashtableSize { 1024 },
+                                 crispy::LRUCapacity { 4096 },
+                                 /* atlasDirectMapping */ false,
+                                 fixture.fontLocator,
+                                 fixture.textCaches,
+                                 /*traceRecorder=*/nullptr,
+                                 Decorator::Underline,
+                                 Decorator::Underline };
+        CHECK(&vtrasterizer::RendererTest::textShaper(second) == &shaper);
+
+        second.setFonts(changed);
+        vtrasterizer::RendererTest::applyPendingReconfig(second);
+        REQUIRE(second.fontDescriptions().maxFallbackCount == changed.maxFallbackCount);
+        CHECK(&vtrasterizer::RendererTest::textShaper(second) != &shaper);
+        CHECK(&vtrasterizer::RendererTest::textShaper(first) == &shaper);
+
+        // Changing back rejoins the shaper the first renderer kept.
+        second.setFonts(fixture.fontDescriptions);
+        vtrasterizer::RendererTest::applyPendingReconfig(second);
+        CHECK(&vtrasterizer::RendererTest::textShaper(second) == &shaper);
+    }
+
+    SECTION("a setting the shaper never sees keeps the shaper shared")
+    {
+        auto second = Renderer { vtbackend::PageSize { LineCount(24), ColumnCount(80) },
+                                 vtrasterizer::PageMargin {},
+                                 fixture.fontDescriptions,
+                                 fixture.colorPalette,
+                                 crispy::StrongHashtableSize { 1024 },
+                                 crispy::LRUCapacity { 4096 },
+                                 /* atlasDirectMapping */ false,
+                                 fixture.fontLocator,
+                                 fixture.textCaches,
+                                 /*traceRecorder=*/nullptr,
+                                 Decorator::Underline,
+                                 Decorator::Underline };
+
+        auto antialiased = fixture.fontDescriptions;
+        antialiased.renderMode = text::RenderMode::LCD;
+        second.setFonts(antialiased);
+        vtrasterizer::RendererTest::applyPendingReconfig(second);
+        REQUIRE(second.fontDescriptions().renderMode == text::RenderMode::LCD);
+        CHECK(&vtrasterizer::RendererTest::textShaper(second) == &shaper);
+    }
+
+    SECTION("renderers of different registries share nothing")
+    {
+        auto otherCaches = SharedTextCacheRegistry {};
+        auto other = Renderer { vtbackend::PageSize { LineCount(24), ColumnCount(80) },
+                                vtrasterizer::PageMargin {},
+                                fixture.fontDescriptions,
+                                fixture.colorPalette,
+                                crispy::StrongHashtableSize { 1024 },
+                                crispy::LRUCapacity { 4096 },
+                                /* atlasDirectMapping */ false,
+                                fixture.fontLocator,
+                                otherCaches,
+                                /*traceRecorder=*/nullptr,
+                                Decorator::Underline,
+                                Decorator::Underline };
+        CHECK(&vtrasterizer::RendererTest::textShaper(other) != &shaper);
+    }
+
+    SECTION("alone, a change reconfigures the shaper in place")
+    {
+        first.setFonts(changed);
+        vtrasterizer::RendererTest::applyPendingReconfig(first);
+        REQUIRE(first.fontDescriptions().maxFallbackCount == changed.maxFallbackCount);
+        CHECK(&vtrasterizer::RendererTest::textShaper(first) == &shaper);
+    }
+}
+
+TEST_CASE("Renderer.glyph_atlas_is_shared_within_a_graphics_context", "[renderer][atlas]")
+{
+    // Panes of one window draw through one graphics context. Configured alike, they fill one atlas and
+    // one shaped-run cache, and the atlas holds every pane's page at once, since each pane's frame is
+    // staged before any of them is drawn.
+    configureMockFont();
+    ReconfigFixture fixture;
+    auto const window = int {}; // Stands in for the window both render targets draw into.
+    auto& first = fixture.renderer;
+    fixture.renderTarget.shareGraphicsContext(&window);
+
+    // Declared before `second`, which draws into it for its whole lifetime.
+    auto secondTarget = MockRenderTarget {};
+    secondTarget.shareGraphicsContext(&window);
+    auto second = Renderer { vtbackend::PageSize { LineCount(24), ColumnCount(80) },
+                             vtrasterizer::PageMargin {},
+                             fixture.fontDescriptions,
+                             fixture.colorPalette,
+                             crispy::StrongHashtableSize { 1024 },
+                             crispy::LRUCapacity { 4096 },
+                             /* atlasDirectMapping */ false,
+                             fixture.fontLocator,
+                             fixture.textCaches,
+                             /*traceRecorder=*/nullptr,
+                             Decorator::Underline,
+                             Decorator::Underline };
+    vtrasterizer::RendererTest::seedMetrics(second, ReconfigFixture::seededMetrics());
+
+    fixture.attachRenderTarget();
+    second.setRenderTarget(secondTarget);
+
+    SECTION("one atlas, sized for both pages")
+    {
+        // The second claim outgrew the atlas the first renderer built; the first moves onto the rebuilt
+        // one at its next frame.
+        vtrasterizer::RendererTest::followSharedAtlas(first);
+        auto const* atlas = vtrasterizer::RendererTest::textureAtlas(first);
+        REQUIRE(atlas != nullptr);
+        CHECK(vtrasterizer::RendererTest::textureAtlas(second) == atlas);
+        CHECK(atlas->properties().tileCount.value
+              >= vtrasterizer::RendererTest::atlasTileCount(first).value
+                     + vtrasterizer::RendererTest::atlasTileCount(second).value);
+    }
+
+    SECTION("a run shaped by one renderer is not shaped again by the other")
+    {
+        auto& cache = vtrasterizer::RendererTest::textCache(first);
+        REQUIRE(&vtrasterizer::RendererTest::textCache(second) == &cache);
+
+        auto const text = std::u32string { U"AB" };
+        auto clusters = std::vector<unsigned> { 0, 1 };
+        auto const& shaped = TextRendererTest::glyphPositions(
+            vtrasterizer::RendererTest::textRenderer(first), text, clusters, TextStyle::Regular);
+        REQUIRE_FALSE(shaped.empty());
+        auto const runsShaped = cache.shapedRuns()->size();
+
+        CHECK_FALSE(TextRendererTest::glyphPositions(
+                        vtrasterizer::RendererTest::textRenderer(second), text, clusters, TextStyle::Regular)
+                        .empty());
+        CHECK(cache.shapedRuns()->size() == runsShaped);
+    }
+
+    SECTION("another graphics context gets an atlas of its own")
+    {
+        auto otherWindow = MockRenderTarget {};
+        auto third = Renderer { vtbackend::PageSize { LineCount(24), ColumnCount(80) },
+                                vtrasterizer::PageMargin {},
+                                fixture.fontDescriptions,
+                                fixture.colorPalette,
+                                crispy::StrongHashtableSize { 1024 },
+                                crispy::LRUCapacity { 4096 },
+                                /* atlasDirectMapping */ false,
+                                fixture.fontLocator,
+                                fixture.textCaches,
+                                /*traceRecorder=*/nullptr,
+                                Decorator::Underline,
+                                Decorator::Underline };
+        vtrasterizer::RendererTest::seedMetrics(third, ReconfigFixture::seededMetrics());
+        third.setRenderTarget(otherWindow);
+
+        CHECK(&vtrasterizer::RendererTest::textCache(third) == &vtrasterizer::RendererTest::textCache(first));
+        CHECK(vtrasterizer::RendererTest::textureAtlas(third)
+              != vtrasterizer::RendererTest::textureAtlas(second));
+    }
+}
+
 int main(int argc, char* argv[])
 {
     crispy::suppressWindowsDialogs();
@@ -255,6 +255,7 @@ class TextureAtlas
 
     [[nodiscard]] vtbackend::ImageSize atlasSize() const noexcept { return _atlasSize; }
     [[nodiscard]] vtbackend::ImageSize tileSize() const noexcept { return _atlasProperties.tileSize; }
+    [[nodiscard]] AtlasProperties const& properties() const noexcept { return _atlasProperties; }
 
     // Tests in LRU-cache if the tile
     [[nodiscard]] constexpr bool contains(crispy::StrongHash const& id) const noexcept;